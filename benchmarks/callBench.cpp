@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/benchmarks/callBench.cpp - Call benchmarks ---------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents the benchmarks of the latencies of the calls, the
+/// indirect calls, the host function calls, and the invocations from the host.
+///
+//===----------------------------------------------------------------------===//
+
+#include "helper.h"
+
+#include "runtime/callingframe.h"
+#include "runtime/hostfunc.h"
+#include "runtime/instance/module.h"
+
+#include <memory>
+#include <string>
+
+namespace {
+
+using namespace std::literals;
+using namespace WasmEdge;
+using namespace WasmEdge::Benchmark;
+
+class HostIdentity : public Runtime::HostFunction<HostIdentity> {
+public:
+  Expect<uint32_t> body(const Runtime::CallingFrame &, uint32_t Value) {
+    return Value;
+  }
+};
+
+class HostModule : public Runtime::Instance::ModuleInstance {
+public:
+  HostModule() : ModuleInstance("env") {
+    addHostFunc("identity", std::make_unique<HostIdentity>());
+  }
+};
+
+std::vector<Byte> createCallWasm() {
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType({ValType::I32}, {ValType::I32});
+  const auto Host = Builder.importFunc("env", "identity", Type);
+  const auto Callee = Builder.addFunc(Type, {}, Code().localGet(0));
+  Builder.setTable({Callee});
+  Builder.exportFunc("callee", Callee);
+
+  Code Direct;
+  Direct.localGet(0).call(Callee).op(0x1A);
+  Builder.exportFunc(
+      "call", Builder.addFunc(Type, {},
+                              Code().countDown(0, Direct).i32Const(0)));
+
+  Code Indirect;
+  Indirect.localGet(0).i32Const(0).callIndirect(Type).op(0x1A);
+  Builder.exportFunc(
+      "call_indirect",
+      Builder.addFunc(Type, {}, Code().countDown(0, Indirect).i32Const(0)));
+
+  Code HostCall;
+  HostCall.localGet(0).call(Host).op(0x1A);
+  Builder.exportFunc(
+      "host_call",
+      Builder.addFunc(Type, {}, Code().countDown(0, HostCall).i32Const(0)));
+  return Builder.build();
+}
+
+// Run the loop of n calls of the kind.
+void calls(benchmark::State &State, std::string_view Func, Mode M) {
+  const auto Conf = createConf();
+  HostModule Host;
+  VM::VM VM(Conf);
+  if (!VM.registerModule(Host) ||
+      !instantiate(VM, Conf, createCallWasm(), M)) {
+    State.SkipWithError("instantiation failed");
+    return;
+  }
+  const auto N = static_cast<uint32_t>(State.range(0));
+  runLoop(State, VM, Func, {N});
+  State.SetItemsProcessed(State.iterations() * N);
+}
+
+// Invoke a wasm function from the host once per iteration.
+void invoke(benchmark::State &State, Mode M) {
+  const auto Conf = createConf();
+  HostModule Host;
+  VM::VM VM(Conf);
+  if (!VM.registerModule(Host) ||
+      !instantiate(VM, Conf, createCallWasm(), M)) {
+    State.SkipWithError("instantiation failed");
+    return;
+  }
+  runLoop(State, VM, "callee", {1});
+  State.SetItemsProcessed(State.iterations());
+}
+
+[[maybe_unused]] const bool Registered = []() {
+  for (const auto &[M, ModeName] : getModes()) {
+    for (const auto Func : {"call"sv, "call_indirect"sv, "host_call"sv}) {
+      const auto Name =
+          "calls/"s + std::string(Func) + "/" + std::string(ModeName);
+      benchmark::RegisterBenchmark(Name.c_str(), calls, Func, M)->Arg(10000);
+    }
+    const auto Name = "invoke/"s + std::string(ModeName);
+    benchmark::RegisterBenchmark(Name.c_str(), invoke, M);
+  }
+  return true;
+}();
+
+} // namespace
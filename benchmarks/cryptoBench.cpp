@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/benchmarks/cryptoBench.cpp - WASI-crypto benchmarks ------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents the benchmarks of the internals of the wasi-crypto
+/// plugin: the handle churn of the handle managers, and the short hash states
+/// of the plugin on the cached contexts compared with allocating the contexts
+/// on every call.
+///
+//===----------------------------------------------------------------------===//
+
+#include "utils/evp_wrapper.h"
+#include "utils/handles_manager.h"
+
+#include "common/filesystem.h"
+#include "plugin/plugin.h"
+#include "runtime/callingframe.h"
+#include "runtime/instance/module.h"
+
+#include <benchmark/benchmark.h>
+#include <openssl/evp.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string_view>
+
+namespace {
+
+using namespace std::literals;
+using namespace WasmEdge::Host::WasiCrypto;
+using WasmEdge::Span;
+
+using Manager = RcHandlesManager<int32_t, std::shared_ptr<int>>;
+
+// Open, look up and close a handle, as the state_open, state_update and
+// state_close calls of concurrent guest threads, which also look up a
+// long-lived handle.
+void handleChurn(benchmark::State &State) {
+  static Manager Handles{0x08};
+  static const auto Shared = Handles.registerManager(std::make_shared<int>(-1));
+  if (!Shared) {
+    State.SkipWithError("handle registration failed");
+    return;
+  }
+  for (auto _ : State) {
+    auto Handle = Handles.registerManager(std::make_shared<int>(0));
+    if (!Handle) {
+      State.SkipWithError("handle registration failed");
+      break;
+    }
+    benchmark::DoNotOptimize(Handles.get(*Handle));
+    benchmark::DoNotOptimize(Handles.get(*Shared));
+    Handles.close(*Handle);
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(handleChurn)->ThreadRange(1, 8)->UseRealTime();
+
+// The symmetric module of the wasi-crypto plugin, whose host functions are
+// called as from the guest, with the arguments in the memory.
+class SymmetricHost {
+public:
+  SymmetricHost() : Mod(""), CallFrame(nullptr, &Mod) {
+    Mod.addHostMemory(
+        "memory", std::make_unique<WasmEdge::Runtime::Instance::MemoryInstance>(
+                      WasmEdge::AST::MemoryType(1)));
+    MemInst = Mod.findMemoryExports("memory");
+    WasmEdge::Plugin::Plugin::load(
+        std::filesystem::u8path(WASMEDGE_WASI_CRYPTO_PLUGIN_PATH));
+    if (const auto *Plugin = WasmEdge::Plugin::Plugin::find("wasi_crypto"sv)) {
+      if (const auto *Module = Plugin->findModule("wasi_crypto_symmetric"sv)) {
+        SymmMod = Module->create();
+      }
+    }
+  }
+
+  explicit operator bool() const noexcept { return SymmMod != nullptr; }
+
+  // Open, absorb, squeeze and close a SHA-256 state.
+  bool hash(std::string_view Data, Span<uint8_t> Out) {
+    const auto DataSize = static_cast<uint32_t>(Data.size());
+    const auto OutSize = static_cast<uint32_t>(Out.size());
+    std::copy(kAlg.begin(), kAlg.end(), MemInst->getPointer<char *>(kAlgPtr));
+    MemInst->getPointer<__wasi_opt_symmetric_key_t *>(kOptKeyPtr)->tag =
+        __WASI_OPT_SYMMETRIC_KEY_U_NONE;
+    MemInst->getPointer<__wasi_opt_options_t *>(kOptOptionsPtr)->tag =
+        __WASI_OPT_OPTIONS_U_NONE;
+    if (!call("symmetric_state_open"sv,
+              {kAlgPtr, static_cast<uint32_t>(kAlg.size()), kOptKeyPtr,
+               kOptOptionsPtr, kStatePtr})) {
+      return false;
+    }
+    const auto State =
+        *MemInst->getPointer<__wasi_symmetric_state_t *>(kStatePtr);
+    std::copy(Data.begin(), Data.end(), MemInst->getPointer<char *>(kDataPtr));
+    const bool Hashed =
+        call("symmetric_state_absorb"sv, {State, kDataPtr, DataSize}) &&
+        call("symmetric_state_squeeze"sv, {State, kOutPtr, OutSize});
+    std::copy_n(MemInst->getPointer<uint8_t *>(kOutPtr), OutSize, Out.begin());
+    return call("symmetric_state_close"sv, {State}) && Hashed;
+  }
+
+private:
+  static inline constexpr std::string_view kAlg = "SHA-256"sv;
+  static inline constexpr uint32_t kAlgPtr = 0;
+  static inline constexpr uint32_t kOptKeyPtr = 8;
+  static inline constexpr uint32_t kOptOptionsPtr = 16;
+  static inline constexpr uint32_t kStatePtr = 24;
+  static inline constexpr uint32_t kDataPtr = 64;
+  static inline constexpr uint32_t kOutPtr = 1024;
+
+  bool call(std::string_view Name,
+            std::initializer_list<WasmEdge::ValVariant> Args) {
+    auto *FuncInst = SymmMod->findFuncExports(Name);
+    std::array<WasmEdge::ValVariant, 1> Errno;
+    return FuncInst && FuncInst->isHostFunction() &&
+           FuncInst->getHostFunc().run(CallFrame, Args, Errno) &&
+           Errno[0].get<int32_t>() == __WASI_CRYPTO_ERRNO_SUCCESS;
+  }
+
+  WasmEdge::Runtime::Instance::ModuleInstance Mod;
+  WasmEdge::Runtime::CallingFrame CallFrame;
+  WasmEdge::Runtime::Instance::MemoryInstance *MemInst = nullptr;
+  std::unique_ptr<WasmEdge::Runtime::Instance::ModuleInstance> SymmMod;
+};
+
+constexpr std::string_view kHashData = "datamore_data"sv;
+
+// Hash through the symmetric state of the plugin, which takes its contexts
+// from the cache of the thread and the digest fetched once.
+void hashPooled(benchmark::State &State) {
+  SymmetricHost Host;
+  if (!Host) {
+    State.SkipWithError("wasi-crypto plugin not found");
+    return;
+  }
+  std::array<uint8_t, 32> Out;
+  for (auto _ : State) {
+    if (!Host.hash(kHashData, Out)) {
+      State.SkipWithError("hash failed");
+      break;
+    }
+    benchmark::DoNotOptimize(Out);
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(hashPooled)->ThreadRange(1, 8)->UseRealTime();
+
+// The same hash as the states did before the cache, which allocate the
+// contexts and look up the digest on every call.
+void hashPerCall(benchmark::State &State) {
+  std::array<uint8_t, 32> Out;
+  for (auto _ : State) {
+    EvpMdCtxPtr Ctx{EVP_MD_CTX_new()};
+    EvpMdCtxPtr CopyCtx{EVP_MD_CTX_new()};
+    unsigned int Size;
+    if (!Ctx || !CopyCtx ||
+        !EVP_DigestInit(Ctx.get(), EVP_get_digestbynid(NID_sha256)) ||
+        !EVP_DigestUpdate(Ctx.get(), kHashData.data(), kHashData.size()) ||
+        !EVP_MD_CTX_copy_ex(CopyCtx.get(), Ctx.get()) ||
+        !EVP_DigestFinal_ex(CopyCtx.get(), Out.data(), &Size)) {
+      State.SkipWithError("hash failed");
+      break;
+    }
+    benchmark::DoNotOptimize(Out);
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(hashPerCall)->ThreadRange(1, 8)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,341 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "helper.h"
+
+#include "loader/loader.h"
+#include "validator/validator.h"
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+#include "aot/compiler.h"
+#endif
+
+#include <cstring>
+
+namespace WasmEdge {
+namespace Benchmark {
+
+namespace {
+
+void writeU32(std::vector<Byte> &Out, uint32_t Value) {
+  do {
+    Byte B = static_cast<Byte>(Value & UINT32_C(0x7F));
+    Value >>= 7;
+    if (Value != 0) {
+      B |= UINT8_C(0x80);
+    }
+    Out.push_back(B);
+  } while (Value != 0);
+}
+
+void writeS64(std::vector<Byte> &Out, int64_t Value) {
+  while (true) {
+    const Byte B = static_cast<Byte>(Value & INT64_C(0x7F));
+    Value >>= 7;
+    if ((Value == 0 && (B & UINT8_C(0x40)) == 0) ||
+        (Value == -1 && (B & UINT8_C(0x40)) != 0)) {
+      Out.push_back(B);
+      return;
+    }
+    Out.push_back(B | UINT8_C(0x80));
+  }
+}
+
+void writeName(std::vector<Byte> &Out, std::string_view Name) {
+  writeU32(Out, static_cast<uint32_t>(Name.size()));
+  Out.insert(Out.end(), Name.begin(), Name.end());
+}
+
+void writeSection(std::vector<Byte> &Out, Byte Id,
+                  const std::vector<Byte> &Content) {
+  Out.push_back(Id);
+  writeU32(Out, static_cast<uint32_t>(Content.size()));
+  Out.insert(Out.end(), Content.begin(), Content.end());
+}
+
+} // namespace
+
+Code &Code::u32(uint32_t Value) {
+  writeU32(Bytes, Value);
+  return *this;
+}
+
+Code &Code::s32(int32_t Value) {
+  writeS64(Bytes, Value);
+  return *this;
+}
+
+Code &Code::s64(int64_t Value) {
+  writeS64(Bytes, Value);
+  return *this;
+}
+
+Code &Code::f64(double Value) {
+  uint64_t Raw;
+  std::memcpy(&Raw, &Value, sizeof(Raw));
+  for (uint32_t I = 0; I < 8; ++I) {
+    Bytes.push_back(static_cast<Byte>(Raw >> (I * 8)));
+  }
+  return *this;
+}
+
+Code &Code::countDown(uint32_t Counter, const Code &Body) {
+  block().loop();
+  // i32.eqz
+  localGet(Counter).op(0x45).brIf(1);
+  append(Body);
+  // i32.sub
+  localGet(Counter).i32Const(1).op(0x6B).localSet(Counter);
+  return br(0).end().end();
+}
+
+Code &Code::forLoop(uint32_t Var, uint32_t Limit, const Code &Body) {
+  i32Const(0).localSet(Var).block().loop();
+  // i32.ge_u
+  localGet(Var).localGet(Limit).op(0x4F).brIf(1);
+  append(Body);
+  // i32.add
+  localGet(Var).i32Const(1).op(0x6A).localSet(Var);
+  return br(0).end().end();
+}
+
+uint32_t ModuleBuilder::addType(std::vector<ValType> Params,
+                                std::vector<ValType> Results) {
+  std::vector<Byte> Type = {0x60};
+  writeU32(Type, static_cast<uint32_t>(Params.size()));
+  for (const auto VType : Params) {
+    Type.push_back(static_cast<Byte>(VType));
+  }
+  writeU32(Type, static_cast<uint32_t>(Results.size()));
+  for (const auto VType : Results) {
+    Type.push_back(static_cast<Byte>(VType));
+  }
+  Types.push_back(std::move(Type));
+  return static_cast<uint32_t>(Types.size() - 1);
+}
+
+uint32_t ModuleBuilder::importFunc(std::string_view Module,
+                                   std::string_view Name, uint32_t TypeIdx) {
+  Imports.push_back({std::string(Module), std::string(Name), TypeIdx});
+  return static_cast<uint32_t>(Imports.size() - 1);
+}
+
+uint32_t ModuleBuilder::addFunc(
+    uint32_t TypeIdx, std::vector<std::pair<uint32_t, ValType>> Locals,
+    const Code &Body) {
+  std::vector<Byte> Bytes;
+  writeU32(Bytes, static_cast<uint32_t>(Locals.size()));
+  for (const auto &[Count, VType] : Locals) {
+    writeU32(Bytes, Count);
+    Bytes.push_back(static_cast<Byte>(VType));
+  }
+  Bytes.insert(Bytes.end(), Body.getBytes().begin(), Body.getBytes().end());
+  Bytes.push_back(0x0B);
+  Functions.push_back({TypeIdx, std::move(Bytes)});
+  return static_cast<uint32_t>(Imports.size() + Functions.size() - 1);
+}
+
+uint32_t ModuleBuilder::addGlobal(ValType Type, bool IsMutable,
+                                  const Code &Init) {
+  const auto &InitBytes = Init.getBytes();
+  std::vector<Byte> Global;
+  Global.reserve(InitBytes.size() + 3);
+  Global.push_back(static_cast<Byte>(Type));
+  Global.push_back(static_cast<Byte>(IsMutable ? 0x01 : 0x00));
+  Global.insert(Global.end(), InitBytes.begin(), InitBytes.end());
+  Global.push_back(0x0B);
+  Globals.push_back(std::move(Global));
+  return static_cast<uint32_t>(Globals.size() - 1);
+}
+
+void ModuleBuilder::exportFunc(std::string_view Name, uint32_t FuncIdx) {
+  Exports.push_back({std::string(Name), FuncIdx});
+}
+
+void ModuleBuilder::setMemory(uint32_t MinPages) { MemoryPages = MinPages; }
+
+void ModuleBuilder::setTable(std::vector<uint32_t> FuncIdxs) {
+  Table = std::move(FuncIdxs);
+}
+
+void ModuleBuilder::addData(uint32_t Offset, Span<const Byte> Data) {
+  Datas.push_back({Offset, std::vector<Byte>(Data.begin(), Data.end())});
+}
+
+std::vector<Byte> ModuleBuilder::build() const {
+  std::vector<Byte> Out = {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00};
+  std::vector<Byte> Section;
+
+  writeU32(Section, static_cast<uint32_t>(Types.size()));
+  for (const auto &Type : Types) {
+    Section.insert(Section.end(), Type.begin(), Type.end());
+  }
+  writeSection(Out, 0x01, Section);
+
+  if (!Imports.empty()) {
+    Section.clear();
+    writeU32(Section, static_cast<uint32_t>(Imports.size()));
+    for (const auto &Imp : Imports) {
+      writeName(Section, Imp.Module);
+      writeName(Section, Imp.Name);
+      Section.push_back(0x00);
+      writeU32(Section, Imp.TypeIdx);
+    }
+    writeSection(Out, 0x02, Section);
+  }
+
+  Section.clear();
+  writeU32(Section, static_cast<uint32_t>(Functions.size()));
+  for (const auto &Func : Functions) {
+    writeU32(Section, Func.TypeIdx);
+  }
+  writeSection(Out, 0x03, Section);
+
+  if (!Table.empty()) {
+    Section = {0x01, 0x70, 0x00};
+    writeU32(Section, static_cast<uint32_t>(Table.size()));
+    writeSection(Out, 0x04, Section);
+  }
+
+  if (MemoryPages > 0) {
+    Section = {0x01, 0x00};
+    writeU32(Section, MemoryPages);
+    writeSection(Out, 0x05, Section);
+  }
+
+  if (!Globals.empty()) {
+    Section.clear();
+    writeU32(Section, static_cast<uint32_t>(Globals.size()));
+    for (const auto &Global : Globals) {
+      Section.insert(Section.end(), Global.begin(), Global.end());
+    }
+    writeSection(Out, 0x06, Section);
+  }
+
+  Section.clear();
+  writeU32(Section, static_cast<uint32_t>(Exports.size() +
+                                          (MemoryPages > 0 ? 1 : 0)));
+  for (const auto &Exp : Exports) {
+    writeName(Section, Exp.Name);
+    Section.push_back(0x00);
+    writeU32(Section, Exp.FuncIdx);
+  }
+  if (MemoryPages > 0) {
+    writeName(Section, "memory");
+    Section.push_back(0x02);
+    writeU32(Section, 0);
+  }
+  writeSection(Out, 0x07, Section);
+
+  if (!Table.empty()) {
+    // One active segment of the table 0 at the offset 0.
+    Section = {0x01, 0x00, 0x41, 0x00, 0x0B};
+    writeU32(Section, static_cast<uint32_t>(Table.size()));
+    for (const auto FuncIdx : Table) {
+      writeU32(Section, FuncIdx);
+    }
+    writeSection(Out, 0x09, Section);
+  }
+
+  Section.clear();
+  writeU32(Section, static_cast<uint32_t>(Functions.size()));
+  for (const auto &Func : Functions) {
+    writeU32(Section, static_cast<uint32_t>(Func.Body.size()));
+    Section.insert(Section.end(), Func.Body.begin(), Func.Body.end());
+  }
+  writeSection(Out, 0x0A, Section);
+
+  if (!Datas.empty()) {
+    Section.clear();
+    writeU32(Section, static_cast<uint32_t>(Datas.size()));
+    for (const auto &Data : Datas) {
+      // Active segment of the memory 0 at the constant offset.
+      Section.push_back(0x00);
+      Section.push_back(0x41);
+      writeS64(Section, static_cast<int32_t>(Data.Offset));
+      Section.push_back(0x0B);
+      writeU32(Section, static_cast<uint32_t>(Data.Bytes.size()));
+      Section.insert(Section.end(), Data.Bytes.begin(), Data.Bytes.end());
+    }
+    writeSection(Out, 0x0B, Section);
+  }
+  return Out;
+}
+
+std::vector<std::pair<Mode, std::string_view>> getModes() {
+  std::vector<std::pair<Mode, std::string_view>> Modes = {
+      {Mode::Interpreter, "Interpreter"}};
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  Modes.emplace_back(Mode::AOT, "AOT");
+#endif
+  return Modes;
+}
+
+Configure createConf(bool IsWasi) {
+  Configure Conf;
+  if (IsWasi) {
+    Conf.addHostRegistration(HostRegistration::Wasi);
+  }
+  return Conf;
+}
+
+Expect<void> instantiate(VM::VM &VM, [[maybe_unused]] const Configure &Conf,
+                         Span<const Byte> Wasm, Mode M) {
+  if (M == Mode::Interpreter) {
+    if (auto Res = VM.loadWasm(Wasm); !Res) {
+      return Unexpect(Res);
+    }
+  } else {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+    Loader::Loader Load(Conf, &Executor::Executor::Intrinsics);
+    Validator::Validator Valid(Conf);
+    AOT::Compiler Compiler(Conf);
+    std::unique_ptr<AST::Module> Mod;
+    if (auto Res = Load.parseModule(Wasm)) {
+      Mod = std::move(*Res);
+    } else {
+      return Unexpect(Res);
+    }
+    if (auto Res = Valid.validate(*Mod); !Res) {
+      return Unexpect(Res);
+    }
+    if (auto Res = Compiler.compile(Wasm, *Mod); !Res) {
+      return Unexpect(Res);
+    }
+    if (auto Res = Load.loadAOTSection(*Mod); !Res) {
+      return Unexpect(Res);
+    }
+    if (auto Res = VM.loadWasm(std::shared_ptr<const AST::Module>(
+            std::move(Mod)));
+        !Res) {
+      return Unexpect(Res);
+    }
+#else
+    return Unexpect(ErrCode::Value::AOTDisabled);
+#endif
+  }
+  if (auto Res = VM.validate(); !Res) {
+    return Unexpect(Res);
+  }
+  return VM.instantiate();
+}
+
+void runLoop(benchmark::State &State, VM::VM &VM, std::string_view Func,
+             const std::vector<uint32_t> &Args) {
+  std::vector<ValVariant> Params;
+  std::vector<ValType> ParamTypes;
+  for (const auto Arg : Args) {
+    Params.emplace_back(Arg);
+    ParamTypes.push_back(ValType::I32);
+  }
+  for (auto _ : State) {
+    auto Res = VM.execute(Func, Params, ParamTypes);
+    if (unlikely(!Res && Res.error() != ErrCode::Value::Terminated)) {
+      State.SkipWithError("execution failed");
+      break;
+    }
+    benchmark::DoNotOptimize(Res);
+  }
+}
+
+} // namespace Benchmark
+} // namespace WasmEdge
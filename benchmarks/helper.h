@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/benchmarks/helper.h - Benchmark helpers ------------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the helpers of the benchmarks, which assemble the wasm
+/// modules to run and run them in the interpreter or as AOT compiled code.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/configure.h"
+#include "common/errcode.h"
+#include "common/filesystem.h"
+#include "common/span.h"
+#include "common/types.h"
+#include "vm/vm.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+namespace Benchmark {
+
+/// Encoder of the instructions of a function body.
+class Code {
+public:
+  /// Append an opcode byte, or a prefixed opcode.
+  Code &op(uint8_t OpCode) {
+    Bytes.push_back(OpCode);
+    return *this;
+  }
+  Code &op(uint8_t Prefix, uint32_t OpCode) {
+    Bytes.push_back(Prefix);
+    return u32(OpCode);
+  }
+
+  /// Append the immediates in LEB128 or in little endian.
+  Code &u32(uint32_t Value);
+  Code &s32(int32_t Value);
+  Code &s64(int64_t Value);
+  Code &f64(double Value);
+
+  Code &i32Const(int32_t Value) { return op(0x41).s32(Value); }
+  Code &i64Const(int64_t Value) { return op(0x42).s64(Value); }
+  Code &f64Const(double Value) { return op(0x44).f64(Value); }
+  Code &localGet(uint32_t Idx) { return op(0x20).u32(Idx); }
+  Code &localSet(uint32_t Idx) { return op(0x21).u32(Idx); }
+  Code &localTee(uint32_t Idx) { return op(0x22).u32(Idx); }
+  Code &globalGet(uint32_t Idx) { return op(0x23).u32(Idx); }
+  Code &globalSet(uint32_t Idx) { return op(0x24).u32(Idx); }
+  Code &call(uint32_t Idx) { return op(0x10).u32(Idx); }
+  Code &callIndirect(uint32_t TypeIdx) {
+    return op(0x11).u32(TypeIdx).u32(0);
+  }
+  /// Memory access with the alignment and the offset.
+  Code &memOp(uint8_t OpCode, uint32_t Align, uint32_t Offset = 0) {
+    return op(OpCode).u32(Align).u32(Offset);
+  }
+  /// Block, loop, and if without results.
+  Code &block() { return op(0x02).op(0x40); }
+  Code &loop() { return op(0x03).op(0x40); }
+  Code &end() { return op(0x0B); }
+  Code &br(uint32_t Depth) { return op(0x0C).u32(Depth); }
+  Code &brIf(uint32_t Depth) { return op(0x0D).u32(Depth); }
+
+  /// Append the body repeated while the i32 local Counter counts down to 0.
+  Code &countDown(uint32_t Counter, const Code &Body);
+  /// Append the body repeated for the i32 local Var from 0 to below the i32
+  /// local Limit.
+  Code &forLoop(uint32_t Var, uint32_t Limit, const Code &Body);
+
+  Code &append(const Code &Other) {
+    Bytes.insert(Bytes.end(), Other.Bytes.begin(), Other.Bytes.end());
+    return *this;
+  }
+
+  const std::vector<Byte> &getBytes() const noexcept { return Bytes; }
+
+private:
+  std::vector<Byte> Bytes;
+};
+
+/// Assembler of a wasm module. The imported functions must be added before
+/// the defined ones, so that the function indices are in order.
+class ModuleBuilder {
+public:
+  uint32_t addType(std::vector<ValType> Params, std::vector<ValType> Results);
+  uint32_t importFunc(std::string_view Module, std::string_view Name,
+                      uint32_t TypeIdx);
+  uint32_t addFunc(uint32_t TypeIdx,
+                   std::vector<std::pair<uint32_t, ValType>> Locals,
+                   const Code &Body);
+  uint32_t addGlobal(ValType Type, bool IsMutable, const Code &Init);
+  void exportFunc(std::string_view Name, uint32_t FuncIdx);
+  /// Define and export the memory "memory".
+  void setMemory(uint32_t MinPages);
+  /// Define the function table with the functions from index 0.
+  void setTable(std::vector<uint32_t> FuncIdxs);
+  void addData(uint32_t Offset, Span<const Byte> Data);
+
+  std::vector<Byte> build() const;
+
+private:
+  struct Import {
+    std::string Module;
+    std::string Name;
+    uint32_t TypeIdx;
+  };
+  struct Function {
+    uint32_t TypeIdx;
+    std::vector<Byte> Body;
+  };
+  struct Export {
+    std::string Name;
+    uint32_t FuncIdx;
+  };
+  struct DataSegment {
+    uint32_t Offset;
+    std::vector<Byte> Bytes;
+  };
+
+  std::vector<std::vector<Byte>> Types;
+  std::vector<Import> Imports;
+  std::vector<Function> Functions;
+  std::vector<std::vector<Byte>> Globals;
+  std::vector<Export> Exports;
+  uint32_t MemoryPages = 0;
+  std::vector<uint32_t> Table;
+  std::vector<DataSegment> Datas;
+};
+
+/// Execution mode of a benchmark.
+enum class Mode {
+  Interpreter,
+  AOT,
+};
+
+/// Get the execution modes of this build, which have the AOT mode only if the
+/// AOT runtime is built.
+std::vector<std::pair<Mode, std::string_view>> getModes();
+
+/// Create the configure of the VM, which registers the WASI module if needed.
+Configure createConf(bool IsWasi = false);
+
+/// Load, validate, and instantiate the module in the VM created with the
+/// configure. The AOT mode compiles the module in memory first.
+Expect<void> instantiate(VM::VM &VM, const Configure &Conf,
+                         Span<const Byte> Wasm, Mode M);
+
+/// Execute the function with the i32 arguments in the benchmark loop, and
+/// stop the benchmark with an error if the execution failed. The termination
+/// by proc_exit succeeds.
+void runLoop(benchmark::State &State, VM::VM &VM, std::string_view Func,
+             const std::vector<uint32_t> &Args = {});
+
+/// Register the benchmarks of running the WASI command in the wasm file, such
+/// as CoreMark or PolyBench compiled to wasm, in each execution mode.
+void registerKernelFile(const std::filesystem::path &Path);
+
+} // namespace Benchmark
+} // namespace WasmEdge
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/benchmarks/instantiateBench.cpp - Instantiate benchmarks -===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents the benchmarks of the latencies of loading, validating,
+/// and instantiating a module, and of acquiring an instance from the pool.
+///
+//===----------------------------------------------------------------------===//
+
+#include "helper.h"
+
+#include <string>
+
+namespace {
+
+using namespace std::literals;
+using namespace WasmEdge;
+using namespace WasmEdge::Benchmark;
+
+// A module with a memory, a table, globals, a data segment, and functions,
+// which all take part in the instantiation.
+std::vector<Byte> createModuleWasm() {
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType({ValType::I32}, {ValType::I32});
+  Builder.setMemory(1);
+  for (int32_t I = 0; I < 4; ++I) {
+    Builder.addGlobal(ValType::I32, true, Code().i32Const(I));
+  }
+  std::vector<uint32_t> Table;
+  for (int32_t I = 0; I < 64; ++I) {
+    Code C;
+    C.localGet(0).i32Const(I).op(0x6A).globalGet(0).op(0x6C);
+    const auto Func = Builder.addFunc(Type, {}, C);
+    Builder.exportFunc("f" + std::to_string(I), Func);
+    if (I < 16) {
+      Table.push_back(Func);
+    }
+  }
+  Builder.setTable(std::move(Table));
+  const std::vector<Byte> Data(4096, 0x2A);
+  Builder.addData(0, Data);
+  return Builder.build();
+}
+
+// Load, validate, and instantiate the binary in each iteration.
+void loadAndInstantiate(benchmark::State &State) {
+  const auto Conf = createConf();
+  const auto Wasm = createModuleWasm();
+  VM::VM VM(Conf);
+  for (auto _ : State) {
+    if (!instantiate(VM, Conf, Wasm, Mode::Interpreter)) {
+      State.SkipWithError("instantiation failed");
+      break;
+    }
+  }
+}
+BENCHMARK(loadAndInstantiate);
+
+// Instantiate the validated module again in each iteration.
+void instantiateOnly(benchmark::State &State, Mode M) {
+  const auto Conf = createConf();
+  VM::VM VM(Conf);
+  if (!instantiate(VM, Conf, createModuleWasm(), M)) {
+    State.SkipWithError("instantiation failed");
+    return;
+  }
+  for (auto _ : State) {
+    if (!VM.instantiate()) {
+      State.SkipWithError("instantiation failed");
+      break;
+    }
+  }
+}
+
+// Acquire an instance from the pool and release it in each iteration, which
+// resets the instance.
+void pooled(benchmark::State &State, Mode M) {
+  const auto Conf = createConf();
+  VM::VM VM(Conf);
+  if (!instantiate(VM, Conf, createModuleWasm(), M) ||
+      !VM.createInstancePool(1)) {
+    State.SkipWithError("instantiation failed");
+    return;
+  }
+  for (auto _ : State) {
+    auto Res = VM.acquireInstance();
+    if (!Res) {
+      State.SkipWithError("acquisition failed");
+      break;
+    }
+    VM.releaseInstance(std::move(*Res));
+  }
+}
+
+[[maybe_unused]] const bool Registered = []() {
+  for (const auto &[M, ModeName] : getModes()) {
+    const auto Suffix = "/"s + std::string(ModeName);
+    benchmark::RegisterBenchmark(("instantiate" + Suffix).c_str(),
+                                 instantiateOnly, M);
+    benchmark::RegisterBenchmark(("pooled" + Suffix).c_str(), pooled, M);
+  }
+  return true;
+}();
+
+} // namespace
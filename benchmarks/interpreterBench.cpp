@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/benchmarks/interpreterBench.cpp - Dispatch benchmarks ----===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents the benchmarks of the interpreter dispatch, which run a
+/// loop of the instructions of one class each.
+///
+//===----------------------------------------------------------------------===//
+
+#include "helper.h"
+
+namespace {
+
+using namespace WasmEdge;
+using namespace WasmEdge::Benchmark;
+
+// The loop counter is the local 0, and the locals 1, 2, and 3 are an i32, an
+// i64, and an f64.
+constexpr uint32_t kN = 0;
+constexpr uint32_t kI32 = 1;
+constexpr uint32_t kI64 = 2;
+constexpr uint32_t kF64 = 3;
+
+// acc = ((acc + n) * 3) ^ (acc >> 1)
+Code i32Arith() {
+  Code C;
+  C.localGet(kI32).localGet(kN).op(0x6A).i32Const(3).op(0x6C);
+  C.localGet(kI32).i32Const(1).op(0x76).op(0x73).localSet(kI32);
+  return C;
+}
+
+Code i64Arith() {
+  Code C;
+  C.localGet(kI64).localGet(kN).op(0xAD).op(0x7C).i64Const(3).op(0x7E);
+  C.localGet(kI64).i64Const(1).op(0x88).op(0x85).localSet(kI64);
+  return C;
+}
+
+// acc = sqrt(acc * 1.5 + n)
+Code f64Arith() {
+  Code C;
+  C.localGet(kF64).f64Const(1.5).op(0xA2).localGet(kN).op(0xB8).op(0xA0);
+  C.op(0x9F).localSet(kF64);
+  return C;
+}
+
+// The conversions between the integers and the floats.
+Code conversion() {
+  Code C;
+  C.localGet(kN).op(0xB7).op(0xAA).op(0xAC).op(0xA7);
+  C.localGet(kI32).op(0x6A).localSet(kI32);
+  return C;
+}
+
+// Load and store a word in the first KiB of the memory.
+Code memory() {
+  Code C;
+  C.localGet(kN).i32Const(1020).op(0x71).localTee(kI32);
+  C.localGet(kI32).memOp(0x28, 2).i32Const(1).op(0x6A).memOp(0x36, 2);
+  return C;
+}
+
+// A forward branch and an if-else.
+Code control() {
+  Code C;
+  C.block().localGet(kN).i32Const(1).op(0x71).brIf(0);
+  C.localGet(kI32).i32Const(1).op(0x6A).localSet(kI32).end();
+  C.localGet(kN).i32Const(2).op(0x71).op(0x04).op(0x7F);
+  C.i32Const(1).op(0x05).i32Const(2).end();
+  C.localGet(kI32).op(0x6A).localSet(kI32);
+  return C;
+}
+
+// The local accesses, select, and drop.
+Code parametric() {
+  Code C;
+  C.localGet(kN).localGet(kI32).localGet(kN).i32Const(1).op(0x71);
+  C.op(0x1B).localTee(kI32).op(0x1A);
+  return C;
+}
+
+Code global() {
+  Code C;
+  C.globalGet(0).i32Const(1).op(0x6A).globalSet(0);
+  return C;
+}
+
+void dispatch(benchmark::State &State, Code (*Body)()) {
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType({ValType::I32}, {ValType::I32});
+  Builder.setMemory(1);
+  Builder.addGlobal(ValType::I32, true, Code().i32Const(0));
+  Code C;
+  C.countDown(kN, Body()).localGet(kI32);
+  Builder.exportFunc(
+      "run", Builder.addFunc(Type,
+                             {{1, ValType::I32}, {1, ValType::I64},
+                              {1, ValType::F64}},
+                             C));
+
+  const auto Conf = createConf();
+  VM::VM VM(Conf);
+  if (!instantiate(VM, Conf, Builder.build(), Mode::Interpreter)) {
+    State.SkipWithError("instantiation failed");
+    return;
+  }
+  const auto N = static_cast<uint32_t>(State.range(0));
+  runLoop(State, VM, "run", {N});
+  State.SetItemsProcessed(State.iterations() * N);
+}
+
+BENCHMARK_CAPTURE(dispatch, i32Arith, i32Arith)->Arg(10000);
+BENCHMARK_CAPTURE(dispatch, i64Arith, i64Arith)->Arg(10000);
+BENCHMARK_CAPTURE(dispatch, f64Arith, f64Arith)->Arg(10000);
+BENCHMARK_CAPTURE(dispatch, conversion, conversion)->Arg(10000);
+BENCHMARK_CAPTURE(dispatch, memory, memory)->Arg(10000);
+BENCHMARK_CAPTURE(dispatch, control, control)->Arg(10000);
+BENCHMARK_CAPTURE(dispatch, parametric, parametric)->Arg(10000);
+BENCHMARK_CAPTURE(dispatch, global, global)->Arg(10000);
+
+} // namespace
@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/benchmarks/kernelBench.cpp - Kernel benchmarks -----------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents the benchmarks of the computing kernels, which compare
+/// the interpreter and the AOT compiled code. The kernels in wasm files given
+/// in the command line are registered as well.
+///
+//===----------------------------------------------------------------------===//
+
+#include "helper.h"
+
+#include "host/wasi/wasimodule.h"
+#include "loader/loader.h"
+
+#include <string>
+
+namespace {
+
+using namespace std::literals;
+using namespace WasmEdge;
+using namespace WasmEdge::Benchmark;
+
+// Recursive Fibonacci number, which is bound by the calls.
+std::vector<Byte> createFibWasm() {
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType({ValType::I32}, {ValType::I32});
+  // The function index is 0 without imports.
+  Code C;
+  // if (n < 2) n else fib(n - 1) + fib(n - 2)
+  C.localGet(0).i32Const(2).op(0x49).op(0x04).op(0x7F);
+  C.localGet(0).op(0x05);
+  C.localGet(0).i32Const(1).op(0x6B).call(0);
+  C.localGet(0).i32Const(2).op(0x6B).call(0).op(0x6A).end();
+  Builder.exportFunc("run", Builder.addFunc(Type, {}, C));
+  return Builder.build();
+}
+
+// Sieve of Eratosthenes counting the primes below n, which is bound by the
+// byte accesses of the memory.
+std::vector<Byte> createSieveWasm() {
+  constexpr uint32_t kN = 0, kI = 1, kJ = 2, kCount = 3;
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType({ValType::I32}, {ValType::I32});
+  Builder.setMemory(4);
+
+  // Mark the multiples of i from 2i.
+  Code Mark;
+  Mark.localGet(kI).localGet(kI).op(0x6A).localSet(kJ);
+  Mark.block().loop().localGet(kJ).localGet(kN).op(0x4F).brIf(1);
+  Mark.localGet(kJ).i32Const(1).memOp(0x3A, 0);
+  Mark.localGet(kJ).localGet(kI).op(0x6A).localSet(kJ).br(0).end().end();
+
+  // if (!composite[i]) { ++count; mark(i); }
+  Code Outer;
+  Outer.localGet(kI).memOp(0x2D, 0).op(0x45).op(0x04).op(0x40);
+  Outer.localGet(kCount).i32Const(1).op(0x6A).localSet(kCount);
+  Outer.append(Mark).end();
+
+  Code C;
+  // memory.fill(0, 0, n), and 0 and 1 are not primes.
+  C.i32Const(0).i32Const(0).localGet(kN).op(0xFC, 11).op(0x00);
+  C.i32Const(0).i32Const(1).memOp(0x3A, 0);
+  C.i32Const(1).i32Const(1).memOp(0x3A, 0);
+  C.forLoop(kI, kN, Outer).localGet(kCount);
+  Builder.exportFunc("run",
+                     Builder.addFunc(Type, {{3, ValType::I32}}, C));
+  return Builder.build();
+}
+
+// Matrix multiplication of n x n f64 matrices with n up to 64, which is bound
+// by the floating point arithmetic.
+std::vector<Byte> createGemmWasm() {
+  constexpr uint32_t kN = 0, kI = 1, kJ = 2, kK = 3, kAcc = 4;
+  constexpr uint32_t kMatrixSize = 64 * 64 * 8;
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType({ValType::I32}, {ValType::I32});
+  Builder.setMemory(2);
+
+  // acc += A[i * n + k] * B[k * n + j]
+  Code Inner;
+  Inner.localGet(kAcc);
+  Inner.localGet(kI).localGet(kN).op(0x6C).localGet(kK).op(0x6A);
+  Inner.i32Const(3).op(0x74).memOp(0x2B, 3);
+  Inner.localGet(kK).localGet(kN).op(0x6C).localGet(kJ).op(0x6A);
+  Inner.i32Const(3).op(0x74).memOp(0x2B, 3, kMatrixSize);
+  Inner.op(0xA2).op(0xA0).localSet(kAcc);
+
+  // C[i * n + j] = acc
+  Code Column;
+  Column.f64Const(0.0).localSet(kAcc).forLoop(kK, kN, Inner);
+  Column.localGet(kI).localGet(kN).op(0x6C).localGet(kJ).op(0x6A);
+  Column.i32Const(3).op(0x74).localGet(kAcc);
+  Column.memOp(0x39, 3, 2 * kMatrixSize);
+
+  Code C;
+  C.forLoop(kI, kN, Code().forLoop(kJ, kN, Column)).i32Const(0);
+  Builder.exportFunc(
+      "run",
+      Builder.addFunc(Type, {{3, ValType::I32}, {1, ValType::F64}}, C));
+  return Builder.build();
+}
+
+void kernel(benchmark::State &State, std::vector<Byte> (*Create)(), Mode M) {
+  const auto Conf = createConf();
+  VM::VM VM(Conf);
+  if (!instantiate(VM, Conf, Create(), M)) {
+    State.SkipWithError("instantiation failed");
+    return;
+  }
+  runLoop(State, VM, "run", {static_cast<uint32_t>(State.range(0))});
+}
+
+// Run the WASI command, which is instantiated again before each execution.
+void kernelFile(benchmark::State &State, const std::filesystem::path &Path,
+                Mode M) {
+  const auto Conf = createConf(true);
+  VM::VM VM(Conf);
+  std::vector<Byte> Wasm;
+  if (auto Res = Loader::Loader::loadFile(Path)) {
+    Wasm = std::move(*Res);
+  } else {
+    State.SkipWithError("file loading failed");
+    return;
+  }
+  auto *WasiMod = dynamic_cast<Host::WasiModule *>(
+      VM.getImportModule(HostRegistration::Wasi));
+  WasiMod->getEnv().init({}, Path.filename().u8string(), {}, {});
+  if (!instantiate(VM, Conf, Wasm, M)) {
+    State.SkipWithError("instantiation failed");
+    return;
+  }
+  for (auto _ : State) {
+    State.PauseTiming();
+    const bool Instantiated = static_cast<bool>(VM.instantiate());
+    State.ResumeTiming();
+    if (!Instantiated) {
+      State.SkipWithError("instantiation failed");
+      break;
+    }
+    auto Res = VM.execute("_start");
+    if (!Res && Res.error() != ErrCode::Value::Terminated) {
+      State.SkipWithError("execution failed");
+      break;
+    }
+  }
+}
+
+[[maybe_unused]] const bool Registered = []() {
+  for (const auto &[M, ModeName] : getModes()) {
+    const auto Suffix = "/"s + std::string(ModeName);
+    benchmark::RegisterBenchmark(("kernel/fib" + Suffix).c_str(), kernel,
+                                 createFibWasm, M)
+        ->Arg(24);
+    benchmark::RegisterBenchmark(("kernel/sieve" + Suffix).c_str(), kernel,
+                                 createSieveWasm, M)
+        ->Arg(1 << 18);
+    benchmark::RegisterBenchmark(("kernel/gemm" + Suffix).c_str(), kernel,
+                                 createGemmWasm, M)
+        ->Arg(64);
+  }
+  return true;
+}();
+
+} // namespace
+
+namespace WasmEdge {
+namespace Benchmark {
+
+void registerKernelFile(const std::filesystem::path &Path) {
+  for (const auto &[M, ModeName] : getModes()) {
+    const auto Name = "kernel/"s + Path.filename().u8string() + "/" +
+                      std::string(ModeName);
+    benchmark::RegisterBenchmark(Name.c_str(), kernelFile, Path, M)
+        ->Unit(benchmark::kMillisecond);
+  }
+}
+
+} // namespace Benchmark
+} // namespace WasmEdge
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/benchmarks/main.cpp - Benchmark entry point --------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents the entry point of the benchmarks. Usage:
+///
+///   wasmedgeBenchmarks [benchmark options] [kernel.wasm ...]
+///
+/// The WASI commands in the wasm files, such as CoreMark or PolyBench
+/// compiled to wasm, are registered as the "kernel/<file>/<mode>" benchmarks.
+/// Use `--benchmark_out=<file> --benchmark_out_format=json` to write the
+/// results for the regression tracking.
+///
+//===----------------------------------------------------------------------===//
+
+#include "helper.h"
+
+int main(int Argc, char *Argv[]) {
+  benchmark::Initialize(&Argc, Argv);
+  // The benchmark options are removed, and the rest are the kernel files.
+  for (int I = 1; I < Argc; ++I) {
+    WasmEdge::Benchmark::registerKernelFile(Argv[I]);
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
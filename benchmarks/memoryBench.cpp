@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/benchmarks/memoryBench.cpp - Memory benchmarks -----------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents the benchmarks of the throughputs of memory.fill and
+/// memory.copy with the sizes from a cache line to a MiB.
+///
+//===----------------------------------------------------------------------===//
+
+#include "helper.h"
+
+#include <string>
+
+namespace {
+
+using namespace std::literals;
+using namespace WasmEdge;
+using namespace WasmEdge::Benchmark;
+
+// The copies are from the first MiB to the second one.
+constexpr uint32_t kMiB = UINT32_C(1) << 20;
+// Bytes filled or copied in one execution.
+constexpr uint32_t kBytesPerRun = UINT32_C(4) << 20;
+
+std::vector<Byte> createMemoryWasm() {
+  ModuleBuilder Builder;
+  const auto Type =
+      Builder.addType({ValType::I32, ValType::I32}, {ValType::I32});
+  Builder.setMemory(2 * kMiB / 65536);
+
+  // memory.fill(0, 7, size)
+  Code Fill;
+  Fill.i32Const(0).i32Const(7).localGet(1).op(0xFC, 11).op(0x00);
+  Builder.exportFunc(
+      "fill", Builder.addFunc(Type, {}, Code().countDown(0, Fill).i32Const(0)));
+
+  // memory.copy(1 MiB, 0, size)
+  Code Copy;
+  Copy.i32Const(static_cast<int32_t>(kMiB)).i32Const(0).localGet(1);
+  Copy.op(0xFC, 10).op(0x00).op(0x00);
+  Builder.exportFunc(
+      "copy", Builder.addFunc(Type, {}, Code().countDown(0, Copy).i32Const(0)));
+  return Builder.build();
+}
+
+void bulkMemory(benchmark::State &State, std::string_view Func, Mode M) {
+  const auto Conf = createConf();
+  VM::VM VM(Conf);
+  if (!instantiate(VM, Conf, createMemoryWasm(), M)) {
+    State.SkipWithError("instantiation failed");
+    return;
+  }
+  const auto Size = static_cast<uint32_t>(State.range(0));
+  const uint32_t N = kBytesPerRun / Size;
+  runLoop(State, VM, Func, {N, Size});
+  State.SetBytesProcessed(State.iterations() * N * Size);
+}
+
+[[maybe_unused]] const bool Registered = []() {
+  for (const auto &[M, ModeName] : getModes()) {
+    for (const auto Func : {"fill"sv, "copy"sv}) {
+      const auto Name =
+          "bulkMemory/"s + std::string(Func) + "/" + std::string(ModeName);
+      benchmark::RegisterBenchmark(Name.c_str(), bulkMemory, Func, M)
+          ->RangeMultiplier(16)
+          ->Range(64, kMiB);
+    }
+  }
+  return true;
+}();
+
+} // namespace
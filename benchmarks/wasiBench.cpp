@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/benchmarks/wasiBench.cpp - WASI benchmarks ---------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents the benchmarks of the WASI fd_read and poll_oneoff
+/// calls from the wasm code.
+///
+//===----------------------------------------------------------------------===//
+
+#include "helper.h"
+
+#include "host/wasi/wasimodule.h"
+
+#include <fstream>
+#include <string>
+
+namespace {
+
+using namespace std::literals;
+using namespace WasmEdge;
+using namespace WasmEdge::Benchmark;
+
+// The memory layout of the arguments and the results of the WASI calls.
+constexpr int32_t kPath = 0;
+constexpr int32_t kFd = 64;
+constexpr int32_t kIovec = 80;
+constexpr int32_t kResult = 96;
+constexpr int32_t kSubscription = 256;
+constexpr int32_t kEvent = 320;
+constexpr int32_t kBuffer = 1024;
+constexpr uint32_t kFileSize = 16384;
+constexpr std::string_view kFileName = "bench.dat"sv;
+
+std::vector<Byte> createWasiWasm() {
+  ModuleBuilder Builder;
+  const auto I32 = ValType::I32, I64 = ValType::I64;
+  const auto PathOpen = Builder.importFunc(
+      "wasi_snapshot_preview1", "path_open",
+      Builder.addType({I32, I32, I32, I32, I32, I64, I64, I32, I32}, {I32}));
+  const auto FdRead =
+      Builder.importFunc("wasi_snapshot_preview1", "fd_read",
+                         Builder.addType({I32, I32, I32, I32}, {I32}));
+  const auto FdSeek =
+      Builder.importFunc("wasi_snapshot_preview1", "fd_seek",
+                         Builder.addType({I32, I64, I32, I32}, {I32}));
+  const auto PollOneoff =
+      Builder.importFunc("wasi_snapshot_preview1", "poll_oneoff",
+                         Builder.addType({I32, I32, I32, I32}, {I32}));
+  Builder.setMemory(1);
+
+  // path_open(3, 0, path, len, 0, fd_read | fd_seek, 0, 0, fd), which opens
+  // the file in the first preopened directory.
+  Code Open;
+  Open.i32Const(3).i32Const(0).i32Const(kPath);
+  Open.i32Const(static_cast<int32_t>(kFileName.size())).i32Const(0);
+  Open.i64Const(6).i64Const(0).i32Const(0).i32Const(kFd).call(PathOpen);
+  Builder.exportFunc("open",
+                     Builder.addFunc(Builder.addType({}, {I32}), {}, Open));
+  const std::vector<Byte> Path(kFileName.begin(), kFileName.end());
+  Builder.addData(kPath, Path);
+
+  // fd_read(fd, iovec, 1, nread) and fd_seek(fd, 0, SET, offset)
+  const auto Type = Builder.addType({I32, I32}, {I32});
+  Code Read;
+  Read.i32Const(kFd).memOp(0x28, 2).i32Const(kIovec).i32Const(1);
+  Read.i32Const(kResult).call(FdRead).op(0x1A);
+  Read.i32Const(kFd).memOp(0x28, 2).i64Const(0).i32Const(0);
+  Read.i32Const(kResult).call(FdSeek).op(0x1A);
+  Code ReadLoop;
+  ReadLoop.i32Const(kIovec).i32Const(kBuffer).memOp(0x36, 2);
+  ReadLoop.i32Const(kIovec).localGet(1).memOp(0x36, 2, 4);
+  ReadLoop.countDown(0, Read).i32Const(0);
+  Builder.exportFunc("read", Builder.addFunc(Type, {}, ReadLoop));
+
+  // poll_oneoff(subscription, event, 1, nevents) with a monotonic clock
+  // subscription of 1 ns timeout, because a zero timeout disarms the timer.
+  Code Poll;
+  Poll.i32Const(kSubscription).i32Const(kEvent).i32Const(1);
+  Poll.i32Const(kResult).call(PollOneoff).op(0x1A);
+  Builder.exportFunc(
+      "poll", Builder.addFunc(Type, {}, Code().countDown(0, Poll).i32Const(0)));
+  std::vector<Byte> Subscription(48, 0);
+  Subscription[16] = 1;
+  Subscription[24] = 1;
+  Builder.addData(kSubscription, Subscription);
+  return Builder.build();
+}
+
+// Create the file to read in the temporary directory, and return the
+// directory.
+std::filesystem::path createBenchDir() {
+  const auto Dir = std::filesystem::temp_directory_path() / "wasmedge-bench";
+  std::filesystem::create_directories(Dir);
+  std::ofstream File(Dir / kFileName, std::ios::binary | std::ios::trunc);
+  const std::string Content(kFileSize, 'x');
+  File.write(Content.data(), static_cast<std::streamsize>(Content.size()));
+  return Dir;
+}
+
+// Instantiate the module with the directory preopened, and open the file.
+bool setup(VM::VM &VM, const Configure &Conf, Mode M) {
+  auto *WasiMod = dynamic_cast<Host::WasiModule *>(
+      VM.getImportModule(HostRegistration::Wasi));
+  const std::vector<std::string> Dirs = {"/:"s +
+                                         createBenchDir().u8string()};
+  WasiMod->getEnv().init(Dirs, "wasmedgeBenchmarks"s, {}, {});
+  if (!instantiate(VM, Conf, createWasiWasm(), M)) {
+    return false;
+  }
+  auto Res = VM.execute("open");
+  return Res && !Res->empty() && (*Res)[0].first.get<uint32_t>() == 0;
+}
+
+void fdRead(benchmark::State &State, Mode M) {
+  const auto Conf = createConf(true);
+  VM::VM VM(Conf);
+  if (!setup(VM, Conf, M)) {
+    State.SkipWithError("instantiation failed");
+    return;
+  }
+  const auto Size = static_cast<uint32_t>(State.range(0));
+  runLoop(State, VM, "read", {100, Size});
+  State.SetItemsProcessed(State.iterations() * 100);
+  State.SetBytesProcessed(State.iterations() * 100 * Size);
+}
+
+void pollOneoff(benchmark::State &State, Mode M) {
+  const auto Conf = createConf(true);
+  VM::VM VM(Conf);
+  if (!setup(VM, Conf, M)) {
+    State.SkipWithError("instantiation failed");
+    return;
+  }
+  runLoop(State, VM, "poll", {100, 0});
+  State.SetItemsProcessed(State.iterations() * 100);
+}
+
+[[maybe_unused]] const bool Registered = []() {
+  for (const auto &[M, ModeName] : getModes()) {
+    const auto Suffix = "/"s + std::string(ModeName);
+    benchmark::RegisterBenchmark(("wasi/fd_read" + Suffix).c_str(), fdRead, M)
+        ->RangeMultiplier(16)
+        ->Range(64, kFileSize);
+    benchmark::RegisterBenchmark(("wasi/poll_oneoff" + Suffix).c_str(),
+                                 pollOneoff, M);
+  }
+  return true;
+}();
+
+} // namespace
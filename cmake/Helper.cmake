@@ -136,7 +136,8 @@ if((WASMEDGE_LINK_LLVM_STATIC OR WASMEDGE_BUILD_STATIC_LIB) AND WASMEDGE_BUILD_A
   find_package(LLVM REQUIRED HINTS "${LLVM_CMAKE_PATH}")
   execute_process(
     COMMAND ${LLVM_BINARY_DIR}/bin/llvm-config --libs --link-static
-    core lto native nativecodegen option passes support transformutils all-targets
+    core lto native nativecodegen option passes runtimedyld support
+    transformutils all-targets
     OUTPUT_VARIABLE WASMEDGE_LLVM_LINK_LIBS_NAME
   )
   string(REPLACE "-l" "" WASMEDGE_LLVM_LINK_LIBS_NAME ${WASMEDGE_LLVM_LINK_LIBS_NAME})
@@ -32,6 +32,10 @@ public:
   };
   static Expect<std::filesystem::path>
   getPath(Span<const Byte> Data, StorageScope Scope, std::string_view Key = {});
+  /// Get the path of the cached module under the given cache root.
+  static std::filesystem::path getPath(Span<const Byte> Data,
+                                       const std::filesystem::path &Root,
+                                       std::string_view Key = {});
   static void clear(StorageScope Scope, std::string_view Key = {});
 };
 
@@ -17,38 +17,107 @@
 #include "common/configure.h"
 #include "common/errcode.h"
 #include "common/filesystem.h"
+#include "common/pgo.h"
 #include "common/span.h"
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <mutex>
+#include <string>
+#include <utility>
 
 namespace WasmEdge {
 namespace AOT {
 
 /// Compiling Module into loadable executable binary.
+///
+/// The compiler keeps no state of a compilation in itself, so one compiler can
+/// compile many modules concurrently from different threads.
 class Compiler {
 public:
-  Compiler(const Configure &Conf) noexcept : Context(nullptr), Conf(Conf) {}
+  /// Callback of the compilation progress, with the numbers of the finished
+  /// steps and of all the steps. The steps are the translation of each
+  /// function, and the optimization and the code generation, for each target
+  /// CPU, followed by the output. In the incremental compilation, the last two
+  /// are replaced by the compilation of the rest of the module and then of
+  /// each function.
+  using ProgressCallback = std::function<void(uint64_t Done, uint64_t Total)>;
+
+  Compiler(const Configure &Conf) noexcept : Conf(Conf) {}
+
+  /// Set the execution profile of the module to compile with, which gives the
+  /// function entry counts and the branch weights to the optimization passes.
+  /// The profile must outlive the compilation. Passing nullptr resets it.
+  void setProfile(const PGO::Profile *P) noexcept {
+    std::unique_lock Lock(Mutex);
+    Profile = P;
+  }
+
+  Expect<void> compile(Span<const Byte> Data, const AST::Module &Module,
+                       std::filesystem::path OutputPath) {
+    return compile(Data, Module, std::move(OutputPath), {}, nullptr);
+  }
 
+  /// Compile with reporting the progress. The compilation stops with
+  /// ErrCode::Value::Cancelled at the next step after \p Cancel becomes true.
   Expect<void> compile(Span<const Byte> Data, const AST::Module &Module,
-                       std::filesystem::path OutputPath);
+                       std::filesystem::path OutputPath,
+                       const ProgressCallback &Progress,
+                       const std::atomic<bool> *Cancel);
+
+  /// Compile the module for the host CPU into its AOT section in memory,
+  /// without writing any file or running the linker. The code is then loaded
+  /// by Loader::loadAOTSection().
+  Expect<void> compile(Span<const Byte> Data, AST::Module &Module,
+                       const ProgressCallback &Progress = {},
+                       const std::atomic<bool> *Cancel = nullptr);
+
+  /// Get the key of the code compiled in memory for the host CPU, which is a
+  /// digest of everything the code depends on besides the wasm binary: the
+  /// versions, the target, the configuration, and the profile.
+  std::string getCacheKey();
+
+  /// Write the AOT section compiled in memory with the binary \p Data into
+  /// a universal wasm file. The file is renamed into place, so that the
+  /// concurrent readers never load a partial one.
+  static Expect<void> output(Span<const Byte> Data,
+                             const AST::AOTSection &AOTSection,
+                             const std::filesystem::path &OutputPath);
 
   struct CompileContext;
 
 private:
-  void compile(const AST::ImportSection &ImportSection);
-  void compile(const AST::ExportSection &ExportSection);
-  void compile(const AST::TypeSection &TypeSection);
-  void compile(const AST::GlobalSection &GlobalSection);
-  void compile(const AST::MemorySection &MemorySection,
+  struct TargetCPU;
+  struct Session;
+
+  /// Compile the module into the object file of the target CPU.
+  Expect<void> compile(Span<const Byte> Data, const AST::Module &Module,
+                       const std::filesystem::path &LLPath, TargetCPU &Target,
+                       Session &S);
+  /// Compile each function into its own object, reusing the cached objects
+  /// of the unchanged functions.
+  Expect<void> compileIncremental(CompileContext &Context, TargetCPU &Target,
+                                  Session &S);
+  void compile(CompileContext &Context,
+               const AST::ImportSection &ImportSection);
+  void compile(CompileContext &Context,
+               const AST::ExportSection &ExportSection);
+  void compile(CompileContext &Context, const AST::TypeSection &TypeSection);
+  void compile(CompileContext &Context,
+               const AST::GlobalSection &GlobalSection);
+  void compile(CompileContext &Context,
+               const AST::MemorySection &MemorySection,
                const AST::DataSection &DataSection);
-  void compile(const AST::TableSection &TableSection,
+  void compile(CompileContext &Context, const AST::TableSection &TableSection,
                const AST::ElementSection &ElementSection);
-  void compile(const AST::FunctionSection &FunctionSection,
-               const AST::CodeSection &CodeSection);
+  Expect<void> compile(CompileContext &Context, Session &S,
+                       const AST::FunctionSection &FunctionSection,
+                       const AST::CodeSection &CodeSection);
 
   std::mutex Mutex;
-  CompileContext *Context;
   const Configure Conf;
+  const PGO::Profile *Profile = nullptr;
 };
 
 } // namespace AOT
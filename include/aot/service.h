@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/aot/service.h - Compiler service definition --------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file is the definition class of the compiler service, which compiles
+/// many wasm modules concurrently on a fixed worker pool.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "aot/compiler.h"
+#include "common/configure.h"
+#include "common/errcode.h"
+#include "common/filesystem.h"
+#include "common/types.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+namespace AOT {
+
+/// Service of compiling wasm binaries.
+///
+/// Each submitted wasm binary becomes a job, which a worker loads, validates,
+/// and compiles into the output path. All the workers share one compiler. The
+/// queue of the jobs waiting for a worker is bounded, and submitting blocks
+/// while it is full.
+class CompilerService {
+public:
+  struct Options {
+    /// Number of worker threads.
+    uint32_t Workers = 1;
+    /// Maximum number of jobs waiting for a worker.
+    uint32_t QueueSize = 16;
+  };
+
+  class Job {
+  public:
+    /// Block until the job finished, and get the result.
+    Expect<void> wait() const;
+
+    /// Block until the job finished or the timeout. Return true if finished.
+    bool waitFor(std::chrono::nanoseconds Timeout) const;
+
+    /// Check whether the job finished.
+    bool isFinished() const noexcept;
+
+    /// Cancel the job. A waiting job is dropped, and a running one stops at
+    /// its next step. Both finish with ErrCode::Value::Cancelled.
+    void cancel() noexcept { Cancelled.store(true, std::memory_order_relaxed); }
+
+    /// Getter of the numbers of the finished steps and of all the steps. All
+    /// the steps are 0 before the compilation starts.
+    std::pair<uint64_t, uint64_t> getProgress() const noexcept {
+      return {Done.load(std::memory_order_relaxed),
+              Total.load(std::memory_order_relaxed)};
+    }
+
+  private:
+    friend class CompilerService;
+
+    Job(std::vector<Byte> Data, std::filesystem::path OutputPath,
+        Compiler::ProgressCallback Progress) noexcept
+        : Data(std::move(Data)), OutputPath(std::move(OutputPath)),
+          Progress(std::move(Progress)) {}
+
+    void finish(ErrCode Code) noexcept;
+
+    std::vector<Byte> Data;
+    const std::filesystem::path OutputPath;
+    const Compiler::ProgressCallback Progress;
+    std::atomic<bool> Cancelled{false};
+    std::atomic<uint64_t> Done{0};
+    std::atomic<uint64_t> Total{0};
+
+    mutable std::mutex Mutex;
+    mutable std::condition_variable Cond;
+    bool Finished = false;
+    ErrCode Result;
+  };
+
+  CompilerService(const Configure &Conf) : CompilerService(Conf, Options{}) {}
+  CompilerService(const Configure &Conf, const Options &Opts);
+  /// Cancel the waiting jobs, and wait for the running ones.
+  ~CompilerService() noexcept;
+
+  /// Set the execution profile to compile the following jobs with. The
+  /// profile must outlive the jobs.
+  void setProfile(const PGO::Profile *P) noexcept { Comp.setProfile(P); }
+
+  /// Submit a wasm binary to compile into the output path. The progress
+  /// callback is called from the worker after each step.
+  Expect<std::shared_ptr<Job>>
+  submit(std::vector<Byte> Data, std::filesystem::path OutputPath,
+         Compiler::ProgressCallback Progress = {});
+
+private:
+  void runWorker();
+  Expect<void> run(Job &J);
+
+  const Configure Conf;
+  const Options Opts;
+  Compiler Comp;
+
+  std::mutex Mutex;
+  std::condition_variable NotEmpty;
+  std::condition_variable NotFull;
+  bool Stopped = false;
+  std::deque<std::shared_ptr<Job>> Queue;
+  std::vector<std::thread> Workers;
+};
+
+} // namespace AOT
+} // namespace WasmEdge
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/aot/tiered.h - Tiered compiler definition ----------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file is the definition class of the tiered compiler, which compiles a
+/// wasm module quickly for starting the execution, and then upgrades it to the
+/// optimized code compiled in the background.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "aot/compiler.h"
+#include "ast/module.h"
+#include "common/configure.h"
+#include "common/errcode.h"
+#include "common/filesystem.h"
+#include "common/span.h"
+#include "common/types.h"
+#include "loader/loader.h"
+#include "runtime/instance/module.h"
+#include "validator/validator.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace WasmEdge {
+namespace AOT {
+
+/// Tiered compiler of a wasm binary.
+///
+/// The baseline tier is compiled at O0 with the fast instruction selection,
+/// and is returned for starting the execution. The optimized tier is compiled
+/// at the configured optimization level, or O3 if it is O0, in a background
+/// thread. When it is ready, every function of the attached module instances
+/// is upgraded to the optimized code, which takes effect at the following
+/// calls of the function. Both tiers are kept in the local cache, or under
+/// the given cache root, as universal wasm files keyed by the host and the
+/// configuration, and the optimized one is loaded directly if cached.
+///
+/// The attached module instances must outlive the tiered compiler, whose
+/// destructor cancels and waits for the background compilation.
+class TieredCompiler {
+public:
+  TieredCompiler(const Configure &Conf, const AST::Module::IntrinsicsTable *IT,
+                 std::filesystem::path CacheRoot = {}) noexcept;
+  ~TieredCompiler() noexcept;
+
+  /// Compile the wasm binary, and get the validated module with the loaded
+  /// code of the baseline tier, or of the optimized tier if cached. The
+  /// optimized tier is compiled in the background after that. A tiered
+  /// compiler compiles only one binary.
+  Expect<std::unique_ptr<AST::Module>> compile(Span<const Byte> Code);
+
+  /// Attach a module instance instantiated from the compiled module, whose
+  /// functions are upgraded when the optimized tier is ready.
+  void attach(const Runtime::Instance::ModuleInstance &ModInst);
+
+  /// Block until the optimized tier finished, and get the result.
+  Expect<void> wait() const;
+
+  /// Check whether the optimized tier is ready.
+  bool isOptimized() const noexcept;
+
+private:
+  /// Load the cached universal wasm file with the loaded code.
+  Expect<std::unique_ptr<AST::Module>>
+  loadCached(const std::filesystem::path &Path);
+  /// Compile the binary by the compiler into the module with the loaded code,
+  /// and write it into the cache.
+  Expect<std::unique_ptr<AST::Module>>
+  compileTier(Compiler &Comp, const std::filesystem::path &Path);
+  void runOptimized();
+  void upgrade(const Runtime::Instance::ModuleInstance &ModInst) const;
+
+  Configure BaselineConf;
+  Configure OptimizedConf;
+  Compiler BaselineCompiler;
+  Compiler OptimizedCompiler;
+  Loader::Loader Load;
+  Validator::Validator Valid;
+
+  std::filesystem::path CacheRoot;
+  std::vector<Byte> Data;
+  std::filesystem::path BaselinePath;
+  std::filesystem::path OptimizedPath;
+  std::atomic<bool> Cancel{false};
+  std::thread Worker;
+
+  mutable std::mutex Mutex;
+  mutable std::condition_variable Cond;
+  bool Finished = false;
+  ErrCode Result;
+  std::unique_ptr<AST::Module> OptimizedModule;
+  std::vector<const Runtime::Instance::ModuleInstance *> Instances;
+};
+
+} // namespace AOT
+} // namespace WasmEdge
@@ -18,7 +18,12 @@
 namespace WasmEdge {
 namespace AOT {
 
-static inline constexpr const uint32_t kBinaryVersion [[maybe_unused]] = 1;
+/// The version is bumped for every change of the AOT section layout or of the
+/// interface between the compiled code and the runtime, such as the
+/// intrinsics table, so the binaries of other versions cannot be run and the
+/// loader accepts only this exact version. A universal wasm file of another
+/// version still runs in the interpreter.
+static inline constexpr const uint32_t kBinaryVersion [[maybe_unused]] = 5;
 
 } // namespace AOT
 } // namespace WasmEdge
@@ -64,6 +64,7 @@ typedef struct WasmEdge_Result {
 #define WasmEdge_Result_Success ((WasmEdge_Result){.Code = 0x00})
 #define WasmEdge_Result_Terminate ((WasmEdge_Result){.Code = 0x01})
 #define WasmEdge_Result_Fail ((WasmEdge_Result){.Code = 0x02})
+#define WasmEdge_Result_Suspend ((WasmEdge_Result){.Code = 0x0A})
 
 /// Struct of WASM limit.
 typedef struct WasmEdge_Limit {
@@ -77,6 +78,26 @@ typedef struct WasmEdge_Limit {
   uint32_t Max;
 } WasmEdge_Limit;
 
+/// Struct of the statistics of a VM instance pool.
+typedef struct WasmEdge_InstancePoolStatistics {
+  /// Instances waiting in the pool.
+  uint32_t Idle;
+  /// Instances acquired and not released yet.
+  uint32_t InUse;
+  /// Acquisitions served from the pool.
+  uint64_t Hits;
+  /// Acquisitions which instantiated a new instance.
+  uint64_t Misses;
+  /// Released instances reset and returned to the pool.
+  uint64_t Resets;
+  /// Released instances destroyed instead of being reset.
+  uint64_t Discards;
+  /// Accumulated wall time of instantiations in nanoseconds.
+  uint64_t InstantiateNanos;
+  /// Accumulated wall time of resets in nanoseconds.
+  uint64_t ResetNanos;
+} WasmEdge_InstancePoolStatistics;
+
 /// Opaque struct of WasmEdge configure.
 typedef struct WasmEdge_ConfigureContext WasmEdge_ConfigureContext;
 
@@ -107,6 +128,9 @@ typedef struct WasmEdge_ExportTypeContext WasmEdge_ExportTypeContext;
 /// Opaque struct of WasmEdge AOT compiler.
 typedef struct WasmEdge_CompilerContext WasmEdge_CompilerContext;
 
+/// Opaque struct of WasmEdge AOT compiler asynchronous job.
+typedef struct WasmEdge_CompilerJobContext WasmEdge_CompilerJobContext;
+
 /// Opaque struct of WasmEdge loader.
 typedef struct WasmEdge_LoaderContext WasmEdge_LoaderContext;
 
@@ -116,6 +140,9 @@ typedef struct WasmEdge_ValidatorContext WasmEdge_ValidatorContext;
 /// Opaque struct of WasmEdge executor.
 typedef struct WasmEdge_ExecutorContext WasmEdge_ExecutorContext;
 
+/// Opaque struct of WasmEdge continuation.
+typedef struct WasmEdge_ContinuationContext WasmEdge_ContinuationContext;
+
 /// Opaque struct of WasmEdge store.
 typedef struct WasmEdge_StoreContext WasmEdge_StoreContext;
 
@@ -755,6 +782,57 @@ WasmEdge_ConfigureCompilerSetInterruptible(WasmEdge_ConfigureContext *Cxt,
 WASMEDGE_CAPI_EXPORT extern bool
 WasmEdge_ConfigureCompilerIsInterruptible(const WasmEdge_ConfigureContext *Cxt);
 
+/// Set the incremental compilation option of AOT compiler.
+///
+/// In the incremental compilation, each function is compiled into its own
+/// object and cached in the AOT cache directory, so that compiling a rebuilt
+/// module only compiles the changed functions.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsIncremental the boolean value to determine to compile
+/// incrementally or not in AOT compiler.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureCompilerSetIncremental(WasmEdge_ConfigureContext *Cxt,
+                                         const bool IsIncremental);
+
+/// Get the incremental compilation option of AOT compiler.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to compile incrementally or not in
+/// AOT compiler.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureCompilerIsIncremental(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the wasm-level optimization option.
+///
+/// With the wasm-level optimization, the functions are optimized after
+/// validation for both the interpreter and the AOT compiler. The instruction
+/// counts and the costs of the executions differ from the original module.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsWasmOptimization the boolean value to determine to optimize the
+/// functions at the wasm level or not.
+WASMEDGE_CAPI_EXPORT extern void WasmEdge_ConfigureCompilerSetWasmOptimization(
+    WasmEdge_ConfigureContext *Cxt, const bool IsWasmOptimization);
+
+/// Get the wasm-level optimization option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to optimize the functions at the
+/// wasm level or not.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureCompilerIsWasmOptimization(
+    const WasmEdge_ConfigureContext *Cxt);
+
 /// Set the instruction counting option.
 ///
 /// This function is thread-safe.
@@ -1398,15 +1476,150 @@ WASMEDGE_CAPI_EXPORT extern WasmEdge_Result WasmEdge_CompilerCompileFromBuffer(
     WasmEdge_CompilerContext *Cxt, const uint8_t *InBuffer,
     const uint64_t InBufferLen, const char *OutPath);
 
+/// Compile the input WASM from the given buffer into memory.
+///
+/// The compiler compiles the WASM from the given buffer for the host CPU, and
+/// loads the compiled code into the output AST module without writing any
+/// file. The AST module runs in the ahead-of-time mode when instantiated.
+///
+/// The caller owns the object and should call `WasmEdge_ASTModuleDelete` to
+/// destroy it.
+///
+/// \param Cxt the WasmEdge_CompilerContext.
+/// \param [out] Module the output WasmEdge_ASTModuleContext if succeeded.
+/// \param InBuffer the input WASM binary buffer.
+/// \param InBufferLen the length of the input WASM binary buffer.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_CompilerCompileFromBufferToASTModule(
+    WasmEdge_CompilerContext *Cxt, WasmEdge_ASTModuleContext **Module,
+    const uint8_t *InBuffer, const uint64_t InBufferLen);
+
+/// Callback of the progress of an asynchronous compilation.
+///
+/// The callback is called from the worker thread after each step of the
+/// compilation, with the numbers of the finished steps and of all the steps.
+typedef void (*WasmEdge_CompilerProgress_t)(void *Data, uint64_t Done,
+                                            uint64_t Total);
+
+/// Set the concurrency of the asynchronous compilations.
+///
+/// The asynchronous compilations run on a pool of worker threads, created at
+/// the first asynchronous compilation. This function only takes effect before
+/// that. By default, the pool has one worker per hardware thread and the queue
+/// holds 4 waiting jobs per worker.
+///
+/// \param Cxt the WasmEdge_CompilerContext.
+/// \param Workers the number of worker threads.
+/// \param QueueSize the maximum number of jobs waiting for a worker. The
+/// asynchronous compilation functions block while the queue is full.
+///
+/// \returns true if set, false if the pool has been created.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_CompilerSetConcurrency(WasmEdge_CompilerContext *Cxt,
+                                const uint32_t Workers,
+                                const uint32_t QueueSize);
+
+/// Compile the input WASM from the file path asynchronously.
+///
+/// The input file is read before returning, and the compilation runs on the
+/// worker pool of the compiler. Many compilations can run concurrently with
+/// one compiler context.
+///
+/// The caller owns the object and should call `WasmEdge_CompilerJobDelete` to
+/// delete it.
+///
+/// \param Cxt the WasmEdge_CompilerContext.
+/// \param InPath the input WASM file path.
+/// \param OutPath the output WASM file path.
+/// \param Progress the progress callback. NULL if not needed.
+/// \param Data the additional data passed to the progress callback.
+///
+/// \returns pointer to the job context, NULL if failed.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_CompilerJobContext *
+WasmEdge_CompilerCompileAsync(WasmEdge_CompilerContext *Cxt,
+                              const char *InPath, const char *OutPath,
+                              WasmEdge_CompilerProgress_t Progress,
+                              void *Data);
+
+/// Compile the input WASM from the given buffer asynchronously.
+///
+/// The buffer is copied before returning. See
+/// `WasmEdge_CompilerCompileAsync` for the details.
+///
+/// \param Cxt the WasmEdge_CompilerContext.
+/// \param InBuffer the input WASM binary buffer.
+/// \param InBufferLen the length of the input WASM binary buffer.
+/// \param OutPath the output WASM file path.
+/// \param Progress the progress callback. NULL if not needed.
+/// \param Data the additional data passed to the progress callback.
+///
+/// \returns pointer to the job context, NULL if failed.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_CompilerJobContext *
+WasmEdge_CompilerCompileFromBufferAsync(WasmEdge_CompilerContext *Cxt,
+                                        const uint8_t *InBuffer,
+                                        const uint64_t InBufferLen,
+                                        const char *OutPath,
+                                        WasmEdge_CompilerProgress_t Progress,
+                                        void *Data);
+
 /// Deletion of the WasmEdge_CompilerContext.
 ///
-/// After calling this function, the context will be destroyed and should
-/// __NOT__ be used.
+/// The waiting asynchronous jobs are cancelled, and the running ones are
+/// waited for. After calling this function, the context will be destroyed and
+/// should __NOT__ be used.
 ///
 /// \param Cxt the WasmEdge_CompilerContext to destroy.
 WASMEDGE_CAPI_EXPORT extern void
 WasmEdge_CompilerDelete(WasmEdge_CompilerContext *Cxt);
 
+/// Wait for an asynchronous compilation and get its result.
+///
+/// \param Cxt the WasmEdge_CompilerJobContext.
+///
+/// \returns WasmEdge_Result. `WasmEdge_ErrCode_Cancelled` if cancelled. Call
+/// `WasmEdge_ResultGetMessage` for the error message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_CompilerJobWait(const WasmEdge_CompilerJobContext *Cxt);
+
+/// Wait for an asynchronous compilation with timeout.
+///
+/// \param Cxt the WasmEdge_CompilerJobContext.
+/// \param Milliseconds the timeout in milliseconds.
+///
+/// \returns true if the compilation finished, false if timeout.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_CompilerJobWaitFor(const WasmEdge_CompilerJobContext *Cxt,
+                            uint64_t Milliseconds);
+
+/// Cancel an asynchronous compilation.
+///
+/// A waiting job is dropped, and a running one stops at its next step.
+///
+/// \param Cxt the WasmEdge_CompilerJobContext.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_CompilerJobCancel(WasmEdge_CompilerJobContext *Cxt);
+
+/// Get the progress of an asynchronous compilation.
+///
+/// \param Cxt the WasmEdge_CompilerJobContext.
+/// \param [out] Done the number of the finished steps.
+/// \param [out] Total the number of all the steps, 0 before starting.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_CompilerJobGetProgress(const WasmEdge_CompilerJobContext *Cxt,
+                                uint64_t *Done, uint64_t *Total);
+
+/// Deletion of the WasmEdge_CompilerJobContext.
+///
+/// Deleting a job does not cancel it. After calling this function, the
+/// context will be destroyed and should __NOT__ be used.
+///
+/// \param Cxt the WasmEdge_CompilerJobContext to destroy.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_CompilerJobDelete(WasmEdge_CompilerJobContext *Cxt);
+
 // <<<<<<<< WasmEdge AOT compiler functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 // >>>>>>>> WasmEdge loader functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
@@ -1619,6 +1832,64 @@ WasmEdge_ExecutorInvoke(WasmEdge_ExecutorContext *Cxt,
                         const WasmEdge_Value *Params, const uint32_t ParamLen,
                         WasmEdge_Value *Returns, const uint32_t ReturnLen);
 
+/// Create a continuation which invokes a WASM function when resumed.
+///
+/// The continuation keeps the execution state of the invocation, and can be
+/// suspended and resumed on any thread by `WasmEdge_ExecutorResume`. The
+/// caller owns the object and should call `WasmEdge_ContinuationDelete` to
+/// destroy it.
+///
+/// \param Cxt the WasmEdge_ExecutorContext.
+/// \param [out] ContCxt the output WasmEdge_ContinuationContext if succeeded.
+/// \param FuncCxt the function instance context to invoke.
+/// \param Params the WasmEdge_Value buffer with the parameter values.
+/// \param ParamLen the parameter buffer length.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result WasmEdge_ExecutorCreateContinuation(
+    WasmEdge_ExecutorContext *Cxt, WasmEdge_ContinuationContext **ContCxt,
+    const WasmEdge_FunctionInstanceContext *FuncCxt,
+    const WasmEdge_Value *Params, const uint32_t ParamLen);
+
+/// Resume a continuation until it returns, fails, or is suspended.
+///
+/// The execution is suspended at the next function entry or loop back-edge of
+/// the interpreter once the fuel or the time slice is used up, or once
+/// `WasmEdge_ExecutorRequestSuspend` is called. The fuel is charged by the cost
+/// table, and takes effect only when the cost measuring is enabled. A host
+/// function called by the interpreter can return `WasmEdge_Result_Suspend` to
+/// suspend the execution. It will be called again with the same arguments when
+/// resumed. Compiled functions are not suspended in the middle.
+///
+/// \param Cxt the WasmEdge_ExecutorContext which created the continuation.
+/// \param ContCxt the WasmEdge_ContinuationContext to resume.
+/// \param Fuel the gas to run in this slice. UINT64_MAX for no limit.
+/// \param TimeSliceMs the time slice in milliseconds. UINT64_MAX for no
+/// limit.
+///
+/// \returns WasmEdge_Result_Success if the function returned, a result with
+/// the `WasmEdge_ErrCode_Suspended` code if suspended, or the error of the
+/// execution. Call `WasmEdge_ResultGetMessage` for the error message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_ExecutorResume(WasmEdge_ExecutorContext *Cxt,
+                        WasmEdge_ContinuationContext *ContCxt,
+                        const uint64_t Fuel, const uint64_t TimeSliceMs);
+
+/// Request a continuation to suspend at its next safe point.
+///
+/// This function is thread-safe and can be called while the continuation is
+/// running on another thread.
+///
+/// \param Cxt the WasmEdge_ExecutorContext which created the continuation.
+/// \param ContCxt the WasmEdge_ContinuationContext to suspend.
+///
+/// \returns true if requested, false if the continuation already finished or
+/// the context is NULL.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ExecutorRequestSuspend(WasmEdge_ExecutorContext *Cxt,
+                                WasmEdge_ContinuationContext *ContCxt);
+
 /// Deletion of the WasmEdge_ExecutorContext.
 ///
 /// After calling this function, the context will be destroyed and should
@@ -1630,6 +1901,56 @@ WasmEdge_ExecutorDelete(WasmEdge_ExecutorContext *Cxt);
 
 // <<<<<<<< WasmEdge executor functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge continuation functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+/// Check whether the continuation can be resumed.
+///
+/// \param Cxt the WasmEdge_ContinuationContext.
+///
+/// \returns true if the continuation is not started or suspended, false if it
+/// returned or failed.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ContinuationIsResumable(const WasmEdge_ContinuationContext *Cxt);
+
+/// Get the times the continuation has been suspended.
+///
+/// \param Cxt the WasmEdge_ContinuationContext.
+///
+/// \returns the suspension count.
+WASMEDGE_CAPI_EXPORT extern uint64_t
+WasmEdge_ContinuationGetSuspendCount(const WasmEdge_ContinuationContext *Cxt);
+
+/// Get the length of the return values of a returned continuation.
+///
+/// \param Cxt the WasmEdge_ContinuationContext.
+///
+/// \returns the return value count, 0 if not returned yet.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ContinuationGetReturnsLength(const WasmEdge_ContinuationContext *Cxt);
+
+/// Get the return values of a returned continuation.
+///
+/// \param Cxt the WasmEdge_ContinuationContext.
+/// \param [out] Returns the WasmEdge_Value buffer to fill the return values.
+/// \param ReturnLen the return buffer length.
+///
+/// \returns the return value count, 0 if not returned yet.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ContinuationGetReturns(const WasmEdge_ContinuationContext *Cxt,
+                                WasmEdge_Value *Returns,
+                                const uint32_t ReturnLen);
+
+/// Deletion of the WasmEdge_ContinuationContext.
+///
+/// After calling this function, the context will be destroyed and should
+/// __NOT__ be used.
+///
+/// \param Cxt the WasmEdge_ContinuationContext to destroy.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ContinuationDelete(WasmEdge_ContinuationContext *Cxt);
+
+// <<<<<<<< WasmEdge continuation functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 // >>>>>>>> WasmEdge store functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
 /// Creation of the WasmEdge_StoreContext.
@@ -3064,6 +3385,96 @@ WasmEdge_VMValidate(WasmEdge_VMContext *Cxt);
 WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
 WasmEdge_VMInstantiate(WasmEdge_VMContext *Cxt);
 
+/// Create a pool of pre-instantiated instances of the validated WASM module.
+///
+/// After validating a WASM module in the VM context, you can call this function
+/// to instantiate `Capacity` instances of it into a pool. The first instance is
+/// captured right after instantiation, including the effects of the start
+/// function. Instances given back by `WasmEdge_VMReleaseInstance` are reset to
+/// that state instead of being destroyed, which is much cheaper than a new
+/// instantiation. Only the memories, tables, and globals owned by the instance
+/// are reset; imported ones are shared and left untouched. Calling this
+/// function again replaces the previous pool.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMContext.
+/// \param Capacity the maximum number of instances kept in the pool.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_VMCreateInstancePool(WasmEdge_VMContext *Cxt, const uint32_t Capacity);
+
+/// Take a module instance from the instance pool of the VM context.
+///
+/// If the pool is empty, a new instance is instantiated. The caller should give
+/// the instance back with `WasmEdge_VMReleaseInstance`, or destroy it with
+/// `WasmEdge_ModuleInstanceDelete`, before the VM context loads another WASM
+/// module or is cleaned up.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMContext.
+/// \param [out] ModuleCxt the output WasmEdge_ModuleInstanceContext if
+/// succeeded.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_VMAcquireInstance(WasmEdge_VMContext *Cxt,
+                           WasmEdge_ModuleInstanceContext **ModuleCxt);
+
+/// Give a module instance back to the instance pool of the VM context.
+///
+/// The instance is reset to its post-instantiation state and kept for the next
+/// `WasmEdge_VMAcquireInstance`. The ownership of the instance is taken in any
+/// case; instances not acquired from the current pool are destroyed.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMContext.
+/// \param ModuleCxt the WasmEdge_ModuleInstanceContext to give back.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_VMReleaseInstance(WasmEdge_VMContext *Cxt,
+                           WasmEdge_ModuleInstanceContext *ModuleCxt);
+
+/// Invoke a WASM function by name in the given module instance.
+///
+/// This function invokes the exported function of a module instance, such as
+/// one taken by `WasmEdge_VMAcquireInstance`. If the `Returns` buffer length is
+/// smaller than the arity of the function, the overflowed return values will be
+/// discarded.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMContext.
+/// \param ModuleCxt the WasmEdge_ModuleInstanceContext.
+/// \param FuncName the function name WasmEdge_String.
+/// \param Params the WasmEdge_Value buffer with the parameter values.
+/// \param ParamLen the parameter buffer length.
+/// \param [out] Returns the WasmEdge_Value buffer to fill the return values.
+/// \param ReturnLen the return buffer length.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result WasmEdge_VMExecuteInstance(
+    WasmEdge_VMContext *Cxt, const WasmEdge_ModuleInstanceContext *ModuleCxt,
+    const WasmEdge_String FuncName, const WasmEdge_Value *Params,
+    const uint32_t ParamLen, WasmEdge_Value *Returns, const uint32_t ReturnLen);
+
+/// Get the statistics of the instance pool of the VM context.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMContext.
+/// \param [out] Stat the WasmEdge_InstancePoolStatistics to fill.
+///
+/// \returns true if the instance pool is created, false if not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_VMGetInstancePoolStatistics(const WasmEdge_VMContext *Cxt,
+                                     WasmEdge_InstancePoolStatistics *Stat);
+
 /// Invoke a WASM function by name.
 ///
 /// This is the final step to invoke a WASM function step by step.
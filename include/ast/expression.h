@@ -22,6 +22,22 @@ namespace AST {
 /// AST Expression node.
 class Expression {
 public:
+  Expression() = default;
+  Expression(Expression &&) = default;
+  Expression &operator=(Expression &&) = default;
+  /// Copying keeps a spare slot after the instructions, so that the end of a
+  /// function body never aliases the beginning of another one in memory. The
+  /// function instances can then refer to the instructions without copying.
+  Expression(const Expression &E) { *this = E; }
+  Expression &operator=(const Expression &E) {
+    if (this != &E) {
+      Instrs.clear();
+      Instrs.reserve(E.Instrs.size() + 1);
+      Instrs.assign(E.Instrs.begin(), E.Instrs.end());
+    }
+    return *this;
+  }
+
   /// Getter of instructions vector.
   InstrView getInstrs() const noexcept { return Instrs; }
   InstrVec &getInstrs() noexcept { return Instrs; }
@@ -45,6 +45,7 @@ public:
 #endif
     Flags.IsAllocLabelList = false;
     Flags.IsAllocValTypeList = false;
+    Flags.IsInBounds = false;
   }
 
   /// Copy constructor.
@@ -177,6 +178,12 @@ public:
   uint8_t getMemoryLane() const noexcept { return Data.Memories.MemLane; }
   uint8_t &getMemoryLane() noexcept { return Data.Memories.MemLane; }
 
+  /// Getter and setter of the in-bounds flag of memory access.
+  bool isInBounds() const noexcept { return Flags.IsInBounds; }
+  void setInBounds(bool InBounds = true) noexcept {
+    Flags.IsInBounds = InBounds;
+  }
+
   /// Getter and setter of the constant value.
   ValVariant getNum() const noexcept {
 #if defined(__x86_64__) || defined(__aarch64__)
@@ -269,6 +276,7 @@ private:
   struct {
     bool IsAllocLabelList : 1;
     bool IsAllocValTypeList : 1;
+    bool IsInBounds : 1;
   } Flags;
   /// @}
 };
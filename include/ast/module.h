@@ -16,6 +16,10 @@
 
 #include "ast/section.h"
 
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace WasmEdge {
@@ -65,6 +69,21 @@ public:
   DataCountSection &getDataCountSection() { return DataCountSec; }
   const AOTSection &getAOTSection() const { return AOTSec; }
   AOTSection &getAOTSection() { return AOTSec; }
+  const NameSection &getNameSection() const { return NameSec; }
+  NameSection &getNameSection() { return NameSec; }
+
+  /// Getter of the function names for diagnostics. The names in the name
+  /// section are preferred, and the export names are used for the rest.
+  std::map<uint32_t, std::string> getFunctionNames() const {
+    auto Names = NameSec.getFunctionNames();
+    for (const auto &ExpDesc : ExportSec.getContent()) {
+      if (ExpDesc.getExternalType() == ExternalType::Function) {
+        Names.try_emplace(ExpDesc.getExternalIndex(),
+                          ExpDesc.getExternalName());
+      }
+    }
+    return Names;
+  }
 
   enum class Intrinsics : uint32_t {
     kTrap,
@@ -88,6 +107,8 @@ public:
     kPtrFunc,
     kMemoryAtomicNotify,
     kMemoryAtomicWait,
+    kCheckDeadline,
+    kRefillGas,
     kIntrinsicMax,
   };
   using IntrinsicsTable = void * [uint32_t(Intrinsics::kIntrinsicMax)];
@@ -98,6 +119,14 @@ public:
     IntrSymbol = std::move(S);
   }
 
+  /// Getter and setter of the loaded text sections holding the compiled code.
+  Span<const std::pair<const uint8_t *, uint64_t>> getTexts() const noexcept {
+    return Texts;
+  }
+  void setTexts(Span<const std::pair<const uint8_t *, uint64_t>> T) {
+    Texts.assign(T.begin(), T.end());
+  }
+
   /// Getter and setter of validated flag.
   bool getIsValidated() const noexcept { return IsValidated; }
   void setIsValidated(bool V = true) noexcept { IsValidated = V; }
@@ -124,12 +153,14 @@ private:
   CodeSection CodeSec;
   DataSection DataSec;
   DataCountSection DataCountSec;
+  NameSection NameSec;
   /// @}
 
   /// \name Data of AOT.
   /// @{
   AOTSection AOTSec;
   Symbol<const IntrinsicsTable *> IntrSymbol;
+  std::vector<std::pair<const uint8_t *, uint64_t>> Texts;
   /// @}
 
   /// \name Validated flag.
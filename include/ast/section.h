@@ -15,8 +15,12 @@
 
 #include "ast/description.h"
 #include "ast/segment.h"
+#include "system/mmap.h"
 
+#include <map>
+#include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 namespace WasmEdge {
@@ -242,6 +246,11 @@ public:
   uint8_t getArchType() const noexcept { return ArchType; }
   void setArchType(uint8_t Type) noexcept { ArchType = Type; }
 
+  /// Getter and setter of the mask of the CPU features which the code is
+  /// compiled for, in the bits of CPU::featureNames().
+  uint64_t getCPUFeatures() const noexcept { return CPUFeatures; }
+  void setCPUFeatures(uint64_t Features) noexcept { CPUFeatures = Features; }
+
   /// Getter and setter of version address.
   uint64_t getVersionAddress() const noexcept { return VersionAddress; }
   void setVersionAddress(uint64_t Addr) noexcept { VersionAddress = Addr; }
@@ -268,18 +277,55 @@ public:
   constexpr const auto &getSections() const noexcept { return Sections; }
   constexpr auto &getSections() noexcept { return Sections; }
 
+  /// Getter and setter of the image offset, which is the position of the
+  /// page-aligned section image in the loaded file or buffer.
+  uint64_t getImageOffset() const noexcept { return ImageOffset; }
+  void setImageOffset(uint64_t Offset) noexcept { ImageOffset = Offset; }
+
+  /// Getter and setter of the image size.
+  uint64_t getImageSize() const noexcept { return ImageSize; }
+  void setImageSize(uint64_t Size) noexcept { ImageSize = Size; }
+
+  /// Getter and setter of the image file. Set only if the module is loaded
+  /// from a file, and then the text sections are left without contents to be
+  /// mapped from the file, which is kept open since loaded.
+  const std::shared_ptr<const MMap> &getImageFile() const noexcept {
+    return ImageFile;
+  }
+  void setImageFile(std::shared_ptr<const MMap> File) noexcept {
+    ImageFile = std::move(File);
+  }
+
 private:
   /// \name Data of AOTSection.
   /// @{
   uint32_t Version;
   uint8_t OSType;
   uint8_t ArchType;
+  uint64_t CPUFeatures = 0;
   uint64_t VersionAddress;
   uint64_t IntrinsicsAddress;
   std::vector<uintptr_t> TypesAddress;
   std::vector<uintptr_t> CodesAddress;
   std::vector<std::tuple<uint8_t, uint64_t, uint64_t, std::vector<Byte>>>
       Sections;
+  uint64_t ImageOffset = 0;
+  uint64_t ImageSize = 0;
+  std::shared_ptr<const MMap> ImageFile;
+  /// @}
+};
+
+/// AST NameSection node, which is parsed from the "name" custom section.
+class NameSection {
+public:
+  /// Getter of function names.
+  constexpr const auto &getFunctionNames() const noexcept { return FuncNames; }
+  constexpr auto &getFunctionNames() noexcept { return FuncNames; }
+
+private:
+  /// \name Data of NameSection.
+  /// @{
+  std::map<uint32_t, std::string> FuncNames;
   /// @}
 };
 
@@ -22,7 +22,10 @@
 #include <initializer_list>
 #include <mutex>
 #include <shared_mutex>
+#include <string>
+#include <string_view>
 #include <unordered_set>
+#include <vector>
 
 namespace WasmEdge {
 
@@ -34,7 +37,11 @@ public:
         OFormat(RHS.OFormat.load(std::memory_order_relaxed)),
         DumpIR(RHS.DumpIR.load(std::memory_order_relaxed)),
         GenericBinary(RHS.GenericBinary.load(std::memory_order_relaxed)),
-        Interruptible(RHS.Interruptible.load(std::memory_order_relaxed)) {}
+        Interruptible(RHS.Interruptible.load(std::memory_order_relaxed)),
+        Incremental(RHS.Incremental.load(std::memory_order_relaxed)),
+        WasmOptimization(
+            RHS.WasmOptimization.load(std::memory_order_relaxed)),
+        TargetCPUs(RHS.getTargetCPUs()) {}
 
   /// AOT compiler optimization level enum class.
   enum class OptimizationLevel : uint8_t {
@@ -98,19 +105,70 @@ public:
     return Interruptible.load(std::memory_order_relaxed);
   }
 
+  /// Compile each function into its own object, cached in the AOT cache
+  /// directory by the hash of its body and of the module context, so that
+  /// recompiling a rebuilt module only compiles the changed functions. The
+  /// functions are not inlined into each other in this mode.
+  void setIncremental(bool IsIncremental) noexcept {
+    Incremental.store(IsIncremental, std::memory_order_relaxed);
+  }
+
+  bool isIncremental() const noexcept {
+    return Incremental.load(std::memory_order_relaxed);
+  }
+
+  /// Optimize the functions at the wasm level after validation, for both the
+  /// interpreter and the AOT compiler. The tiny leaf functions are inlined,
+  /// the constants are folded, and the unread locals and the unreachable code
+  /// are removed, so the instruction counts and the costs of the executions
+  /// differ from the original module.
+  void setWasmOptimization(bool IsWasmOptimization) noexcept {
+    WasmOptimization.store(IsWasmOptimization, std::memory_order_relaxed);
+  }
+
+  bool isWasmOptimization() const noexcept {
+    return WasmOptimization.load(std::memory_order_relaxed);
+  }
+
+  /// Add a CPU level to compile a code variant for, which is one of the
+  /// CPU::levelNames() such as `x86-64-v3`. The loader selects the variant
+  /// with the most CPU features supported by the host. Without any, only one
+  /// variant for the host CPU, or the generic CPU for the generic binary, is
+  /// compiled.
+  void addTargetCPU(std::string_view Name) {
+    std::unique_lock Lock(Mutex);
+    TargetCPUs.emplace_back(Name);
+  }
+
+  void clearTargetCPUs() noexcept {
+    std::unique_lock Lock(Mutex);
+    TargetCPUs.clear();
+  }
+
+  std::vector<std::string> getTargetCPUs() const {
+    std::unique_lock Lock(Mutex);
+    return TargetCPUs;
+  }
+
 private:
   std::atomic<OptimizationLevel> OptLevel = OptimizationLevel::O3;
   std::atomic<OutputFormat> OFormat = OutputFormat::Wasm;
   std::atomic<bool> DumpIR = false;
   std::atomic<bool> GenericBinary = false;
   std::atomic<bool> Interruptible = false;
+  std::atomic<bool> Incremental = false;
+  std::atomic<bool> WasmOptimization = false;
+  mutable std::mutex Mutex;
+  std::vector<std::string> TargetCPUs;
 };
 
 class RuntimeConfigure {
 public:
   RuntimeConfigure() noexcept = default;
   RuntimeConfigure(const RuntimeConfigure &RHS) noexcept
-      : MaxMemPage(RHS.MaxMemPage.load(std::memory_order_relaxed)) {}
+      : MaxMemPage(RHS.MaxMemPage.load(std::memory_order_relaxed)),
+        PerfMap(RHS.PerfMap.load(std::memory_order_relaxed)),
+        JitDump(RHS.JitDump.load(std::memory_order_relaxed)) {}
 
   void setMaxMemoryPage(const uint32_t Page) noexcept {
     MaxMemPage.store(Page, std::memory_order_relaxed);
@@ -120,8 +178,28 @@ public:
     return MaxMemPage.load(std::memory_order_relaxed);
   }
 
+  /// Emit the perf map entries of the loaded AOT code.
+  void setPerfMap(bool IsPerfMap) noexcept {
+    PerfMap.store(IsPerfMap, std::memory_order_relaxed);
+  }
+
+  bool isPerfMap() const noexcept {
+    return PerfMap.load(std::memory_order_relaxed);
+  }
+
+  /// Emit the jitdump records of the loaded AOT code.
+  void setJitDump(bool IsJitDump) noexcept {
+    JitDump.store(IsJitDump, std::memory_order_relaxed);
+  }
+
+  bool isJitDump() const noexcept {
+    return JitDump.load(std::memory_order_relaxed);
+  }
+
 private:
   std::atomic<uint32_t> MaxMemPage = 65536;
+  std::atomic<bool> PerfMap = false;
+  std::atomic<bool> JitDump = false;
 };
 
 class StatisticsConfigure {
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/common/pgo.h - Execution profile definition --------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the execution profile for the profile-guided
+/// optimization of the AOT compiler.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+#include "common/filesystem.h"
+#include "common/span.h"
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <vector>
+
+namespace WasmEdge {
+namespace PGO {
+
+/// Execution counts of a wasm module.
+///
+/// The function entries are counted by the function indices, including the
+/// imported functions. The conditional branches are counted by the offsets of
+/// the `if`, `br_if`, and `br_table` instructions in the wasm binary, one count
+/// per target: the taken and the not taken ones for `if` and `br_if`, and the
+/// labels followed by the default label for `br_table`. The profile is keyed
+/// to the binary, so it only applies to the same wasm file.
+class Profile {
+public:
+  /// Add to the entry count of a function.
+  void addEntry(uint32_t FuncIdx, uint64_t Count = 1);
+
+  /// Add to the count of a branch target.
+  /// \param Offset the offset of the branch instruction.
+  /// \param Target the index of the target.
+  /// \param TargetNum the number of targets of the branch.
+  void addBranch(uint32_t Offset, uint32_t Target, uint32_t TargetNum,
+                 uint64_t Count = 1);
+
+  /// Add the counts of another profile, such as one of another run.
+  void merge(const Profile &Other);
+
+  /// Getter of the entry count of a function. Zero if never entered.
+  uint64_t getEntryCount(uint32_t FuncIdx) const noexcept;
+
+  /// Getter of the counts of a branch. Empty if never reached.
+  Span<const uint64_t> getBranchCounts(uint32_t Offset) const noexcept;
+
+  /// Getter of all the entry counts and the branch counts.
+  const std::map<uint32_t, uint64_t> &getEntries() const noexcept {
+    return Entries;
+  }
+  const std::map<uint32_t, std::vector<uint64_t>> &
+  getBranches() const noexcept {
+    return Branches;
+  }
+
+  /// Check whether nothing is counted.
+  bool empty() const noexcept { return Entries.empty() && Branches.empty(); }
+
+  /// Load the profile in the text format.
+  static Expect<Profile> load(std::istream &IS);
+  static Expect<Profile> load(const std::filesystem::path &Path);
+
+  /// Dump the profile in the text format.
+  void dump(std::ostream &OS) const;
+  Expect<void> dump(const std::filesystem::path &Path) const;
+
+private:
+  /// \name Data of profile.
+  /// @{
+  std::map<uint32_t, uint64_t> Entries;
+  std::map<uint32_t, std::vector<uint64_t>> Branches;
+  /// @}
+};
+
+} // namespace PGO
+} // namespace WasmEdge
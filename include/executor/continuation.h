@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/executor/continuation.h - Continuation definition --------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the continuation, which is the saved
+/// state of a suspended function invocation.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "ast/instruction.h"
+#include "common/types.h"
+#include "runtime/instance/function.h"
+#include "runtime/stackmgr.h"
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+namespace Executor {
+
+class Executor;
+
+/// State of a function invocation which can be suspended and resumed.
+///
+/// The continuation owns the value and frame stacks of the invocation and the
+/// instruction to resume from. It is created by Executor::createContinuation()
+/// and run by Executor::resume() of the same executor on any thread, one
+/// thread at a time. The module instances on the frame stack must outlive it.
+///
+/// The execution is suspended at a safe point of the interpreter when the
+/// slice given to resume() is used up, or when Executor::requestSuspend() is
+/// called from any thread. A host function called by the interpreter can also
+/// return ErrCode::Value::Suspended to suspend the caller, for example while
+/// waiting for an asynchronous operation. Such a host function is called again
+/// with the same arguments when resumed. Called by the compiled code, which
+/// cannot be suspended in the middle, such a host function fails instead.
+class Continuation {
+public:
+  enum class Status : uint8_t {
+    /// Not started yet.
+    Ready,
+    /// Suspended at a safe point and can be resumed.
+    Suspended,
+    /// The function returned and the return values are available.
+    Returned,
+    /// The execution failed or was terminated.
+    Failed,
+  };
+
+  Continuation(const Runtime::Instance::FunctionInstance &Func,
+               Span<const ValVariant> Params) noexcept
+      : Func(&Func) {
+    // Push a dummy frame and the arguments as the invocation does.
+    StackMgr.pushFrame(nullptr, AST::InstrView::iterator(), 0, 0);
+    for (auto &Val : Params) {
+      StackMgr.push(Val);
+    }
+  }
+
+  /// Getter of the invoked function.
+  const Runtime::Instance::FunctionInstance &getFunction() const noexcept {
+    return *Func;
+  }
+
+  /// Getter of the status.
+  Status getStatus() const noexcept { return St.load(); }
+
+  /// Check whether the continuation can be resumed.
+  bool isResumable() const noexcept {
+    const auto Current = St.load();
+    return Current == Status::Ready || Current == Status::Suspended;
+  }
+
+  /// Getter of the times of being suspended.
+  uint64_t getSuspendCount() const noexcept { return SuspendCount; }
+
+  /// Getter of the return values. Available once returned.
+  Span<const std::pair<ValVariant, ValType>> getReturns() const noexcept {
+    return Returns;
+  }
+
+private:
+  friend class Executor;
+
+  /// \name Data of continuation.
+  /// @{
+  const Runtime::Instance::FunctionInstance *Func;
+  Runtime::StackManager StackMgr;
+  /// Instruction to resume from.
+  AST::InstrView::iterator PC = {};
+  /// Host function to call again when resumed, which returns to the PC.
+  const Runtime::Instance::FunctionInstance *PendingHost = nullptr;
+  std::atomic<Status> St = Status::Ready;
+  /// Suspension requested by Executor::requestSuspend().
+  std::atomic_bool SuspendRequested = false;
+  uint64_t SuspendCount = 0;
+  std::vector<std::pair<ValVariant, ValType>> Returns;
+  /// @}
+};
+
+} // namespace Executor
+} // namespace WasmEdge
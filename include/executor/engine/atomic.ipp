@@ -14,9 +14,9 @@ template <typename T>
 TypeT<T> Executor::runAtomicWaitOp(Runtime::StackManager &StackMgr,
                                    Runtime::Instance::MemoryInstance &MemInst,
                                    const AST::Instruction &Instr) {
-  ValVariant RawAddress = StackMgr.pop();
+  ValVariant RawTimeout = StackMgr.pop();
   ValVariant RawValue = StackMgr.pop();
-  ValVariant &RawTimeout = StackMgr.getTop();
+  ValVariant &RawAddress = StackMgr.getTop();
 
   uint32_t Address = RawAddress.get<uint32_t>();
   if (Address >
@@ -54,7 +54,7 @@ TypeT<T> Executor::runAtomicWaitOp(Runtime::StackManager &StackMgr,
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
     return Unexpect(Res);
   } else {
-    RawTimeout.emplace<uint32_t>(*Res);
+    RawAddress.emplace<uint32_t>(*Res);
   }
   return {};
 }
@@ -474,20 +474,35 @@ Executor::atomicWait(Runtime::Instance::MemoryInstance &MemInst,
   while (true) {
     std::unique_lock<decltype(WaiterIterator->second.Mutex)> Locker(
         WaiterIterator->second.Mutex);
+    // Wake up at the timeout of the executor as well, because the waiter
+    // cannot check the epoch counter while blocked.
+    const uint64_t ExecTimeout = this->Timeout.load(std::memory_order_relaxed);
+    auto WakeUp = Until;
+    if (ExecTimeout != Epoch::kNever) {
+      const auto TimeoutPoint = Epoch::timePoint(ExecTimeout);
+      if (!WakeUp || TimeoutPoint < *WakeUp) {
+        WakeUp.emplace(TimeoutPoint);
+      }
+    }
     std::cv_status WaitResult = std::cv_status::no_timeout;
-    if (!Until) {
+    if (!WakeUp) {
       WaiterIterator->second.Cond.wait(Locker);
     } else {
-      WaitResult = WaiterIterator->second.Cond.wait_until(Locker, *Until);
+      WaitResult = WaiterIterator->second.Cond.wait_until(Locker, *WakeUp);
     }
-    if (unlikely(StopToken.load(std::memory_order_relaxed) != 0)) {
+    if (unlikely(isInterrupted() ||
+                 (ExecTimeout != Epoch::kNever &&
+                  std::chrono::steady_clock::now() >=
+                      Epoch::timePoint(ExecTimeout)))) {
+      clearTimeout();
       spdlog::error(ErrCode::Value::Interrupted);
       return Unexpect(ErrCode::Value::Interrupted);
     }
     if (likely(AtomicObj->load() != Expected)) {
       return UINT32_C(0); // ok
     }
-    if (WaitResult == std::cv_status::timeout) {
+    if (WaitResult == std::cv_status::timeout && Until &&
+        std::chrono::steady_clock::now() >= *Until) {
       return UINT32_C(2); // Timed-out
     }
   }
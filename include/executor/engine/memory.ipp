@@ -15,6 +15,11 @@ TypeT<T> Executor::runLoadOp(Runtime::StackManager &StackMgr,
                              const AST::Instruction &Instr) {
   // Calculate EA
   ValVariant &Val = StackMgr.getTop();
+  if (Instr.isInBounds()) {
+    // A previous access has checked the range.
+    uint32_t EA = Val.get<uint32_t>() + Instr.getMemoryOffset();
+    return MemInst.loadValue<T, BitWidth / 8, false>(Val.emplace<T>(), EA);
+  }
   if (Val.get<uint32_t>() >
       std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
     spdlog::error(ErrCode::Value::MemoryOutOfBounds);
@@ -46,6 +51,11 @@ TypeN<T> Executor::runStoreOp(Runtime::StackManager &StackMgr,
 
   // Calculate EA = i + offset
   uint32_t I = StackMgr.pop().get<uint32_t>();
+  if (Instr.isInBounds()) {
+    // A previous access has checked the range.
+    return MemInst.storeValue<T, BitWidth / 8, false>(
+        C, I + Instr.getMemoryOffset());
+  }
   if (I > std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
     spdlog::error(ErrCode::Value::MemoryOutOfBounds);
     spdlog::error(ErrInfo::InfoBoundary(
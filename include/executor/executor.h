@@ -18,12 +18,17 @@
 #include "common/configure.h"
 #include "common/defines.h"
 #include "common/errcode.h"
+#include "common/pgo.h"
 #include "common/statistics.h"
+#include "executor/continuation.h"
+#include "executor/profiler.h"
 #include "runtime/callingframe.h"
 #include "runtime/instance/module.h"
 #include "runtime/stackmgr.h"
 #include "runtime/storemgr.h"
+#include "system/epoch.h"
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <csignal>
@@ -33,6 +38,7 @@
 #include <optional>
 #include <string_view>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -87,6 +93,33 @@ using TypeNN =
 
 } // namespace
 
+/// Execution counters of a module instance for the execution profile. They
+/// are allocated when the module is instantiated, so that counting only bumps
+/// them with relaxed atomics.
+struct PGOCounters {
+  /// Counters of a function or a branch instruction, keyed by the function
+  /// body or the instruction.
+  struct Slot {
+    const void *Key;
+    /// Function index or instruction offset.
+    uint32_t Id;
+    /// First counter and the number of counters.
+    uint32_t Begin;
+    uint32_t Num;
+  };
+
+  /// Count the target of the function or the branch of the key.
+  static void add(Span<const Slot> Slots, Span<std::atomic_uint64_t> Counts,
+                  const void *Key, uint32_t Target) noexcept;
+
+  /// Generation of the profile the counters belong to.
+  uint64_t Generation = 0;
+  /// Slots sorted by the keys.
+  std::vector<Slot> Funcs;
+  std::vector<Slot> Branches;
+  std::vector<std::atomic_uint64_t> Counts;
+};
+
 /// Executor flow control class.
 class Executor {
 public:
@@ -100,14 +133,22 @@ public:
     } else {
       Stat = nullptr;
     }
-    newThread();
     if (Stat) {
       Stat->setCostLimit(Conf.getStatisticsConfigure().getCostLimit());
     }
+    newThread();
   }
   ~Executor() noexcept {
+    if (Prof) {
+      Prof->stop();
+    }
+    if (PGOProf.load(std::memory_order_relaxed)) {
+      setPGOProfile(nullptr);
+    }
+    clearTimeout();
     This = nullptr;
-    ExecutionContext.StopToken = nullptr;
+    ExecutionContext.EpochCounter = nullptr;
+    ExecutionContext.Deadline = nullptr;
     ExecutionContext.InstrCount = nullptr;
     ExecutionContext.CostTable = nullptr;
     ExecutionContext.Gas = nullptr;
@@ -117,11 +158,24 @@ public:
   Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
   instantiateModule(Runtime::StoreManager &StoreMgr, const AST::Module &Mod);
 
+  /// Instantiate a shared WASM Module into an anonymous module instance. The
+  /// module instance keeps the module alive and refers to its code instead of
+  /// copying it, so instances of one module hold the code only once.
+  Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
+  instantiateModule(Runtime::StoreManager &StoreMgr,
+                    std::shared_ptr<const AST::Module> Mod);
+
   /// Instantiate and register a WASM module into a named module instance.
   Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
   registerModule(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
                  std::string_view Name);
 
+  /// Instantiate and register a shared WASM module into a named module
+  /// instance.
+  Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
+  registerModule(Runtime::StoreManager &StoreMgr,
+                 std::shared_ptr<const AST::Module> Mod, std::string_view Name);
+
   /// Register an instantiated module into a named module instance.
   Expect<void> registerModule(Runtime::StoreManager &StoreMgr,
                               const Runtime::Instance::ModuleInstance &ModInst);
@@ -131,29 +185,182 @@ public:
   invoke(const Runtime::Instance::FunctionInstance &FuncInst,
          Span<const ValVariant> Params, Span<const ValType> ParamTypes);
 
+  /// Create a continuation which invokes a WASM function when resumed.
+  Expect<std::unique_ptr<Continuation>>
+  createContinuation(const Runtime::Instance::FunctionInstance &FuncInst,
+                     Span<const ValVariant> Params,
+                     Span<const ValType> ParamTypes);
+
+  /// Run the continuation until the function returns, the execution fails, or
+  /// the slice is used up. The slice is bounded by the fuel in the gas of the
+  /// cost table, which takes effect when the cost measuring is enabled, and by
+  /// the deadline in epochs. Once the slice is used up, the continuation is
+  /// suspended at the next function entry or loop back-edge of the
+  /// interpreter. Compiled and host functions run to completion.
+  /// Returns true if the function returned, false if suspended.
+  Expect<bool> resume(Continuation &Cont, uint64_t Fuel = UINT64_MAX,
+                      uint64_t SliceDeadline = Epoch::kNever);
+
+  /// Request the continuation to suspend at its next safe point. Can be called
+  /// from any thread. Returns false if the continuation already finished.
+  bool requestSuspend(Continuation &Cont) noexcept;
+
   /// Register new thread
   void newThread() noexcept {
     This = this;
-    ExecutionContext.StopToken = &StopToken;
+    ExecutionContext.EpochCounter = &Epoch::counter();
+    ExecutionContext.Deadline = &Deadline;
     if (Stat) {
       ExecutionContext.InstrCount = &Stat->getInstrCountRef();
       ExecutionContext.CostTable = Stat->getCostTable().data();
-      ExecutionContext.Gas = &Stat->getTotalCostRef();
-      ExecutionContext.GasLimit = Stat->getCostLimit();
+      ExecutionContext.Gas = &ThreadGas;
+      resetGasBudget();
     }
   }
 
   /// Stop execution
   void stop() noexcept {
-    StopToken.store(1, std::memory_order_relaxed);
+    Timeout.store(0, std::memory_order_relaxed);
+    Deadline.store(0, std::memory_order_relaxed);
+    atomicNotifyAll();
+  }
+
+  /// Interrupt the execution once the timeout is reached.
+  void setTimeout(Epoch::Clock::time_point TimePoint) noexcept {
+    const uint64_t NewTimeout = Epoch::deadline(TimePoint);
+    if (!TimeoutArmed.exchange(true, std::memory_order_relaxed)) {
+      Epoch::arm();
+    }
+    Timeout.store(NewTimeout, std::memory_order_relaxed);
+    Deadline.store(NewTimeout, std::memory_order_relaxed);
+    // Let the waiters of memory.atomic.wait wait until the new timeout.
     atomicNotifyAll();
   }
 
+  /// Remove the timeout set by setTimeout.
+  void clearTimeout() noexcept {
+    Timeout.store(Epoch::kNever, std::memory_order_relaxed);
+    Deadline.store(Epoch::kNever, std::memory_order_relaxed);
+    if (TimeoutArmed.exchange(false, std::memory_order_relaxed)) {
+      Epoch::disarm();
+    }
+  }
+
+  /// Attach the sampling profiler and start sampling. The modules
+  /// instantiated afterwards are registered into the profiler. Passing nullptr
+  /// stops sampling.
+  void setProfiler(Profiler *P) {
+    if (Prof) {
+      Prof->stop();
+    }
+    Prof = P;
+    if (Prof) {
+      Prof->start([this]() { requestSample(); });
+    }
+  }
+
+  /// Request a profiling sample at the next function entry or loop back-edge.
+  void requestSample() noexcept {
+    SampleRequested.store(true, std::memory_order_relaxed);
+    Deadline.store(0, std::memory_order_relaxed);
+  }
+
+  /// Attach the execution profile and start counting the function entries and
+  /// the branches. Only the active modules instantiated afterwards are counted,
+  /// and only when run by the interpreter. Passing nullptr stops counting.
+  /// The counts are added into the profile when it is detached or replaced,
+  /// or when the executor is destroyed.
+  void setPGOProfile(PGO::Profile *P);
+
 private:
   /// Run Wasm bytecode expression for initialization.
   Expect<void> runExpression(Runtime::StackManager &StackMgr,
                              AST::InstrView Instrs);
 
+  /// Action to take at a safe point.
+  enum class SafePoint : uint8_t { Continue, Interrupt, Suspend };
+
+  /// Check the deadlines. The deadlines are checked only at function entries
+  /// and loop back-edges, and the arguments locate the guest code for
+  /// sampling. Suspend is returned only if the caller can suspend here.
+  SafePoint
+  checkSafePoint(Runtime::StackManager *StackMgr,
+                 const Runtime::Instance::FunctionInstance *Func,
+                 AST::InstrView::iterator PC, const void *FrameAddress,
+                 bool CanSuspend) noexcept {
+    const uint64_t Now = Epoch::current();
+    if (likely(Now < Deadline.load(std::memory_order_relaxed) &&
+               Now < Preemption.Deadline)) {
+      return SafePoint::Continue;
+    }
+    return handleDeadline(StackMgr, Func, PC, FrameAddress, CanSuspend);
+  }
+  bool isInterrupted(Runtime::StackManager *StackMgr = nullptr,
+                     const Runtime::Instance::FunctionInstance *Func = nullptr,
+                     AST::InstrView::iterator PC = {},
+                     const void *FrameAddress = nullptr) noexcept {
+    return checkSafePoint(StackMgr, Func, PC, FrameAddress, false) ==
+           SafePoint::Interrupt;
+  }
+
+  /// Lower the deadline for the slow path if any suspension is requested, or
+  /// restore it to the timeout.
+  void restoreDeadline() noexcept {
+    Deadline.store(PendingSuspends.load(std::memory_order_relaxed) > 0
+                       ? 0
+                       : Timeout.load(std::memory_order_relaxed),
+                   std::memory_order_relaxed);
+  }
+
+  /// Clear the suspension request of the continuation.
+  void consumeSuspendRequest(Continuation &Cont) noexcept {
+    if (Cont.SuspendRequested.exchange(false) &&
+        PendingSuspends.fetch_sub(1) == 1) {
+      restoreDeadline();
+    }
+  }
+
+  /// Take the requested profiling sample, consume the reached timeout, and
+  /// check the slice of the running continuation.
+  SafePoint handleDeadline(Runtime::StackManager *StackMgr,
+                           const Runtime::Instance::FunctionInstance *Func,
+                           AST::InstrView::iterator PC,
+                           const void *FrameAddress,
+                           bool CanSuspend = false) noexcept;
+
+  /// \name Helper functions for gas metering.
+  /// The gas of the current thread is charged into a non-atomic per-thread
+  /// counter against a budget reserved in chunks from the total cost in the
+  /// statistics, so the threads sharing the statistics never exceed the cost
+  /// limit together. The unused reservation is given back at host function
+  /// boundaries and when leaving the executor.
+  /// @{
+  /// End of the gas counter window which the reservations are placed before.
+  static inline constexpr uint64_t kGasWindowEnd = UINT64_C(1) << 62;
+  /// Gas reserved from the statistics at once.
+  static inline constexpr uint64_t kGasChunk = UINT64_C(1) << 16;
+  /// Charge the gas counter of the current thread.
+  bool chargeGas(uint64_t Cost) noexcept {
+    if (unlikely(Cost > Preemption.GasLimit - ThreadGas)) {
+      return chargeGasSlow(Cost);
+    }
+    ThreadGas += Cost;
+    return true;
+  }
+  /// Reserve more gas when the reservation of the current thread is used up,
+  /// and request the suspension when the fuel of the slice is used up.
+  bool chargeGasSlow(uint64_t Cost) noexcept;
+  /// Refund the gas counter of the current thread.
+  void refundGas(uint64_t Cost) noexcept {
+    ThreadGas -= std::min(ThreadGas - GasBase, Cost);
+  }
+  /// Drop the gas reservation of the current thread without giving it back.
+  void resetGasBudget() noexcept;
+  /// Give the unused gas reservation of the current thread back to the
+  /// statistics, and charge the used one from the fuel of the slice.
+  void flushGas() noexcept;
+  /// @}
+
   /// Run Wasm function.
   Expect<void> runFunction(Runtime::StackManager &StackMgr,
                            const Runtime::Instance::FunctionInstance &Func,
@@ -169,7 +376,8 @@ private:
   /// Instantiation of Module Instance.
   Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
   instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
-              std::optional<std::string_view> Name = std::nullopt);
+              std::optional<std::string_view> Name = std::nullopt,
+              std::shared_ptr<const AST::Module> SharedMod = nullptr);
 
   /// Instantiation of Imports.
   Expect<void> instantiate(Runtime::StoreManager &StoreMgr,
@@ -225,6 +433,17 @@ private:
                 const Runtime::Instance::FunctionInstance &Func,
                 const AST::InstrView::iterator RetIt, bool IsTailCall = false);
 
+  /// Helper function for running host functions with the statistics.
+  Expect<void> runHostFunction(const Runtime::CallingFrame &CallFrame,
+                               const Runtime::Instance::FunctionInstance &Func,
+                               Span<const ValVariant> Args,
+                               Span<ValVariant> Rets);
+
+  /// Helper function for calling functions from compiled code.
+  Expect<void> callFunction(Runtime::StackManager &StackMgr,
+                            const Runtime::Instance::FunctionInstance &Func,
+                            const ValVariant *Args, ValVariant *Rets) noexcept;
+
   /// Helper function for branching to label.
   Expect<void> branchToLabel(Runtime::StackManager &StackMgr,
                              uint32_t EraseBegin, uint32_t EraseEnd,
@@ -232,6 +451,25 @@ private:
                              AST::InstrView::iterator &PC) noexcept;
   /// @}
 
+  /// Update the memory pointers of a module instance read by the compiled
+  /// code, since growing a memory may move it.
+  static void
+  refreshMemoryPtrs(Runtime::Instance::ModuleInstance &ModInst) noexcept;
+
+  /// \name Helper Functions for the execution profile.
+  /// @{
+  /// Allocate the counters of the functions and the branches of a module
+  /// instance.
+  void registerPGOModule(Runtime::Instance::ModuleInstance &ModInst);
+
+  /// Count the entry of a native function.
+  void countPGOEntry(const Runtime::Instance::FunctionInstance &Func) noexcept;
+
+  /// Count the target of a branch instruction in the current module.
+  void countPGOBranch(const Runtime::StackManager &StackMgr,
+                      const AST::Instruction &Instr, uint32_t Target) noexcept;
+  /// @}
+
   /// \name Helper Functions for getting instances.
   /// @{
   /// Helper function for get table instance by index.
@@ -568,6 +806,11 @@ private:
 public:
   Expect<void> trap(Runtime::StackManager &StackMgr,
                     const uint32_t Code) noexcept;
+  Expect<void> checkDeadline(Runtime::StackManager &StackMgr,
+                             const uint32_t FuncIdx,
+                             const void *FrameAddress) noexcept;
+  Expect<void> refillGas(Runtime::StackManager &StackMgr,
+                         const uint64_t Cost) noexcept;
   Expect<void> call(Runtime::StackManager &StackMgr, const uint32_t FuncIdx,
                     const ValVariant *Args, ValVariant *Rets) noexcept;
   Expect<void> callIndirect(Runtime::StackManager &StackMgr,
@@ -661,17 +904,109 @@ private:
     ValVariant *const *Globals;
     std::atomic_uint64_t *InstrCount;
     uint64_t *CostTable;
-    std::atomic_uint64_t *Gas;
+    uint64_t *Gas;
     uint64_t GasLimit;
-    std::atomic_uint32_t *StopToken;
+    const std::atomic_uint64_t *EpochCounter;
+    std::atomic_uint64_t *Deadline;
+  };
+
+  /// RAII helper for switching the execution context of compiled functions.
+  struct SavedExecutionContext {
+    SavedExecutionContext(Runtime::StackManager &StackMgr,
+                          uint8_t *const *Memories,
+                          ValVariant *const *Globals) noexcept
+        : SavedStack(CurrentStack), SavedMemories(ExecutionContext.Memories),
+          SavedGlobals(ExecutionContext.Globals),
+          SavedStackEnd(CompiledStackEnd) {
+      CurrentStack = &StackMgr;
+      ExecutionContext.Memories = Memories;
+      ExecutionContext.Globals = Globals;
+      // This object lives in the frame calling the compiled code, so the
+      // compiled frames are below it.
+      CompiledStackEnd = this;
+    }
+    ~SavedExecutionContext() noexcept {
+      CurrentStack = SavedStack;
+      ExecutionContext.Memories = SavedMemories;
+      ExecutionContext.Globals = SavedGlobals;
+      CompiledStackEnd = SavedStackEnd;
+    }
+    Runtime::StackManager *SavedStack;
+    uint8_t *const *SavedMemories;
+    ValVariant *const *SavedGlobals;
+    const void *SavedStackEnd;
+  };
+
+  /// Preemption state of the continuation running on the current thread.
+  struct PreemptionContext {
+    /// The outermost interpreter loop of a continuation is running, and no
+    /// compiled or host function is on the way, so the safe points can
+    /// suspend the execution.
+    bool Suspendable = false;
+    /// The slice is used up and the suspension is pending.
+    bool Requested = false;
+    /// Deadline in epochs of the slice.
+    uint64_t Deadline = Epoch::kNever;
+    /// Fuel of the slice not charged into the thread gas counter yet.
+    uint64_t Fuel = UINT64_MAX;
+    /// Limit of the thread gas counter for the interpreter, which is the gas
+    /// limit bounded by the fuel of the slice.
+    uint64_t GasLimit = 0;
+    /// Instruction to resume from after being suspended.
+    AST::InstrView::iterator ResumePC = {};
+    /// Host function which suspended the execution and is called again when
+    /// resumed. The ResumePC is its return position.
+    const Runtime::Instance::FunctionInstance *ResumeHost = nullptr;
+    /// The running continuation.
+    Continuation *Current = nullptr;
+  };
+
+  /// RAII helper for running compiled or host functions, which cannot be
+  /// suspended in the middle.
+  struct SavedSuspendable {
+    SavedSuspendable() noexcept : Saved(Preemption.Suspendable) {
+      Preemption.Suspendable = false;
+    }
+    ~SavedSuspendable() noexcept { Preemption.Suspendable = Saved; }
+    bool Saved;
+  };
+
+  /// RAII helper for switching the current thread to run a continuation.
+  struct SavedThreadState {
+    SavedThreadState() noexcept
+        : SavedThis(This), SavedContext(ExecutionContext),
+          SavedGas(ThreadGas), SavedGasBase(GasBase),
+          SavedPreemption(Preemption) {}
+    ~SavedThreadState() noexcept {
+      This = SavedThis;
+      ExecutionContext = SavedContext;
+      ThreadGas = SavedGas;
+      GasBase = SavedGasBase;
+      Preemption = SavedPreemption;
+    }
+    Executor *SavedThis;
+    ExecutionContextStruct SavedContext;
+    uint64_t SavedGas;
+    uint64_t SavedGasBase;
+    PreemptionContext SavedPreemption;
   };
 
   /// Pointer to current object.
   static thread_local Executor *This;
   /// Stack for passing into compiled functions
   static thread_local Runtime::StackManager *CurrentStack;
+  /// End of the native stack range of the innermost compiled functions
+  static thread_local const void *CompiledStackEnd;
   /// Execution context for compiled functions
   static thread_local ExecutionContextStruct ExecutionContext;
+  /// Gas counter of the current thread. The gas reserved from the statistics
+  /// spans from GasBase to the GasLimit in the execution context, which stays
+  /// constant because compiled functions read it once at their entries.
+  static thread_local uint64_t ThreadGas;
+  /// Gas counter value at which the current reservation starts
+  static thread_local uint64_t GasBase;
+  /// Preemption state of the current thread
+  static thread_local PreemptionContext Preemption;
   /// @}
 
 private:
@@ -679,8 +1014,25 @@ private:
   const Configure Conf;
   /// Executor statistics
   Statistics::Statistics *Stat;
-  /// Stop Execution
-  std::atomic_uint32_t StopToken = 0;
+  /// Deadline in epochs for entering the slow path of the deadline checks
+  std::atomic_uint64_t Deadline = Epoch::kNever;
+  /// Deadline in epochs for interrupting the execution
+  std::atomic_uint64_t Timeout = Epoch::kNever;
+  /// The timeout keeps the epoch timer armed
+  std::atomic_bool TimeoutArmed = false;
+  /// Sampling profiler
+  Profiler *Prof = nullptr;
+  /// Pending profiling sample request
+  std::atomic_bool SampleRequested = false;
+  /// Number of continuations with a pending suspension request
+  std::atomic_uint32_t PendingSuspends = 0;
+  /// Execution profile, which is only checked for being set when running
+  std::atomic<PGO::Profile *> PGOProf = nullptr;
+  std::mutex PGOMutex;
+  /// Generation of the attached profile, which the counters belong to
+  std::atomic_uint64_t PGOGeneration = 0;
+  /// Counters of the modules registered to the attached profile
+  std::vector<std::shared_ptr<PGOCounters>> PGOTables;
 };
 
 } // namespace Executor
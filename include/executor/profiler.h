@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/executor/profiler.h - Sampling profiler definition -------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the sampling profiler for guest code.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "ast/instruction.h"
+#include "ast/module.h"
+#include "runtime/instance/module.h"
+#include "runtime/stackmgr.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace WasmEdge {
+namespace Executor {
+
+/// Sampling profiler for guest functions.
+///
+/// A sampling thread periodically requests a sample from the executor. The
+/// executor takes the sample at the next function entry or loop back-edge,
+/// where it checks its deadline. Interpreted frames are resolved from the
+/// frame stack, and compiled frames by walking the frame pointers of
+/// interruptible AOT code. Samples are aggregated per guest function, named
+/// from the name section.
+class Profiler {
+public:
+  Profiler(std::chrono::nanoseconds Interval = std::chrono::milliseconds(10))
+      : Interval(Interval) {}
+  ~Profiler() noexcept { stop(); }
+
+  /// Start the sampling thread which calls the request function periodically.
+  void start(std::function<void()> Request);
+
+  /// Stop the sampling thread.
+  void stop() noexcept;
+
+  /// Register the functions of an instantiated module. The name section of the
+  /// AST module, if any, is used for naming the functions.
+  void registerModule(const Runtime::Instance::ModuleInstance &ModInst,
+                      const AST::Module *Mod = nullptr);
+
+  /// Record a sample of the guest call stack.
+  /// \param StackMgr the stack manager of the sampled thread.
+  /// \param Func the function on the top of stack if it has not pushed frame.
+  /// \param PC the instruction executed by the interpreter, if any.
+  /// \param FrameAddress the frame address of the compiled code, if any.
+  /// \param StackEnd the end of the native stack range holding the frames of
+  /// the compiled code, which bounds the frame walk.
+  void addSample(const Runtime::StackManager &StackMgr,
+                 const Runtime::Instance::FunctionInstance *Func,
+                 AST::InstrView::iterator PC, const void *FrameAddress,
+                 const void *StackEnd);
+
+  /// Getter of the total sample count.
+  uint64_t getSampleCount() const noexcept;
+
+  /// Dump the samples in the folded stack format.
+  void dumpFolded(std::ostream &OS) const;
+
+  /// Dump the samples in the pprof protocol buffer format.
+  void dumpPprof(std::ostream &OS) const;
+
+private:
+  const Runtime::Instance::FunctionInstance *
+  findFunction(const AST::Instruction *Instr) const noexcept;
+  const Runtime::Instance::FunctionInstance *
+  findFunction(uintptr_t Address) const noexcept;
+  uint32_t getFunctionId(const Runtime::Instance::FunctionInstance *Func);
+  uint32_t addName(std::string Name);
+
+  /// \name Data of profiler.
+  /// @{
+  const std::chrono::nanoseconds Interval;
+  mutable std::mutex Mutex;
+  /// Instruction ranges of interpreted functions, keyed by the range end.
+  std::map<const AST::Instruction *,
+           std::pair<const AST::Instruction *,
+                     const Runtime::Instance::FunctionInstance *>>
+      InstrRanges;
+  /// Code ranges of compiled functions and wrappers, keyed by the range end.
+  /// The wrappers are mapped to nullptr to end the frame walks.
+  std::map<uintptr_t,
+           std::pair<uintptr_t, const Runtime::Instance::FunctionInstance *>>
+      CodeRanges;
+  /// Interned function names.
+  std::unordered_map<const Runtime::Instance::FunctionInstance *, uint32_t>
+      FuncIds;
+  std::vector<std::string> Names;
+  std::unordered_map<std::string, uint32_t> NameIds;
+  /// Sample counts keyed by the function ids from the leaf to the root.
+  std::map<std::vector<uint32_t>, uint64_t> Samples;
+  /// Sampling thread.
+  std::thread Thread;
+  std::condition_variable Cond;
+  bool Done = false;
+  std::chrono::steady_clock::duration Duration{};
+  /// @}
+};
+
+} // namespace Executor
+} // namespace WasmEdge
@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -96,6 +97,9 @@ public:
   /// Jump the content with size (size + content).
   Expect<void> jumpContent();
 
+  /// Get the mapping of the file, or nullptr if not loaded from a file.
+  std::shared_ptr<const MMap> getFileMap() const noexcept { return FileMap; }
+
   /// Change the access position of the file.
   void seek(uint64_t NewPos) {
     if (Status != ErrCode::Value::IllegalPath) {
@@ -140,7 +144,7 @@ private:
 
   /// File or data management.
   const Byte *Data;
-  std::optional<MMap> FileMap;
+  std::shared_ptr<MMap> FileMap;
   std::optional<std::vector<Byte>> DataHolder;
 };
 
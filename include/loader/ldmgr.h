@@ -42,6 +42,9 @@ public:
     return Library->get<T>(Name);
   }
 
+  /// Get the loaded text sections.
+  auto getTexts() const noexcept { return Library->getTexts(); }
+
 private:
   std::shared_ptr<Loader::SharedLibrary> Library;
   const void *Intrinsics;
@@ -94,6 +94,10 @@ public:
   /// Parse module from byte code.
   Expect<std::unique_ptr<AST::Module>> parseModule(Span<const uint8_t> Code);
 
+  /// Load the code in the AOT section of the module, such as the one compiled
+  /// in memory by the AOT compiler, and set the symbols into the module.
+  Expect<void> loadAOTSection(AST::Module &Mod);
+
 private:
   /// \name Helper functions to print error log when loading AST nodes
   /// @{
@@ -122,6 +126,7 @@ private:
   /// @{
   Expect<std::unique_ptr<AST::Module>> loadModule();
   Expect<void> loadCompiled(AST::Module &Mod);
+  void writePerfMap(const AST::Module &Mod, const SharedLibrary &Library);
   /// @}
 
   /// \name Load AST section node helper functions
@@ -187,6 +192,7 @@ private:
   Expect<void> loadSection(AST::DataSection &Sec);
   Expect<void> loadSection(AST::DataCountSection &Sec);
   static Expect<void> loadSection(FileMgr &VecMgr, AST::AOTSection &Sec);
+  static Expect<void> loadSection(FileMgr &VecMgr, AST::NameSection &Sec);
   Expect<void> loadSegment(AST::GlobalSegment &GlobSeg);
   Expect<void> loadSegment(AST::ElementSegment &ElemSeg);
   Expect<void> loadSegment(AST::CodeSegment &CodeSeg);
@@ -22,6 +22,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #if WASMEDGE_OS_WINDOWS
@@ -80,6 +81,11 @@ public:
     return Result;
   }
 
+  /// Getter of the loaded text sections.
+  Span<const std::pair<const uint8_t *, uint64_t>> getTexts() const noexcept {
+    return Texts;
+  }
+
   template <typename T> std::vector<Symbol<T>> getCodes() noexcept {
     std::vector<Symbol<T>> Result;
     if (Binary) {
@@ -100,6 +106,7 @@ private:
   uint64_t IntrinsicsAddress = 0;
   std::vector<uintptr_t> TypesAddress;
   std::vector<uintptr_t> CodesAddress;
+  std::vector<std::pair<const uint8_t *, uint64_t>> Texts;
 };
 
 } // namespace Loader
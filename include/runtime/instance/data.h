@@ -37,6 +37,9 @@ public:
   /// Clear data in data instance.
   void clear() { Data.clear(); }
 
+  /// Reset data in data instance.
+  void reset(Span<const Byte> Init) { Data.assign(Init.begin(), Init.end()); }
+
 private:
   /// \name Data of data instance.
   /// @{
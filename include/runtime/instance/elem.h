@@ -41,6 +41,11 @@ public:
   /// Clear references in element instance.
   void clear() { Refs.clear(); }
 
+  /// Reset references in element instance.
+  void reset(Span<const RefVariant> Init) {
+    Refs.assign(Init.begin(), Init.end());
+  }
+
 private:
   /// \name Data of element instance.
   /// @{
@@ -14,9 +14,11 @@
 #pragma once
 
 #include "ast/instruction.h"
+#include "ast/segment.h"
 #include "common/symbol.h"
 #include "runtime/hostfunc.h"
 
+#include <atomic>
 #include <memory>
 #include <numeric>
 #include <string>
@@ -43,11 +45,17 @@ public:
                    AST::InstrView Expr) noexcept
       : ModInst(Mod), FuncType(Type),
         Data(std::in_place_type_t<WasmFunction>(), Locs, Expr) {}
+  /// Constructor for native function referring to the code segment of a
+  /// shared module, which should outlive this function instance.
+  FunctionInstance(const ModuleInstance *Mod, const AST::FunctionType &Type,
+                   const AST::CodeSegment &Code) noexcept
+      : ModInst(Mod), FuncType(Type),
+        Data(std::in_place_type_t<WasmFunction>(), Code) {}
   /// Constructor for compiled function.
   FunctionInstance(const ModuleInstance *Mod, const AST::FunctionType &Type,
                    Symbol<CompiledFunction> S) noexcept
       : ModInst(Mod), FuncType(Type),
-        Data(std::in_place_type_t<Symbol<CompiledFunction>>(), std::move(S)) {}
+        Data(std::in_place_type_t<CompiledCode>(), std::move(S)) {}
   /// Constructor for host function.
   FunctionInstance(const ModuleInstance *Mod,
                    std::unique_ptr<HostFunctionBase> &&Func) noexcept
@@ -62,7 +70,7 @@ public:
 
   /// Getter of checking is compiled function.
   bool isCompiledFunction() const noexcept {
-    return std::holds_alternative<Symbol<CompiledFunction>>(Data);
+    return std::holds_alternative<CompiledCode>(Data);
   }
 
   /// Getter of checking is host function.
@@ -97,7 +105,30 @@ public:
 
   /// Getter of symbol
   auto &getSymbol() const noexcept {
-    return *std::get_if<Symbol<CompiledFunction>>(&Data);
+    return std::get_if<CompiledCode>(&Data)->Code;
+  }
+
+  /// Getter of the entry of the compiled function, which is the upgraded code
+  /// once the function is upgraded.
+  CompiledFunction *getCompiledEntry() const noexcept {
+    return std::get_if<CompiledCode>(&Data)->Entry.load(
+        std::memory_order_acquire);
+  }
+
+  /// Upgrade the compiled function to the code of the same function compiled
+  /// by another tier, which takes effect at the following calls. The previous
+  /// code stays loaded, because it may be still running. A function can be
+  /// upgraded only once. Return false if not upgraded.
+  bool upgradeSymbol(Symbol<CompiledFunction> S) noexcept {
+    auto *Compiled = std::get_if<CompiledCode>(&Data);
+    if (!Compiled || !S ||
+        Compiled->IsUpgraded.exchange(true, std::memory_order_acq_rel)) {
+      return false;
+    }
+    Compiled->UpgradedCode = std::move(S);
+    Compiled->Entry.store(Compiled->UpgradedCode.get(),
+                          std::memory_order_release);
+    return true;
   }
 
   /// Getter of host function.
@@ -107,23 +138,58 @@ public:
 
 private:
   struct WasmFunction {
-    const std::vector<std::pair<uint32_t, ValType>> Locals;
+    /// Copies of the locals and the instructions. Empty if referring to the
+    /// code segment of a shared module.
+    std::vector<std::pair<uint32_t, ValType>> OwnedLocals;
+    AST::InstrVec OwnedInstrs;
+    const Span<const std::pair<uint32_t, ValType>> Locals;
     const uint32_t LocalNum;
-    AST::InstrVec Instrs;
+    const AST::InstrView Instrs;
     WasmFunction(Span<const std::pair<uint32_t, ValType>> Locs,
                  AST::InstrView Expr) noexcept
-        : Locals(Locs.begin(), Locs.end()),
-          LocalNum(
-              std::accumulate(Locals.begin(), Locals.end(), UINT32_C(0),
-                              [](uint32_t N, const auto &Pair) -> uint32_t {
-                                return N + Pair.first;
-                              })) {
-      // FIXME: Modify the capacity to prevent from connection of 2 vectors.
+        : OwnedLocals(Locs.begin(), Locs.end()),
+          OwnedInstrs(reserveInstrs(Expr)), Locals(OwnedLocals),
+          LocalNum(countLocals(Locals)), Instrs(OwnedInstrs) {}
+    WasmFunction(const AST::CodeSegment &Code) noexcept
+        : Locals(Code.getLocals()), LocalNum(countLocals(Locals)),
+          Instrs(Code.getExpr().getInstrs()) {}
+    /// Moving the vectors keeps their buffers, so the views stay valid.
+    WasmFunction(WasmFunction &&F) noexcept
+        : OwnedLocals(std::move(F.OwnedLocals)),
+          OwnedInstrs(std::move(F.OwnedInstrs)), Locals(F.Locals),
+          LocalNum(F.LocalNum), Instrs(F.Instrs) {}
+
+    static AST::InstrVec reserveInstrs(AST::InstrView Expr) noexcept {
+      // Keep a spare slot. See "include/ast/expression.h".
+      AST::InstrVec Instrs;
       Instrs.reserve(Expr.size() + 1);
       Instrs.assign(Expr.begin(), Expr.end());
+      return Instrs;
+    }
+    static uint32_t
+    countLocals(Span<const std::pair<uint32_t, ValType>> Locs) noexcept {
+      return std::accumulate(Locs.begin(), Locs.end(), UINT32_C(0),
+                             [](uint32_t N, const auto &Pair) -> uint32_t {
+                               return N + Pair.first;
+                             });
     }
   };
 
+  struct CompiledCode {
+    /// The loaded code and the upgraded code, which is published through the
+    /// entry.
+    Symbol<CompiledFunction> Code;
+    Symbol<CompiledFunction> UpgradedCode;
+    std::atomic<CompiledFunction *> Entry;
+    std::atomic<bool> IsUpgraded = false;
+    CompiledCode(Symbol<CompiledFunction> S) noexcept
+        : Code(std::move(S)), Entry(Code.get()) {}
+    CompiledCode(CompiledCode &&C) noexcept
+        : Code(std::move(C.Code)), UpgradedCode(std::move(C.UpgradedCode)),
+          Entry(C.Entry.load(std::memory_order_relaxed)),
+          IsUpgraded(C.IsUpgraded.load(std::memory_order_relaxed)) {}
+  };
+
   friend class ModuleInstance;
   void setModule(const ModuleInstance *Mod) noexcept { ModInst = Mod; }
 
@@ -131,8 +197,7 @@ private:
   /// @{
   const ModuleInstance *ModInst;
   const AST::FunctionType &FuncType;
-  std::variant<WasmFunction, Symbol<CompiledFunction>,
-               std::unique_ptr<HostFunctionBase>>
+  std::variant<WasmFunction, CompiledCode, std::unique_ptr<HostFunctionBase>>
       Data;
   /// @}
 };
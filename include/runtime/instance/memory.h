@@ -116,6 +116,23 @@ public:
     return true;
   }
 
+  /// Zero the memory and shrink it back to the given page count, which must
+  /// not exceed the current one.
+  bool resetPage(const uint32_t Count) noexcept {
+    const uint32_t Min = MemType.getLimit().getMin();
+    if (Count > Min) {
+      return false;
+    }
+    if (auto NewPtr = Allocator::reset(DataPtr, Min, Count);
+        NewPtr == nullptr) {
+      return false;
+    } else {
+      DataPtr = NewPtr;
+    }
+    MemType.getLimit().setMin(Count);
+    return true;
+  }
+
   /// Get slice of Data[Offset : Offset + Length - 1]
   Expect<Span<Byte>> getBytes(uint32_t Offset, uint32_t Length) const noexcept {
     // Check the memory boundary.
@@ -241,14 +258,17 @@ public:
   /// \param Value the constructed output value.
   /// \param Offset the start offset in data array.
   ///
+  /// The memory boundary check is skipped if CheckBound is false, which is
+  /// only for the accesses proven in bounds.
+  ///
   /// \returns void when success, ErrCode when failed.
-  template <typename T, uint32_t Length = sizeof(T)>
+  template <typename T, uint32_t Length = sizeof(T), bool CheckBound = true>
   typename std::enable_if_t<IsWasmNumV<T>, Expect<void>>
   loadValue(T &Value, uint32_t Offset) const noexcept {
     // Check the data boundary.
     static_assert(Length <= sizeof(T));
     // Check the memory boundary.
-    if (unlikely(!checkAccessBound(Offset, Length))) {
+    if (CheckBound && unlikely(!checkAccessBound(Offset, Length))) {
       spdlog::error(ErrCode::Value::MemoryOutOfBounds);
       spdlog::error(ErrInfo::InfoBoundary(Offset, Length, getBoundIdx()));
       return Unexpect(ErrCode::Value::MemoryOutOfBounds);
@@ -288,14 +308,17 @@ public:
   /// \param Value the value want to store into data array.
   /// \param Offset the start offset in data array.
   ///
+  /// The memory boundary check is skipped if CheckBound is false, which is
+  /// only for the accesses proven in bounds.
+  ///
   /// \returns void when success, ErrCode when failed.
-  template <typename T, uint32_t Length = sizeof(T)>
+  template <typename T, uint32_t Length = sizeof(T), bool CheckBound = true>
   typename std::enable_if_t<IsWasmNativeNumV<T>, Expect<void>>
   storeValue(const T &Value, uint32_t Offset) noexcept {
     // Check the data boundary.
     static_assert(Length <= sizeof(T));
     // Check the memory boundary.
-    if (unlikely(!checkAccessBound(Offset, Length))) {
+    if (CheckBound && unlikely(!checkAccessBound(Offset, Length))) {
       spdlog::error(ErrCode::Value::MemoryOutOfBounds);
       spdlog::error(ErrInfo::InfoBoundary(Offset, Length, getBoundIdx()));
       return Unexpect(ErrCode::Value::MemoryOutOfBounds);
@@ -24,6 +24,7 @@
 #include "runtime/instance/table.h"
 
 #include <atomic>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
@@ -36,14 +37,25 @@
 
 namespace WasmEdge {
 
+namespace AST {
+class Module;
+}
+
 namespace Executor {
 class Executor;
+class Profiler;
+struct PGOCounters;
+}
+
+namespace AOT {
+class TieredCompiler;
 }
 
 namespace Runtime {
 
 class StoreManager;
 class CallingFrame;
+class ModuleSnapshot;
 
 namespace Instance {
 
@@ -73,6 +85,17 @@ public:
       assuming(Pair.second);
       Pair.second(Pair.first, this);
     }
+    if (DestroyCallback) {
+      DestroyCallback(this);
+    }
+  }
+
+  /// Set the callback before destruction, for the owner which tracks this
+  /// instance without owning it, such as the instance pool.
+  void
+  setDestroyCallback(std::function<void(const ModuleInstance *)> Callback) {
+    std::unique_lock Lock(Mutex);
+    DestroyCallback = std::move(Callback);
   }
 
   std::string_view getModuleName() const noexcept {
@@ -174,12 +197,31 @@ public:
 
 protected:
   friend class Executor::Executor;
+  friend class Executor::Profiler;
+  friend class AOT::TieredCompiler;
   friend class Runtime::CallingFrame;
+  friend class Runtime::ModuleSnapshot;
 
   /// Copy the function types in type section to this module instance.
   void addFuncType(const AST::FunctionType &FuncType) {
     std::unique_lock Lock(Mutex);
-    FuncTypes.emplace_back(FuncType);
+    FuncTypes.push_back(&OwnedFuncTypes.emplace_back(FuncType));
+  }
+
+  /// Refer to the function types in type section of the source module.
+  void addSharedFuncType(const AST::FunctionType &FuncType) {
+    std::unique_lock Lock(Mutex);
+    FuncTypes.push_back(&FuncType);
+  }
+
+  /// Keep the shared source module alive for the instances referring to it.
+  void setSourceModule(std::shared_ptr<const AST::Module> Mod) {
+    std::unique_lock Lock(Mutex);
+    SourceMod = std::move(Mod);
+  }
+  const AST::Module *getSourceModule() const noexcept {
+    std::shared_lock Lock(Mutex);
+    return SourceMod.get();
   }
 
   /// Create and add instances into this module instance.
@@ -253,7 +295,7 @@ protected:
       // Error logging need to be handled in caller.
       return Unexpect(ErrCode::Value::WrongInstanceIndex);
     }
-    return &FuncTypes[Idx];
+    return FuncTypes[Idx];
   }
 
   /// Get instance pointer by index.
@@ -265,6 +307,9 @@ protected:
     }
     return FuncInsts[Idx];
   }
+  FunctionInstance *unsafeGetFunction(uint32_t Idx) const noexcept {
+    return FuncInsts[Idx];
+  }
   Expect<TableInstance *> getTable(uint32_t Idx) const noexcept {
     std::shared_lock Lock(Mutex);
     if (Idx >= TabInsts.size()) {
@@ -419,8 +464,12 @@ protected:
   /// Module name.
   const std::string ModName;
 
+  /// Shared source module, which the functions and function types refer to.
+  std::shared_ptr<const AST::Module> SourceMod;
+
   /// Function types.
-  std::vector<AST::FunctionType> FuncTypes;
+  std::deque<AST::FunctionType> OwnedFuncTypes;
+  std::vector<const AST::FunctionType *> FuncTypes;
 
   /// Owned instances in this module.
   std::vector<std::unique_ptr<Instance::FunctionInstance>> OwnedFuncInsts;
@@ -453,6 +502,12 @@ protected:
   /// Linked store.
   std::map<StoreManager *, std::function<BeforeModuleDestroyCallback>>
       LinkedStore;
+
+  /// Execution counters, set when the executor counts this module.
+  std::shared_ptr<Executor::PGOCounters> PGOCounters;
+
+  /// Callback before destruction.
+  std::function<void(const ModuleInstance *)> DestroyCallback;
 };
 
 } // namespace Instance
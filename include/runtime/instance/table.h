@@ -74,6 +74,12 @@ public:
     return growTable(Count, UnknownRef());
   }
 
+  /// Replace the whole table, including its size, by Init.
+  void resetRefs(Span<const RefVariant> Init) noexcept {
+    Refs.assign(Init.begin(), Init.end());
+    TabType.getLimit().setMin(static_cast<uint32_t>(Refs.size()));
+  }
+
   /// Get slice of Refs[Offset : Offset + Length - 1]
   Expect<Span<const RefVariant>> getRefs(uint32_t Offset,
                                          uint32_t Length) const noexcept {
@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/runtime/snapshot.h - Module snapshot definition ----------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the module instance snapshot, which
+/// rolls module instances back to a captured state without instantiating them
+/// again.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "runtime/instance/module.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+namespace Runtime {
+
+/// Snapshot of the memories, tables, globals, element and data segments
+/// owned by a module instance.
+///
+/// The snapshot can be restored into the instance it was taken from or into
+/// any other instance of the same module. Function references into the source
+/// instance are recorded by function index and rebound to the target. Imported
+/// entities belong to other modules and are left untouched.
+class ModuleSnapshot {
+public:
+  ModuleSnapshot(const Instance::ModuleInstance &ModInst) {
+    std::shared_lock Lock(ModInst.Mutex);
+    std::unordered_map<const Instance::FunctionInstance *, uint32_t> FuncIdx;
+    for (uint32_t I = 0; I < ModInst.FuncInsts.size(); ++I) {
+      FuncIdx.emplace(ModInst.FuncInsts[I], I);
+    }
+    auto Capture = [&FuncIdx](Span<const RefVariant> Refs, bool IsFuncRef) {
+      RefList List;
+      List.Refs.assign(Refs.begin(), Refs.end());
+      if (IsFuncRef) {
+        for (uint32_t I = 0; I < List.Refs.size(); ++I) {
+          if (isNullRef(List.Refs[I])) {
+            continue;
+          }
+          const auto *Func = List.Refs[I].get<FuncRef>().Ptr;
+          if (auto Iter = FuncIdx.find(Func); Iter != FuncIdx.end()) {
+            List.Relocs.emplace_back(I, Iter->second);
+          }
+        }
+      }
+      return List;
+    };
+
+    FuncNum = static_cast<uint32_t>(ModInst.FuncInsts.size());
+    for (const auto &Mem : ModInst.OwnedMemInsts) {
+      Memories.push_back(captureMemory(*Mem));
+    }
+    for (const auto &Tab : ModInst.OwnedTabInsts) {
+      const bool IsFuncRef =
+          Tab->getTableType().getRefType() == RefType::FuncRef;
+      Tables.push_back(
+          Capture(*Tab->getRefs(0, Tab->getSize()), IsFuncRef));
+    }
+    for (const auto &Glob : ModInst.OwnedGlobInsts) {
+      Globals.push_back(Glob->getValue());
+      if (Glob->getGlobalType().getValType() == ValType::FuncRef &&
+          !isNullRef(Glob->getValue())) {
+        const auto *Func = Glob->getValue().get<FuncRef>().Ptr;
+        if (auto Iter = FuncIdx.find(Func); Iter != FuncIdx.end()) {
+          GlobalRelocs.emplace_back(
+              static_cast<uint32_t>(Globals.size() - 1), Iter->second);
+        }
+      }
+    }
+    for (const auto &Elem : ModInst.OwnedElemInsts) {
+      Elems.push_back(
+          Capture(Elem->getRefs(), Elem->getRefType() == RefType::FuncRef));
+    }
+    for (const auto &Data : ModInst.OwnedDataInsts) {
+      const auto Bytes = Data->getData();
+      Datas.emplace_back(Bytes.begin(), Bytes.end());
+    }
+  }
+
+  /// Roll the owned state of the module instance back to this snapshot.
+  /// Returns false if the instance does not match the snapshot layout or the
+  /// memory could not be reset, in which case it should be discarded.
+  ///
+  /// The cost is linear in the memory size plus the snapshot size, whichever
+  /// pages the instance actually wrote: every memory is dropped or zeroed over
+  /// its whole size, then every non-zero chunk of the snapshot is copied back.
+  bool restore(Instance::ModuleInstance &ModInst) const noexcept {
+    std::unique_lock Lock(ModInst.Mutex);
+    if (ModInst.FuncInsts.size() != FuncNum ||
+        ModInst.OwnedMemInsts.size() != Memories.size() ||
+        ModInst.OwnedTabInsts.size() != Tables.size() ||
+        ModInst.OwnedGlobInsts.size() != Globals.size() ||
+        ModInst.OwnedElemInsts.size() != Elems.size() ||
+        ModInst.OwnedDataInsts.size() != Datas.size()) {
+      return false;
+    }
+    auto Rebind = [&ModInst](const RefList &List) {
+      std::vector<RefVariant> Refs = List.Refs;
+      for (const auto &[Pos, Idx] : List.Relocs) {
+        Refs[Pos] = FuncRef(ModInst.FuncInsts[Idx]);
+      }
+      return Refs;
+    };
+
+    for (uint32_t I = 0; I < Memories.size(); ++I) {
+      auto &Mem = *ModInst.OwnedMemInsts[I];
+      if (!Mem.resetPage(Memories[I].PageCount)) {
+        return false;
+      }
+      for (const auto &Seg : Memories[I].Segments) {
+        std::copy(Seg.second.begin(), Seg.second.end(),
+                  Mem.getDataPtr() + Seg.first);
+      }
+    }
+    for (uint32_t I = 0; I < Tables.size(); ++I) {
+      ModInst.OwnedTabInsts[I]->resetRefs(Rebind(Tables[I]));
+    }
+    for (uint32_t I = 0; I < Globals.size(); ++I) {
+      ModInst.OwnedGlobInsts[I]->getValue() = Globals[I];
+    }
+    for (const auto &[Pos, Idx] : GlobalRelocs) {
+      ModInst.OwnedGlobInsts[Pos]->getValue() =
+          FuncRef(ModInst.FuncInsts[Idx]);
+    }
+    for (uint32_t I = 0; I < Elems.size(); ++I) {
+      ModInst.OwnedElemInsts[I]->reset(Rebind(Elems[I]));
+    }
+    for (uint32_t I = 0; I < Datas.size(); ++I) {
+      ModInst.OwnedDataInsts[I]->reset(Datas[I]);
+    }
+    return true;
+  }
+
+private:
+  /// Granularity of the memory capture. Only chunks holding a non-zero byte
+  /// are stored, since a reset memory reads back as zero.
+  static inline constexpr const uint32_t kChunkSize = UINT32_C(4096);
+
+  struct MemoryImage {
+    uint32_t PageCount;
+    /// Offsets and contents of the non-zero ranges.
+    std::vector<std::pair<uint32_t, std::vector<Byte>>> Segments;
+  };
+
+  struct RefList {
+    std::vector<RefVariant> Refs;
+    /// Positions in Refs which point to functions of the module, paired with
+    /// the function index.
+    std::vector<std::pair<uint32_t, uint32_t>> Relocs;
+  };
+
+  static MemoryImage captureMemory(const Instance::MemoryInstance &Mem) {
+    MemoryImage Image{Mem.getPageSize(), {}};
+    const uint8_t *Data = Mem.getDataPtr();
+    const uint64_t Size =
+        static_cast<uint64_t>(Image.PageCount) *
+        Instance::MemoryInstance::kPageSize;
+    uint64_t Begin = 0;
+    bool InSegment = false;
+    for (uint64_t Off = 0; Off < Size; Off += kChunkSize) {
+      const bool IsZero =
+          std::all_of(Data + Off, Data + Off + kChunkSize,
+                      [](uint8_t B) { return B == 0; });
+      if (!IsZero && !InSegment) {
+        Begin = Off;
+        InSegment = true;
+      } else if (IsZero && InSegment) {
+        Image.Segments.emplace_back(
+            static_cast<uint32_t>(Begin),
+            std::vector<Byte>(Data + Begin, Data + Off));
+        InSegment = false;
+      }
+    }
+    if (InSegment) {
+      Image.Segments.emplace_back(static_cast<uint32_t>(Begin),
+                                  std::vector<Byte>(Data + Begin, Data + Size));
+    }
+    return Image;
+  }
+
+  uint32_t FuncNum = 0;
+  std::vector<MemoryImage> Memories;
+  std::vector<RefList> Tables;
+  std::vector<ValVariant> Globals;
+  std::vector<std::pair<uint32_t, uint32_t>> GlobalRelocs;
+  std::vector<RefList> Elems;
+  std::vector<std::vector<Byte>> Datas;
+};
+
+} // namespace Runtime
+} // namespace WasmEdge
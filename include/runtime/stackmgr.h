@@ -110,6 +110,13 @@ public:
     return From;
   }
 
+  /// Unsafe pop top frame and keep the values in it, as if the frame was not
+  /// pushed. The frame must not be pushed for a tail-call.
+  void discardFrame() noexcept {
+    assuming(!FrameStack.empty());
+    FrameStack.pop_back();
+  }
+
   /// Unsafe erase stack.
   void stackErase(uint32_t EraseBegin, uint32_t EraseEnd) noexcept {
     assuming(EraseEnd <= EraseBegin && EraseBegin <= ValueStack.size());
@@ -126,6 +133,9 @@ public:
     return PC;
   }
 
+  /// Getter of the frames from the bottom to the top.
+  Span<const Frame> getFrames() const noexcept { return FrameStack; }
+
   /// Unsafe getter of module address.
   const Instance::ModuleInstance *getModule() const noexcept {
     assuming(!FrameStack.empty());
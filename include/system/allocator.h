@@ -27,6 +27,11 @@ public:
 
   static void release(uint8_t *Pointer, uint32_t PageCount) noexcept;
 
+  /// Zero the first NewPageCount pages and give back the pages after them.
+  /// Resident pages are dropped instead of written when the platform allows.
+  static uint8_t *reset(uint8_t *Pointer, uint32_t OldPageCount,
+                        uint32_t NewPageCount) noexcept;
+
   static uint8_t *allocate_chunk(uint64_t Size) noexcept;
   static void release_chunk(uint8_t *Pointer, uint64_t Size) noexcept;
   static bool set_chunk_executable(uint8_t *Pointer, uint64_t Size) noexcept;
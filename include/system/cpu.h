@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/system/cpu.h - CPU feature detection ---------------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the CPU features which the AOT code can depend on, and
+/// the detection of them on the host.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/span.h"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace WasmEdge {
+
+/// CPU features of the host architecture.
+///
+/// The features are the bits of a mask, named as in the LLVM targets. The AOT
+/// compiler records the mask of the features each code variant is compiled
+/// for, and the loader selects the variant with the most features which are
+/// all supported by the host.
+class CPU {
+public:
+  /// Getter of the feature names, in the order of the bits.
+  static Span<const std::string_view> featureNames() noexcept;
+
+  /// Getter of the features of the host CPU.
+  static uint64_t hostFeatures() noexcept;
+
+  /// Getter of the names of the CPU levels, from the lowest. The levels are
+  /// also the LLVM CPU names, such as `x86-64-v3`.
+  static Span<const std::string_view> levelNames() noexcept;
+
+  /// Getter of the features of a CPU level. Return nullopt for unknown
+  /// levels.
+  static std::optional<uint64_t> levelFeatures(std::string_view Name) noexcept;
+};
+
+} // namespace WasmEdge
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/system/epoch.h - Process-wide epoch counter --------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the epoch counter for cooperative interruption.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace WasmEdge {
+
+/// Process-wide epoch counter advanced by a single timer thread.
+///
+/// Timeouts are expressed as deadlines in epochs and compared against the
+/// counter with plain loads, so any number of instances can be bounded in
+/// time with one timer thread. The timer thread is started when the first
+/// deadline is armed, and parks while no deadline is armed. The counter does
+/// not advance while parked, which only delays the deadlines nobody waits for.
+class Epoch {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// Interval between two epochs.
+  static inline constexpr const std::chrono::milliseconds kTick{1};
+
+  /// Deadline which is never reached.
+  static inline constexpr const uint64_t kNever = UINT64_MAX;
+
+  /// Getter of the epoch counter.
+  static const std::atomic_uint64_t &counter() noexcept { return Counter; }
+
+  /// Getter of the current epoch.
+  static uint64_t current() noexcept {
+    return Counter.load(std::memory_order_relaxed);
+  }
+
+  /// Convert the time point into the first epoch reaching it.
+  static uint64_t deadline(Clock::time_point Timeout) noexcept;
+
+  /// Convert the epoch into the time point at which it is reached.
+  static Clock::time_point timePoint(uint64_t Value) noexcept;
+
+  /// Arm a deadline, which keeps the timer thread advancing the counter until
+  /// the matching disarm().
+  static void arm() noexcept;
+
+  /// Disarm a deadline armed by arm().
+  static void disarm() noexcept;
+
+private:
+  static std::atomic_uint64_t Counter;
+};
+
+} // namespace WasmEdge
@@ -23,6 +23,13 @@ public:
   MMap(const std::filesystem::path &Path) noexcept;
   ~MMap() noexcept;
   void *address() const noexcept;
+  /// Getter of the size of the file when mapped.
+  uint64_t size() const noexcept;
+  /// Replace the pages at the page-aligned pointer by a private executable
+  /// mapping of the file at the page-aligned offset. Returns false if not
+  /// supported or failed.
+  bool mapExecutable(void *Pointer, uint64_t Size,
+                     uint64_t Offset) const noexcept;
   static bool supported() noexcept;
 
 private:
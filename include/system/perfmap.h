@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/system/perfmap.h - Perf map and jitdump writer -----------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the writer of the perf map and jitdump files, which
+/// let the Linux perf tool symbolize the code in anonymous memory.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/span.h"
+
+#include <cstdint>
+#include <string>
+
+namespace WasmEdge {
+
+class PerfMap {
+public:
+  /// Symbol of a code range.
+  struct Entry {
+    const void *Address;
+    uint64_t Size;
+    std::string Name;
+  };
+
+  /// Append the entries to `/tmp/perf-<pid>.map`. Both files are created with
+  /// mode 0600 on the first write, and are not written if the path exists
+  /// before that.
+  static void writePerfMap(Span<const Entry> Entries) noexcept;
+
+  /// Append the code load records with the code bytes to
+  /// `/tmp/jit-<pid>.dump`. The timestamps are in CLOCK_MONOTONIC, so the
+  /// profile should be recorded with `perf record -k mono`.
+  static void writeJitDump(Span<const Entry> Entries) noexcept;
+
+  static bool supported() noexcept;
+};
+
+} // namespace WasmEdge
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/validator/optimizer.h - Optimizer class definition -------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the Optimizer class, which optimizes
+/// the validated functions at the wasm level.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "ast/module.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace WasmEdge {
+namespace Validator {
+
+/// Wasm-level optimizer of the validated functions.
+///
+/// The optimizer rewrites the instructions of the functions in place, before
+/// they are interpreted or compiled. It inlines the tiny leaf functions into
+/// their callers, removes the locals which are never read, folds the integer
+/// constants, removes the unreachable code, and marks the memory accesses
+/// which are covered by a previous access in the same basic block. The
+/// rewritten functions must be validated again, which updates the jumps and
+/// the stack offsets of their instructions.
+class Optimizer {
+public:
+  /// Maximum number of instructions of an inlined function, without the last
+  /// end.
+  static inline constexpr uint32_t kMaxInlineSize = 8;
+
+  /// Upper bound of the encoded size in bytes of an inlinable function body:
+  /// the empty local declarations, kMaxInlineSize instructions of at most 16
+  /// bytes each, and the end.
+  static inline constexpr uint32_t kMaxInlineBodySize =
+      5 + kMaxInlineSize * 16 + 1;
+
+  /// Check whether a function can be inlined into its callers. The function
+  /// has no locals besides the parameters, and at most kMaxInlineSize
+  /// instructions without control instructions or calls.
+  static bool isInlinable(const AST::CodeSegment &CodeSeg) noexcept;
+
+  /// Optimize the functions of the validated module. Return the indices in the
+  /// code section of the changed functions.
+  std::vector<uint32_t> optimize(AST::Module &Mod);
+};
+
+} // namespace Validator
+} // namespace WasmEdge
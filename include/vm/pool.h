@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/vm/pool.h - Module instance pool definition --------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file is the definition class of the module instance pool, which keeps
+/// pre-instantiated instances of one module for request-per-instance serving.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "ast/module.h"
+#include "common/errcode.h"
+#include "executor/executor.h"
+#include "runtime/instance/module.h"
+#include "runtime/snapshot.h"
+#include "runtime/storemgr.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace WasmEdge {
+namespace VM {
+
+/// Pool of instances of a validated module.
+///
+/// The first instance is captured into a snapshot right after instantiation,
+/// including the effects of the start function. Released instances are rolled
+/// back to that snapshot instead of being destroyed, so acquiring one skips
+/// instantiation. The instances share the code of the module. The store and
+/// executor must outlive the pool and every instance acquired from it. An
+/// acquired instance may also be destroyed directly instead of released.
+class InstancePool {
+public:
+  struct Statistics {
+    /// Instances waiting in the pool.
+    uint32_t Idle = 0;
+    /// Instances acquired and not released yet.
+    uint32_t InUse = 0;
+    /// Acquisitions served from the pool and by a new instantiation.
+    uint64_t Hits = 0;
+    uint64_t Misses = 0;
+    /// Released instances rolled back, and the ones dropped on failure.
+    uint64_t Resets = 0;
+    uint64_t Discards = 0;
+    /// Accumulated wall time of instantiations and resets.
+    uint64_t InstantiateNanos = 0;
+    uint64_t ResetNanos = 0;
+  };
+
+  InstancePool(Executor::Executor &Exec, Runtime::StoreManager &Store,
+               std::shared_ptr<const AST::Module> Mod,
+               uint32_t Capacity) noexcept
+      : ExecutorEngine(Exec), StoreRef(Store), Mod(std::move(Mod)),
+        Capacity(Capacity) {}
+
+  /// Instantiate instances until the pool holds its capacity of idle ones.
+  Expect<void> fill();
+
+  /// Take an instance from the pool, or instantiate one if the pool is empty.
+  Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>> acquire();
+
+  /// Roll an acquired instance back and put it into the pool. Instances not
+  /// acquired from this pool, failing to reset, or released when the pool
+  /// already holds its capacity of idle ones are destroyed.
+  void release(std::unique_ptr<Runtime::Instance::ModuleInstance> ModInst);
+
+  /// Getter of the pool statistics.
+  Statistics getStatistics() const;
+
+private:
+  /// The acquired instances, which outlives the pool for the instances
+  /// destroyed after it.
+  struct AcquiredSet {
+    std::mutex Mutex;
+    std::unordered_set<const Runtime::Instance::ModuleInstance *> Instances;
+  };
+
+  Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>> instantiate();
+  void markAcquired(const Runtime::Instance::ModuleInstance *ModInst);
+
+  Executor::Executor &ExecutorEngine;
+  Runtime::StoreManager &StoreRef;
+  const std::shared_ptr<const AST::Module> Mod;
+  const uint32_t Capacity;
+
+  mutable std::mutex Mutex;
+  std::unique_ptr<const Runtime::ModuleSnapshot> Snapshot;
+  const std::shared_ptr<AcquiredSet> Acquired =
+      std::make_shared<AcquiredSet>();
+  std::vector<std::unique_ptr<Runtime::Instance::ModuleInstance>> Idle;
+  Statistics Stat;
+};
+
+} // namespace VM
+} // namespace WasmEdge
@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/vm/scheduler.h - Guest scheduler definition --------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file is the definition class of the scheduler, which runs function
+/// invocations of many guests as preemptible tasks on a fixed worker pool.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+#include "common/span.h"
+#include "common/types.h"
+#include "executor/continuation.h"
+#include "executor/executor.h"
+#include "vm/vm.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+namespace VM {
+
+/// Scheduler of guest function invocations.
+///
+/// Each submitted invocation becomes a task owning a continuation. The workers
+/// resume the ready tasks for a slice bounded by the quantum in time and by the
+/// fuel in gas, and put the suspended ones back into the ready queue. Tasks of
+/// higher priority run first. Tasks of the same priority are ordered by the
+/// weighted run time of their tenants, so that the tenants share the workers in
+/// proportion to their weights. Only the interpreter can be preempted. The
+/// executors and the module instances of the tasks must outlive the scheduler.
+class Scheduler {
+public:
+  struct Options {
+    /// Number of worker threads.
+    uint32_t Workers = 1;
+    /// Time slice of a task.
+    std::chrono::nanoseconds Quantum = std::chrono::milliseconds(10);
+    /// Gas slice of a task. Effective only if the executor of the task has
+    /// the cost measuring enabled.
+    uint64_t Fuel = UINT64_MAX;
+  };
+
+  struct Statistics {
+    /// Submitted, returned and failed tasks.
+    uint64_t Submitted = 0;
+    uint64_t Finished = 0;
+    uint64_t Failed = 0;
+    /// Slices run and the ones ended with a suspension.
+    uint64_t Slices = 0;
+    uint64_t Suspends = 0;
+  };
+
+  class Task {
+  public:
+    /// Block until the task finished, and get the return values.
+    Expect<std::vector<std::pair<ValVariant, ValType>>> wait() const;
+
+    /// Check whether the task finished.
+    bool isFinished() const noexcept;
+
+    /// Getter of the number of slices run.
+    uint64_t getSliceCount() const noexcept;
+
+    /// Getter of the accumulated run time on the workers.
+    std::chrono::nanoseconds getRunTime() const noexcept;
+
+    /// Getter of the tenant and the priority.
+    uint32_t getTenant() const noexcept { return Tenant; }
+    int32_t getPriority() const noexcept { return Priority; }
+
+  private:
+    friend class Scheduler;
+
+    Task(Executor::Executor &Exec,
+         std::unique_ptr<Executor::Continuation> Cont, uint32_t Tenant,
+         int32_t Priority) noexcept
+        : Exec(Exec), Cont(std::move(Cont)), Tenant(Tenant),
+          Priority(Priority) {}
+
+    void finish(ErrCode Code) noexcept;
+
+    Executor::Executor &Exec;
+    std::unique_ptr<Executor::Continuation> Cont;
+    const uint32_t Tenant;
+    const int32_t Priority;
+
+    mutable std::mutex Mutex;
+    mutable std::condition_variable Cond;
+    bool Finished = false;
+    ErrCode Result;
+    uint64_t Slices = 0;
+    std::chrono::nanoseconds RunTime{0};
+  };
+
+  Scheduler() : Scheduler(Options{}) {}
+  explicit Scheduler(const Options &Opts);
+  ~Scheduler() noexcept;
+
+  /// Set the share of a tenant. Tenants default to the weight 1.
+  void setTenantWeight(uint32_t Tenant, uint32_t Weight);
+
+  /// Submit the invocation of a function.
+  Expect<std::shared_ptr<Task>>
+  submit(Executor::Executor &Exec,
+         const Runtime::Instance::FunctionInstance &Func,
+         Span<const ValVariant> Params, Span<const ValType> ParamTypes,
+         uint32_t Tenant = 0, int32_t Priority = 0);
+
+  /// Submit the invocation of a function exported by the active module.
+  Expect<std::shared_ptr<Task>>
+  submit(VM &TargetVM, std::string_view Func, Span<const ValVariant> Params,
+         Span<const ValType> ParamTypes, uint32_t Tenant = 0,
+         int32_t Priority = 0);
+
+  /// Getter of the scheduler statistics.
+  Statistics getStatistics() const;
+
+private:
+  std::shared_ptr<Task> submit(Executor::Executor &Exec,
+                               std::unique_ptr<Executor::Continuation> Cont,
+                               uint32_t Tenant, int32_t Priority);
+
+  /// Weighted run time is kept in nanoseconds divided by the weight, scaled up
+  /// to keep the precision for heavy tenants.
+  static inline constexpr const uint64_t kWeightScale = UINT64_C(1024);
+
+  struct TenantState {
+    uint32_t Weight = 1;
+    uint64_t VRuntime = 0;
+  };
+
+  struct Entry {
+    int32_t Priority;
+    uint64_t VRuntime;
+    uint64_t Seq;
+    std::shared_ptr<Task> T;
+    bool operator<(const Entry &Other) const noexcept {
+      if (Priority != Other.Priority) {
+        return Priority > Other.Priority;
+      }
+      if (VRuntime != Other.VRuntime) {
+        return VRuntime < Other.VRuntime;
+      }
+      return Seq < Other.Seq;
+    }
+  };
+
+  /// Put the task into the ready queue. The lock must be held.
+  void enqueue(std::shared_ptr<Task> T);
+
+  void runWorker();
+
+  const Options Opts;
+
+  mutable std::mutex Mutex;
+  std::condition_variable Cond;
+  bool Stopped = false;
+  uint64_t NextSeq = 0;
+  /// Weighted run time of the latest dispatched task. Tenants becoming ready
+  /// start from here instead of the time they have been idle.
+  uint64_t MinVRuntime = 0;
+  std::set<Entry> Ready;
+  std::unordered_map<uint32_t, TenantState> Tenants;
+  Statistics Stat;
+  std::vector<std::thread> Workers;
+};
+
+} // namespace VM
+} // namespace WasmEdge
@@ -24,10 +24,12 @@
 
 #include "runtime/instance/module.h"
 #include "runtime/storemgr.h"
+#include "vm/pool.h"
 
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <optional>
 #include <shared_mutex>
 #include <string>
 #include <string_view>
@@ -117,6 +119,13 @@ public:
     std::unique_lock Lock(Mutex);
     return unsafeLoadWasm(Module);
   }
+  /// Share the given module without copying. A validated module, such as the
+  /// one got from getValidatedModule() of another VM, skips the validation.
+  /// Otherwise the module is copied, since the validation updates it.
+  Expect<void> loadWasm(std::shared_ptr<const AST::Module> Module) {
+    std::unique_lock Lock(Mutex);
+    return unsafeLoadWasm(std::move(Module));
+  }
 
   /// ======= Functions can be called after loaded stage. =======
   /// Validate loaded wasm module.
@@ -126,12 +135,56 @@ public:
   }
 
   /// ======= Functions can be called after validated stage. =======
+  /// Get the validated module, or nullptr before the validated stage. The
+  /// module is immutable and can be loaded into other VMs, which instantiate
+  /// it concurrently without parsing, validating or copying its code again.
+  std::shared_ptr<const AST::Module> getValidatedModule() const {
+    std::shared_lock Lock(Mutex);
+    if (Stage < VMStage::Validated) {
+      return nullptr;
+    }
+    return Mod;
+  }
+
   /// Instantiate validated wasm module.
   Expect<void> instantiate() {
     std::unique_lock Lock(Mutex);
     return unsafeInstantiate();
   }
 
+  /// Create a pool of pre-instantiated instances of the validated module and
+  /// fill it up to the capacity. Replaces the previous pool, if any.
+  Expect<void> createInstancePool(uint32_t Capacity) {
+    std::unique_lock Lock(Mutex);
+    return unsafeCreateInstancePool(Capacity);
+  }
+
+  /// Take an instance from the pool. The instance must be given back with
+  /// releaseInstance() or destroyed before the VM loads another module or is
+  /// cleaned up.
+  Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
+  acquireInstance() {
+    std::shared_lock Lock(Mutex);
+    return unsafeAcquireInstance();
+  }
+
+  /// Reset an instance to its post-instantiation state and return it to the
+  /// pool.
+  void
+  releaseInstance(std::unique_ptr<Runtime::Instance::ModuleInstance> ModInst) {
+    std::shared_lock Lock(Mutex);
+    unsafeReleaseInstance(std::move(ModInst));
+  }
+
+  /// Get the statistics of the instance pool, if created.
+  std::optional<InstancePool::Statistics> getInstancePoolStatistics() const {
+    std::shared_lock Lock(Mutex);
+    if (Pool) {
+      return Pool->getStatistics();
+    }
+    return std::nullopt;
+  }
+
   /// ======= Functions can be called after instantiated stage. =======
   /// Execute wasm with given input.
   Expect<std::vector<std::pair<ValVariant, ValType>>>
@@ -150,6 +203,16 @@ public:
     return unsafeExecute(ModName, Func, Params, ParamTypes);
   }
 
+  /// Execute function of the given module instance, such as one acquired from
+  /// the instance pool.
+  Expect<std::vector<std::pair<ValVariant, ValType>>>
+  execute(const Runtime::Instance::ModuleInstance &ModInst,
+          std::string_view Func, Span<const ValVariant> Params = {},
+          Span<const ValType> ParamTypes = {}) {
+    std::shared_lock Lock(Mutex);
+    return unsafeExecute(&ModInst, Func, Params, ParamTypes);
+  }
+
   /// Asynchronous execute wasm with given input.
   Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>
   asyncExecute(std::string_view Func, Span<const ValVariant> Params = {},
@@ -161,10 +224,43 @@ public:
                Span<const ValVariant> Params = {},
                Span<const ValType> ParamTypes = {});
 
+  /// Create a continuation of the function exported by the active module.
+  Expect<std::unique_ptr<Executor::Continuation>>
+  createContinuation(std::string_view Func, Span<const ValVariant> Params = {},
+                     Span<const ValType> ParamTypes = {});
+
+  /// Resume the continuation. See Executor::resume().
+  Expect<bool> resume(Executor::Continuation &Cont,
+                      uint64_t Fuel = UINT64_MAX,
+                      uint64_t SliceDeadline = Epoch::kNever) {
+    std::shared_lock Lock(Mutex);
+    return ExecutorEngine.resume(Cont, Fuel, SliceDeadline);
+  }
+
+  /// Request the continuation to suspend at its next safe point.
+  bool requestSuspend(Executor::Continuation &Cont) noexcept {
+    return ExecutorEngine.requestSuspend(Cont);
+  }
+
   /// Register new thread
   void newThread() noexcept { ExecutorEngine.newThread(); }
   /// Stop execution
   void stop() noexcept { ExecutorEngine.stop(); }
+  /// Interrupt the execution once the timeout is reached
+  void setTimeout(Epoch::Clock::time_point Timeout) noexcept {
+    ExecutorEngine.setTimeout(Timeout);
+  }
+  /// Remove the timeout of execution
+  void clearTimeout() noexcept { ExecutorEngine.clearTimeout(); }
+  /// Attach the sampling profiler for the modules instantiated afterwards
+  void setProfiler(Executor::Profiler *Prof) {
+    ExecutorEngine.setProfiler(Prof);
+  }
+  /// Attach the execution profile for the active modules instantiated
+  /// afterwards
+  void setPGOProfile(PGO::Profile *Prof) {
+    ExecutorEngine.setPGOProfile(Prof);
+  }
 
   /// ======= Functions which are stageless. =======
   /// Clean up VM status
@@ -237,11 +333,20 @@ private:
   Expect<void> unsafeLoadWasm(const std::filesystem::path &Path);
   Expect<void> unsafeLoadWasm(Span<const Byte> Code);
   Expect<void> unsafeLoadWasm(const AST::Module &Module);
+  Expect<void> unsafeLoadWasm(std::shared_ptr<const AST::Module> Module);
 
   Expect<void> unsafeValidate();
 
   Expect<void> unsafeInstantiate();
 
+  Expect<void> unsafeCreateInstancePool(uint32_t Capacity);
+
+  Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
+  unsafeAcquireInstance();
+
+  void unsafeReleaseInstance(
+      std::unique_ptr<Runtime::Instance::ModuleInstance> ModInst);
+
   Expect<std::vector<std::pair<ValVariant, ValType>>>
   unsafeExecute(std::string_view Func, Span<const ValVariant> Params = {},
                 Span<const ValType> ParamTypes = {});
@@ -283,13 +388,14 @@ private:
   Executor::Executor ExecutorEngine;
 
   /// VM Storage.
-  std::unique_ptr<AST::Module> Mod;
+  std::shared_ptr<const AST::Module> Mod;
   std::unique_ptr<Runtime::Instance::ModuleInstance> ActiveModInst;
   std::vector<std::unique_ptr<Runtime::Instance::ModuleInstance>> RegModInst;
   std::unique_ptr<Runtime::StoreManager> Store;
   Runtime::StoreManager &StoreRef;
   std::map<HostRegistration, std::unique_ptr<Runtime::Instance::ModuleInstance>>
       ImpObjs;
+  std::unique_ptr<InstancePool> Pool;
 };
 
 } // namespace VM
@@ -36,7 +36,13 @@ std::filesystem::path getRoot(Cache::StorageScope Scope) {
 Expect<std::filesystem::path> Cache::getPath(Span<const Byte> Data,
                                              Cache::StorageScope Scope,
                                              std::string_view Key) {
-  auto Root = getRoot(Scope);
+  return getPath(Data, getRoot(Scope), Key);
+}
+
+std::filesystem::path Cache::getPath(Span<const Byte> Data,
+                                     const std::filesystem::path &CacheRoot,
+                                     std::string_view Key) {
+  auto Root = CacheRoot;
   if (!Key.empty()) {
     Root /= std::filesystem::u8path(Key);
   }
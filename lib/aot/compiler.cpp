@@ -3,10 +3,16 @@
 
 #include "aot/compiler.h"
 
+#include "aot/blake3.h"
+#include "aot/cache.h"
 #include "aot/version.h"
 #include "common/defines.h"
 #include "common/filesystem.h"
+#include "common/hexstr.h"
 #include "common/log.h"
+#include "common/version.h"
+#include "system/cpu.h"
+#include "validator/optimizer.h"
 
 #include <algorithm>
 #include <array>
@@ -14,16 +20,22 @@
 #include <cinttypes>
 #include <cstdint>
 #include <cstdlib>
+#include <functional>
 #include <limits>
 #include <lld/Common/Driver.h>
 #include <llvm/Analysis/TargetLibraryInfo.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/ExecutionEngine/JITSymbol.h>
+#include <llvm/ExecutionEngine/RuntimeDyld.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/IR/ProfileSummary.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/MC/SubtargetFeature.h>
 #include <llvm/Object/ObjectFile.h>
 #include <llvm/Passes/PassBuilder.h>
+#include <llvm/ProfileData/ProfileCommon.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Host.h>
 #include <llvm/Support/TargetSelect.h>
@@ -31,11 +43,18 @@
 #include <llvm/Transforms/IPO/AlwaysInliner.h>
 #include <llvm/Transforms/Scalar/TailRecursionElimination.h>
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/Mem2Reg.h>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <numeric>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <unordered_map>
+#include <vector>
 
 #if WASMEDGE_OS_WINDOWS
 #include <llvm/Object/COFF.h>
@@ -134,6 +153,32 @@ class FunctionCompiler;
 // force unalignment load/store
 static inline constexpr const bool kForceUnalignment = true;
 
+// Alignment of the AOT image in universal wasm files, which is the largest
+// page size of the target.
+#if defined(__aarch64__)
+static inline constexpr const uint64_t kImageAlignment = UINT64_C(65536);
+#else
+static inline constexpr const uint64_t kImageAlignment = UINT64_C(4096);
+#endif
+
+// OS and architecture types of the AOT section.
+#if WASMEDGE_OS_LINUX
+static inline constexpr const uint8_t kOSType = UINT8_C(1);
+#elif WASMEDGE_OS_MACOS
+static inline constexpr const uint8_t kOSType = UINT8_C(2);
+#elif WASMEDGE_OS_WINDOWS
+static inline constexpr const uint8_t kOSType = UINT8_C(3);
+#else
+#error Unsupported operating system!
+#endif
+#if defined(__x86_64__)
+static inline constexpr const uint8_t kArchType = UINT8_C(1);
+#elif defined(__aarch64__)
+static inline constexpr const uint8_t kArchType = UINT8_C(2);
+#else
+#error Unsupported hardware architecture!
+#endif
+
 // force checking div/rem on zero
 static inline constexpr const bool kForceDivCheck = true;
 
@@ -168,6 +213,47 @@ toLLVMLevel(WasmEdge::CompilerConfigure::OptimizationLevel Level) {
   }
 }
 
+/// Summarize the counts of an execution profile in the percentiles, which the
+/// optimization passes use to classify the hot and the cold code.
+llvm::Metadata *createProfileSummary(llvm::LLVMContext &LLContext,
+                                     const WasmEdge::PGO::Profile &Profile) {
+  std::vector<uint64_t> Counts;
+  uint64_t MaxFunctionCount = 0;
+  uint64_t MaxInternalCount = 0;
+  for (const auto &Entry : Profile.getEntries()) {
+    Counts.push_back(Entry.second);
+    MaxFunctionCount = std::max(MaxFunctionCount, Entry.second);
+  }
+  for (const auto &Branch : Profile.getBranches()) {
+    for (const auto Count : Branch.second) {
+      Counts.push_back(Count);
+      MaxInternalCount = std::max(MaxInternalCount, Count);
+    }
+  }
+  std::sort(Counts.begin(), Counts.end(), std::greater<>());
+  const uint64_t TotalCount =
+      std::accumulate(Counts.begin(), Counts.end(), UINT64_C(0));
+
+  llvm::SummaryEntryVector Detailed;
+  uint64_t Accumulated = 0;
+  size_t Num = 0;
+  for (const uint32_t Cutoff : llvm::ProfileSummaryBuilder::DefaultCutoffs) {
+    const auto Desired = static_cast<uint64_t>(
+        static_cast<double>(TotalCount) * Cutoff / llvm::ProfileSummary::Scale);
+    while (Num < Counts.size() && (Num == 0 || Accumulated < Desired)) {
+      Accumulated += Counts[Num++];
+    }
+    Detailed.emplace_back(Cutoff, Num ? Counts[Num - 1] : 0, Num);
+  }
+
+  llvm::ProfileSummary Summary(
+      llvm::ProfileSummary::PSK_Instr, Detailed, TotalCount,
+      std::max(MaxFunctionCount, MaxInternalCount), MaxInternalCount,
+      MaxFunctionCount, static_cast<uint32_t>(Counts.size()),
+      static_cast<uint32_t>(Profile.getEntries().size()));
+  return Summary.getMD(LLContext);
+}
+
 WasmEdge::Expect<void> WriteByte(llvm::raw_ostream &OS, uint8_t Data) {
   OS.write(Data);
   return {};
@@ -197,6 +283,20 @@ WasmEdge::Expect<void> WriteU64(llvm::raw_ostream &OS, uint64_t Data) {
   return {};
 };
 
+/// Write an unsigned int in the padded 5-byte encoding, which makes the size
+/// of the output independent of the value.
+WasmEdge::Expect<void> WritePaddedU32(llvm::raw_ostream &OS, uint32_t Data) {
+  for (uint32_t I = 0; I < 5; ++I) {
+    uint8_t Byte = static_cast<uint8_t>(Data & UINT32_C(0x7f));
+    Data >>= 7;
+    if (I < 4) {
+      Byte |= UINT8_C(0x80);
+    }
+    WriteByte(OS, Byte);
+  }
+  return {};
+};
+
 WasmEdge::Expect<void> WriteName(llvm::raw_ostream &OS, std::string_view Data) {
   WriteU32(OS, static_cast<uint32_t>(Data.size()));
   for (const auto C : Data) {
@@ -281,9 +381,16 @@ struct WasmEdge::AOT::Compiler::CompileContext {
                          const WasmEdge::AST::CodeSegment *>>
       Functions;
   std::vector<llvm::Type *> Globals;
+  uint32_t MemoryNum = 0;
   llvm::GlobalVariable *IntrinsicsTable;
   llvm::Function *Trap;
-  CompileContext(llvm::Module &M, bool IsGenericBinary)
+  /// TBAA tags of the accesses to the linear memories, the global instances,
+  /// and the runtime structures reached from the execution context, which
+  /// never alias each other.
+  llvm::MDNode *MemoryTBAA = nullptr;
+  llvm::MDNode *GlobalTBAA = nullptr;
+  llvm::MDNode *ContextTBAA = nullptr;
+  CompileContext(llvm::Module &M, const llvm::StringMap<bool> &FeatureMap)
       : LLContext(M.getContext()), LLModule(M),
         VoidTy(llvm::Type::getVoidTy(LLContext)),
         Int8Ty(llvm::Type::getInt8Ty(LLContext)),
@@ -318,8 +425,10 @@ struct WasmEdge::AOT::Compiler::CompileContext {
             Int64PtrTy,
             // GasLimit
             Int64Ty,
-            // StopToken
-            llvm::Type::getInt32PtrTy(LLContext))),
+            // Epoch
+            Int64PtrTy,
+            // Deadline
+            Int64PtrTy)),
         ExecCtxPtrTy(ExecCtxTy->getPointerTo()),
         IntrinsicsTableTy(llvm::ArrayType::get(
             Int8PtrTy, uint32_t(AST::Module::Intrinsics::kIntrinsicMax))),
@@ -339,33 +448,41 @@ struct WasmEdge::AOT::Compiler::CompileContext {
         LLModule, Int32Ty, true, llvm::GlobalValue::ExternalLinkage,
         llvm::ConstantInt::get(Int32Ty, kBinaryVersion), "version");
 
-    if (!IsGenericBinary) {
-      llvm::StringMap<bool> FeatureMap;
-      llvm::sys::getHostCPUFeatures(FeatureMap);
-      for (auto &Feature : FeatureMap) {
-        if (Feature.second) {
+    for (auto &Feature : FeatureMap) {
+      if (Feature.second) {
 #if defined(__x86_64__)
-          if (!SupportXOP && Feature.first() == "xop") {
-            SupportXOP = true;
-          }
-          if (!SupportSSE4_1 && Feature.first() == "sse4.1") {
-            SupportSSE4_1 = true;
-          }
-          if (!SupportSSSE3 && Feature.first() == "ssse3") {
-            SupportSSSE3 = true;
-          }
-          if (!SupportSSE2 && Feature.first() == "sse2") {
-            SupportSSE2 = true;
-          }
+        if (!SupportXOP && Feature.first() == "xop") {
+          SupportXOP = true;
+        }
+        if (!SupportSSE4_1 && Feature.first() == "sse4.1") {
+          SupportSSE4_1 = true;
+        }
+        if (!SupportSSSE3 && Feature.first() == "ssse3") {
+          SupportSSSE3 = true;
+        }
+        if (!SupportSSE2 && Feature.first() == "sse2") {
+          SupportSSE2 = true;
+        }
 #elif defined(__aarch64__)
-          if (!SupportNEON && Feature.first() == "neon") {
-            SupportNEON = true;
-          }
-#endif
+        if (!SupportNEON && Feature.first() == "neon") {
+          SupportNEON = true;
         }
-
-        SubtargetFeatures.AddFeature(Feature.first(), Feature.second);
+#endif
       }
+
+      SubtargetFeatures.AddFeature(Feature.first(), Feature.second);
+    }
+
+    {
+      llvm::MDBuilder MDB(LLContext);
+      auto *Root = MDB.createTBAARoot("wasmedge");
+      const auto CreateTag = [&MDB, Root](llvm::StringRef Name) {
+        auto *Type = MDB.createTBAAScalarTypeNode(Name, Root);
+        return MDB.createTBAAStructTagNode(Type, Type, 0);
+      };
+      MemoryTBAA = CreateTag("memory");
+      GlobalTBAA = CreateTag("global");
+      ContextTBAA = CreateTag("context");
     }
 
     {
@@ -385,6 +502,7 @@ struct WasmEdge::AOT::Compiler::CompileContext {
     auto *Array = Builder.CreateExtractValue(ExecCtx, {0});
     auto *VPtr = Builder.CreateLoad(
         Int8PtrTy, Builder.CreateConstInBoundsGEP1_64(Int8PtrTy, Array, Index));
+    VPtr->setMetadata(llvm::LLVMContext::MD_tbaa, ContextTBAA);
     return Builder.CreateBitCast(VPtr, Int8PtrTy);
   }
   std::pair<llvm::Type *, llvm::Value *> getGlobal(llvm::IRBuilder<> &Builder,
@@ -395,6 +513,7 @@ struct WasmEdge::AOT::Compiler::CompileContext {
     auto *VPtr = Builder.CreateLoad(
         Int128PtrTy,
         Builder.CreateConstInBoundsGEP1_64(Int128PtrTy, Array, Index));
+    VPtr->setMetadata(llvm::LLVMContext::MD_tbaa, ContextTBAA);
     auto *Ptr = Builder.CreateBitCast(VPtr, Ty->getPointerTo());
     return {Ty, Ptr};
   }
@@ -413,10 +532,13 @@ struct WasmEdge::AOT::Compiler::CompileContext {
                            llvm::LoadInst *ExecCtx) {
     return Builder.CreateExtractValue(ExecCtx, {5});
   }
-  llvm::Value *getStopToken(llvm::IRBuilder<> &Builder,
-                            llvm::LoadInst *ExecCtx) {
+  llvm::Value *getEpoch(llvm::IRBuilder<> &Builder, llvm::LoadInst *ExecCtx) {
     return Builder.CreateExtractValue(ExecCtx, {6});
   }
+  llvm::Value *getDeadline(llvm::IRBuilder<> &Builder,
+                           llvm::LoadInst *ExecCtx) {
+    return Builder.CreateExtractValue(ExecCtx, {7});
+  }
   llvm::FunctionCallee getIntrinsic(llvm::IRBuilder<> &Builder,
                                     AST::Module::Intrinsics Index,
                                     llvm::FunctionType *Ty) {
@@ -546,25 +668,32 @@ class FunctionCompiler {
 
 public:
   FunctionCompiler(AOT::Compiler::CompileContext &Context, llvm::Function *F,
-                   Span<const ValType> Locals, bool Interruptible,
-                   bool InstructionCounting, bool GasMeasuring, bool OptNone)
-      : Context(Context), LLContext(Context.LLContext),
-        Interruptible(Interruptible), OptNone(OptNone), F(F),
+                   uint32_t FuncIdx, Span<const ValType> Locals,
+                   bool Interruptible, bool InstructionCounting,
+                   bool GasMeasuring, bool OptNone,
+                   const PGO::Profile *Profile = nullptr)
+      : Context(Context), LLContext(Context.LLContext), FuncIdx(FuncIdx),
+        Interruptible(Interruptible), GasMeasuring(GasMeasuring),
+        OptNone(OptNone), Profile(Profile), F(F),
         Builder(llvm::BasicBlock::Create(LLContext, "entry", F)) {
     if (F) {
       setIsFPConstrained(Builder);
       ExecCtx = Builder.CreateLoad(Context.ExecCtxTy, F->arg_begin());
+      ExecCtx->setMetadata(llvm::LLVMContext::MD_tbaa, Context.ContextTBAA);
+
+      // Keep the memory bases in locals, which become SSA values after the
+      // promotion, and only reload them after the calls and `memory.grow`
+      // which may move the memories.
+      for (uint32_t I = 0; I < Context.MemoryNum; ++I) {
+        MemoryBase.push_back(Builder.CreateAlloca(Context.Int8PtrTy));
+      }
+      reloadMemoryBase();
 
       if (InstructionCounting) {
         LocalInstrCount = Builder.CreateAlloca(Context.Int64Ty);
         Builder.CreateStore(Builder.getInt64(0), LocalInstrCount);
       }
 
-      if (GasMeasuring) {
-        LocalGas = Builder.CreateAlloca(Context.Int64Ty);
-        Builder.CreateStore(Builder.getInt64(0), LocalGas);
-      }
-
       for (llvm::Argument *Arg = F->arg_begin() + 1; Arg != F->arg_end();
            ++Arg) {
         llvm::Type *Ty = Arg->getType();
@@ -588,6 +717,27 @@ public:
     }
   }
 
+  /// Get the branch weights of a branch instruction from the profile, in the
+  /// order of the targets of the profile. Return nullptr if not profiled.
+  llvm::MDNode *getBranchWeights(const AST::Instruction &Instr,
+                                 uint32_t TargetNum) {
+    if (!Profile) {
+      return nullptr;
+    }
+    const auto Counts = Profile->getBranchCounts(Instr.getOffset());
+    if (Counts.size() != TargetNum) {
+      return nullptr;
+    }
+    // Scale the counts down to fit the 32-bit weights.
+    const uint64_t Max = *std::max_element(Counts.begin(), Counts.end());
+    const uint64_t Scale = Max / std::numeric_limits<uint32_t>::max() + 1;
+    std::vector<uint32_t> Weights(Counts.size());
+    for (size_t I = 0; I < Counts.size(); ++I) {
+      Weights[I] = static_cast<uint32_t>(Counts[I] / Scale);
+    }
+    return llvm::MDBuilder(LLContext).createBranchWeights(Weights);
+  }
+
   llvm::BasicBlock *getTrapBB(ErrCode::Value Error) {
     if (auto Iter = TrapBB.find(Error); Iter != TrapBB.end()) {
       return Iter->second;
@@ -602,6 +752,7 @@ public:
     auto *RetBB = llvm::BasicBlock::Create(LLContext, "ret", F);
     Type.first.clear();
     enterBlock(RetBB, nullptr, nullptr, {}, std::move(Type));
+    checkStop();
     compile(Code.getExpr().getInstrs());
     assuming(ControlStack.empty());
     compileReturn();
@@ -609,7 +760,6 @@ public:
     for (auto &[Error, BB] : TrapBB) {
       Builder.SetInsertPoint(BB);
       updateInstrCount();
-      updateGasAtTrap();
       auto *CallTrap = Builder.CreateCall(
           Context.Trap, {Builder.getInt32(static_cast<uint32_t>(Error))});
       CallTrap->setDoesNotReturn();
@@ -642,8 +792,6 @@ public:
         }
         enterBlock(EndBlock, nullptr, nullptr, std::move(Args),
                    std::move(Type));
-        checkStop();
-        updateGas();
         return;
       }
       case OpCode::Loop: {
@@ -675,7 +823,6 @@ public:
         }
         enterBlock(Loop, EndLoop, nullptr, std::move(Args), std::move(Type));
         checkStop();
-        updateGas();
         return;
       }
       case OpCode::If: {
@@ -688,7 +835,7 @@ public:
         } else {
           Cond = Builder.CreateICmpNE(stackPop(), Builder.getInt32(0));
         }
-        Builder.CreateCondBr(Cond, Then, Else);
+        Builder.CreateCondBr(Cond, Then, Else, getBranchWeights(Instr, 2));
 
         Builder.SetInsertPoint(Then);
         auto Type = Context.resolveBlockType(Instr.getBlockType());
@@ -764,7 +911,8 @@ public:
         auto *Cond = Builder.CreateICmpNE(stackPop(), Builder.getInt32(0));
         setLableJumpPHI(Label);
         auto *Next = llvm::BasicBlock::Create(LLContext, "br_if.end", F);
-        Builder.CreateCondBr(Cond, getLabel(Label), Next);
+        Builder.CreateCondBr(Cond, getLabel(Label), Next,
+                             getBranchWeights(Instr, 2));
         Builder.SetInsertPoint(Next);
         break;
       }
@@ -775,9 +923,18 @@ public:
             static_cast<uint32_t>(LabelTable.size() - 1);
         auto *Value = stackPop();
         setLableJumpPHI(LabelTable[LabelTableSize].TargetIndex);
+        // The profile counts the default target last, while the weights of
+        // the switch start with it.
+        llvm::MDNode *Weights = nullptr;
+        if (auto *Counts = getBranchWeights(Instr, LabelTableSize + 1)) {
+          llvm::SmallVector<llvm::Metadata *, 8> Ops(Counts->op_begin(),
+                                                     Counts->op_end());
+          std::rotate(Ops.begin() + 1, Ops.end() - 1, Ops.end());
+          Weights = llvm::MDNode::get(LLContext, Ops);
+        }
         auto *Switch = Builder.CreateSwitch(
             Value, getLabel(LabelTable[LabelTableSize].TargetIndex),
-            LabelTableSize);
+            LabelTableSize, Weights);
         for (uint32_t I = 0; I < LabelTableSize; ++I) {
           setLableJumpPHI(LabelTable[I].TargetIndex);
           Switch->addCase(Builder.getInt32(I),
@@ -790,17 +947,14 @@ public:
       }
       case OpCode::Call:
         updateInstrCount();
-        updateGas();
         compileCallOp(Instr.getTargetIndex());
         break;
       case OpCode::Call_indirect:
         updateInstrCount();
-        updateGas();
         compileIndirectCallOp(Instr.getSourceIndex(), Instr.getTargetIndex());
         break;
       case OpCode::Return_call:
         updateInstrCount();
-        updateGas();
         compileReturnCallOp(Instr.getTargetIndex());
         setUnreachable();
         Builder.SetInsertPoint(
@@ -808,7 +962,6 @@ public:
         break;
       case OpCode::Return_call_indirect:
         updateInstrCount();
-        updateGas();
         compileReturnIndirectCallOp(Instr.getSourceIndex(),
                                     Instr.getTargetIndex());
         setUnreachable();
@@ -856,14 +1009,18 @@ public:
       case OpCode::Global__get: {
         const auto G =
             Context.getGlobal(Builder, ExecCtx, Instr.getTargetIndex());
-        stackPush(Builder.CreateLoad(G.first, G.second));
+        auto *Load = Builder.CreateLoad(G.first, G.second);
+        Load->setMetadata(llvm::LLVMContext::MD_tbaa, Context.GlobalTBAA);
+        stackPush(Load);
         break;
       }
-      case OpCode::Global__set:
-        Builder.CreateStore(
+      case OpCode::Global__set: {
+        auto *Store = Builder.CreateStore(
             stackPop(),
             Context.getGlobal(Builder, ExecCtx, Instr.getTargetIndex()).second);
+        Store->setMetadata(llvm::LLVMContext::MD_tbaa, Context.GlobalTBAA);
         break;
+      }
       case OpCode::Table__get: {
         auto *Idx = stackPop();
         stackPush(Builder.CreateCall(
@@ -1078,6 +1235,7 @@ public:
                                         {Context.Int32Ty, Context.Int32Ty},
                                         false)),
             {Builder.getInt32(Instr.getTargetIndex()), Diff}));
+        reloadMemoryBase(Instr.getTargetIndex());
         break;
       }
       case OpCode::Memory__init: {
@@ -3056,7 +3214,9 @@ public:
       }
       return;
     };
-    for (const auto &Instr : Instrs) {
+    bool IsBlockStart = true;
+    for (auto Iter = Instrs.begin(); Iter != Instrs.end(); ++Iter) {
+      const auto &Instr = *Iter;
       // Update instruction count
       if (LocalInstrCount) {
         Builder.CreateStore(
@@ -3065,20 +3225,14 @@ public:
                 Builder.getInt64(1)),
             LocalInstrCount);
       }
-      if (LocalGas) {
-        auto *NewGas = Builder.CreateAdd(
-            Builder.CreateLoad(Context.Int64Ty, LocalGas),
-            Builder.CreateLoad(
-                Context.Int64Ty,
-                Builder.CreateConstInBoundsGEP2_64(
-                    llvm::ArrayType::get(Context.Int64Ty, UINT16_MAX + 1),
-                    Context.getCostTable(Builder, ExecCtx), 0,
-                    uint16_t(Instr.getOpCode()))));
-        Builder.CreateStore(NewGas, LocalGas);
+      // Charge the gas of the whole basic block at its entry.
+      if (GasMeasuring && IsBlockStart) {
+        chargeGas(Iter, Instrs.end());
       }
 
       // Make the instruction node according to Code.
       Dispatch(Instr);
+      IsBlockStart = isBlockTerminator(Instr.getOpCode());
     }
   }
   void compileSignedTrunc(llvm::IntegerType *IntType) {
@@ -3289,13 +3443,14 @@ public:
     }
     compileAtomicCheckOffsetAlignment(Offset, TargetType);
     auto *VPtr = Builder.CreateInBoundsGEP(
-        Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex),
+        Context.Int8Ty, getMemoryBase(MemoryIndex),
         Offset);
 
     auto *Ptr = Builder.CreateBitCast(VPtr, TargetType->getPointerTo());
     auto *Load = Builder.CreateLoad(TargetType, Ptr, OptNone);
     Load->setAlignment(Align(UINT64_C(1) << Alignment));
     Load->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+    Load->setMetadata(llvm::LLVMContext::MD_tbaa, Context.MemoryTBAA);
 
     if (Signed) {
       Stack.back() = Builder.CreateSExt(Load, IntType);
@@ -3320,12 +3475,13 @@ public:
     }
     compileAtomicCheckOffsetAlignment(Offset, TargetType);
     auto *VPtr = Builder.CreateInBoundsGEP(
-        Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex),
+        Context.Int8Ty, getMemoryBase(MemoryIndex),
         Offset);
     auto *Ptr = Builder.CreateBitCast(VPtr, TargetType->getPointerTo());
     auto *Store = Builder.CreateStore(V, Ptr, OptNone);
     Store->setAlignment(Align(UINT64_C(1) << Alignment));
     Store->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+    Store->setMetadata(llvm::LLVMContext::MD_tbaa, Context.MemoryTBAA);
   }
 
   void compileAtomicRMWOp(unsigned MemoryIndex, unsigned MemoryOffset,
@@ -3340,16 +3496,18 @@ public:
     }
     compileAtomicCheckOffsetAlignment(Offset, TargetType);
     auto *VPtr = Builder.CreateInBoundsGEP(
-        Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex),
+        Context.Int8Ty, getMemoryBase(MemoryIndex),
         Offset);
     auto *Ptr = Builder.CreateBitCast(VPtr, TargetType->getPointerTo());
 
-    Stack.back() =
+    auto *RMW =
         Builder.CreateAtomicRMW(BinOp, Ptr, Value,
 #if LLVM_VERSION_MAJOR >= 13
                                 Align(UINT64_C(1) << Alignment),
 #endif
                                 llvm::AtomicOrdering::SequentiallyConsistent);
+    RMW->setMetadata(llvm::LLVMContext::MD_tbaa, Context.MemoryTBAA);
+    Stack.back() = RMW;
 
     if (Signed) {
       Stack.back() = Builder.CreateSExt(Stack.back(), IntType);
@@ -3371,7 +3529,7 @@ public:
     }
     compileAtomicCheckOffsetAlignment(Offset, TargetType);
     auto *VPtr = Builder.CreateInBoundsGEP(
-        Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex),
+        Context.Int8Ty, getMemoryBase(MemoryIndex),
         Offset);
     auto *Ptr = Builder.CreateBitCast(VPtr, TargetType->getPointerTo());
 
@@ -3382,6 +3540,7 @@ public:
 #endif
         llvm::AtomicOrdering::SequentiallyConsistent,
         llvm::AtomicOrdering::SequentiallyConsistent);
+    Ret->setMetadata(llvm::LLVMContext::MD_tbaa, Context.MemoryTBAA);
 
     auto *OldVal = Builder.CreateExtractValue(Ret, 0);
     Stack.back() = OldVal;
@@ -3394,7 +3553,6 @@ public:
 
   void compileReturn() {
     updateInstrCount();
-    updateGas();
     auto *Ty = F->getReturnType();
     if (Ty->isVoidTy()) {
       Builder.CreateRetVoid();
@@ -3411,6 +3569,22 @@ public:
     }
   }
 
+  /// Getter of the base of a memory.
+  llvm::Value *getMemoryBase(uint32_t Index) {
+    return Builder.CreateLoad(Context.Int8PtrTy, MemoryBase[Index]);
+  }
+  /// Reload the bases of all memories, or of one memory, from the execution
+  /// context.
+  void reloadMemoryBase() {
+    for (uint32_t I = 0; I < MemoryBase.size(); ++I) {
+      reloadMemoryBase(I);
+    }
+  }
+  void reloadMemoryBase(uint32_t Index) {
+    Builder.CreateStore(Context.getMemory(Builder, ExecCtx, Index),
+                        MemoryBase[Index]);
+  }
+
   void updateInstrCount() {
     if (LocalInstrCount) {
       Builder.CreateAtomicRMW(
@@ -3425,60 +3599,88 @@ public:
     }
   }
 
-  void updateGas() {
-    if (LocalGas) {
-      auto *CurrBB = Builder.GetInsertBlock();
-      auto *CheckBB = llvm::BasicBlock::Create(LLContext, "gas_check", F);
-      auto *OkBB = llvm::BasicBlock::Create(LLContext, "gas_ok", F);
-      auto *EndBB = llvm::BasicBlock::Create(LLContext, "gas_end", F);
-
-      auto *Cost = Builder.CreateLoad(Context.Int64Ty, LocalGas);
-      Cost->setAlignment(Align(8));
-      auto *GasPtr = Context.getGas(Builder, ExecCtx);
-      auto *GasLimit = Context.getGasLimit(Builder, ExecCtx);
-      auto *Gas = Builder.CreateLoad(Context.Int64Ty, GasPtr);
-      Gas->setAlignment(Align(8));
-      Gas->setAtomic(llvm::AtomicOrdering::Monotonic);
-      Builder.CreateBr(CheckBB);
-      Builder.SetInsertPoint(CheckBB);
-
-      auto *PHIOldGas = Builder.CreatePHI(Context.Int64Ty, 2);
-      auto *NewGas = Builder.CreateAdd(PHIOldGas, Cost);
-      auto *IsGasRemain =
-          createLikely(Builder, Builder.CreateICmpULE(NewGas, GasLimit));
-      Builder.CreateCondBr(IsGasRemain, OkBB,
-                           getTrapBB(ErrCode::Value::CostLimitExceeded));
-      Builder.SetInsertPoint(OkBB);
-
-      auto *RGasAndSucceed = Builder.CreateAtomicCmpXchg(
-          GasPtr, PHIOldGas, NewGas,
-#if LLVM_VERSION_MAJOR >= 13
-          llvm::MaybeAlign(8),
-#endif
-          llvm::AtomicOrdering::Monotonic, llvm::AtomicOrdering::Monotonic);
-      RGasAndSucceed->setWeak(true);
-      auto *RGas = Builder.CreateExtractValue(RGasAndSucceed, {0});
-      auto *Succeed = Builder.CreateExtractValue(RGasAndSucceed, {1});
-      Builder.CreateCondBr(createLikely(Builder, Succeed), EndBB, CheckBB);
-      Builder.SetInsertPoint(EndBB);
-
-      Builder.CreateStore(Builder.getInt64(0), LocalGas);
-
-      PHIOldGas->addIncoming(Gas, CurrBB);
-      PHIOldGas->addIncoming(RGas, OkBB);
+  /// Check whether the instruction ends a basic block for the gas metering.
+  /// The instructions after it are either the target of a branch or only
+  /// reachable through a branch.
+  static bool isBlockTerminator(OpCode Code) noexcept {
+    switch (Code) {
+    case OpCode::Unreachable:
+    case OpCode::Block:
+    case OpCode::Loop:
+    case OpCode::If:
+    case OpCode::Else:
+    case OpCode::End:
+    case OpCode::Br:
+    case OpCode::Br_if:
+    case OpCode::Br_table:
+    case OpCode::Return:
+    case OpCode::Return_call:
+    case OpCode::Return_call_indirect:
+      return true;
+    default:
+      return false;
     }
   }
 
-  void updateGasAtTrap() {
-    if (LocalGas) {
-      Builder.CreateAtomicRMW(llvm::AtomicRMWInst::BinOp::Add,
-                              Context.getGas(Builder, ExecCtx),
-                              Builder.CreateLoad(Context.Int64Ty, LocalGas),
-#if LLVM_VERSION_MAJOR >= 13
-                              llvm::MaybeAlign(8),
-#endif
-                              llvm::AtomicOrdering::Monotonic);
+  /// Charge the static cost of the basic block starting at \p Begin into the
+  /// per-thread gas counter. The block ends at the first terminator, so an
+  /// early exit through `br`, `br_if` or `return` never pays for the rest of
+  /// its enclosing structured block. A trap inside the block does not refund
+  /// the instructions after it.
+  void chargeGas(AST::InstrView::iterator Begin,
+                 AST::InstrView::iterator End) {
+    if (isUnreachable()) {
+      return;
     }
+    std::map<uint16_t, uint64_t> OpCount;
+    for (auto Iter = Begin; Iter != End; ++Iter) {
+      ++OpCount[uint16_t(Iter->getOpCode())];
+      if (isBlockTerminator(Iter->getOpCode())) {
+        break;
+      }
+    }
+
+    auto *CostTable = Context.getCostTable(Builder, ExecCtx);
+    llvm::Value *Cost = nullptr;
+    for (const auto &[Code, Count] : OpCount) {
+      llvm::Value *OpCost = Builder.CreateLoad(
+          Context.Int64Ty,
+          Builder.CreateConstInBoundsGEP2_64(
+              llvm::ArrayType::get(Context.Int64Ty, UINT16_MAX + 1),
+              CostTable, 0, Code));
+      if (Count > 1) {
+        OpCost = Builder.CreateMul(OpCost, Builder.getInt64(Count));
+      }
+      Cost = Cost ? Builder.CreateAdd(Cost, OpCost) : OpCost;
+    }
+
+    auto *OkBB = llvm::BasicBlock::Create(LLContext, "gas_ok", F);
+    auto *RefillBB = llvm::BasicBlock::Create(LLContext, "gas_refill", F);
+    auto *EndBB = llvm::BasicBlock::Create(LLContext, "gas_end", F);
+    auto *GasPtr = Context.getGas(Builder, ExecCtx);
+    auto *Gas = Builder.CreateLoad(Context.Int64Ty, GasPtr);
+    Gas->setAlignment(Align(8));
+    auto *NewGas = Builder.CreateAdd(Gas, Cost);
+    auto *IsGasRemain = createLikely(
+        Builder, Builder.CreateICmpULE(NewGas,
+                                       Context.getGasLimit(Builder, ExecCtx)));
+    Builder.CreateCondBr(IsGasRemain, OkBB, RefillBB);
+    Builder.SetInsertPoint(OkBB);
+    auto *Store = Builder.CreateStore(NewGas, GasPtr);
+    Store->setAlignment(Align(8));
+    Builder.CreateBr(EndBB);
+
+    // The reservation of this thread is used up. The executor reserves more
+    // gas from the statistics and charges the cost, or traps when the cost
+    // limit is exceeded.
+    Builder.SetInsertPoint(RefillBB);
+    Builder.CreateCall(
+        Context.getIntrinsic(
+            Builder, AST::Module::Intrinsics::kRefillGas,
+            llvm::FunctionType::get(Context.VoidTy, {Context.Int64Ty}, false)),
+        {Cost});
+    Builder.CreateBr(EndBB);
+    Builder.SetInsertPoint(EndBB);
   }
 
 private:
@@ -3496,6 +3698,7 @@ private:
     }
 
     auto *Ret = Builder.CreateCall(Function, Args);
+    reloadMemoryBase();
     auto *Ty = Ret->getType();
     if (Ty->isVoidTy()) {
       // nothing to do
@@ -3628,6 +3831,7 @@ private:
       PHIRet->addIncoming(RetsVec[I], IsNullBB);
       stackPush(PHIRet);
     }
+    reloadMemoryBase();
   }
 
   void compileReturnCallOp(const unsigned int FuncIndex) {
@@ -3769,10 +3973,11 @@ private:
     }
 
     auto *VPtr = Builder.CreateInBoundsGEP(
-        Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex), Off);
+        Context.Int8Ty, getMemoryBase(MemoryIndex), Off);
     auto *Ptr = Builder.CreateBitCast(VPtr, LoadTy->getPointerTo());
     auto *LoadInst = Builder.CreateLoad(LoadTy, Ptr, OptNone);
     LoadInst->setAlignment(Align(UINT64_C(1) << Alignment));
+    LoadInst->setMetadata(llvm::LLVMContext::MD_tbaa, Context.MemoryTBAA);
     stackPush(LoadInst);
   }
   void compileLoadOp(unsigned MemoryIndex, unsigned Offset, unsigned Alignment,
@@ -3839,10 +4044,11 @@ private:
       V = Builder.CreateBitCast(V, LoadTy);
     }
     auto *VPtr = Builder.CreateInBoundsGEP(
-        Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex), Off);
+        Context.Int8Ty, getMemoryBase(MemoryIndex), Off);
     auto *Ptr = Builder.CreateBitCast(VPtr, LoadTy->getPointerTo());
     auto *StoreInst = Builder.CreateStore(V, Ptr, OptNone);
     StoreInst->setAlignment(Align(UINT64_C(1) << Alignment));
+    StoreInst->setMetadata(llvm::LLVMContext::MD_tbaa, Context.MemoryTBAA);
   }
   void compileSplatOp(llvm::VectorType *VectorTy) {
     auto *Undef = llvm::UndefValue::get(VectorTy);
@@ -4514,22 +4720,40 @@ private:
     return Entry;
   }
 
+  /// Check the deadline of the executor against the epoch counter. It is
+  /// only placed at function entries and loop headers, which are the targets
+  /// of all loop back-edges. The executor decides on the slow path whether
+  /// the deadline is a timeout or a profiling sample request.
   void checkStop() {
     if (!Interruptible) {
       return;
     }
+    auto *CheckBB = llvm::BasicBlock::Create(LLContext, "Check", F);
     auto *NotStopBB = llvm::BasicBlock::Create(LLContext, "NotStop", F);
-    auto *StopToken = Builder.CreateAtomicRMW(
-        llvm::AtomicRMWInst::BinOp::Xchg,
-        Context.getStopToken(Builder, ExecCtx), Builder.getInt32(0),
-#if LLVM_VERSION_MAJOR >= 13
-        llvm::MaybeAlign(4),
-#endif
-        llvm::AtomicOrdering::Monotonic);
-    auto *NotStop = createLikely(
-        Builder, Builder.CreateICmpEQ(StopToken, Builder.getInt32(0)));
-    Builder.CreateCondBr(NotStop, NotStopBB,
-                         getTrapBB(ErrCode::Value::Interrupted));
+    auto *Epoch = Builder.CreateLoad(Context.Int64Ty,
+                                     Context.getEpoch(Builder, ExecCtx));
+    Epoch->setAlignment(Align(8));
+    Epoch->setAtomic(llvm::AtomicOrdering::Monotonic);
+    auto *Deadline = Builder.CreateLoad(Context.Int64Ty,
+                                        Context.getDeadline(Builder, ExecCtx));
+    Deadline->setAlignment(Align(8));
+    Deadline->setAtomic(llvm::AtomicOrdering::Monotonic);
+    auto *NotStop =
+        createLikely(Builder, Builder.CreateICmpULT(Epoch, Deadline));
+    Builder.CreateCondBr(NotStop, NotStopBB, CheckBB);
+
+    Builder.SetInsertPoint(CheckBB);
+    updateInstrCount();
+    Builder.CreateCall(
+        Context.getIntrinsic(
+            Builder, AST::Module::Intrinsics::kCheckDeadline,
+            llvm::FunctionType::get(Context.VoidTy,
+                                    {Context.Int32Ty, Context.Int8PtrTy},
+                                    false)),
+        {Builder.getInt32(FuncIdx),
+         Builder.CreateIntrinsic(llvm::Intrinsic::frameaddress,
+                                 {Context.Int8PtrTy}, {Builder.getInt32(0)})});
+    Builder.CreateBr(NotStopBB);
 
     Builder.SetInsertPoint(NotStopBB);
   }
@@ -4617,14 +4841,17 @@ private:
 
   AOT::Compiler::CompileContext &Context;
   llvm::LLVMContext &LLContext;
+  uint32_t FuncIdx;
   std::vector<std::pair<llvm::Type *, llvm::Value *>> Local;
   std::vector<llvm::Value *> Stack;
   llvm::Value *LocalInstrCount = nullptr;
-  llvm::Value *LocalGas = nullptr;
+  std::vector<llvm::Value *> MemoryBase;
   std::unordered_map<ErrCode::Value, llvm::BasicBlock *> TrapBB;
   bool IsUnreachable = false;
   bool Interruptible = false;
+  bool GasMeasuring = false;
   bool OptNone = false;
+  const PGO::Profile *Profile = nullptr;
   struct Control {
     size_t StackSize;
     llvm::BasicBlock *JumpBlock;
@@ -4670,9 +4897,11 @@ static llvm::Value *createLikely(llvm::IRBuilder<> &Builder,
                                        Builder.getTrue());
 }
 
-// Write output object and link
+// Write output object and link with the objects of the functions compiled
+// incrementally
 Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
-                                 const llvm::SmallString<0> &OSVec) {
+                                 const llvm::SmallString<0> &OSVec,
+                                 Span<const std::string> FunctionObjects) {
   using namespace std::literals;
 
   spdlog::info("output start");
@@ -4704,6 +4933,48 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
   }
 
   // link
+  const std::string OutputName = OutputPath.u8string();
+#if WASMEDGE_OS_WINDOWS
+  const std::string OutputArg = "-out:" + OutputName;
+#endif
+  std::vector<const char *> Args = {
+#if WASMEDGE_OS_MACOS
+    "lld", "-arch",
+#if defined(__x86_64__)
+        "x86_64",
+#elif defined(__aarch64__)
+        "arm64",
+#else
+#error Unsupported architectur on the MacOS!
+#endif
+#if LLVM_VERSION_MAJOR >= 14
+        // LLVM 14 replaces the older mach_o lld implementation with the new
+        // one. And it require -arch and -platform_version to always be
+        // specified. Reference: https://reviews.llvm.org/D97799
+        "-platform_version", "macos", "10.0", "11.0",
+#else
+        "-sdk_version", "11.3",
+#endif
+        "-dylib", "-demangle", "-macosx_version_min", "10.0.0", "-syslibroot",
+        "/Library/Developer/CommandLineTools/SDKs/MacOSX.sdk", "-lSystem",
+#elif WASMEDGE_OS_LINUX
+    "ld.lld", "--shared", "--gc-sections", "--discard-all",
+#elif WASMEDGE_OS_WINDOWS
+    "lld-link", "-dll", "-defaultlib:libcmt", "-base:0", "-nologo",
+        OutputArg.c_str(),
+#endif
+#if !WASMEDGE_OS_WINDOWS
+        "-o", OutputName.c_str(),
+#endif
+        ObjectName.c_str()
+  };
+  for (const auto &Name : FunctionObjects) {
+    Args.push_back(Name.c_str());
+  }
+
+  // The linker keeps its state in globals, so only one link runs at a time.
+  static std::mutex LinkMutex;
+  std::unique_lock LinkLock(LinkMutex);
   bool LinkResult = false;
 #if WASMEDGE_OS_MACOS
 #if LLVM_VERSION_MAJOR >= 14
@@ -4714,40 +4985,12 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
 #else
   LinkResult = lld::mach_o::link(
 #endif
-      std::initializer_list<const char *> {
-        "lld", "-arch",
-#if defined(__x86_64__)
-            "x86_64",
-#elif defined(__aarch64__)
-            "arm64",
-#else
-#error Unsupported architectur on the MacOS!
-#endif
-#if LLVM_VERSION_MAJOR >= 14
-            // LLVM 14 replaces the older mach_o lld implementation with the new
-            // one. And it require -arch and -platform_version to always be
-            // specified. Reference: https://reviews.llvm.org/D97799
-            "-platform_version", "macos", "10.0", "11.0",
-#else
-            "-sdk_version", "11.3",
-#endif
-            "-dylib", "-demangle", "-macosx_version_min", "10.0.0",
-            "-syslibroot",
-            "/Library/Developer/CommandLineTools/SDKs/MacOSX.sdk",
-            ObjectName.c_str(), "-o", OutputPath.u8string().c_str(), "-lSystem"
-      },
 #elif WASMEDGE_OS_LINUX
   LinkResult = lld::elf::link(
-      std::initializer_list<const char *>{"ld.lld", "--shared", "--gc-sections",
-                                          "--discard-all", ObjectName.c_str(),
-                                          "-o", OutputPath.u8string().c_str()},
 #elif WASMEDGE_OS_WINDOWS
   LinkResult = lld::coff::link(
-      std::initializer_list<const char *>{
-          "lld-link", "-dll", "-defaultlib:libcmt", "-base:0", "-nologo",
-          ObjectName.c_str(), ("-out:" + OutputPath.u8string()).c_str()},
 #endif
-
+      Args,
 #if LLVM_VERSION_MAJOR >= 14
       llvm::outs(), llvm::errs(), false, false
 #elif LLVM_VERSION_MAJOR >= 10
@@ -4797,9 +5040,110 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
   return {};
 }
 
-Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
-                               Span<const Byte> Data,
-                               const llvm::SmallString<0> &OSVec) {
+/// Addresses of the symbols looked up by the loader.
+struct SymbolAddresses {
+  uint64_t Version = 0;
+  uint64_t Intrinsics = 0;
+  std::vector<uint64_t> Types;
+  std::vector<uint64_t> Codes;
+};
+
+SymbolAddresses
+resolveSymbols(Span<const std::pair<std::string, uint64_t>> SymbolTable) {
+  using namespace std::literals;
+  SymbolAddresses Symbols;
+  uint64_t CodesMin = std::numeric_limits<uint64_t>::max();
+  for (const auto &[Name, Address] : SymbolTable) {
+    if (Name == SYMBOL("version"sv)) {
+      Symbols.Version = Address;
+    } else if (Name == SYMBOL("intrinsics"sv)) {
+      Symbols.Intrinsics = Address;
+    } else if (startsWith(Name, SYMBOL("t"sv))) {
+      uint64_t Index = 0;
+      std::from_chars(Name.data() + SYMBOL("t"sv).size(),
+                      Name.data() + Name.size(), Index);
+      if (Symbols.Types.size() < Index + 1) {
+        Symbols.Types.resize(Index + 1);
+      }
+      Symbols.Types[Index] = Address;
+    } else if (startsWith(Name, SYMBOL("f"sv))) {
+      uint64_t Index = 0;
+      std::from_chars(Name.data() + SYMBOL("f"sv).size(),
+                      Name.data() + Name.size(), Index);
+      if (Symbols.Codes.size() < Index + 1) {
+        Symbols.Codes.resize(Index + 1);
+      }
+      CodesMin = std::min(CodesMin, Index);
+      Symbols.Codes[Index] = Address;
+    }
+  }
+  if (CodesMin != std::numeric_limits<uint64_t>::max()) {
+    Symbols.Codes.erase(Symbols.Codes.begin(),
+                        Symbols.Codes.begin() + static_cast<int64_t>(CodesMin));
+  }
+  return Symbols;
+}
+
+/// Header of a section in the image of an AOT section.
+struct ImageSectionHeader {
+  uint8_t Kind;
+  uint64_t Address;
+  uint64_t Size;
+};
+
+// Write the AOT section with the sections placed in the image, which starts at
+// the file offset SectionStart of the output.
+void writeAOTSection(llvm::SmallString<0> &OSCustomSecVec,
+                     uint64_t SectionStart, uint64_t Features,
+                     const SymbolAddresses &Symbols,
+                     Span<const ImageSectionHeader> Headers,
+                     Span<const char> Image) {
+  using namespace std::literals;
+  llvm::raw_svector_ostream OS(OSCustomSecVec);
+
+  WriteName(OS, "wasmedge"sv);
+  const uint64_t AOTSectionStart = OSCustomSecVec.size();
+  WriteU32(OS, WasmEdge::AOT::kBinaryVersion);
+
+  WriteByte(OS, kOSType);
+  WriteByte(OS, kArchType);
+  WriteU64(OS, Features);
+
+  WriteU64(OS, Symbols.Version);
+  WriteU64(OS, Symbols.Intrinsics);
+  WriteU64(OS, Symbols.Types.size());
+  for (const uint64_t TypeAddress : Symbols.Types) {
+    WriteU64(OS, TypeAddress);
+  }
+  WriteU64(OS, Symbols.Codes.size());
+  for (const uint64_t CodeAddress : Symbols.Codes) {
+    WriteU64(OS, CodeAddress);
+  }
+
+  WriteU32(OS, static_cast<uint32_t>(Headers.size()));
+  for (const auto &Header : Headers) {
+    WriteByte(OS, Header.Kind);
+    WriteU64(OS, Header.Address);
+    WriteU64(OS, Header.Size);
+  }
+
+  // Align the image to a page boundary of the output file, so that the
+  // loader can map the text sections from the file.
+  const uint64_t ImageStart = llvm::alignTo(
+      SectionStart + OSCustomSecVec.size() + 20, kImageAlignment);
+  WriteU64(OS, ImageStart - SectionStart - AOTSectionStart);
+  WriteU64(OS, Image.size());
+  OS.write_zeros(ImageStart - SectionStart - OSCustomSecVec.size());
+  OS.write(Image.data(), Image.size());
+}
+
+// Write the AOT section of a code variant, which starts at the file offset
+// SectionStart of the output.
+Expect<void> outputAOTSection(const std::filesystem::path &OutputPath,
+                              llvm::SmallString<0> &OSCustomSecVec,
+                              uint64_t SectionStart, uint64_t Features,
+                              const llvm::SmallString<0> &OSVec,
+                              Span<const std::string> FunctionObjects) {
   using namespace std::literals;
 
   std::string SharedObjectName;
@@ -4825,8 +5169,8 @@ Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
     llvm::consumeError(Object->keep());
   }
 
-  if (auto Res =
-          outputNativeLibrary(std::filesystem::u8path(SharedObjectName), OSVec);
+  if (auto Res = outputNativeLibrary(std::filesystem::u8path(SharedObjectName),
+                                    OSVec, FunctionObjects);
       unlikely(!Res)) {
     return Unexpect(Res);
   }
@@ -4849,143 +5193,112 @@ Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
     ObjFile = std::move(*Res);
   }
 
-  llvm::SmallString<0> OSCustomSecVec;
-  {
-    llvm::raw_svector_ostream OS(OSCustomSecVec);
-
-    WriteName(OS, "wasmedge"sv);
-    WriteU32(OS, WasmEdge::AOT::kBinaryVersion);
-
-#if WASMEDGE_OS_LINUX
-    WriteByte(OS, UINT8_C(1));
-#elif WASMEDGE_OS_MACOS
-    WriteByte(OS, UINT8_C(2));
-#elif WASMEDGE_OS_WINDOWS
-    WriteByte(OS, UINT8_C(3));
-#else
-#error Unsupported operating system!
-#endif
-
-#if defined(__x86_64__)
-    WriteByte(OS, UINT8_C(1));
-#elif defined(__aarch64__)
-    WriteByte(OS, UINT8_C(2));
-#else
-#error Unsupported hardware architecture!
-#endif
-
-    std::vector<std::pair<std::string, uint64_t>> SymbolTable;
+  std::vector<std::pair<std::string, uint64_t>> SymbolTable;
 #if !WASMEDGE_OS_WINDOWS
-    for (auto &Symbol : ObjFile->symbols()) {
-      std::string Name;
-      if (auto Res = Symbol.getName(); unlikely(!Res)) {
-        continue;
-      } else if (Res->empty()) {
-        continue;
-      } else {
-        Name = std::move(*Res);
-      }
-      uint64_t Address = 0;
-      if (auto Res = Symbol.getAddress(); unlikely(!Res)) {
-        continue;
-      } else {
-        Address = *Res;
-      }
-      SymbolTable.emplace_back(std::move(Name), std::move(Address));
+  for (auto &Symbol : ObjFile->symbols()) {
+    std::string Name;
+    if (auto Res = Symbol.getName(); unlikely(!Res)) {
+      continue;
+    } else if (Res->empty()) {
+      continue;
+    } else {
+      Name = std::move(*Res);
+    }
+    uint64_t Address = 0;
+    if (auto Res = Symbol.getAddress(); unlikely(!Res)) {
+      continue;
+    } else {
+      Address = *Res;
     }
+    SymbolTable.emplace_back(std::move(Name), std::move(Address));
+  }
 #else
-    for (auto &Symbol : llvm::cast<llvm::object::COFFObjectFile>(ObjFile.get())
-                            ->export_directories()) {
-      llvm::StringRef Name;
-      if (auto Error = Symbol.getSymbolName(Name); unlikely(!!Error)) {
-        continue;
-      } else if (Name.empty()) {
-        continue;
-      }
-      uint32_t Offset = 0;
-      if (auto Error = Symbol.getExportRVA(Offset); unlikely(!!Error)) {
-        continue;
-      }
-      SymbolTable.emplace_back(Name.str(), Offset);
+  for (auto &Symbol : llvm::cast<llvm::object::COFFObjectFile>(ObjFile.get())
+                          ->export_directories()) {
+    llvm::StringRef Name;
+    if (auto Error = Symbol.getSymbolName(Name); unlikely(!!Error)) {
+      continue;
+    } else if (Name.empty()) {
+      continue;
+    }
+    uint32_t Offset = 0;
+    if (auto Error = Symbol.getExportRVA(Offset); unlikely(!!Error)) {
+      continue;
     }
+    SymbolTable.emplace_back(Name.str(), Offset);
+  }
 #endif
-    uint64_t VersionAddress = 0, IntrinsicsAddress = 0;
-    std::vector<uint64_t> Types;
-    std::vector<uint64_t> Codes;
-    uint64_t CodesMin = std::numeric_limits<uint64_t>::max();
-    for (const auto &[Name, Address] : SymbolTable) {
-      if (Name == SYMBOL("version"sv)) {
-        VersionAddress = Address;
-      } else if (Name == SYMBOL("intrinsics"sv)) {
-        IntrinsicsAddress = Address;
-      } else if (startsWith(Name, SYMBOL("t"sv))) {
-        uint64_t Index = 0;
-        std::from_chars(Name.data() + SYMBOL("t"sv).size(),
-                        Name.data() + Name.size(), Index);
-        if (Types.size() < Index + 1) {
-          Types.resize(Index + 1);
-        }
-        Types[Index] = Address;
-      } else if (startsWith(Name, SYMBOL("f"sv))) {
-        uint64_t Index = 0;
-        std::from_chars(Name.data() + SYMBOL("f"sv).size(),
-                        Name.data() + Name.size(), Index);
-        if (Codes.size() < Index + 1) {
-          Codes.resize(Index + 1);
-        }
-        CodesMin = std::min(CodesMin, Index);
-        Codes[Index] = Address;
-      }
+
+  // The section contents are placed in an image at their addresses instead
+  // of following their headers.
+  std::vector<ImageSectionHeader> Headers;
+  uint64_t ImageSize = 0;
+  for (auto &Section : ObjFile->sections()) {
+    if (auto Res = Section.getContents(); unlikely(!Res)) {
+      continue;
     }
-    if (CodesMin != std::numeric_limits<uint64_t>::max()) {
-      Codes.erase(Codes.begin(),
-                  Codes.begin() + static_cast<int64_t>(CodesMin));
+    uint8_t Kind;
+    if (Section.isText()) {
+      Kind = UINT8_C(1);
+    } else if (Section.isData()) {
+      Kind = UINT8_C(2);
+    } else if (Section.isBSS()) {
+      Kind = UINT8_C(3);
+    } else {
+      continue;
     }
-    WriteU64(OS, VersionAddress);
-    WriteU64(OS, IntrinsicsAddress);
-    WriteU64(OS, Types.size());
-    for (const uint64_t TypeAddress : Types) {
-      WriteU64(OS, TypeAddress);
+    Headers.push_back({Kind, Section.getAddress(), Section.getSize()});
+    if (!Section.isBSS()) {
+      ImageSize =
+          std::max(ImageSize, Section.getAddress() + Section.getSize());
     }
-    WriteU64(OS, Codes.size());
-    for (const uint64_t CodeAddress : Codes) {
-      WriteU64(OS, CodeAddress);
+  }
+  std::vector<char> Image(ImageSize);
+  for (auto &Section : ObjFile->sections()) {
+    if (Section.isBSS() || (!Section.isText() && !Section.isData())) {
+      continue;
     }
-
-    uint32_t SectionCount = 0;
-    for (auto &Section : ObjFile->sections()) {
-      if (auto Res = Section.getContents(); unlikely(!Res)) {
-        continue;
-      }
-      if (!Section.isText() && !Section.isData() && !Section.isBSS()) {
-        continue;
-      }
-      ++SectionCount;
+    if (auto Res = Section.getContents(); likely(!!Res)) {
+      std::copy(Res->begin(), Res->end(), Image.data() + Section.getAddress());
+    } else {
+      llvm::consumeError(Res.takeError());
     }
-    WriteU32(OS, SectionCount);
+  }
 
-    for (auto &Section : ObjFile->sections()) {
-      const uint64_t Address = Section.getAddress();
-      const uint64_t Size = Section.getSize();
-      std::vector<char> Content;
-      if (auto Res = Section.getContents(); unlikely(!Res)) {
-        continue;
-      } else {
-        Content.assign(Res->begin(), Res->end());
-      }
-      if (Section.isText()) {
-        WriteByte(OS, UINT8_C(1));
-      } else if (Section.isData()) {
-        WriteByte(OS, UINT8_C(2));
-      } else if (Section.isBSS()) {
-        WriteByte(OS, UINT8_C(3));
-      } else {
-        continue;
-      }
-      WriteU64(OS, Address);
-      WriteU64(OS, Size);
-      WriteName(OS, std::string_view(Content.data(), Content.size()));
+  writeAOTSection(OSCustomSecVec, SectionStart, Features,
+                  resolveSymbols(SymbolTable), Headers, Image);
+
+  llvm::sys::fs::remove(SharedObjectName);
+  return {};
+}
+
+/// Compiled objects of a code variant.
+struct CodeObject {
+  /// Mask of the CPU features the code depends on.
+  uint64_t Features = 0;
+  /// Object of the whole module, or of the rest of the functions when
+  /// compiled incrementally.
+  llvm::SmallString<0> Object;
+  /// Paths of the cached objects of the functions compiled incrementally.
+  std::vector<std::string> FunctionObjects;
+};
+
+Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
+                               Span<const Byte> Data,
+                               Span<const CodeObject> Objects) {
+  // Append one AOT section for each code variant. A section starts after the
+  // previous ones, its section id and its padded size.
+  std::vector<llvm::SmallString<0>> Sections(Objects.size());
+  uint64_t FileSize = Data.size();
+  for (size_t I = 0; I < Objects.size(); ++I) {
+    const auto &Object = Objects[I];
+    if (auto Res = outputAOTSection(OutputPath, Sections[I], FileSize + 1 + 5,
+                                    Object.Features, Object.Object,
+                                    Object.FunctionObjects);
+        unlikely(!Res)) {
+      return Unexpect(Res);
     }
+    FileSize += 1 + 5 + Sections[I].size();
   }
 
   spdlog::info("output start");
@@ -4997,77 +5310,754 @@ Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
     return Unexpect(ErrCode::Value::IllegalPath);
   }
   OS.write(reinterpret_cast<const char *>(Data.data()), Data.size());
-  // Custom section id
-  WriteByte(OS, UINT8_C(0x00));
-  WriteName(OS, std::string_view(OSCustomSecVec.data(), OSCustomSecVec.size()));
-
-  llvm::sys::fs::remove(SharedObjectName);
+  for (const auto &OSCustomSecVec : Sections) {
+    // Custom section id
+    WriteByte(OS, UINT8_C(0x00));
+    WritePaddedU32(OS, static_cast<uint32_t>(OSCustomSecVec.size()));
+    OS.write(OSCustomSecVec.data(), OSCustomSecVec.size());
+  }
   return {};
 }
 
-} // namespace
+/// Memory manager of the in-memory linking, which lays out the sections one
+/// after another in an image. The text sections are on pages of their own for
+/// the loader to make them executable.
+class ImageMemoryManager final : public llvm::RuntimeDyld::MemoryManager {
+public:
+  struct Section {
+    uint8_t Kind;
+    uint64_t Offset;
+    uint64_t Size;
+    std::vector<Byte> Content;
+  };
 
-namespace WasmEdge {
-namespace AOT {
+  uint8_t *allocateCodeSection(uintptr_t Size, unsigned, unsigned,
+                               llvm::StringRef) override {
+    return allocate(UINT8_C(1), Size, kImageAlignment);
+  }
+  uint8_t *allocateDataSection(uintptr_t Size, unsigned Alignment, unsigned,
+                               llvm::StringRef, bool) override {
+    return allocate(UINT8_C(2), Size, Alignment);
+  }
+  void registerEHFrames(uint8_t *, uint64_t, size_t) override {}
+  void deregisterEHFrames() override {}
+  bool finalizeMemory(std::string *) override { return false; }
 
-Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
-                               std::filesystem::path OutputPath) {
-  // Check the module is validated.
-  if (unlikely(!Module.getIsValidated())) {
-    spdlog::error(ErrCode::Value::NotValidated);
-    return Unexpect(ErrCode::Value::NotValidated);
+  /// Tell the linker the addresses of the sections in the image at Base.
+  void mapSections(llvm::RuntimeDyld &Dyld, uint64_t Base) const {
+    for (const auto &S : Sections) {
+      Dyld.mapSectionAddress(S.Content.data(), Base + S.Offset);
+    }
   }
 
-  using namespace std::literals;
+  const std::vector<Section> &getSections() const noexcept { return Sections; }
 
-  std::unique_lock Lock(Mutex);
-  spdlog::info("compile start");
-  std::filesystem::path LLPath(OutputPath);
-  LLPath.replace_extension("ll"sv);
+private:
+  uint8_t *allocate(uint8_t Kind, uint64_t Size, uint64_t Alignment) {
+    const uint64_t Offset =
+        llvm::alignTo(End, std::max<uint64_t>(Alignment, 1));
+    // Keep a valid address for the empty sections.
+    auto &S = Sections.emplace_back(Section{
+        Kind, Offset, Size, std::vector<Byte>(std::max<uint64_t>(Size, 1))});
+    End = Offset + Size;
+    if (Kind == UINT8_C(1)) {
+      End = llvm::alignTo(End, kImageAlignment);
+    }
+    return S.Content.data();
+  }
 
-  llvm::InitializeNativeTarget();
-  llvm::InitializeNativeTargetAsmPrinter();
+  std::vector<Section> Sections;
+  uint64_t End = 0;
+};
 
-  llvm::LLVMContext LLContext;
-  llvm::Module LLModule(LLPath.u8string(), LLContext);
-  LLModule.setTargetTriple(llvm::sys::getProcessTriple());
-#if WASMEDGE_OS_MACOS
-  LLModule.setPICLevel(llvm::PICLevel::Level::BigPIC);
-#elif WASMEDGE_OS_LINUX | WASMEDGE_OS_WINDOWS
-  LLModule.setPICLevel(llvm::PICLevel::Level::SmallPIC);
-#endif
-  CompileContext NewContext(LLModule,
-                            Conf.getCompilerConfigure().isGenericBinary());
-  struct RAIICleanup {
-    RAIICleanup(CompileContext *&Context, CompileContext &NewContext)
-        : Context(Context) {
-      Context = &NewContext;
+/// Symbol resolver of the in-memory linking. The compiled code calls the
+/// runtime only through the intrinsics table, so no external symbol is
+/// expected.
+class NoExternalResolver final : public llvm::JITSymbolResolver {
+public:
+  void lookup(const LookupSet &Symbols,
+              OnResolvedFunction OnResolved) override {
+    if (Symbols.empty()) {
+      OnResolved(LookupResult{});
+      return;
     }
-    ~RAIICleanup() { Context = nullptr; }
-    CompileContext *&Context;
-  };
-  RAIICleanup Cleanup(Context, NewContext);
+    OnResolved(llvm::make_error<llvm::StringError>(
+        "undefined symbol " + Symbols.begin()->str(),
+        llvm::inconvertibleErrorCode()));
+  }
+  llvm::Expected<LookupSet> getResponsibilitySet(const LookupSet &) override {
+    return LookupSet{};
+  }
+};
 
-  // Compile Function Types
-  compile(Module.getTypeSection());
-  // Compile ImportSection
-  compile(Module.getImportSection());
-  // Compile GlobalSection
-  compile(Module.getGlobalSection());
-  // Compile MemorySection (MemorySec, DataSec)
-  compile(Module.getMemorySection(), Module.getDataSection());
-  // Compile TableSection (TableSec, ElemSec)
-  compile(Module.getTableSection(), Module.getElementSection());
-  // compile Functions in module. (FunctionSec, CodeSec)
-  compile(Module.getFunctionSection(), Module.getCodeSection());
+/// Image of an object linked in memory, with the offsets of its symbols.
+struct LinkedImage {
+  std::vector<ImageMemoryManager::Section> Sections;
+  std::vector<std::pair<std::string, uint64_t>> SymbolTable;
+};
+
+Expect<LinkedImage> linkObject(const llvm::object::ObjectFile &ObjFile,
+                               uint64_t Base) {
+  ImageMemoryManager MemoryManager;
+  NoExternalResolver Resolver;
+  llvm::RuntimeDyld Dyld(MemoryManager, Resolver);
+  if (auto Info = Dyld.loadObject(ObjFile);
+      unlikely(!Info || Dyld.hasError())) {
+    spdlog::error("object file link error:{}", Dyld.getErrorString().str());
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  MemoryManager.mapSections(Dyld, Base);
+  Dyld.resolveRelocations();
+  if (unlikely(Dyld.hasError())) {
+    spdlog::error("object file link error:{}", Dyld.getErrorString().str());
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+
+  LinkedImage Image;
+  for (auto &Symbol : ObjFile.symbols()) {
+    auto Name = Symbol.getName();
+    if (unlikely(!Name)) {
+      llvm::consumeError(Name.takeError());
+      continue;
+    }
+    if (Name->empty()) {
+      continue;
+    }
+    // Only the symbols defined by the object are found.
+    if (auto Sym = Dyld.getSymbol(*Name); Sym) {
+      Image.SymbolTable.emplace_back(Name->str(), Sym.getAddress() - Base);
+    }
+  }
+  Image.Sections = MemoryManager.getSections();
+  return Image;
+}
+
+// Link the object in memory into the AOT section of a code variant. The loader
+// copies the image to an address unknown here, so the image is linked at two
+// bases and rejected if they differ, which means that the code is not position
+// independent.
+Expect<void> relocateObject(const llvm::SmallString<0> &OSVec,
+                            uint64_t Features, AST::AOTSection &AOTSection) {
+  std::unique_ptr<llvm::object::ObjectFile> ObjFile;
+  if (auto Res = llvm::object::ObjectFile::createObjectFile(
+          llvm::MemoryBufferRef(OSVec.str(), "wasm"));
+      unlikely(!Res)) {
+    spdlog::error("object file parse error:{}",
+                  llvm::toString(Res.takeError()));
+    return Unexpect(ErrCode::Value::IllegalPath);
+  } else {
+    ObjFile = std::move(*Res);
+  }
+
+  LinkedImage Image;
+  if (auto Res = linkObject(*ObjFile, UINT64_C(1) << 32); unlikely(!Res)) {
+    return Unexpect(Res);
+  } else {
+    Image = std::move(*Res);
+  }
+  if (auto Res = linkObject(*ObjFile, UINT64_C(2) << 32); unlikely(!Res)) {
+    return Unexpect(Res);
+  } else {
+    const auto Same = [](const ImageMemoryManager::Section &L,
+                         const ImageMemoryManager::Section &R) {
+      return L.Kind == R.Kind && L.Offset == R.Offset && L.Size == R.Size &&
+             L.Content == R.Content;
+    };
+    if (unlikely(!std::equal(Image.Sections.begin(), Image.Sections.end(),
+                             Res->Sections.begin(), Res->Sections.end(),
+                             Same) ||
+                 Image.SymbolTable != Res->SymbolTable)) {
+      spdlog::error("object file is not position independent");
+      return Unexpect(ErrCode::Value::IllegalPath);
+    }
+  }
+
+  AOTSection.setVersion(WasmEdge::AOT::kBinaryVersion);
+  AOTSection.setOSType(kOSType);
+  AOTSection.setArchType(kArchType);
+  AOTSection.setCPUFeatures(Features);
+  auto Symbols = resolveSymbols(Image.SymbolTable);
+  AOTSection.setVersionAddress(Symbols.Version);
+  AOTSection.setIntrinsicsAddress(Symbols.Intrinsics);
+  AOTSection.getTypesAddress().assign(Symbols.Types.begin(),
+                                      Symbols.Types.end());
+  AOTSection.getCodesAddress().assign(Symbols.Codes.begin(),
+                                      Symbols.Codes.end());
+  auto &Sections = AOTSection.getSections();
+  Sections.clear();
+  for (auto &S : Image.Sections) {
+    S.Content.resize(S.Size);
+    Sections.emplace_back(S.Kind, S.Offset, S.Size, std::move(S.Content));
+  }
+  return {};
+}
+
+bool readU32(Span<const Byte> Data, size_t &Offset, uint32_t &Value) {
+  Value = 0;
+  for (uint32_t Shift = 0; Shift < 35; Shift += 7) {
+    if (Offset >= Data.size()) {
+      return false;
+    }
+    const Byte B = Data[Offset++];
+    Value |= static_cast<uint32_t>(B & UINT8_C(0x7F)) << Shift;
+    if ((B & UINT8_C(0x80)) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Split the binary into the sections which the compiled code depends on, and
+// the bodies of the functions in the code section.
+bool scanFunctionSources(Span<const Byte> Data,
+                         std::vector<Span<const Byte>> &ContextSections,
+                         std::vector<Span<const Byte>> &FunctionBodies) {
+  // Skip the magic and the version.
+  size_t Offset = 8;
+  while (Offset < Data.size()) {
+    const size_t Start = Offset;
+    const Byte Id = Data[Offset++];
+    uint32_t Size;
+    if (!readU32(Data, Offset, Size) || Size > Data.size() - Offset) {
+      return false;
+    }
+    const auto Content = Data.subspan(Offset, Size);
+    Offset += Size;
+    switch (Id) {
+    case 0x00: // Custom section
+    case 0x07: // Export section
+    case 0x08: // Start section
+    case 0x09: // Element section
+    case 0x0B: // Data section
+    case 0x0C: // Data count section
+      // The compiled functions only refer to the indices of them.
+      break;
+    case 0x0A: { // Code section
+      size_t Pos = 0;
+      uint32_t Count;
+      if (!readU32(Content, Pos, Count)) {
+        return false;
+      }
+      for (uint32_t I = 0; I < Count; ++I) {
+        uint32_t BodySize;
+        if (!readU32(Content, Pos, BodySize) ||
+            BodySize > Content.size() - Pos) {
+          return false;
+        }
+        FunctionBodies.push_back(Content.subspan(Pos, BodySize));
+        Pos += BodySize;
+      }
+      break;
+    }
+    default:
+      ContextSections.push_back(Data.subspan(Start, Offset - Start));
+      break;
+    }
+  }
+  return true;
+}
+
+// Write the object into the cache. The file is renamed into place, so that
+// the concurrent compilations never read a partial one.
+Expect<void> writeCacheFile(const std::filesystem::path &Path,
+                            const llvm::SmallString<0> &OSVec) {
+  std::error_code EC;
+  std::filesystem::create_directories(Path.parent_path(), EC);
+  auto File = llvm::sys::fs::TempFile::create(Path.u8string() + ".%%%%%%");
+  if (!File) {
+    spdlog::error("cache file creation failed:{}", Path.u8string());
+    llvm::consumeError(File.takeError());
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  {
+    llvm::raw_fd_ostream OS(File->FD, false);
+    OS.write(OSVec.data(), OSVec.size());
+#if WASMEDGE_OS_WINDOWS
+    OS.flush();
+#else
+    OS.close();
+#endif
+  }
+  if (auto Err = File->keep(Path.u8string())) {
+    spdlog::error("cache file creation failed:{}", Path.u8string());
+    llvm::consumeError(std::move(Err));
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  return {};
+}
+
+Expect<std::unique_ptr<llvm::TargetMachine>>
+createTargetMachine(const llvm::Module &LLModule, const std::string &CPU,
+                    const std::string &Features,
+                    CompilerConfigure::OptimizationLevel Level) {
+  llvm::Triple Triple(LLModule.getTargetTriple());
+  std::string Error;
+  const llvm::Target *TheTarget =
+      llvm::TargetRegistry::lookupTarget(Triple.getTriple(), Error);
+  if (!TheTarget) {
+    // TODO:return error
+    spdlog::error("lookupTarget failed:{}", Error);
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+
+  llvm::TargetOptions Options;
+  llvm::Reloc::Model RM = llvm::Reloc::PIC_;
+  auto CodeGenLevel = llvm::CodeGenOpt::Level::Aggressive;
+  if (Level == CompilerConfigure::OptimizationLevel::O0) {
+    // Select the instructions quickly for the fastest code generation.
+    CodeGenLevel = llvm::CodeGenOpt::Level::None;
+    Options.EnableFastISel = true;
+  }
+  return std::unique_ptr<llvm::TargetMachine>(
+      TheTarget->createTargetMachine(Triple.str(), CPU, Features, Options, RM,
+                                     llvm::None, CodeGenLevel));
+}
+
+void optimize(llvm::Module &LLModule, llvm::TargetMachine &TM,
+              CompilerConfigure::OptimizationLevel Level,
+              bool PromoteLocals) {
+  llvm::TargetLibraryInfoImpl TLII(llvm::Triple(LLModule.getTargetTriple()));
+#if LLVM_VERSION_MAJOR == 12
+  llvm::PassBuilder PB(false, &TM);
+#else
+  llvm::PassBuilder PB(&TM);
+#endif
+
+  llvm::LoopAnalysisManager LAM;
+  llvm::FunctionAnalysisManager FAM;
+  llvm::CGSCCAnalysisManager CGAM;
+  llvm::ModuleAnalysisManager MAM;
+
+  // Register the AA manager first so that our version is the one
+  // used.
+  FAM.registerPass([&] { return PB.buildDefaultAAPipeline(); });
+
+  // Register the target library analysis directly and give it a
+  // customized preset TLI.
+  FAM.registerPass([&] { return llvm::TargetLibraryAnalysis(TLII); });
+#if LLVM_VERSION_MAJOR <= 9
+  MAM.registerPass([&] { return llvm::TargetLibraryAnalysis(TLII); });
+#endif
+
+  // Register all the basic analyses with the managers.
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  llvm::ModulePassManager MPM;
+  if (Level == CompilerConfigure::OptimizationLevel::O0) {
+    if (PromoteLocals) {
+      // Keep the locals in the registers.
+      MPM.addPass(llvm::createModuleToFunctionPassAdaptor(llvm::PromotePass()));
+    }
+    MPM.addPass(
+        llvm::createModuleToFunctionPassAdaptor(llvm::TailCallElimPass()));
+    MPM.addPass(llvm::AlwaysInlinerPass(false));
+  } else {
+    MPM.addPass(PB.buildPerModuleDefaultPipeline(toLLVMLevel(Level)));
+  }
+
+  MPM.run(LLModule, MAM);
+}
+
+// Set initializer for constant value. The table is only a declaration during
+// the optimization, which must not assume its content.
+void defineIntrinsicsTable(llvm::Module &LLModule) {
+  if (auto *IntrinsicsTable = LLModule.getNamedGlobal("intrinsics")) {
+    IntrinsicsTable->setInitializer(llvm::ConstantPointerNull::get(
+        llvm::cast<llvm::PointerType>(IntrinsicsTable->getValueType())));
+    IntrinsicsTable->setConstant(false);
+  }
+}
+
+void initNativeTarget() {
+  static std::once_flag InitTarget;
+  std::call_once(InitTarget, []() {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+  });
+}
+
+/// Write everything the compiled code depends on besides the wasm binary,
+/// which keys the cached code.
+void writeCodegenOptions(std::ostream &OS, const Configure &Conf,
+                         std::string_view Triple, std::string_view CPUName,
+                         std::string_view Features,
+                         const PGO::Profile *Profile) {
+  const auto &CompilerConf = Conf.getCompilerConfigure();
+  const auto &StatConf = Conf.getStatisticsConfigure();
+  OS << kVersionString << ' ' << LLVM_VERSION_STRING << ' '
+     << WasmEdge::AOT::kBinaryVersion << ' ' << Triple << ' ' << CPUName
+     << ' ' << Features << ' '
+     << static_cast<uint32_t>(CompilerConf.getOptimizationLevel()) << ' '
+     << CompilerConf.isInterruptible() << CompilerConf.isWasmOptimization()
+     << StatConf.isInstructionCounting() << StatConf.isCostMeasuring() << '\n';
+  if (Profile) {
+    Profile->dump(OS);
+  }
+}
+
+Expect<void> emitObject(llvm::Module &LLModule, llvm::TargetMachine &TM,
+                        llvm::SmallString<0> &OSVec) {
+  llvm::TargetLibraryInfoImpl TLII(llvm::Triple(LLModule.getTargetTriple()));
+  llvm::legacy::PassManager CodeGenPasses;
+  CodeGenPasses.add(
+      llvm::createTargetTransformInfoWrapperPass(TM.getTargetIRAnalysis()));
+
+  // Add LibraryInfo.
+  CodeGenPasses.add(new llvm::TargetLibraryInfoWrapperPass(TLII));
+
+  llvm::raw_svector_ostream OS(OSVec);
+#if LLVM_VERSION_MAJOR >= 10
+  using llvm::CGFT_ObjectFile;
+#else
+  const auto CGFT_ObjectFile = llvm::TargetMachine::CGFT_ObjectFile;
+#endif
+  if (TM.addPassesToEmitFile(CodeGenPasses, OS, nullptr, CGFT_ObjectFile,
+                             false)) {
+    // TODO:return error
+    spdlog::error("addPassesToEmitFile failed");
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  CodeGenPasses.run(LLModule);
+  return {};
+}
+
+} // namespace
+
+namespace WasmEdge {
+namespace AOT {
+
+struct Compiler::TargetCPU {
+  /// LLVM CPU name.
+  std::string Name;
+  /// LLVM subtarget features.
+  llvm::StringMap<bool> FeatureMap;
+  /// Mask of the features in the bits of CPU::featureNames().
+  uint64_t Features = 0;
+  /// Target machine of the code generation.
+  std::unique_ptr<llvm::TargetMachine> Machine;
+  /// Compiled object file.
+  llvm::SmallString<0> Object;
+  /// Paths of the cached objects of the functions compiled incrementally.
+  std::vector<std::string> FunctionObjects;
+};
+
+struct Compiler::Session {
+  Session(const PGO::Profile *Profile, const ProgressCallback &Progress,
+          const std::atomic<bool> *Cancel) noexcept
+      : Profile(Profile), Progress(Progress), Cancel(Cancel) {}
+
+  /// Finish a step and report the progress. Return false if cancelled.
+  bool step() {
+    ++Done;
+    if (Progress) {
+      Progress(Done, Total);
+    }
+    return !isCancelled();
+  }
+  bool isCancelled() const noexcept {
+    return Cancel && Cancel->load(std::memory_order_relaxed);
+  }
+
+  const PGO::Profile *const Profile;
+  const ProgressCallback &Progress;
+  const std::atomic<bool> *const Cancel;
+  uint64_t Done = 0;
+  uint64_t Total = 0;
+  /// Whether to compile the functions incrementally, with the sections of the
+  /// binary the compiled code depends on, and the bodies of the functions.
+  bool Incremental = false;
+  std::vector<Span<const Byte>> ContextSections;
+  std::vector<Span<const Byte>> FunctionBodies;
+  /// Whether to compile into memory instead of a file.
+  bool InMemory = false;
+};
+
+Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
+                               std::filesystem::path OutputPath,
+                               const ProgressCallback &Progress,
+                               const std::atomic<bool> *Cancel) {
+  // Check the module is validated.
+  if (unlikely(!Module.getIsValidated())) {
+    spdlog::error(ErrCode::Value::NotValidated);
+    return Unexpect(ErrCode::Value::NotValidated);
+  }
+
+  using namespace std::literals;
+
+  Session S = [&]() {
+    std::unique_lock Lock(Mutex);
+    return Session(Profile, Progress, Cancel);
+  }();
+  if (S.isCancelled()) {
+    return Unexpect(ErrCode::Value::Cancelled);
+  }
+  spdlog::info("compile start");
+  std::filesystem::path LLPath(OutputPath);
+  LLPath.replace_extension("ll"sv);
+
+  initNativeTarget();
+
+  // Resolve the CPUs to compile the code variants for.
+  std::vector<TargetCPU> Targets;
+  if (const auto Names = Conf.getCompilerConfigure().getTargetCPUs();
+      Names.empty()) {
+    auto &Target = Targets.emplace_back();
+    if (Conf.getCompilerConfigure().isGenericBinary()) {
+      Target.Name = "generic";
+    } else {
+      Target.Name = llvm::sys::getHostCPUName().str();
+      llvm::sys::getHostCPUFeatures(Target.FeatureMap);
+    }
+  } else {
+    for (const auto &Name : Names) {
+      const auto Features = CPU::levelFeatures(Name);
+      if (!Features) {
+        spdlog::error("unknown target CPU:{}", Name);
+        return Unexpect(ErrCode::Value::RuntimeError);
+      }
+      auto &Target = Targets.emplace_back();
+      Target.Name = Name;
+      const auto FeatureNames = CPU::featureNames();
+      for (size_t I = 0; I < FeatureNames.size(); ++I) {
+        Target.FeatureMap[FeatureNames[I]] = (*Features >> I) & 1U;
+      }
+    }
+    // The native library holds only one variant.
+    if (Conf.getCompilerConfigure().getOutputFormat() ==
+        CompilerConfigure::OutputFormat::Native) {
+      Targets.resize(1);
+    }
+  }
+  // Record the features which the code depends on, for the loader to check.
+  for (auto &Target : Targets) {
+    const auto FeatureNames = CPU::featureNames();
+    for (size_t I = 0; I < FeatureNames.size(); ++I) {
+      if (Target.FeatureMap.lookup(FeatureNames[I])) {
+        Target.Features |= UINT64_C(1) << I;
+      }
+    }
+  }
+
+  const size_t CodeNum = Module.getCodeSection().getContent().size();
+  if (Conf.getCompilerConfigure().isIncremental()) {
+    S.Incremental =
+        scanFunctionSources(Data, S.ContextSections, S.FunctionBodies) &&
+        S.FunctionBodies.size() == CodeNum;
+    if (!S.Incremental) {
+      spdlog::warn("code section not found, compile the whole module");
+    }
+  }
+
+  // Each function is translated, and then the module is optimized and
+  // generated as a whole, or the rest and each function are separately.
+  const size_t TargetSteps = S.Incremental ? CodeNum * 2 + 1 : CodeNum + 2;
+  S.Total = Targets.size() * TargetSteps + 1;
+  std::vector<CodeObject> Objects;
+  for (auto &Target : Targets) {
+    spdlog::info("compile for {}", Target.Name);
+    if (auto Res = compile(Data, Module, LLPath, Target, S); unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+    Objects.push_back(CodeObject{Target.Features, std::move(Target.Object),
+                                 std::move(Target.FunctionObjects)});
+  }
+
+  switch (Conf.getCompilerConfigure().getOutputFormat()) {
+  case CompilerConfigure::OutputFormat::Native:
+    if (auto Res = outputNativeLibrary(OutputPath, Objects.front().Object,
+                                       Objects.front().FunctionObjects);
+        unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+    break;
+  case CompilerConfigure::OutputFormat::Wasm:
+    if (auto Res = outputWasmLibrary(OutputPath, Data, Objects);
+        unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+    break;
+  }
+  S.step();
+
+  return {};
+}
+
+Expect<void> Compiler::compile(Span<const Byte> Data, AST::Module &Module,
+                               const ProgressCallback &Progress,
+                               const std::atomic<bool> *Cancel) {
+  // Check the module is validated.
+  if (unlikely(!Module.getIsValidated())) {
+    spdlog::error(ErrCode::Value::NotValidated);
+    return Unexpect(ErrCode::Value::NotValidated);
+  }
+
+  Session S = [&]() {
+    std::unique_lock Lock(Mutex);
+    return Session(Profile, Progress, Cancel);
+  }();
+  if (S.isCancelled()) {
+    return Unexpect(ErrCode::Value::Cancelled);
+  }
+  S.InMemory = true;
+  spdlog::info("compile start");
+
+  initNativeTarget();
+
+  // The code runs only on this host, so it is compiled for the host CPU.
+  TargetCPU Target;
+  Target.Name = llvm::sys::getHostCPUName().str();
+  llvm::sys::getHostCPUFeatures(Target.FeatureMap);
+  const auto FeatureNames = CPU::featureNames();
+  for (size_t I = 0; I < FeatureNames.size(); ++I) {
+    if (Target.FeatureMap.lookup(FeatureNames[I])) {
+      Target.Features |= UINT64_C(1) << I;
+    }
+  }
+
+  S.Total = Module.getCodeSection().getContent().size() + 3;
+  if (auto Res = compile(Data, Module, "wasm", Target, S); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+
+  spdlog::info("link start");
+  if (auto Res = relocateObject(Target.Object, Target.Features,
+                                Module.getAOTSection());
+      unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+  S.step();
+
+  return {};
+}
+
+std::string Compiler::getCacheKey() {
+  llvm::StringMap<bool> FeatureMap;
+  llvm::sys::getHostCPUFeatures(FeatureMap);
+  llvm::SubtargetFeatures Features;
+  for (auto &Feature : FeatureMap) {
+    Features.AddFeature(Feature.first(), Feature.second);
+  }
+  std::ostringstream OS;
+  {
+    std::unique_lock Lock(Mutex);
+    writeCodegenOptions(OS, Conf, llvm::sys::getProcessTriple(),
+                        llvm::sys::getHostCPUName(), Features.getString(),
+                        Profile);
+  }
+  const auto Options = OS.str();
+
+  Blake3 Hasher;
+  Hasher.update(Span<const Byte>(
+      reinterpret_cast<const Byte *>(Options.data()), Options.size()));
+  std::array<Byte, 32> Hash;
+  Hasher.finalize(Hash);
+  std::string Key;
+  convertBytesToHexStr(Hash, Key);
+  return Key;
+}
+
+Expect<void> Compiler::output(Span<const Byte> Data,
+                              const AST::AOTSection &AOTSection,
+                              const std::filesystem::path &OutputPath) {
+  SymbolAddresses Symbols;
+  Symbols.Version = AOTSection.getVersionAddress();
+  Symbols.Intrinsics = AOTSection.getIntrinsicsAddress();
+  Symbols.Types.assign(AOTSection.getTypesAddress().begin(),
+                       AOTSection.getTypesAddress().end());
+  Symbols.Codes.assign(AOTSection.getCodesAddress().begin(),
+                       AOTSection.getCodesAddress().end());
+
+  std::vector<ImageSectionHeader> Headers;
+  uint64_t ImageSize = 0;
+  for (const auto &[Kind, Offset, Size, Content] : AOTSection.getSections()) {
+    Headers.push_back({Kind, Offset, Size});
+    if (Kind != UINT8_C(3)) {
+      ImageSize = std::max(ImageSize, Offset + Size);
+    }
+  }
+  std::vector<char> Image(ImageSize);
+  for (const auto &[Kind, Offset, Size, Content] : AOTSection.getSections()) {
+    if (Kind != UINT8_C(3)) {
+      std::copy(Content.begin(), Content.end(), Image.data() + Offset);
+    }
+  }
+
+  // The AOT section follows the binary, its section id and its padded size.
+  llvm::SmallString<0> OSCustomSecVec;
+  writeAOTSection(OSCustomSecVec, Data.size() + 1 + 5,
+                  AOTSection.getCPUFeatures(), Symbols, Headers, Image);
+
+  llvm::SmallString<0> OSVec;
+  {
+    llvm::raw_svector_ostream OS(OSVec);
+    OS.write(reinterpret_cast<const char *>(Data.data()), Data.size());
+    // Custom section id
+    WriteByte(OS, UINT8_C(0x00));
+    WritePaddedU32(OS, static_cast<uint32_t>(OSCustomSecVec.size()));
+    OS.write(OSCustomSecVec.data(), OSCustomSecVec.size());
+  }
+  return writeCacheFile(OutputPath, OSVec);
+}
+
+Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
+                               const std::filesystem::path &LLPath,
+                               TargetCPU &Target, Session &S) {
+  llvm::LLVMContext LLContext;
+  llvm::Module LLModule(LLPath.u8string(), LLContext);
+  LLModule.setTargetTriple(llvm::sys::getProcessTriple());
+#if WASMEDGE_OS_MACOS
+  LLModule.setPICLevel(llvm::PICLevel::Level::BigPIC);
+#elif WASMEDGE_OS_LINUX | WASMEDGE_OS_WINDOWS
+  LLModule.setPICLevel(llvm::PICLevel::Level::SmallPIC);
+#endif
+  CompileContext Context(LLModule, Target.FeatureMap);
+
+  // Compile Function Types
+  compile(Context, Module.getTypeSection());
+  // Compile ImportSection
+  compile(Context, Module.getImportSection());
+  // Compile GlobalSection
+  compile(Context, Module.getGlobalSection());
+  // Compile MemorySection (MemorySec, DataSec)
+  compile(Context, Module.getMemorySection(), Module.getDataSection());
+  // Compile TableSection (TableSec, ElemSec)
+  compile(Context, Module.getTableSection(), Module.getElementSection());
+  // compile Functions in module. (FunctionSec, CodeSec)
+  if (auto Res = compile(Context, S, Module.getFunctionSection(),
+                         Module.getCodeSection());
+      unlikely(!Res)) {
+    return Unexpect(Res);
+  }
   // Compile ExportSection
-  compile(Module.getExportSection());
+  compile(Context, Module.getExportSection());
   // StartSection is not required to compile
 
-  if (Conf.getCompilerConfigure().getOutputFormat() ==
-      CompilerConfigure::OutputFormat::Native) {
+  // Summarize the execution profile for telling the hot and cold code apart.
+  if (S.Profile && !S.Profile->empty()) {
+    LLModule.setProfileSummary(createProfileSummary(LLContext, *S.Profile),
+                               llvm::ProfileSummary::PSK_Instr);
+  }
+
+  // Alias the compiled functions with their names for the profilers. The
+  // prefix keeps the aliases apart from the symbols looked up by the loader.
+  for (const auto &[Idx, Name] : Module.getFunctionNames()) {
+    if (Idx >= Context.Functions.size()) {
+      continue;
+    }
+    if (auto [T, F, Code] = Context.Functions[Idx]; Code) {
+      llvm::GlobalAlias::create(llvm::GlobalValue::ExternalLinkage,
+                                "wasm:" + Name, F);
+    }
+  }
+
+  if (!S.InMemory && Conf.getCompilerConfigure().getOutputFormat() ==
+                         CompilerConfigure::OutputFormat::Native) {
     // create wasm.code and wasm.size
-    auto *Int32Ty = Context->Int32Ty;
+    auto *Int32Ty = Context.Int32Ty;
     auto *Content = llvm::ConstantDataArray::getString(
         LLContext,
         llvm::StringRef(reinterpret_cast<const char *>(Data.data()),
@@ -5098,161 +6088,210 @@ Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
 
   spdlog::info("verify start");
   llvm::verifyModule(LLModule, &llvm::errs());
-  spdlog::info("optimize start");
 
-  llvm::SmallString<0> OSVec;
-
-  // optimize + codegen
-  llvm::Triple Triple(LLModule.getTargetTriple());
-  {
-    std::string Error;
-    const llvm::Target *TheTarget =
-        llvm::TargetRegistry::lookupTarget(Triple.getTriple(), Error);
-    if (!TheTarget) {
-      // TODO:return error
-      spdlog::error("lookupTarget failed:{}", Error);
-      return Unexpect(ErrCode::Value::IllegalPath);
-    }
-
-    llvm::TargetOptions Options;
-    llvm::Reloc::Model RM = llvm::Reloc::PIC_;
-    llvm::StringRef CPUName("generic");
-    if (!Conf.getCompilerConfigure().isGenericBinary()) {
-      CPUName = llvm::sys::getHostCPUName();
-    }
-    std::unique_ptr<llvm::TargetMachine> TM(TheTarget->createTargetMachine(
-        Triple.str(), CPUName, Context->SubtargetFeatures.getString(), Options,
-        RM, llvm::None, llvm::CodeGenOpt::Level::Aggressive));
-    LLModule.setDataLayout(TM->createDataLayout());
+  if (auto Res = createTargetMachine(
+          LLModule, Target.Name, Context.SubtargetFeatures.getString(),
+          Conf.getCompilerConfigure().getOptimizationLevel());
+      unlikely(!Res)) {
+    return Unexpect(Res);
+  } else {
+    Target.Machine = std::move(*Res);
+  }
+  LLModule.setDataLayout(Target.Machine->createDataLayout());
 
-    llvm::TargetLibraryInfoImpl TLII(Triple);
+  if (S.Incremental) {
+    return compileIncremental(Context, Target, S);
+  }
 
-    {
-#if LLVM_VERSION_MAJOR == 12
-      llvm::PassBuilder PB(false, TM.get());
-#else
-      llvm::PassBuilder PB(TM.get());
-#endif
+  // optimize + codegen
+  spdlog::info("optimize start");
+  optimize(LLModule, *Target.Machine,
+           Conf.getCompilerConfigure().getOptimizationLevel(),
+           Conf.getCompilerConfigure().isWasmOptimization());
+  if (!S.step()) {
+    return Unexpect(ErrCode::Value::Cancelled);
+  }
+  defineIntrinsicsTable(LLModule);
 
-      llvm::LoopAnalysisManager LAM;
-      llvm::FunctionAnalysisManager FAM;
-      llvm::CGSCCAnalysisManager CGAM;
-      llvm::ModuleAnalysisManager MAM;
+  if (Conf.getCompilerConfigure().isDumpIR()) {
+    int Fd;
+    llvm::sys::fs::openFileForWrite("wasm-opt.ll", Fd);
+    llvm::raw_fd_ostream LLOS(Fd, true);
+    LLModule.print(LLOS, nullptr);
+  }
+  spdlog::info("codegen start");
+  if (auto Res = emitObject(LLModule, *Target.Machine, Target.Object);
+      unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+  if (!S.step()) {
+    return Unexpect(ErrCode::Value::Cancelled);
+  }
 
-      // Register the AA manager first so that our version is the one
-      // used.
-      FAM.registerPass([&] { return PB.buildDefaultAAPipeline(); });
+  return {};
+}
 
-      // Register the target library analysis directly and give it a
-      // customized preset TLI.
-      FAM.registerPass([&] { return llvm::TargetLibraryAnalysis(TLII); });
-#if LLVM_VERSION_MAJOR <= 9
-      MAM.registerPass([&] { return llvm::TargetLibraryAnalysis(TLII); });
-#endif
+Expect<void> Compiler::compileIncremental(CompileContext &Context,
+                                          TargetCPU &Target, Session &S) {
+  using namespace std::literals;
+  auto &LLModule = Context.LLModule;
+  const auto Level = Conf.getCompilerConfigure().getOptimizationLevel();
 
-      // Register all the basic analyses with the managers.
-      PB.registerModuleAnalyses(MAM);
-      PB.registerCGSCCAnalyses(CGAM);
-      PB.registerFunctionAnalyses(FAM);
-      PB.registerLoopAnalyses(LAM);
-      PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
-
-      llvm::ModulePassManager MPM;
-      if (Conf.getCompilerConfigure().getOptimizationLevel() ==
-          CompilerConfigure::OptimizationLevel::O0) {
-        MPM.addPass(
-            llvm::createModuleToFunctionPassAdaptor(llvm::TailCallElimPass()));
-        MPM.addPass(llvm::AlwaysInlinerPass(false));
-      } else {
-        MPM.addPass(PB.buildPerModuleDefaultPipeline(
-            toLLVMLevel(Conf.getCompilerConfigure().getOptimizationLevel())));
+  // Hash everything the code of a function depends on besides its body.
+  std::array<Byte, 32> ContextHash;
+  {
+    std::ostringstream OS;
+    writeCodegenOptions(OS, Conf, LLModule.getTargetTriple(), Target.Name,
+                        Context.SubtargetFeatures.getString(), S.Profile);
+    const auto Options = OS.str();
+    Blake3 Hasher;
+    Hasher.update(Span<const Byte>(
+        reinterpret_cast<const Byte *>(Options.data()), Options.size()));
+    for (const auto Section : S.ContextSections) {
+      Hasher.update(Section);
+    }
+    // The functions which may be inlined at the wasm level are part of their
+    // callers.
+    if (Conf.getCompilerConfigure().isWasmOptimization()) {
+      for (const auto Body : S.FunctionBodies) {
+        if (Body.size() <= Validator::Optimizer::kMaxInlineBodySize) {
+          const auto Size = static_cast<uint32_t>(Body.size());
+          Hasher.update(Span<const Byte>(
+              reinterpret_cast<const Byte *>(&Size), sizeof(Size)));
+          Hasher.update(Body);
+        }
       }
-
-      MPM.run(LLModule, MAM);
     }
-
-    // Set initializer for constant value
-    if (auto *IntrinsicsTable = LLModule.getNamedGlobal("intrinsics")) {
-      IntrinsicsTable->setInitializer(llvm::ConstantPointerNull::get(
-          llvm::cast<llvm::PointerType>(IntrinsicsTable->getValueType())));
-      IntrinsicsTable->setConstant(false);
+    Hasher.finalize(ContextHash);
+  }
+
+  // Give each function, with its aliases, a partition of its own, keyed by
+  // its index and its body. The rest is the partition 0, which is compiled
+  // every time.
+  const auto &Bodies = S.FunctionBodies;
+  const size_t ImportNum = Context.Functions.size() - Bodies.size();
+  std::unordered_map<const llvm::GlobalValue *, size_t> Partitions;
+  std::vector<std::vector<Byte>> Keys(Bodies.size());
+  for (size_t I = 0; I < Bodies.size(); ++I) {
+    const auto FuncIdx = static_cast<uint32_t>(ImportNum + I);
+    Partitions.emplace(std::get<1>(Context.Functions[FuncIdx]), I + 1);
+    auto &Key = Keys[I];
+    Key.assign(ContextHash.begin(), ContextHash.end());
+    for (uint32_t Shift = 0; Shift < 32; Shift += 8) {
+      Key.push_back(static_cast<Byte>(FuncIdx >> Shift));
     }
-
-    llvm::legacy::PassManager CodeGenPasses;
-    CodeGenPasses.add(
-        llvm::createTargetTransformInfoWrapperPass(TM->getTargetIRAnalysis()));
-
-    // Add LibraryInfo.
-    CodeGenPasses.add(new llvm::TargetLibraryInfoWrapperPass(TLII));
-
-    llvm::raw_svector_ostream OS(OSVec);
-#if LLVM_VERSION_MAJOR >= 10
-    using llvm::CGFT_ObjectFile;
-#else
-    const auto CGFT_ObjectFile = llvm::TargetMachine::CGFT_ObjectFile;
-#endif
-    if (TM->addPassesToEmitFile(CodeGenPasses, OS, nullptr, CGFT_ObjectFile,
-                                false)) {
-      // TODO:return error
-      spdlog::error("addPassesToEmitFile failed");
-      return Unexpect(ErrCode::Value::IllegalPath);
+    Key.insert(Key.end(), Bodies[I].begin(), Bodies[I].end());
+  }
+  for (const auto &Alias : LLModule.aliases()) {
+    const auto *Aliasee = Alias.getAliasee()->stripPointerCasts();
+    if (auto It = Partitions.find(llvm::dyn_cast<llvm::GlobalValue>(Aliasee));
+        It != Partitions.end()) {
+      const size_t Part = It->second;
+      Partitions.emplace(&Alias, Part);
+      const auto Name = Alias.getName();
+      Keys[Part - 1].insert(Keys[Part - 1].end(), Name.begin(), Name.end());
     }
+  }
 
-    if (Conf.getCompilerConfigure().isDumpIR()) {
-      int Fd;
-      llvm::sys::fs::openFileForWrite("wasm-opt.ll", Fd);
-      llvm::raw_fd_ostream LLOS(Fd, true);
-      LLModule.print(LLOS, nullptr);
+  // Let the partitions refer to the local symbols of each other.
+  for (auto &GV : LLModule.global_values()) {
+    if (GV.hasLocalLinkage()) {
+      GV.setLinkage(llvm::GlobalValue::ExternalLinkage);
+      GV.setVisibility(llvm::GlobalValue::HiddenVisibility);
     }
-    spdlog::info("codegen start");
-    CodeGenPasses.run(LLModule);
   }
 
-  switch (Conf.getCompilerConfigure().getOutputFormat()) {
-  case CompilerConfigure::OutputFormat::Native:
-    if (auto Res = outputNativeLibrary(OutputPath, OSVec); unlikely(!Res)) {
-      return Unexpect(Res);
+  size_t Reused = 0;
+  for (size_t Part = 0; Part <= Bodies.size(); ++Part) {
+    std::filesystem::path CachePath;
+    if (Part > 0) {
+      if (auto Res = Cache::getPath(Keys[Part - 1], Cache::StorageScope::Local,
+                                    "objects"sv);
+          unlikely(!Res)) {
+        return Unexpect(Res);
+      } else {
+        CachePath = std::move(*Res);
+      }
+      std::error_code EC;
+      if (std::filesystem::is_regular_file(CachePath, EC)) {
+        Target.FunctionObjects.push_back(CachePath.u8string());
+        ++Reused;
+        if (!S.step()) {
+          return Unexpect(ErrCode::Value::Cancelled);
+        }
+        continue;
+      }
     }
-    break;
-  case CompilerConfigure::OutputFormat::Wasm:
-    if (auto Res = outputWasmLibrary(OutputPath, Data, OSVec); unlikely(!Res)) {
-      return Unexpect(Res);
+
+    llvm::ValueToValueMapTy VMap;
+    auto PartModule = llvm::CloneModule(
+        LLModule, VMap, [&Partitions, Part](const llvm::GlobalValue *GV) {
+          const auto It = Partitions.find(GV);
+          return (It == Partitions.end() ? 0 : It->second) == Part;
+        });
+    for (auto &GV : PartModule->global_values()) {
+      if (GV.isDeclaration()) {
+        GV.setDLLStorageClass(llvm::GlobalValue::DefaultStorageClass);
+      }
+    }
+    optimize(*PartModule, *Target.Machine, Level,
+             Conf.getCompilerConfigure().isWasmOptimization());
+    if (Part == 0) {
+      defineIntrinsicsTable(*PartModule);
+      if (auto Res = emitObject(*PartModule, *Target.Machine, Target.Object);
+          unlikely(!Res)) {
+        return Unexpect(Res);
+      }
+    } else {
+      llvm::SmallString<0> OSVec;
+      if (auto Res = emitObject(*PartModule, *Target.Machine, OSVec);
+          unlikely(!Res)) {
+        return Unexpect(Res);
+      }
+      if (auto Res = writeCacheFile(CachePath, OSVec); unlikely(!Res)) {
+        return Unexpect(Res);
+      }
+      Target.FunctionObjects.push_back(CachePath.u8string());
+    }
+    if (!S.step()) {
+      return Unexpect(ErrCode::Value::Cancelled);
     }
-    break;
   }
+  spdlog::info("reused {} of {} functions", Reused, Bodies.size());
 
   return {};
 }
 
-void Compiler::compile(const AST::TypeSection &TypeSec) {
+void Compiler::compile(CompileContext &Context,
+                       const AST::TypeSection &TypeSec) {
   auto *WrapperTy =
-      llvm::FunctionType::get(Context->VoidTy,
-                              {Context->ExecCtxPtrTy, Context->Int8PtrTy,
-                               Context->Int8PtrTy, Context->Int8PtrTy},
+      llvm::FunctionType::get(Context.VoidTy,
+                              {Context.ExecCtxPtrTy, Context.Int8PtrTy,
+                               Context.Int8PtrTy, Context.Int8PtrTy},
                               false);
   const auto &FuncTypes = TypeSec.getContent();
   const auto Size = FuncTypes.size();
   if (Size == 0) {
     return;
   }
-  Context->FunctionTypes.reserve(Size);
-  Context->FunctionWrappers.reserve(Size);
+  Context.FunctionTypes.reserve(Size);
+  Context.FunctionWrappers.reserve(Size);
 
   // Iterate and compile types.
   for (size_t I = 0; I < Size; ++I) {
     const auto &FuncType = FuncTypes[I];
-    const auto Name = "t" + std::to_string(Context->FunctionTypes.size());
+    const auto Name = "t" + std::to_string(Context.FunctionTypes.size());
 
     // Check function type is unique
     {
       bool Unique = true;
       for (size_t J = 0; J < I; ++J) {
-        const auto &OldFuncType = *Context->FunctionTypes[J];
+        const auto &OldFuncType = *Context.FunctionTypes[J];
         if (OldFuncType == FuncType) {
           Unique = false;
-          Context->FunctionTypes.push_back(&OldFuncType);
-          auto *F = Context->FunctionWrappers[J];
-          Context->FunctionWrappers.push_back(F);
+          Context.FunctionTypes.push_back(&OldFuncType);
+          auto *F = Context.FunctionWrappers[J];
+          Context.FunctionWrappers.push_back(F);
           llvm::GlobalAlias::create(Name, F);
           break;
         }
@@ -5264,7 +6303,7 @@ void Compiler::compile(const AST::TypeSection &TypeSec) {
 
     // Create Wrapper
     auto *F = llvm::Function::Create(WrapperTy, llvm::Function::ExternalLinkage,
-                                     Name, Context->LLModule);
+                                     Name, Context.LLModule);
     {
       F->addFnAttr(llvm::Attribute::StrictFP);
       F->addParamAttr(0, llvm::Attribute::AttrKind::ReadOnly);
@@ -5276,7 +6315,7 @@ void Compiler::compile(const AST::TypeSection &TypeSec) {
       llvm::IRBuilder<> Builder(
           llvm::BasicBlock::Create(F->getContext(), "entry", F));
       setIsFPConstrained(Builder);
-      auto *FTy = toLLVMType(Context->ExecCtxPtrTy, FuncType);
+      auto *FTy = toLLVMType(Context.ExecCtxPtrTy, FuncType);
       auto *RTy = FTy->getReturnType();
       const size_t ArgCount = FTy->getNumParams() - 1;
       const size_t RetCount =
@@ -5295,7 +6334,7 @@ void Compiler::compile(const AST::TypeSection &TypeSec) {
       for (size_t J = 0; J < ArgCount; ++J) {
         auto *ArgTy = FTy->getParamType(static_cast<uint32_t>(J + 1));
         llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(
-            Context->Int8Ty, RawArgs, J * kValSize);
+            Context.Int8Ty, RawArgs, J * kValSize);
         llvm::Value *Ptr = Builder.CreateBitCast(VPtr, ArgTy->getPointerTo());
         Args.push_back(Builder.CreateLoad(ArgTy, Ptr));
       }
@@ -5307,14 +6346,14 @@ void Compiler::compile(const AST::TypeSection &TypeSec) {
         auto Rets = unpackStruct(Builder, Ret);
         for (size_t J = 0; J < RetCount; ++J) {
           llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(
-              Context->Int8Ty, RawRets, J * kValSize);
+              Context.Int8Ty, RawRets, J * kValSize);
           llvm::Value *Ptr =
               Builder.CreateBitCast(VPtr, Rets[J]->getType()->getPointerTo());
           Builder.CreateStore(Rets[J], Ptr);
         }
       } else {
         llvm::Value *VPtr =
-            Builder.CreateConstInBoundsGEP1_64(Context->Int8Ty, RawRets, 0);
+            Builder.CreateConstInBoundsGEP1_64(Context.Int8Ty, RawRets, 0);
         llvm::Value *Ptr =
             Builder.CreateBitCast(VPtr, Ret->getType()->getPointerTo());
         Builder.CreateStore(Ret, Ptr);
@@ -5322,12 +6361,13 @@ void Compiler::compile(const AST::TypeSection &TypeSec) {
       Builder.CreateRetVoid();
     }
     // Copy wrapper, param and return lists to module instance.
-    Context->FunctionTypes.push_back(&FuncType);
-    Context->FunctionWrappers.push_back(F);
+    Context.FunctionTypes.push_back(&FuncType);
+    Context.FunctionWrappers.push_back(F);
   }
 }
 
-void Compiler::compile(const AST::ImportSection &ImportSec) {
+void Compiler::compile(CompileContext &Context,
+                       const AST::ImportSection &ImportSec) {
   // Iterate and compile import descriptions.
   for (const auto &ImpDesc : ImportSec.getContent()) {
     // Get data from import description.
@@ -5337,22 +6377,22 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
     switch (ExtType) {
     case ExternalType::Function: // Function type index
     {
-      const auto FuncID = static_cast<uint32_t>(Context->Functions.size());
+      const auto FuncID = static_cast<uint32_t>(Context.Functions.size());
       // Get the function type index in module.
       uint32_t TypeIdx = ImpDesc.getExternalFuncTypeIdx();
-      assuming(TypeIdx < Context->FunctionTypes.size());
-      const auto &FuncType = *Context->FunctionTypes[TypeIdx];
+      assuming(TypeIdx < Context.FunctionTypes.size());
+      const auto &FuncType = *Context.FunctionTypes[TypeIdx];
 
-      auto *FTy = toLLVMType(Context->ExecCtxPtrTy, FuncType);
+      auto *FTy = toLLVMType(Context.ExecCtxPtrTy, FuncType);
       auto *RTy = FTy->getReturnType();
       auto *F = llvm::Function::Create(FTy, llvm::Function::PrivateLinkage,
                                        "f" + std::to_string(FuncID),
-                                       Context->LLModule);
+                                       Context.LLModule);
       F->addFnAttr(llvm::Attribute::StrictFP);
       F->addParamAttr(0, llvm::Attribute::AttrKind::ReadOnly);
       F->addParamAttr(0, llvm::Attribute::AttrKind::NoAlias);
 
-      auto *Entry = llvm::BasicBlock::Create(Context->LLContext, "entry", F);
+      auto *Entry = llvm::BasicBlock::Create(Context.LLContext, "entry", F);
       llvm::IRBuilder<> Builder(Entry);
       setIsFPConstrained(Builder);
 
@@ -5362,20 +6402,20 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
 
       llvm::Value *Args;
       if (ArgSize == 0) {
-        Args = llvm::ConstantPointerNull::get(Context->Int8PtrTy);
+        Args = llvm::ConstantPointerNull::get(Context.Int8PtrTy);
       } else {
         auto *Alloca = Builder.CreateAlloca(
-            Context->Int8Ty, Builder.getInt64(ArgSize * kValSize));
+            Context.Int8Ty, Builder.getInt64(ArgSize * kValSize));
         Alloca->setAlignment(Align(kValSize));
         Args = Alloca;
       }
 
       llvm::Value *Rets;
       if (RetSize == 0) {
-        Rets = llvm::ConstantPointerNull::get(Context->Int8PtrTy);
+        Rets = llvm::ConstantPointerNull::get(Context.Int8PtrTy);
       } else {
         auto *Alloca = Builder.CreateAlloca(
-            Context->Int8Ty, Builder.getInt64(RetSize * kValSize));
+            Context.Int8Ty, Builder.getInt64(RetSize * kValSize));
         Alloca->setAlignment(Align(kValSize));
         Rets = Alloca;
       }
@@ -5383,17 +6423,17 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
       for (unsigned I = 0; I < ArgSize; ++I) {
         llvm::Argument *Arg = F->arg_begin() + 1 + I;
         llvm::Value *Ptr = Builder.CreateConstInBoundsGEP1_64(
-            Context->Int8Ty, Args, I * kValSize);
+            Context.Int8Ty, Args, I * kValSize);
         Builder.CreateStore(
             Arg, Builder.CreateBitCast(Ptr, Arg->getType()->getPointerTo()));
       }
 
       Builder.CreateCall(
-          Context->getIntrinsic(
+          Context.getIntrinsic(
               Builder, AST::Module::Intrinsics::kCall,
               llvm::FunctionType::get(
-                  Context->VoidTy,
-                  {Context->Int32Ty, Context->Int8PtrTy, Context->Int8PtrTy},
+                  Context.VoidTy,
+                  {Context.Int32Ty, Context.Int8PtrTy, Context.Int8PtrTy},
                   false)),
           {Builder.getInt32(FuncID), Args, Rets});
 
@@ -5401,7 +6441,7 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
         Builder.CreateRetVoid();
       } else if (RetSize == 1) {
         llvm::Value *VPtr =
-            Builder.CreateConstInBoundsGEP1_64(Context->Int8Ty, Rets, 0);
+            Builder.CreateConstInBoundsGEP1_64(Context.Int8Ty, Rets, 0);
         llvm::Value *Ptr =
             Builder.CreateBitCast(VPtr, F->getReturnType()->getPointerTo());
         Builder.CreateRet(Builder.CreateLoad(F->getReturnType(), Ptr));
@@ -5410,7 +6450,7 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
         Ret.reserve(RetSize);
         for (unsigned I = 0; I < RetSize; ++I) {
           llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(
-              Context->Int8Ty, Rets, I * kValSize);
+              Context.Int8Ty, Rets, I * kValSize);
           llvm::Value *Ptr = Builder.CreateBitCast(
               VPtr, RTy->getStructElementType(I)->getPointerTo());
           Ret.push_back(Builder.CreateLoad(RTy->getStructElementType(I), Ptr));
@@ -5418,7 +6458,7 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
         Builder.CreateAggregateRet(Ret.data(), static_cast<uint32_t>(RetSize));
       }
 
-      Context->Functions.emplace_back(TypeIdx, F, nullptr);
+      Context.Functions.emplace_back(TypeIdx, F, nullptr);
       break;
     }
     case ExternalType::Table: // Table type
@@ -5428,7 +6468,7 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
     }
     case ExternalType::Memory: // Memory type
     {
-      // Nothing to do.
+      ++Context.MemoryNum;
       break;
     }
     case ExternalType::Global: // Global type
@@ -5436,8 +6476,8 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
       // Get global type. External type checked in validation.
       const auto &GlobType = ImpDesc.getExternalGlobalType();
       const auto &ValType = GlobType.getValType();
-      auto *Type = toLLVMType(Context->LLContext, ValType);
-      Context->Globals.push_back(Type);
+      auto *Type = toLLVMType(Context.LLContext, ValType);
+      Context.Globals.push_back(Type);
       break;
     }
     default:
@@ -5446,50 +6486,61 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
   }
 }
 
-void Compiler::compile(const AST::ExportSection &) {}
+void Compiler::compile(CompileContext &, const AST::ExportSection &) {}
 
-void Compiler::compile(const AST::GlobalSection &GlobalSec) {
+void Compiler::compile(CompileContext &Context,
+                       const AST::GlobalSection &GlobalSec) {
   for (const auto &GlobalSeg : GlobalSec.getContent()) {
     const auto &ValType = GlobalSeg.getGlobalType().getValType();
-    auto *Type = toLLVMType(Context->LLContext, ValType);
-    Context->Globals.push_back(Type);
+    auto *Type = toLLVMType(Context.LLContext, ValType);
+    Context.Globals.push_back(Type);
   }
 }
 
-void Compiler::compile(const AST::MemorySection &, const AST::DataSection &) {}
-
-void Compiler::compile(const AST::TableSection &, const AST::ElementSection &) {
+void Compiler::compile(CompileContext &Context,
+                       const AST::MemorySection &MemorySec,
+                       const AST::DataSection &) {
+  Context.MemoryNum += static_cast<uint32_t>(MemorySec.getContent().size());
 }
 
-void Compiler::compile(const AST::FunctionSection &FuncSec,
-                       const AST::CodeSection &CodeSec) {
+void Compiler::compile(CompileContext &, const AST::TableSection &,
+                       const AST::ElementSection &) {}
+
+Expect<void> Compiler::compile(CompileContext &Context, Session &S,
+                               const AST::FunctionSection &FuncSec,
+                               const AST::CodeSection &CodeSec) {
   const auto &TypeIdxs = FuncSec.getContent();
   const auto &CodeSegs = CodeSec.getContent();
   if (TypeIdxs.size() == 0 || CodeSegs.size() == 0) {
-    return;
+    return {};
   }
 
   for (size_t I = 0; I < TypeIdxs.size() && I < CodeSegs.size(); ++I) {
     const auto &TypeIdx = TypeIdxs[I];
     const auto &Code = CodeSegs[I];
-    assuming(TypeIdx < Context->FunctionTypes.size());
-    const auto &FuncType = *Context->FunctionTypes[TypeIdx];
-    const auto FuncID = Context->Functions.size();
-    auto *FTy = toLLVMType(Context->ExecCtxPtrTy, FuncType);
+    assuming(TypeIdx < Context.FunctionTypes.size());
+    const auto &FuncType = *Context.FunctionTypes[TypeIdx];
+    const auto FuncID = Context.Functions.size();
+    auto *FTy = toLLVMType(Context.ExecCtxPtrTy, FuncType);
     auto *F =
         llvm::Function::Create(FTy, llvm::Function::ExternalLinkage,
-                               "f" + std::to_string(FuncID), Context->LLModule);
+                               "f" + std::to_string(FuncID), Context.LLModule);
     F->addFnAttr(llvm::Attribute::StrictFP);
     F->addParamAttr(0, llvm::Attribute::AttrKind::ReadOnly);
     F->addParamAttr(0, llvm::Attribute::AttrKind::NoAlias);
 
-    Context->Functions.emplace_back(TypeIdx, F, &Code);
+    Context.Functions.emplace_back(TypeIdx, F, &Code);
   }
 
-  for (auto [T, F, Code] : Context->Functions) {
+  for (size_t I = 0; I < Context.Functions.size(); ++I) {
+    auto [T, F, Code] = Context.Functions[I];
     if (!Code) {
       continue;
     }
+    if (Conf.getCompilerConfigure().isInterruptible()) {
+      // Keep the frame pointers for walking the stack on profiling samples.
+      F->addFnAttr("frame-pointer", "all");
+    }
 
     std::vector<ValType> Locals;
     for (const auto &Local : Code->getLocals()) {
@@ -5497,16 +6548,24 @@ void Compiler::compile(const AST::FunctionSection &FuncSec,
         Locals.push_back(Local.second);
       }
     }
-    FunctionCompiler FC(*Context, F, Locals,
+    if (S.Profile) {
+      F->setEntryCount(S.Profile->getEntryCount(static_cast<uint32_t>(I)));
+    }
+    FunctionCompiler FC(Context, F, static_cast<uint32_t>(I), Locals,
                         Conf.getCompilerConfigure().isInterruptible(),
                         Conf.getStatisticsConfigure().isInstructionCounting(),
                         Conf.getStatisticsConfigure().isCostMeasuring(),
                         Conf.getCompilerConfigure().getOptimizationLevel() ==
-                            CompilerConfigure::OptimizationLevel::O0);
-    auto Type = Context->resolveBlockType(T);
+                            CompilerConfigure::OptimizationLevel::O0,
+                        S.Profile);
+    auto Type = Context.resolveBlockType(T);
     FC.compile(*Code, std::move(Type));
     llvm::EliminateUnreachableBlocks(*F);
+    if (!S.step()) {
+      return Unexpect(ErrCode::Value::Cancelled);
+    }
   }
+  return {};
 }
 
 } // namespace AOT
@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "aot/service.h"
+
+#include "common/log.h"
+#include "loader/loader.h"
+#include "validator/validator.h"
+
+#include <algorithm>
+
+namespace WasmEdge {
+namespace AOT {
+
+Expect<void> CompilerService::Job::wait() const {
+  std::unique_lock Lock(Mutex);
+  Cond.wait(Lock, [this]() { return Finished; });
+  if (Result != ErrCode::Value::Success) {
+    return Unexpect(Result);
+  }
+  return {};
+}
+
+bool CompilerService::Job::waitFor(std::chrono::nanoseconds Timeout) const {
+  std::unique_lock Lock(Mutex);
+  return Cond.wait_for(Lock, Timeout, [this]() { return Finished; });
+}
+
+bool CompilerService::Job::isFinished() const noexcept {
+  std::unique_lock Lock(Mutex);
+  return Finished;
+}
+
+void CompilerService::Job::finish(ErrCode Code) noexcept {
+  {
+    std::unique_lock Lock(Mutex);
+    Finished = true;
+    Result = Code;
+  }
+  Cond.notify_all();
+}
+
+CompilerService::CompilerService(const Configure &C, const Options &O)
+    : Conf(C), Opts(O), Comp(C) {
+  const uint32_t Num = std::max(Opts.Workers, UINT32_C(1));
+  Workers.reserve(Num);
+  for (uint32_t I = 0; I < Num; ++I) {
+    Workers.emplace_back([this]() { runWorker(); });
+  }
+}
+
+CompilerService::~CompilerService() noexcept {
+  {
+    std::unique_lock Lock(Mutex);
+    Stopped = true;
+    for (auto &J : Queue) {
+      J->cancel();
+    }
+  }
+  NotEmpty.notify_all();
+  NotFull.notify_all();
+  for (auto &Worker : Workers) {
+    Worker.join();
+  }
+}
+
+Expect<std::shared_ptr<CompilerService::Job>>
+CompilerService::submit(std::vector<Byte> Data,
+                        std::filesystem::path OutputPath,
+                        Compiler::ProgressCallback Progress) {
+  auto J = std::shared_ptr<Job>(
+      new Job(std::move(Data), std::move(OutputPath), std::move(Progress)));
+  {
+    std::unique_lock Lock(Mutex);
+    const size_t Limit = std::max(Opts.QueueSize, UINT32_C(1));
+    NotFull.wait(Lock, [&]() { return Stopped || Queue.size() < Limit; });
+    if (Stopped) {
+      return Unexpect(ErrCode::Value::Cancelled);
+    }
+    Queue.push_back(J);
+  }
+  NotEmpty.notify_one();
+  return J;
+}
+
+void CompilerService::runWorker() {
+  while (true) {
+    std::shared_ptr<Job> J;
+    {
+      std::unique_lock Lock(Mutex);
+      NotEmpty.wait(Lock, [this]() { return Stopped || !Queue.empty(); });
+      if (Queue.empty()) {
+        // Stopped and drained.
+        return;
+      }
+      J = std::move(Queue.front());
+      Queue.pop_front();
+    }
+    NotFull.notify_one();
+
+    if (auto Res = run(*J); unlikely(!Res)) {
+      J->finish(Res.error());
+    } else {
+      J->finish(ErrCode::Value::Success);
+    }
+  }
+}
+
+Expect<void> CompilerService::run(Job &J) {
+  if (J.Cancelled.load(std::memory_order_relaxed)) {
+    return Unexpect(ErrCode::Value::Cancelled);
+  }
+  Loader::Loader Load(Conf);
+  Validator::Validator Valid(Conf);
+  std::unique_ptr<AST::Module> Module;
+  if (auto Res = Load.parseModule(J.Data)) {
+    Module = std::move(*Res);
+  } else {
+    return Unexpect(Res);
+  }
+  if (auto Res = Valid.validate(*Module); !Res) {
+    return Unexpect(Res);
+  }
+  auto Res = Comp.compile(
+      J.Data, *Module, J.OutputPath,
+      [&J](uint64_t Done, uint64_t Total) {
+        J.Total.store(Total, std::memory_order_relaxed);
+        J.Done.store(Done, std::memory_order_relaxed);
+        if (J.Progress) {
+          J.Progress(Done, Total);
+        }
+      },
+      &J.Cancelled);
+  // The binary is no longer needed after the compilation.
+  std::vector<Byte>().swap(J.Data);
+  return Res;
+}
+
+} // namespace AOT
+} // namespace WasmEdge
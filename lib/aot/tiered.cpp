@@ -0,0 +1,229 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "aot/tiered.h"
+
+#include "aot/cache.h"
+#include "common/log.h"
+
+#include <string>
+#include <utility>
+
+namespace WasmEdge {
+namespace AOT {
+
+namespace {
+
+using OptimizationLevel = CompilerConfigure::OptimizationLevel;
+
+Configure withLevel(const Configure &Conf, OptimizationLevel Level) noexcept {
+  Configure Result(Conf);
+  Result.getCompilerConfigure().setOptimizationLevel(Level);
+  return Result;
+}
+
+OptimizationLevel getOptimizedLevel(const Configure &Conf) noexcept {
+  const auto Level = Conf.getCompilerConfigure().getOptimizationLevel();
+  return Level == OptimizationLevel::O0 ? OptimizationLevel::O3 : Level;
+}
+
+std::string getLevelName(OptimizationLevel Level) {
+  switch (Level) {
+  case OptimizationLevel::O0:
+    return "O0";
+  case OptimizationLevel::O1:
+    return "O1";
+  case OptimizationLevel::O2:
+    return "O2";
+  case OptimizationLevel::O3:
+    return "O3";
+  case OptimizationLevel::Os:
+    return "Os";
+  case OptimizationLevel::Oz:
+    return "Oz";
+  }
+  return {};
+}
+
+} // namespace
+
+TieredCompiler::TieredCompiler(const Configure &Conf,
+                               const AST::Module::IntrinsicsTable *IT,
+                               std::filesystem::path CacheRoot) noexcept
+    : BaselineConf(withLevel(Conf, OptimizationLevel::O0)),
+      OptimizedConf(withLevel(Conf, getOptimizedLevel(Conf))),
+      BaselineCompiler(BaselineConf), OptimizedCompiler(OptimizedConf),
+      Load(Conf, IT), Valid(Conf), CacheRoot(std::move(CacheRoot)) {}
+
+TieredCompiler::~TieredCompiler() noexcept {
+  Cancel.store(true, std::memory_order_relaxed);
+  if (Worker.joinable()) {
+    Worker.join();
+  }
+}
+
+Expect<std::unique_ptr<AST::Module>>
+TieredCompiler::compile(Span<const Byte> Code) {
+  if (unlikely(!Data.empty())) {
+    spdlog::error("tiered compiler has compiled a module");
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  Data.assign(Code.begin(), Code.end());
+
+  // The code is cached apart for every host and configuration it is compiled
+  // for, keyed as the incremental compilation keys the function objects.
+  const std::string Key = "tiered/" + OptimizedCompiler.getCacheKey();
+  std::filesystem::path Dir;
+  if (!CacheRoot.empty()) {
+    Dir = Cache::getPath(Data, CacheRoot, Key);
+  } else if (auto Res = Cache::getPath(Data, Cache::StorageScope::Local, Key)) {
+    Dir = std::move(*Res);
+  } else {
+    std::unique_lock Lock(Mutex);
+    Finished = true;
+    Result = Res.error();
+    return Unexpect(Res);
+  }
+  BaselinePath = Dir / "O0.wasm";
+  OptimizedPath =
+      Dir / (getLevelName(getOptimizedLevel(OptimizedConf)) + ".wasm");
+
+  if (auto Res = loadCached(OptimizedPath)) {
+    spdlog::info("tiered: optimized code loaded from cache");
+    std::unique_lock Lock(Mutex);
+    Finished = true;
+    return std::move(*Res);
+  }
+
+  std::unique_ptr<AST::Module> Mod;
+  if (auto Res = loadCached(BaselinePath)) {
+    spdlog::info("tiered: baseline code loaded from cache");
+    Mod = std::move(*Res);
+  } else if (auto Res = compileTier(BaselineCompiler, BaselinePath)) {
+    Mod = std::move(*Res);
+  } else {
+    // No optimized tier follows a failed baseline.
+    std::unique_lock Lock(Mutex);
+    Finished = true;
+    Result = Res.error();
+    return Unexpect(Res);
+  }
+
+  Worker = std::thread([this]() { runOptimized(); });
+  return Mod;
+}
+
+void TieredCompiler::attach(const Runtime::Instance::ModuleInstance &ModInst) {
+  std::unique_lock Lock(Mutex);
+  if (OptimizedModule) {
+    upgrade(ModInst);
+  } else if (!Finished) {
+    Instances.push_back(&ModInst);
+  }
+}
+
+Expect<void> TieredCompiler::wait() const {
+  std::unique_lock Lock(Mutex);
+  Cond.wait(Lock, [this]() { return Finished; });
+  if (Result != ErrCode::Value::Success) {
+    return Unexpect(Result);
+  }
+  return {};
+}
+
+bool TieredCompiler::isOptimized() const noexcept {
+  std::unique_lock Lock(Mutex);
+  return Finished && Result == ErrCode::Value::Success;
+}
+
+Expect<std::unique_ptr<AST::Module>>
+TieredCompiler::loadCached(const std::filesystem::path &Path) {
+  std::error_code EC;
+  if (!std::filesystem::is_regular_file(Path, EC)) {
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  std::unique_ptr<AST::Module> Mod;
+  if (auto Res = Load.parseModule(Path)) {
+    Mod = std::move(*Res);
+  } else {
+    return Unexpect(Res);
+  }
+  // The code is not loaded if it is compiled for another CPU.
+  if (!Mod->getSymbol()) {
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  if (auto Res = Valid.validate(*Mod); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+  return Mod;
+}
+
+Expect<std::unique_ptr<AST::Module>>
+TieredCompiler::compileTier(Compiler &Comp, const std::filesystem::path &Path) {
+  std::unique_ptr<AST::Module> Mod;
+  if (auto Res = Load.parseModule(Data)) {
+    Mod = std::move(*Res);
+  } else {
+    return Unexpect(Res);
+  }
+  if (auto Res = Valid.validate(*Mod); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+  if (auto Res = Comp.compile(Data, *Mod, {}, &Cancel); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+  if (auto Res = Load.loadAOTSection(*Mod); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+  // A failed cache write only costs the compilation of the next run.
+  if (auto Res = Compiler::output(Data, Mod->getAOTSection(), Path);
+      unlikely(!Res)) {
+    spdlog::warn("tiered: cache write failed:{}", Path.u8string());
+  }
+  return Mod;
+}
+
+void TieredCompiler::runOptimized() {
+  auto Res = compileTier(OptimizedCompiler, OptimizedPath);
+  {
+    std::unique_lock Lock(Mutex);
+    if (Res) {
+      OptimizedModule = std::move(*Res);
+      for (const auto *ModInst : Instances) {
+        upgrade(*ModInst);
+      }
+      spdlog::info("tiered: {} module instances upgraded", Instances.size());
+      Result = ErrCode::Value::Success;
+    } else {
+      Result = Res.error();
+    }
+    Instances.clear();
+    Finished = true;
+  }
+  Cond.notify_all();
+}
+
+void TieredCompiler::upgrade(
+    const Runtime::Instance::ModuleInstance &ModInst) const {
+  const auto &CodeSegs = OptimizedModule->getCodeSection().getContent();
+  const uint32_t FuncNum = ModInst.getFuncNum();
+  if (unlikely(FuncNum < CodeSegs.size())) {
+    return;
+  }
+  // The functions defined in the module follow the imported ones.
+  const uint32_t ImportFuncNum =
+      FuncNum - static_cast<uint32_t>(CodeSegs.size());
+  for (uint32_t I = 0; I < CodeSegs.size(); ++I) {
+    auto Res = ModInst.getFunc(ImportFuncNum + I);
+    if (unlikely(!Res)) {
+      continue;
+    }
+    auto *FuncInst = *Res;
+    if (FuncInst->isCompiledFunction() && FuncInst->getModule() == &ModInst) {
+      FuncInst->upgradeSymbol(CodeSegs[I].getSymbol());
+    }
+  }
+}
+
+} // namespace AOT
+} // namespace WasmEdge
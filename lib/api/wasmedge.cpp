@@ -4,6 +4,7 @@
 #include "wasmedge/wasmedge.h"
 
 #include "aot/compiler.h"
+#include "aot/service.h"
 #include "driver/compiler.h"
 #include "driver/tool.h"
 #include "host/wasi/wasimodule.h"
@@ -23,8 +24,11 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -61,10 +65,32 @@ struct WasmEdge_ExportTypeContext {};
 struct WasmEdge_CompilerContext {
 #ifdef WASMEDGE_BUILD_AOT_RUNTIME
   WasmEdge_CompilerContext(const WasmEdge::Configure &Conf) noexcept
-      : Compiler(Conf), Load(Conf), Valid(Conf) {}
+      : Conf(Conf), Compiler(Conf),
+        Load(Conf, &WasmEdge::Executor::Executor::Intrinsics), Valid(Conf) {
+    Opts.Workers = std::max(std::thread::hardware_concurrency(), 1U);
+    Opts.QueueSize = Opts.Workers * 4;
+  }
+  WasmEdge::AOT::CompilerService &getService() {
+    std::unique_lock Lock(Mutex);
+    if (!Service) {
+      Service = std::make_unique<WasmEdge::AOT::CompilerService>(Conf, Opts);
+    }
+    return *Service;
+  }
+  const WasmEdge::Configure Conf;
   WasmEdge::AOT::Compiler Compiler;
   WasmEdge::Loader::Loader Load;
   WasmEdge::Validator::Validator Valid;
+  std::mutex Mutex;
+  WasmEdge::AOT::CompilerService::Options Opts;
+  std::unique_ptr<WasmEdge::AOT::CompilerService> Service;
+#endif
+};
+
+// WasmEdge_CompilerJobContext implementation.
+struct WasmEdge_CompilerJobContext {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  std::shared_ptr<WasmEdge::AOT::CompilerService::Job> Job;
 #endif
 };
 
@@ -77,6 +103,9 @@ struct WasmEdge_ValidatorContext {};
 // WasmEdge_ExecutorContext implementation.
 struct WasmEdge_ExecutorContext {};
 
+// WasmEdge_ContinuationContext implementation.
+struct WasmEdge_ContinuationContext {};
+
 // WasmEdge_StoreContext implementation.
 struct WasmEdge_StoreContext {};
 
@@ -310,6 +339,7 @@ CONVTO(Store, Runtime::StoreManager, Store, )
 CONVTO(Loader, Loader::Loader, Loader, )
 CONVTO(Validator, Validator::Validator, Validator, )
 CONVTO(Executor, Executor::Executor, Executor, )
+CONVTO(Cont, Executor::Continuation, Continuation, )
 CONVTO(Mod, Runtime::Instance::ModuleInstance, ModuleInstance, )
 CONVTO(Mod, Runtime::Instance::ModuleInstance, ModuleInstance, const)
 CONVTO(Func, Runtime::Instance::FunctionInstance, FunctionInstance, )
@@ -344,6 +374,8 @@ CONVFROM(Store, Runtime::StoreManager, Store, const)
 CONVFROM(Loader, Loader::Loader, Loader, )
 CONVFROM(Validator, Validator::Validator, Validator, )
 CONVFROM(Executor, Executor::Executor, Executor, )
+CONVFROM(Cont, Executor::Continuation, Continuation, )
+CONVFROM(Cont, Executor::Continuation, Continuation, const)
 CONVFROM(Mod, Runtime::Instance::ModuleInstance, ModuleInstance, )
 CONVFROM(Mod, Runtime::Instance::ModuleInstance, ModuleInstance, const)
 CONVFROM(Func, Runtime::Instance::FunctionInstance, FunctionInstance, )
@@ -818,6 +850,37 @@ WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureCompilerIsInterruptible(
   return false;
 }
 
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureCompilerSetIncremental(WasmEdge_ConfigureContext *Cxt,
+                                         const bool IsIncremental) {
+  if (Cxt) {
+    Cxt->Conf.getCompilerConfigure().setIncremental(IsIncremental);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureCompilerIsIncremental(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getCompilerConfigure().isIncremental();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_ConfigureCompilerSetWasmOptimization(
+    WasmEdge_ConfigureContext *Cxt, const bool IsWasmOptimization) {
+  if (Cxt) {
+    Cxt->Conf.getCompilerConfigure().setWasmOptimization(IsWasmOptimization);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureCompilerIsWasmOptimization(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getCompilerConfigure().isWasmOptimization();
+  }
+  return false;
+}
+
 WASMEDGE_CAPI_EXPORT void WasmEdge_ConfigureStatisticsSetInstructionCounting(
     WasmEdge_ConfigureContext *Cxt, const bool IsCount) {
   if (Cxt) {
@@ -1458,11 +1521,186 @@ WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_CompilerCompileFromBuffer(
 #endif
 }
 
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_CompilerCompileFromBufferToASTModule(
+    WasmEdge_CompilerContext *Cxt [[maybe_unused]],
+    WasmEdge_ASTModuleContext **Module [[maybe_unused]],
+    const uint8_t *InBuffer [[maybe_unused]],
+    const uint64_t InBufferLen [[maybe_unused]]) {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  return wrap(
+      [&]() -> WasmEdge::Expect<std::unique_ptr<WasmEdge::AST::Module>> {
+        WasmEdge::Span<const WasmEdge::Byte> Data(InBuffer, InBufferLen);
+        std::unique_ptr<WasmEdge::AST::Module> Mod;
+        if (auto Res = Cxt->Load.parseModule(Data)) {
+          Mod = std::move(*Res);
+        } else {
+          return Unexpect(Res);
+        }
+        if (auto Res = Cxt->Valid.validate(*Mod.get()); !Res) {
+          return Unexpect(Res);
+        }
+        if (auto Res = Cxt->Compiler.compile(Data, *Mod.get()); !Res) {
+          return Unexpect(Res);
+        }
+        if (auto Res = Cxt->Load.loadAOTSection(*Mod.get()); !Res) {
+          return Unexpect(Res);
+        }
+        return Mod;
+      },
+      [&](auto &&Res) { *Module = toASTModCxt((*Res).release()); }, Cxt,
+      Module);
+#else
+  return genWasmEdge_Result(ErrCode::Value::AOTDisabled);
+#endif
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_CompilerSetConcurrency(WasmEdge_CompilerContext *Cxt
+                                [[maybe_unused]],
+                                const uint32_t Workers [[maybe_unused]],
+                                const uint32_t QueueSize [[maybe_unused]]) {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  if (Cxt) {
+    std::unique_lock Lock(Cxt->Mutex);
+    if (!Cxt->Service) {
+      Cxt->Opts.Workers = Workers;
+      Cxt->Opts.QueueSize = QueueSize;
+      return true;
+    }
+  }
+#endif
+  return false;
+}
+
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+namespace {
+WasmEdge_CompilerJobContext *
+submitCompilerJob(WasmEdge_CompilerContext *Cxt,
+                  std::vector<WasmEdge::Byte> Data, const char *OutPath,
+                  WasmEdge_CompilerProgress_t Progress, void *ProgressData) {
+  WasmEdge::AOT::Compiler::ProgressCallback Callback;
+  if (Progress) {
+    Callback = [Progress, ProgressData](uint64_t Done, uint64_t Total) {
+      Progress(ProgressData, Done, Total);
+    };
+  }
+  if (auto Res = Cxt->getService().submit(std::move(Data),
+                                          std::filesystem::absolute(OutPath),
+                                          std::move(Callback))) {
+    return new WasmEdge_CompilerJobContext{std::move(*Res)};
+  }
+  return nullptr;
+}
+} // namespace
+#endif
+
+WASMEDGE_CAPI_EXPORT WasmEdge_CompilerJobContext *
+WasmEdge_CompilerCompileAsync(WasmEdge_CompilerContext *Cxt [[maybe_unused]],
+                              const char *InPath [[maybe_unused]],
+                              const char *OutPath [[maybe_unused]],
+                              WasmEdge_CompilerProgress_t Progress
+                              [[maybe_unused]],
+                              void *Data [[maybe_unused]]) {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  if (!Cxt || !InPath || !OutPath) {
+    return nullptr;
+  }
+  std::vector<WasmEdge::Byte> Buffer;
+  {
+    // The loader of the context is not thread-safe.
+    std::unique_lock Lock(Cxt->Mutex);
+    if (auto Res = Cxt->Load.loadFile(std::filesystem::absolute(InPath))) {
+      Buffer = std::move(*Res);
+    } else {
+      return nullptr;
+    }
+  }
+  return submitCompilerJob(Cxt, std::move(Buffer), OutPath, Progress, Data);
+#else
+  return nullptr;
+#endif
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_CompilerJobContext *
+WasmEdge_CompilerCompileFromBufferAsync(
+    WasmEdge_CompilerContext *Cxt [[maybe_unused]],
+    const uint8_t *InBuffer [[maybe_unused]],
+    const uint64_t InBufferLen [[maybe_unused]],
+    const char *OutPath [[maybe_unused]],
+    WasmEdge_CompilerProgress_t Progress [[maybe_unused]],
+    void *Data [[maybe_unused]]) {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  if (!Cxt || !InBuffer || !OutPath) {
+    return nullptr;
+  }
+  return submitCompilerJob(
+      Cxt, std::vector<WasmEdge::Byte>(InBuffer, InBuffer + InBufferLen),
+      OutPath, Progress, Data);
+#else
+  return nullptr;
+#endif
+}
+
 WASMEDGE_CAPI_EXPORT void
 WasmEdge_CompilerDelete(WasmEdge_CompilerContext *Cxt) {
   delete Cxt;
 }
 
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_CompilerJobWait(const WasmEdge_CompilerJobContext *Cxt
+                         [[maybe_unused]]) {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  return wrap([&]() { return Cxt->Job->wait(); }, EmptyThen, Cxt);
+#else
+  return genWasmEdge_Result(ErrCode::Value::AOTDisabled);
+#endif
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_CompilerJobWaitFor(const WasmEdge_CompilerJobContext *Cxt
+                            [[maybe_unused]],
+                            uint64_t Milliseconds [[maybe_unused]]) {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  if (Cxt) {
+    return Cxt->Job->waitFor(std::chrono::milliseconds(Milliseconds));
+  }
+#endif
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_CompilerJobCancel(WasmEdge_CompilerJobContext *Cxt [[maybe_unused]]) {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  if (Cxt) {
+    Cxt->Job->cancel();
+  }
+#endif
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_CompilerJobGetProgress(const WasmEdge_CompilerJobContext *Cxt
+                                [[maybe_unused]],
+                                uint64_t *Done, uint64_t *Total) {
+  uint64_t D = 0, T = 0;
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  if (Cxt) {
+    std::tie(D, T) = Cxt->Job->getProgress();
+  }
+#endif
+  if (Done) {
+    *Done = D;
+  }
+  if (Total) {
+    *Total = T;
+  }
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_CompilerJobDelete(WasmEdge_CompilerJobContext *Cxt) {
+  delete Cxt;
+}
+
 // <<<<<<<< WasmEdge AOT compiler functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 // >>>>>>>> WasmEdge loader functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
@@ -1608,6 +1846,52 @@ WasmEdge_ExecutorInvoke(WasmEdge_ExecutorContext *Cxt,
       FuncCxt);
 }
 
+WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_ExecutorCreateContinuation(
+    WasmEdge_ExecutorContext *Cxt, WasmEdge_ContinuationContext **ContCxt,
+    const WasmEdge_FunctionInstanceContext *FuncCxt,
+    const WasmEdge_Value *Params, const uint32_t ParamLen) {
+  auto ParamPair = genParamPair(Params, ParamLen);
+  return wrap(
+      [&]() {
+        return fromExecutorCxt(Cxt)->createContinuation(
+            *fromFuncCxt(FuncCxt), ParamPair.first, ParamPair.second);
+      },
+      [&](auto &&Res) { *ContCxt = toContCxt((*Res).release()); }, Cxt,
+      ContCxt, FuncCxt);
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_ExecutorResume(WasmEdge_ExecutorContext *Cxt,
+                        WasmEdge_ContinuationContext *ContCxt,
+                        const uint64_t Fuel, const uint64_t TimeSliceMs) {
+  uint64_t SliceDeadline = WasmEdge::Epoch::kNever;
+  if (TimeSliceMs != UINT64_MAX) {
+    SliceDeadline = WasmEdge::Epoch::deadline(
+        WasmEdge::Epoch::Clock::now() +
+        std::chrono::milliseconds(
+            std::min(TimeSliceMs, static_cast<uint64_t>(INT32_MAX))));
+  }
+  if (!isContext(Cxt, ContCxt)) {
+    return genWasmEdge_Result(ErrCode::Value::WrongVMWorkflow);
+  }
+  auto Res =
+      fromExecutorCxt(Cxt)->resume(*fromContCxt(ContCxt), Fuel, SliceDeadline);
+  if (!Res) {
+    return genWasmEdge_Result(Res.error());
+  }
+  return genWasmEdge_Result(*Res ? ErrCode::Value::Success
+                                 : ErrCode::Value::Suspended);
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ExecutorRequestSuspend(WasmEdge_ExecutorContext *Cxt,
+                                WasmEdge_ContinuationContext *ContCxt) {
+  if (Cxt && ContCxt) {
+    return fromExecutorCxt(Cxt)->requestSuspend(*fromContCxt(ContCxt));
+  }
+  return false;
+}
+
 WASMEDGE_CAPI_EXPORT void
 WasmEdge_ExecutorDelete(WasmEdge_ExecutorContext *Cxt) {
   delete fromExecutorCxt(Cxt);
@@ -1615,6 +1899,51 @@ WasmEdge_ExecutorDelete(WasmEdge_ExecutorContext *Cxt) {
 
 // <<<<<<<< WasmEdge executor functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge continuation functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ContinuationIsResumable(const WasmEdge_ContinuationContext *Cxt) {
+  if (Cxt) {
+    return fromContCxt(Cxt)->isResumable();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT uint64_t
+WasmEdge_ContinuationGetSuspendCount(const WasmEdge_ContinuationContext *Cxt) {
+  if (Cxt) {
+    return fromContCxt(Cxt)->getSuspendCount();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_ContinuationGetReturnsLength(const WasmEdge_ContinuationContext *Cxt) {
+  if (Cxt) {
+    return static_cast<uint32_t>(fromContCxt(Cxt)->getReturns().size());
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_ContinuationGetReturns(const WasmEdge_ContinuationContext *Cxt,
+                                WasmEdge_Value *Returns,
+                                const uint32_t ReturnLen) {
+  if (Cxt) {
+    const auto Rets = fromContCxt(Cxt)->getReturns();
+    fillWasmEdge_ValueArr(Rets, Returns, ReturnLen);
+    return static_cast<uint32_t>(Rets.size());
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ContinuationDelete(WasmEdge_ContinuationContext *Cxt) {
+  delete fromContCxt(Cxt);
+}
+
+// <<<<<<<< WasmEdge continuation functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 // >>>>>>>> WasmEdge store functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
 WASMEDGE_CAPI_EXPORT WasmEdge_StoreContext *WasmEdge_StoreCreate(void) {
@@ -2539,6 +2868,65 @@ WasmEdge_VMInstantiate(WasmEdge_VMContext *Cxt) {
   return wrap([&]() { return Cxt->VM.instantiate(); }, EmptyThen, Cxt);
 }
 
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_VMCreateInstancePool(WasmEdge_VMContext *Cxt,
+                              const uint32_t Capacity) {
+  return wrap([&]() { return Cxt->VM.createInstancePool(Capacity); },
+              EmptyThen, Cxt);
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_VMAcquireInstance(WasmEdge_VMContext *Cxt,
+                           WasmEdge_ModuleInstanceContext **ModuleCxt) {
+  return wrap([&]() { return Cxt->VM.acquireInstance(); },
+              [&](auto &&Res) { *ModuleCxt = toModCxt((*Res).release()); },
+              Cxt, ModuleCxt);
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_VMReleaseInstance(WasmEdge_VMContext *Cxt,
+                           WasmEdge_ModuleInstanceContext *ModuleCxt) {
+  std::unique_ptr<WasmEdge::Runtime::Instance::ModuleInstance> ModInst(
+      fromModCxt(ModuleCxt));
+  if (Cxt) {
+    Cxt->VM.releaseInstance(std::move(ModInst));
+  }
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_VMExecuteInstance(
+    WasmEdge_VMContext *Cxt, const WasmEdge_ModuleInstanceContext *ModuleCxt,
+    const WasmEdge_String FuncName, const WasmEdge_Value *Params,
+    const uint32_t ParamLen, WasmEdge_Value *Returns,
+    const uint32_t ReturnLen) {
+  auto ParamPair = genParamPair(Params, ParamLen);
+  return wrap(
+      [&]() {
+        return Cxt->VM.execute(*fromModCxt(ModuleCxt), genStrView(FuncName),
+                               ParamPair.first, ParamPair.second);
+      },
+      [&](auto &&Res) { fillWasmEdge_ValueArr(*Res, Returns, ReturnLen); },
+      Cxt, ModuleCxt);
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_VMGetInstancePoolStatistics(const WasmEdge_VMContext *Cxt,
+                                     WasmEdge_InstancePoolStatistics *Stat) {
+  if (Cxt && Stat) {
+    if (auto Res = Cxt->VM.getInstancePoolStatistics()) {
+      Stat->Idle = Res->Idle;
+      Stat->InUse = Res->InUse;
+      Stat->Hits = Res->Hits;
+      Stat->Misses = Res->Misses;
+      Stat->Resets = Res->Resets;
+      Stat->Discards = Res->Discards;
+      Stat->InstantiateNanos = Res->InstantiateNanos;
+      Stat->ResetNanos = Res->ResetNanos;
+      return true;
+    }
+  }
+  return false;
+}
+
 WASMEDGE_CAPI_EXPORT WasmEdge_Result
 WasmEdge_VMExecute(WasmEdge_VMContext *Cxt, const WasmEdge_String FuncName,
                    const WasmEdge_Value *Params, const uint32_t ParamLen,
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "common/pgo.h"
+
+#include "common/log.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace WasmEdge {
+namespace PGO {
+
+namespace {
+using namespace std::literals;
+/// Header line of the text format, followed by the lines of
+/// `function <index> <count>` and `branch <offset> <count>...`.
+inline constexpr std::string_view kHeader = "wasmedge-profile 1"sv;
+} // namespace
+
+void Profile::addEntry(uint32_t FuncIdx, uint64_t Count) {
+  Entries[FuncIdx] += Count;
+}
+
+void Profile::addBranch(uint32_t Offset, uint32_t Target, uint32_t TargetNum,
+                        uint64_t Count) {
+  auto &Counts = Branches[Offset];
+  if (Counts.size() < TargetNum) {
+    Counts.resize(TargetNum);
+  }
+  if (Target < Counts.size()) {
+    Counts[Target] += Count;
+  }
+}
+
+void Profile::merge(const Profile &Other) {
+  for (const auto &[FuncIdx, Count] : Other.Entries) {
+    Entries[FuncIdx] += Count;
+  }
+  for (const auto &[Offset, OtherCounts] : Other.Branches) {
+    auto &Counts = Branches[Offset];
+    if (Counts.size() < OtherCounts.size()) {
+      Counts.resize(OtherCounts.size());
+    }
+    for (size_t I = 0; I < OtherCounts.size(); ++I) {
+      Counts[I] += OtherCounts[I];
+    }
+  }
+}
+
+uint64_t Profile::getEntryCount(uint32_t FuncIdx) const noexcept {
+  if (auto It = Entries.find(FuncIdx); It != Entries.end()) {
+    return It->second;
+  }
+  return 0;
+}
+
+Span<const uint64_t> Profile::getBranchCounts(uint32_t Offset) const noexcept {
+  if (auto It = Branches.find(Offset); It != Branches.end()) {
+    return It->second;
+  }
+  return {};
+}
+
+Expect<Profile> Profile::load(std::istream &IS) {
+  std::string Line;
+  if (!std::getline(IS, Line) || Line != kHeader) {
+    spdlog::error(ErrCode::Value::ReadError);
+    spdlog::error("    Profile header not matched."sv);
+    return Unexpect(ErrCode::Value::ReadError);
+  }
+
+  Profile Result;
+  uint64_t LineNum = 1;
+  while (std::getline(IS, Line)) {
+    ++LineNum;
+    std::istringstream LS(Line);
+    std::string Kind;
+    uint32_t Key = 0;
+    if (!(LS >> Kind)) {
+      // Skip the empty lines.
+      continue;
+    }
+    bool Valid = static_cast<bool>(LS >> Key);
+    std::vector<uint64_t> Counts;
+    for (uint64_t Count; Valid && LS >> Count;) {
+      Counts.push_back(Count);
+    }
+    Valid = Valid && LS.eof();
+    if (Valid && Kind == "function"sv && Counts.size() == 1) {
+      Result.addEntry(Key, Counts[0]);
+    } else if (Valid && Kind == "branch"sv && !Counts.empty()) {
+      for (uint32_t I = 0; I < Counts.size(); ++I) {
+        Result.addBranch(Key, I, static_cast<uint32_t>(Counts.size()),
+                         Counts[I]);
+      }
+    } else {
+      spdlog::error(ErrCode::Value::ReadError);
+      spdlog::error("    Malformed profile at line {}."sv, LineNum);
+      return Unexpect(ErrCode::Value::ReadError);
+    }
+  }
+  return Result;
+}
+
+Expect<Profile> Profile::load(const std::filesystem::path &Path) {
+  std::ifstream File(Path);
+  if (!File) {
+    spdlog::error(ErrCode::Value::IllegalPath);
+    spdlog::error("    Profile {} open failed."sv, Path.u8string());
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  return load(File);
+}
+
+void Profile::dump(std::ostream &OS) const {
+  OS << kHeader << '\n';
+  for (const auto &[FuncIdx, Count] : Entries) {
+    OS << "function "sv << FuncIdx << ' ' << Count << '\n';
+  }
+  for (const auto &[Offset, Counts] : Branches) {
+    OS << "branch "sv << Offset;
+    for (const auto Count : Counts) {
+      OS << ' ' << Count;
+    }
+    OS << '\n';
+  }
+}
+
+Expect<void> Profile::dump(const std::filesystem::path &Path) const {
+  std::ofstream File(Path);
+  if (!File) {
+    spdlog::error(ErrCode::Value::IllegalPath);
+    spdlog::error("    Profile {} open failed."sv, Path.u8string());
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  dump(File);
+  return {};
+}
+
+} // namespace PGO
+} // namespace WasmEdge
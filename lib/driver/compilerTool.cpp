@@ -5,6 +5,7 @@
 #include "common/configure.h"
 #include "common/defines.h"
 #include "common/filesystem.h"
+#include "common/pgo.h"
 #include "common/version.h"
 #include "driver/compiler.h"
 #include "loader/loader.h"
@@ -14,6 +15,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -38,12 +40,23 @@ int Compiler([[maybe_unused]] int Argc,
   PO::Option<PO::Toggle> ConfGenericBinary(
       PO::Description("Generate a generic binary"sv));
 
+  PO::List<std::string> ConfTargetCPU(
+      PO::Description(
+          "Compile a code variant for each CPU level, such as `x86-64-v2`, `x86-64-v3`, and `x86-64-v4`. The runtime selects the best variant the host CPU supports."sv),
+      PO::MetaVar("CPU"sv));
+
   PO::Option<PO::Toggle> ConfDumpIR(
       PO::Description("Dump LLVM IR to `wasm.ll` and `wasm-opt.ll`."sv));
 
   PO::Option<PO::Toggle> ConfInterruptible(
       PO::Description("Generate a interruptible binary"sv));
 
+  PO::Option<PO::Toggle> ConfIncremental(PO::Description(
+      "Cache the code of each function, and only recompile the changed functions."sv));
+
+  PO::Option<PO::Toggle> ConfWasmOptimization(PO::Description(
+      "Optimize the functions at the wasm level before compiling them."sv));
+
   PO::Option<PO::Toggle> ConfEnableInstructionCounting(PO::Description(
       "Enable generating code for counting Wasm instructions executed."sv));
   PO::Option<PO::Toggle> ConfEnableGasMeasuring(PO::Description(
@@ -79,17 +92,24 @@ int Compiler([[maybe_unused]] int Argc,
   PO::Option<std::string> PropOptimizationLevel(
       PO::Description("Optimization level, one of 0, 1, 2, 3, s, z."sv),
       PO::DefaultValue(std::string("2")));
+  PO::Option<std::string> ProfileUse(
+      PO::Description(
+          "Optimize with the execution profile written by `wasmedge --profile-generate` running the same Wasm file."sv),
+      PO::MetaVar("PATH"sv), PO::DefaultValue(std::string()));
   auto Parser = PO::ArgumentParser();
   if (!Parser.add_option(WasmName)
            .add_option(SoName)
            .add_option("dump"sv, ConfDumpIR)
            .add_option("interruptible"sv, ConfInterruptible)
+           .add_option("incremental"sv, ConfIncremental)
+           .add_option("optimize-wasm"sv, ConfWasmOptimization)
            .add_option("enable-instruction-count"sv,
                        ConfEnableInstructionCounting)
            .add_option("enable-gas-measuring"sv, ConfEnableGasMeasuring)
            .add_option("enable-time-measuring"sv, ConfEnableTimeMeasuring)
            .add_option("enable-all-statistics"sv, ConfEnableAllStatistics)
            .add_option("generic-binary"sv, ConfGenericBinary)
+           .add_option("target-cpu"sv, ConfTargetCPU)
            .add_option("disable-import-export-mut-globals"sv, PropMutGlobals)
            .add_option("disable-non-trap-float-to-int"sv, PropNonTrapF2IConvs)
            .add_option("disable-sign-extension-operators"sv, PropSignExtendOps)
@@ -103,6 +123,7 @@ int Compiler([[maybe_unused]] int Argc,
            .add_option("enable-threads"sv, PropThreads)
            .add_option("enable-all"sv, PropAll)
            .add_option("optimize"sv, PropOptimizationLevel)
+           .add_option("profile-use"sv, ProfileUse)
            .parse(stdout, Argc, Argv)) {
     return EXIT_FAILURE;
   }
@@ -210,6 +231,12 @@ int Compiler([[maybe_unused]] int Argc,
     if (ConfInterruptible.value()) {
       Conf.getCompilerConfigure().setInterruptible(true);
     }
+    if (ConfIncremental.value()) {
+      Conf.getCompilerConfigure().setIncremental(true);
+    }
+    if (ConfWasmOptimization.value()) {
+      Conf.getCompilerConfigure().setWasmOptimization(true);
+    }
     if (ConfEnableAllStatistics.value()) {
       Conf.getStatisticsConfigure().setInstructionCounting(true);
       Conf.getStatisticsConfigure().setCostMeasuring(true);
@@ -228,11 +255,28 @@ int Compiler([[maybe_unused]] int Argc,
     if (ConfGenericBinary.value()) {
       Conf.getCompilerConfigure().setGenericBinary(true);
     }
+    for (const auto &Name : ConfTargetCPU.value()) {
+      Conf.getCompilerConfigure().addTargetCPU(Name);
+    }
     if (OutputPath.extension().u8string() == WASMEDGE_LIB_EXTENSION) {
       Conf.getCompilerConfigure().setOutputFormat(
           CompilerConfigure::OutputFormat::Native);
     }
+    std::optional<PGO::Profile> Profile;
+    if (!ProfileUse.value().empty()) {
+      if (auto Res = PGO::Profile::load(
+              std::filesystem::u8path(ProfileUse.value()))) {
+        Profile = std::move(*Res);
+      } else {
+        const auto Err = static_cast<uint32_t>(Res.error());
+        spdlog::error("Load profile failed. Error code: {}", Err);
+        return EXIT_FAILURE;
+      }
+    }
     AOT::Compiler Compiler(Conf);
+    if (Profile.has_value()) {
+      Compiler.setProfile(&*Profile);
+    }
     if (auto Res = Compiler.compile(Data, *Module, OutputPath); !Res) {
       const auto Err = static_cast<uint32_t>(Res.error());
       spdlog::error("Compilation failed. Error code: {}", Err);
@@ -1,13 +1,17 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: 2019-2022 Second State INC
 
+#include "aot/tiered.h"
 #include "common/configure.h"
 #include "common/filesystem.h"
 #include "common/log.h"
+#include "common/pgo.h"
 #include "common/types.h"
 #include "common/version.h"
 #include "driver/tool.h"
+#include "executor/profiler.h"
 #include "host/wasi/wasimodule.h"
+#include "loader/loader.h"
 #include "plugin/plugin.h"
 #include "po/argument_parser.h"
 #include "vm/vm.h"
@@ -15,7 +19,9 @@
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -24,6 +30,50 @@
 namespace WasmEdge {
 namespace Driver {
 
+namespace {
+
+/// Sampling profiler which writes the profile when the execution finished.
+class ProfileWriter {
+public:
+  ProfileWriter(std::filesystem::path Path) : Path(std::move(Path)) {}
+  ~ProfileWriter() noexcept {
+    Prof.stop();
+    std::ofstream File(Path, std::ios::binary);
+    if (!File) {
+      spdlog::error("Failed to open the profile output {}."sv, Path.u8string());
+      return;
+    }
+    const auto Ext = Path.extension();
+    if (Ext == std::filesystem::u8path(".folded"sv) ||
+        Ext == std::filesystem::u8path(".txt"sv)) {
+      Prof.dumpFolded(File);
+    } else {
+      Prof.dumpPprof(File);
+    }
+  }
+
+  Executor::Profiler &getProfiler() noexcept { return Prof; }
+
+private:
+  Executor::Profiler Prof;
+  std::filesystem::path Path;
+};
+
+/// Execution profile which is written when the execution finished.
+class PGOProfileWriter {
+public:
+  PGOProfileWriter(std::filesystem::path Path) : Path(std::move(Path)) {}
+  ~PGOProfileWriter() noexcept { Prof.dump(Path); }
+
+  PGO::Profile &getProfile() noexcept { return Prof; }
+
+private:
+  PGO::Profile Prof;
+  std::filesystem::path Path;
+};
+
+} // namespace
+
 int Tool(int Argc, const char *Argv[]) noexcept {
   using namespace std::literals;
 
@@ -87,6 +137,15 @@ int Tool(int Argc, const char *Argv[]) noexcept {
   PO::Option<PO::Toggle> ConfEnableAllStatistics(PO::Description(
       "Enable generating code for all statistics options include instruction counting, gas measuring, and execution time"sv));
 
+  PO::Option<PO::Toggle> ConfEnablePerfMap(PO::Description(
+      "Enable writing the symbols of the AOT code in universal Wasm to /tmp/perf-<pid>.map for the Linux perf tool."sv));
+  PO::Option<PO::Toggle> ConfEnableJitDump(PO::Description(
+      "Enable writing the AOT code in universal Wasm to /tmp/jit-<pid>.dump for `perf inject --jit`."sv));
+  PO::Option<PO::Toggle> ConfWasmOptimization(PO::Description(
+      "Optimize the functions at the wasm level before executing them."sv));
+  PO::Option<PO::Toggle> Tiered(PO::Description(
+      "Compile the Wasm quickly to start executing, and switch to the optimized code compiled in the background. Both are cached."sv));
+
   PO::Option<uint64_t> TimeLim(
       PO::Description(
           "Limitation of maximum time(in milliseconds) for execution, default value is 0 for no limitations"sv),
@@ -102,6 +161,16 @@ int Tool(int Argc, const char *Argv[]) noexcept {
           "Limitation of pages(as size of 64 KiB) in every memory instance. Upper bound can be specified as --memory-page-limit `PAGE_COUNT`."sv),
       PO::MetaVar("PAGE_COUNT"sv));
 
+  PO::Option<std::string> ProfilePath(
+      PO::Description(
+          "Write a sampling profile of the Wasm functions. The profile is in the folded stack format for the `.folded` and `.txt` extensions, and in the pprof format otherwise. The AOT compiled code must be compiled with `--interruptible`."sv),
+      PO::MetaVar("PATH"sv), PO::DefaultValue(std::string()));
+
+  PO::Option<std::string> ProfileGeneratePath(
+      PO::Description(
+          "Write the function entry counts and the branch counts of the interpreter for `wasmedgec --profile-use`."sv),
+      PO::MetaVar("PATH"sv), PO::DefaultValue(std::string()));
+
   PO::List<std::string> ForbiddenPlugins(
       PO::Description("List of plugins to ignore."sv), PO::MetaVar("NAMES"sv));
 
@@ -115,6 +184,10 @@ int Tool(int Argc, const char *Argv[]) noexcept {
       .add_option("enable-gas-measuring"sv, ConfEnableGasMeasuring)
       .add_option("enable-time-measuring"sv, ConfEnableTimeMeasuring)
       .add_option("enable-all-statistics"sv, ConfEnableAllStatistics)
+      .add_option("enable-perf-map"sv, ConfEnablePerfMap)
+      .add_option("enable-jitdump"sv, ConfEnableJitDump)
+      .add_option("optimize-wasm"sv, ConfWasmOptimization)
+      .add_option("tiered"sv, Tiered)
       .add_option("disable-import-export-mut-globals"sv, PropMutGlobals)
       .add_option("disable-non-trap-float-to-int"sv, PropNonTrapF2IConvs)
       .add_option("disable-sign-extension-operators"sv, PropSignExtendOps)
@@ -130,6 +203,8 @@ int Tool(int Argc, const char *Argv[]) noexcept {
       .add_option("time-limit"sv, TimeLim)
       .add_option("gas-limit"sv, GasLim)
       .add_option("memory-page-limit"sv, MemLim)
+      .add_option("profile"sv, ProfilePath)
+      .add_option("profile-generate"sv, ProfileGeneratePath)
       .add_option("forbidden-plugin"sv, ForbiddenPlugins);
 
   Plugin::Plugin::addPluginOptions(Parser);
@@ -183,10 +258,10 @@ int Tool(int Argc, const char *Argv[]) noexcept {
     Conf.addProposal(Proposal::Threads);
   }
 
-  std::optional<std::chrono::system_clock::time_point> Timeout;
+  std::optional<Epoch::Clock::time_point> Timeout;
   if (TimeLim.value() > 0) {
-    Timeout = std::chrono::system_clock::now() +
-              std::chrono::milliseconds(TimeLim.value());
+    Timeout =
+        Epoch::Clock::now() + std::chrono::milliseconds(TimeLim.value());
   }
   if (GasLim.value().size() > 0) {
     Conf.getStatisticsConfigure().setCostMeasuring(true);
@@ -197,6 +272,15 @@ int Tool(int Argc, const char *Argv[]) noexcept {
     Conf.getRuntimeConfigure().setMaxMemoryPage(
         static_cast<uint32_t>(MemLim.value().back()));
   }
+  if (ConfEnablePerfMap.value()) {
+    Conf.getRuntimeConfigure().setPerfMap(true);
+  }
+  if (ConfEnableJitDump.value()) {
+    Conf.getRuntimeConfigure().setJitDump(true);
+  }
+  if (ConfWasmOptimization.value()) {
+    Conf.getCompilerConfigure().setWasmOptimization(true);
+  }
   if (ConfEnableAllStatistics.value()) {
     Conf.getStatisticsConfigure().setInstructionCounting(true);
     Conf.getStatisticsConfigure().setCostMeasuring(true);
@@ -226,7 +310,73 @@ int Tool(int Argc, const char *Argv[]) noexcept {
   Conf.addHostRegistration(HostRegistration::WasiCrypto_Signatures);
   Conf.addHostRegistration(HostRegistration::WasiCrypto_Symmetric);
   const auto InputPath = std::filesystem::absolute(SoName.value());
+  // The profiler must outlive the VM, which samples until it is destroyed.
+  std::optional<ProfileWriter> Profile;
+  if (!ProfilePath.value().empty()) {
+    Profile.emplace(std::filesystem::u8path(ProfilePath.value()));
+  }
+  std::optional<PGOProfileWriter> PGOProfile;
+  if (!ProfileGeneratePath.value().empty()) {
+    PGOProfile.emplace(std::filesystem::u8path(ProfileGeneratePath.value()));
+  }
   VM::VM VM(Conf);
+  if (Profile.has_value()) {
+    VM.setProfiler(&Profile->getProfiler());
+  }
+  if (PGOProfile.has_value()) {
+    VM.setPGOProfile(&PGOProfile->getProfile());
+  }
+  if (Timeout.has_value()) {
+    // The deadline is checked at function entries and loop back-edges.
+    VM.setTimeout(*Timeout);
+  }
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  // The tiered compiler upgrades the instantiated module, so that it must be
+  // destroyed before the VM.
+  std::optional<AOT::TieredCompiler> TieredCompiler;
+  if (Tiered.value()) {
+    TieredCompiler.emplace(Conf, &Executor::Executor::Intrinsics);
+  }
+#else
+  if (Tiered.value()) {
+    spdlog::error(ErrCode::Value::AOTDisabled);
+    return EXIT_FAILURE;
+  }
+#endif
+
+  // Load, validate, and instantiate the module.
+  auto Instantiate = [&]() -> Expect<void> {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+    if (TieredCompiler.has_value()) {
+      std::shared_ptr<const AST::Module> Mod;
+      if (auto Data = Loader::Loader::loadFile(InputPath); !Data) {
+        return Unexpect(Data);
+      } else if (auto Res = TieredCompiler->compile(*Data); !Res) {
+        return Unexpect(Res);
+      } else {
+        Mod = std::move(*Res);
+      }
+      if (auto Res = VM.loadWasm(std::move(Mod)); !Res) {
+        return Unexpect(Res);
+      }
+      if (auto Res = VM.validate(); !Res) {
+        return Unexpect(Res);
+      }
+      if (auto Res = VM.instantiate(); !Res) {
+        return Unexpect(Res);
+      }
+      TieredCompiler->attach(*VM.getActiveModule());
+      return {};
+    }
+#endif
+    if (auto Res = VM.loadWasm(InputPath.u8string()); !Res) {
+      return Unexpect(Res);
+    }
+    if (auto Res = VM.validate(); !Res) {
+      return Unexpect(Res);
+    }
+    return VM.instantiate();
+  };
 
   Host::WasiModule *WasiMod = dynamic_cast<Host::WasiModule *>(
       VM.getImportModule(HostRegistration::Wasi));
@@ -240,13 +390,18 @@ int Tool(int Argc, const char *Argv[]) noexcept {
 
   if (!Reactor.value()) {
     // command mode
-    auto AsyncResult = VM.asyncRunWasmFile(InputPath.u8string(), "_start");
-    if (Timeout.has_value()) {
-      if (!AsyncResult.waitUntil(*Timeout)) {
-        AsyncResult.cancel();
+    if (Tiered.value()) {
+      if (auto Result = Instantiate(); !Result) {
+        return EXIT_FAILURE;
+      }
+      if (auto Result = VM.execute("_start");
+          Result || Result.error() == ErrCode::Value::Terminated) {
+        return static_cast<int>(WasiMod->getEnv().getExitCode());
+      } else {
+        return EXIT_FAILURE;
       }
     }
-    if (auto Result = AsyncResult.get();
+    if (auto Result = VM.runWasmFile(InputPath, "_start");
         Result || Result.error() == ErrCode::Value::Terminated) {
       return static_cast<int>(WasiMod->getEnv().getExitCode());
     } else {
@@ -260,13 +415,7 @@ int Tool(int Argc, const char *Argv[]) noexcept {
       return EXIT_FAILURE;
     }
     const auto &FuncName = Args.value().front();
-    if (auto Result = VM.loadWasm(InputPath.u8string()); !Result) {
-      return EXIT_FAILURE;
-    }
-    if (auto Result = VM.validate(); !Result) {
-      return EXIT_FAILURE;
-    }
-    if (auto Result = VM.instantiate(); !Result) {
+    if (auto Result = Instantiate(); !Result) {
       return EXIT_FAILURE;
     }
 
@@ -285,13 +434,7 @@ int Tool(int Argc, const char *Argv[]) noexcept {
     }
 
     if (HasInit) {
-      auto AsyncResult = VM.asyncExecute(InitFunc);
-      if (Timeout.has_value()) {
-        if (!AsyncResult.waitUntil(*Timeout)) {
-          AsyncResult.cancel();
-        }
-      }
-      if (auto Result = AsyncResult.get(); unlikely(!Result)) {
+      if (auto Result = VM.execute(InitFunc); unlikely(!Result)) {
         return EXIT_FAILURE;
       }
     }
@@ -343,13 +486,7 @@ int Tool(int Argc, const char *Argv[]) noexcept {
       }
     }
 
-    auto AsyncResult = VM.asyncExecute(FuncName, FuncArgs, FuncArgTypes);
-    if (Timeout.has_value()) {
-      if (!AsyncResult.waitUntil(*Timeout)) {
-        AsyncResult.cancel();
-      }
-    }
-    if (auto Result = AsyncResult.get()) {
+    if (auto Result = VM.execute(FuncName, FuncArgs, FuncArgTypes)) {
       /// Print results.
       for (size_t I = 0; I < Result->size(); ++I) {
         switch ((*Result)[I].second) {
@@ -3,6 +3,7 @@
 
 #include "executor/executor.h"
 
+#include <algorithm>
 #include <cstdint>
 
 namespace WasmEdge {
@@ -13,6 +14,9 @@ Expect<void> Executor::runIfElseOp(Runtime::StackManager &StackMgr,
                                    AST::InstrView::iterator &PC) noexcept {
   // Get condition.
   uint32_t Cond = StackMgr.pop().get<uint32_t>();
+  if (unlikely(PGOProf.load(std::memory_order_relaxed))) {
+    countPGOBranch(StackMgr, Instr, Cond != 0 ? 0 : 1);
+  }
 
   // If non-zero, run if-statement; else, run else-statement.
   if (Cond == 0) {
@@ -22,7 +26,8 @@ Expect<void> Executor::runIfElseOp(Runtime::StackManager &StackMgr,
     } else {
       if (Stat) {
         Stat->incInstrCount();
-        if (unlikely(!Stat->addInstrCost(OpCode::Else))) {
+        if (unlikely(
+                !chargeGas(Stat->getCostTable()[uint16_t(OpCode::Else)]))) {
           return Unexpect(ErrCode::Value::CostLimitExceeded);
         }
       }
@@ -44,7 +49,11 @@ Expect<void> Executor::runBrOp(Runtime::StackManager &StackMgr,
 Expect<void> Executor::runBrIfOp(Runtime::StackManager &StackMgr,
                                  const AST::Instruction &Instr,
                                  AST::InstrView::iterator &PC) noexcept {
-  if (StackMgr.pop().get<uint32_t>() != 0) {
+  const bool Taken = StackMgr.pop().get<uint32_t>() != 0;
+  if (unlikely(PGOProf.load(std::memory_order_relaxed))) {
+    countPGOBranch(StackMgr, Instr, Taken ? 0 : 1);
+  }
+  if (Taken) {
     return runBrOp(StackMgr, Instr, PC);
   }
   return {};
@@ -59,6 +68,9 @@ Expect<void> Executor::runBrTableOp(Runtime::StackManager &StackMgr,
   // Do branch.
   auto LabelTable = Instr.getLabelList();
   const auto LabelTableSize = static_cast<uint32_t>(LabelTable.size() - 1);
+  if (unlikely(PGOProf.load(std::memory_order_relaxed))) {
+    countPGOBranch(StackMgr, Instr, std::min(Value, LabelTableSize));
+  }
   if (Value < LabelTableSize) {
     return branchToLabel(StackMgr, LabelTable[Value].StackEraseBegin,
                          LabelTable[Value].StackEraseEnd,
@@ -71,11 +83,6 @@ Expect<void> Executor::runBrTableOp(Runtime::StackManager &StackMgr,
 
 Expect<void> Executor::runReturnOp(Runtime::StackManager &StackMgr,
                                    AST::InstrView::iterator &PC) noexcept {
-  // Check stop token
-  if (unlikely(StopToken.exchange(0, std::memory_order_relaxed))) {
-    spdlog::error(ErrCode::Value::Interrupted);
-    return Unexpect(ErrCode::Value::Interrupted);
-  }
   PC = StackMgr.popFrame();
   return {};
 }
@@ -12,16 +12,24 @@ namespace Executor {
 
 Expect<void> Executor::runExpression(Runtime::StackManager &StackMgr,
                                      AST::InstrView Instrs) {
-  return execute(StackMgr, Instrs.begin(), Instrs.end());
+  auto Res = execute(StackMgr, Instrs.begin(), Instrs.end());
+  if (Stat) {
+    // Give back the gas reserved by this thread.
+    flushGas();
+  }
+  return Res;
 }
 
 Expect<void>
 Executor::runFunction(Runtime::StackManager &StackMgr,
                       const Runtime::Instance::FunctionInstance &Func,
                       Span<const ValVariant> Params) {
-  // Set start time.
-  if (Stat && Conf.getStatisticsConfigure().isTimeMeasuring()) {
-    Stat->startRecordWasm();
+  // Set start time and start the gas reservation of this thread.
+  if (Stat) {
+    if (Conf.getStatisticsConfigure().isTimeMeasuring()) {
+      Stat->startRecordWasm();
+    }
+    resetGasBudget();
   }
 
   // Reset and push a dummy frame into stack.
@@ -43,6 +51,9 @@ Executor::runFunction(Runtime::StackManager &StackMgr,
       // For the terminated case, not return now to print the statistics.
       Res = Unexpect(GetIt.error());
     } else {
+      if (Stat) {
+        flushGas();
+      }
       return Unexpect(GetIt);
     }
   }
@@ -59,8 +70,12 @@ Executor::runFunction(Runtime::StackManager &StackMgr,
     spdlog::debug(" Terminated.");
   }
 
-  if (Stat && Conf.getStatisticsConfigure().isTimeMeasuring()) {
-    Stat->stopRecordWasm();
+  if (Stat) {
+    // Give back the gas reserved by this thread.
+    flushGas();
+    if (Conf.getStatisticsConfigure().isTimeMeasuring()) {
+      Stat->stopRecordWasm();
+    }
   }
 
   // If Statistics is enabled, then dump it here.
@@ -103,12 +118,9 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
     case OpCode::Else:
       if (Stat && Conf.getStatisticsConfigure().isCostMeasuring()) {
         // Reach here means end of if-statement.
-        if (unlikely(!Stat->subInstrCost(Instr.getOpCode()))) {
-          spdlog::error(
-              ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-          return Unexpect(ErrCode::Value::CostLimitExceeded);
-        }
-        if (unlikely(!Stat->addInstrCost(OpCode::End))) {
+        const auto CostTab = Stat->getCostTable();
+        refundGas(CostTab[uint16_t(Instr.getOpCode())]);
+        if (unlikely(!chargeGas(CostTab[uint16_t(OpCode::End)]))) {
           spdlog::error(
               ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
           return Unexpect(ErrCode::Value::CostLimitExceeded);
@@ -1819,7 +1831,7 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
       }
       // Add cost. Note: if-else case should be processed additionally.
       if (Conf.getStatisticsConfigure().isCostMeasuring()) {
-        if (unlikely(!Stat->addInstrCost(Code))) {
+        if (unlikely(!chargeGas(Stat->getCostTable()[uint16_t(Code)]))) {
           const AST::Instruction &Instr = *PC;
           spdlog::error(
               ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
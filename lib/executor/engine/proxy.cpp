@@ -11,7 +11,11 @@ namespace Executor {
 
 thread_local Executor *Executor::This = nullptr;
 thread_local Runtime::StackManager *Executor::CurrentStack = nullptr;
+thread_local const void *Executor::CompiledStackEnd = nullptr;
 thread_local Executor::ExecutionContextStruct Executor::ExecutionContext;
+thread_local uint64_t Executor::ThreadGas = 0;
+thread_local uint64_t Executor::GasBase = 0;
+thread_local Executor::PreemptionContext Executor::Preemption;
 
 template <typename RetT, typename... ArgsT>
 struct Executor::ProxyHelper<Expect<RetT> (Executor::*)(Runtime::StackManager &,
@@ -68,6 +72,8 @@ const AST::Module::IntrinsicsTable Executor::Intrinsics = {
     ENTRY(kPtrFunc, ptrFunc),
     ENTRY(kMemoryAtomicNotify, memoryAtomicNotify),
     ENTRY(kMemoryAtomicWait, memoryAtomicWait),
+    ENTRY(kCheckDeadline, checkDeadline),
+    ENTRY(kRefillGas, refillGas),
 #undef ENTRY
 };
 
@@ -80,39 +86,37 @@ Expect<void> Executor::trap(Runtime::StackManager &,
   return Unexpect(static_cast<ErrCategory>(Code >> 24), Code);
 }
 
-Expect<void> Executor::call(Runtime::StackManager &StackMgr,
-                            const uint32_t FuncIdx, const ValVariant *Args,
-                            ValVariant *Rets) noexcept {
+Expect<void> Executor::checkDeadline(Runtime::StackManager &StackMgr,
+                                     const uint32_t FuncIdx,
+                                     const void *FrameAddress) noexcept {
   const auto *ModInst = StackMgr.getModule();
-  const auto *FuncInst = *ModInst->getFunc(FuncIdx);
-  const auto &FuncType = FuncInst->getFuncType();
-  const uint32_t ParamsSize =
-      static_cast<uint32_t>(FuncType.getParamTypes().size());
-  const uint32_t ReturnsSize =
-      static_cast<uint32_t>(FuncType.getReturnTypes().size());
-
-  for (uint32_t I = 0; I < ParamsSize; ++I) {
-    StackMgr.push(Args[I]);
-  }
-
-  auto Instrs = FuncInst->getInstrs();
-  AST::InstrView::iterator StartIt;
-  if (auto Res = enterFunction(StackMgr, *FuncInst, Instrs.end())) {
-    StartIt = *Res;
-  } else {
-    return Unexpect(Res);
-  }
-  if (auto Res = execute(StackMgr, StartIt, Instrs.end()); unlikely(!Res)) {
-    return Unexpect(Res);
+  const auto *Func = ModInst ? ModInst->unsafeGetFunction(FuncIdx) : nullptr;
+  if (handleDeadline(&StackMgr, Func, {}, FrameAddress) ==
+      SafePoint::Interrupt) {
+    spdlog::error(ErrCode::Value::Interrupted);
+    return Unexpect(ErrCode::Value::Interrupted);
   }
+  return {};
+}
 
-  for (uint32_t I = 0; I < ReturnsSize; ++I) {
-    Rets[ReturnsSize - 1 - I] = StackMgr.pop();
+Expect<void> Executor::refillGas(Runtime::StackManager &,
+                                 const uint64_t Cost) noexcept {
+  if (unlikely(!chargeGas(Cost))) {
+    return Unexpect(ErrCode::Value::CostLimitExceeded);
   }
-
   return {};
 }
 
+Expect<void> Executor::call(Runtime::StackManager &StackMgr,
+                            const uint32_t FuncIdx, const ValVariant *Args,
+                            ValVariant *Rets) noexcept {
+  const auto *ModInst = StackMgr.getModule();
+  assuming(ModInst);
+  const auto *FuncInst = ModInst->unsafeGetFunction(FuncIdx);
+  assuming(FuncInst);
+  return callFunction(StackMgr, *FuncInst, Args, Rets);
+}
+
 Expect<void *> Executor::ptrFunc(Runtime::StackManager &StackMgr,
                                  const uint32_t TableIdx,
                                  const uint32_t FuncTypeIdx,
@@ -145,7 +149,7 @@ Expect<void *> Executor::ptrFunc(Runtime::StackManager &StackMgr,
     return nullptr;
   }
 
-  return FuncInst->getSymbol().get();
+  return FuncInst->getCompiledEntry();
 }
 
 Expect<void>
@@ -176,18 +180,84 @@ Executor::callIndirect(Runtime::StackManager &StackMgr, const uint32_t TableIdx,
     return Unexpect(ErrCode::Value::IndirectCallTypeMismatch);
   }
 
+  return callFunction(StackMgr, *FuncInst, Args, Rets);
+}
+
+Expect<void>
+Executor::callFunction(Runtime::StackManager &StackMgr,
+                       const Runtime::Instance::FunctionInstance &Func,
+                       const ValVariant *Args, ValVariant *Rets) noexcept {
+  const auto &FuncType = Func.getFuncType();
   const uint32_t ParamsSize =
       static_cast<uint32_t>(FuncType.getParamTypes().size());
   const uint32_t ReturnsSize =
       static_cast<uint32_t>(FuncType.getReturnTypes().size());
 
+  // Check the interruption at the function entry as enterFunction() does.
+  // The compiled code cannot be suspended, so no suspension point here.
+  if (unlikely(isInterrupted(&StackMgr, &Func))) {
+    spdlog::error(ErrCode::Value::Interrupted);
+    return Unexpect(ErrCode::Value::Interrupted);
+  }
+
+  // The callee may grow the memories imported by the caller, which reloads
+  // the memory bases from its pointers after the call.
+  auto *Caller =
+      const_cast<Runtime::Instance::ModuleInstance *>(StackMgr.getModule());
+
+  if (Func.isCompiledFunction()) {
+    // Compiled function case: call the native symbol directly with the
+    // arguments and returns buffers of the caller. The frame is only pushed
+    // for the intrinsics to resolve the module instance of the callee. The
+    // faults are handled by the handler of the outermost compiled function.
+    auto *ModInst =
+        const_cast<Runtime::Instance::ModuleInstance *>(Func.getModule());
+    refreshMemoryPtrs(*ModInst);
+    StackMgr.pushFrame(ModInst, AST::InstrView::iterator(), 0, 0);
+    {
+      SavedExecutionContext Saved(StackMgr, ModInst->MemoryPtrs.data(),
+                                  ModInst->GlobalPtrs.data());
+      auto &Wrapper = FuncType.getSymbol();
+      Wrapper(&ExecutionContext, Func.getCompiledEntry(), Args, Rets);
+    }
+    StackMgr.popFrame();
+    if (Caller) {
+      refreshMemoryPtrs(*Caller);
+    }
+    return {};
+  }
+
+  if (Func.isHostFunction()) {
+    // Host function case: run the host function directly with the arguments
+    // and returns buffers of the caller.
+    const auto *ModInst = Caller ? Caller : Func.getModule();
+    Runtime::CallingFrame CallFrame(this, ModInst);
+    // Push the frame of the host function as enterFunction() does. The
+    // arguments and returns stay in the buffers of the caller.
+    StackMgr.pushFrame(Func.getModule(), AST::InstrView::iterator(), 0, 0);
+    auto Res = runHostFunction(CallFrame, Func,
+                               Span<const ValVariant>(Args, ParamsSize),
+                               Span<ValVariant>(Rets, ReturnsSize));
+    StackMgr.popFrame();
+    if (unlikely(!Res && Res.error() == ErrCode::Value::Suspended)) {
+      // The compiled caller cannot be suspended in the middle.
+      spdlog::error(ErrCode::Value::Suspended);
+      return Unexpect(ErrCode::Value::HostFuncError);
+    }
+    if (Res && Caller) {
+      refreshMemoryPtrs(*Caller);
+    }
+    return Res;
+  }
+
+  // Native function case: execute the function in the interpreter.
   for (uint32_t I = 0; I < ParamsSize; ++I) {
     StackMgr.push(Args[I]);
   }
 
-  auto Instrs = FuncInst->getInstrs();
+  auto Instrs = Func.getInstrs();
   AST::InstrView::iterator StartIt;
-  if (auto Res = enterFunction(StackMgr, *FuncInst, Instrs.end())) {
+  if (auto Res = enterFunction(StackMgr, Func, Instrs.end())) {
     StartIt = *Res;
   } else {
     return Unexpect(Res);
@@ -199,6 +269,9 @@ Executor::callIndirect(Runtime::StackManager &StackMgr, const uint32_t TableIdx,
   for (uint32_t I = 0; I < ReturnsSize; ++I) {
     Rets[ReturnsSize - 1 - I] = StackMgr.pop();
   }
+  if (Caller) {
+    refreshMemoryPtrs(*Caller);
+  }
 
   return {};
 }
@@ -210,6 +283,11 @@ Expect<uint32_t> Executor::memGrow(Runtime::StackManager &StackMgr,
   assuming(MemInst);
   const uint32_t CurrPageSize = MemInst->getPageSize();
   if (MemInst->growPage(NewSize)) {
+    // Update the memory pointers, which the compiled code reloads after
+    // `memory.grow`, in case the pages are moved. The other modules importing
+    // the memory update theirs when entered or returned to.
+    refreshMemoryPtrs(
+        *const_cast<Runtime::Instance::ModuleInstance *>(StackMgr.getModule()));
     return CurrPageSize;
   } else {
     return static_cast<uint32_t>(-1);
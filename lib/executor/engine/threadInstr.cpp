@@ -10,8 +10,8 @@ Expect<void>
 Executor::runAtomicNotifyOp(Runtime::StackManager &StackMgr,
                             Runtime::Instance::MemoryInstance &MemInst,
                             const AST::Instruction &Instr) {
-  ValVariant RawAddress = StackMgr.pop();
-  ValVariant &RawCount = StackMgr.getTop();
+  ValVariant RawCount = StackMgr.pop();
+  ValVariant &RawAddress = StackMgr.getTop();
 
   uint32_t Address = RawAddress.get<uint32_t>();
 
@@ -34,7 +34,7 @@ Executor::runAtomicNotifyOp(Runtime::StackManager &StackMgr,
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
     return Unexpect(Res);
   } else {
-    RawCount.emplace<uint32_t>(*Res);
+    RawAddress.emplace<uint32_t>(*Res);
   }
   return {};
 }
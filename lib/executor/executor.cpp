@@ -6,9 +6,31 @@
 #include "common/errinfo.h"
 #include "common/log.h"
 
+#include <experimental/scope.hpp>
+
+#include <utility>
+
 namespace WasmEdge {
 namespace Executor {
 
+namespace {
+/// Check the arguments against the parameter types of the function.
+Expect<void> checkParamTypes(const AST::FunctionType &FuncType,
+                             Span<const ValVariant> Params,
+                             Span<const ValType> ParamTypes) {
+  const auto &PTypes = FuncType.getParamTypes();
+  const auto &RTypes = FuncType.getReturnTypes();
+  std::vector<ValType> GotParamTypes(ParamTypes.begin(), ParamTypes.end());
+  GotParamTypes.resize(Params.size(), ValType::I32);
+  if (PTypes != GotParamTypes) {
+    spdlog::error(ErrCode::Value::FuncSigMismatch);
+    spdlog::error(ErrInfo::InfoMismatch(PTypes, RTypes, GotParamTypes, RTypes));
+    return Unexpect(ErrCode::Value::FuncSigMismatch);
+  }
+  return {};
+}
+} // namespace
+
 /// Instantiate a WASM Module. See "include/executor/executor.h".
 Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
 Executor::instantiateModule(Runtime::StoreManager &StoreMgr,
@@ -26,6 +48,24 @@ Executor::instantiateModule(Runtime::StoreManager &StoreMgr,
   }
 }
 
+/// Instantiate a shared WASM Module. See "include/executor/executor.h".
+Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
+Executor::instantiateModule(Runtime::StoreManager &StoreMgr,
+                            std::shared_ptr<const AST::Module> Mod) {
+  const AST::Module &ModRef = *Mod;
+  if (auto Res = instantiate(StoreMgr, ModRef, std::nullopt, std::move(Mod))) {
+    return Res;
+  } else {
+    // If Statistics is enabled, then dump it here.
+    // When there is an error happened, the following execution will not
+    // execute.
+    if (Stat) {
+      Stat->dumpToLog(Conf);
+    }
+    return Unexpect(Res);
+  }
+}
+
 /// Register a named WASM module. See "include/executor/executor.h".
 Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
 Executor::registerModule(Runtime::StoreManager &StoreMgr,
@@ -43,6 +83,25 @@ Executor::registerModule(Runtime::StoreManager &StoreMgr,
   }
 }
 
+/// Register a named shared WASM module. See "include/executor/executor.h".
+Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
+Executor::registerModule(Runtime::StoreManager &StoreMgr,
+                         std::shared_ptr<const AST::Module> Mod,
+                         std::string_view Name) {
+  const AST::Module &ModRef = *Mod;
+  if (auto Res = instantiate(StoreMgr, ModRef, Name, std::move(Mod))) {
+    return Res;
+  } else {
+    // If Statistics is enabled, then dump it here.
+    // When there is an error happened, the following execution will not
+    // execute.
+    if (Stat) {
+      Stat->dumpToLog(Conf);
+    }
+    return Unexpect(Res);
+  }
+}
+
 /// Register an instantiated module. See "include/executor/executor.h".
 Expect<void>
 Executor::registerModule(Runtime::StoreManager &StoreMgr,
@@ -61,15 +120,10 @@ Executor::invoke(const Runtime::Instance::FunctionInstance &FuncInst,
                  Span<const ValVariant> Params,
                  Span<const ValType> ParamTypes) {
   // Check parameter and function type.
-  const auto &FuncType = FuncInst.getFuncType();
-  const auto &PTypes = FuncType.getParamTypes();
-  const auto &RTypes = FuncType.getReturnTypes();
-  std::vector<ValType> GotParamTypes(ParamTypes.begin(), ParamTypes.end());
-  GotParamTypes.resize(Params.size(), ValType::I32);
-  if (PTypes != GotParamTypes) {
-    spdlog::error(ErrCode::Value::FuncSigMismatch);
-    spdlog::error(ErrInfo::InfoMismatch(PTypes, RTypes, GotParamTypes, RTypes));
-    return Unexpect(ErrCode::Value::FuncSigMismatch);
+  const auto &RTypes = FuncInst.getFuncType().getReturnTypes();
+  if (auto Res = checkParamTypes(FuncInst.getFuncType(), Params, ParamTypes);
+      !Res) {
+    return Unexpect(Res);
   }
 
   Runtime::StackManager StackMgr;
@@ -91,5 +145,132 @@ Executor::invoke(const Runtime::Instance::FunctionInstance &FuncInst,
   return Returns;
 }
 
+/// Create a continuation. See "include/executor/executor.h".
+Expect<std::unique_ptr<Continuation>>
+Executor::createContinuation(const Runtime::Instance::FunctionInstance &FuncInst,
+                             Span<const ValVariant> Params,
+                             Span<const ValType> ParamTypes) {
+  if (auto Res = checkParamTypes(FuncInst.getFuncType(), Params, ParamTypes);
+      !Res) {
+    return Unexpect(Res);
+  }
+  return std::make_unique<Continuation>(FuncInst, Params);
+}
+
+/// Resume a continuation. See "include/executor/executor.h".
+Expect<bool> Executor::resume(Continuation &Cont, uint64_t Fuel,
+                              uint64_t SliceDeadline) {
+  if (unlikely(!Cont.isResumable())) {
+    spdlog::error(ErrCode::Value::WrongVMWorkflow);
+    return Unexpect(ErrCode::Value::WrongVMWorkflow);
+  }
+
+  // Run the continuation as the current thread and restore the caller state
+  // when leaving, so that a host function can resume other continuations.
+  SavedThreadState Saved;
+  Preemption = PreemptionContext{};
+  Preemption.Suspendable = true;
+  Preemption.Deadline = SliceDeadline;
+  Preemption.Fuel = Fuel;
+  Preemption.Current = &Cont;
+  newThread();
+  // Keep the epoch counter advancing until the slice ends.
+  if (SliceDeadline != Epoch::kNever) {
+    Epoch::arm();
+  }
+  cxx20::scope_exit DisarmSlice([SliceDeadline]() noexcept {
+    if (SliceDeadline != Epoch::kNever) {
+      Epoch::disarm();
+    }
+  });
+
+  const auto &Func = *Cont.Func;
+  auto &StackMgr = Cont.StackMgr;
+  if (Stat && Conf.getStatisticsConfigure().isTimeMeasuring()) {
+    Stat->startRecordWasm();
+  }
+
+  Expect<void> Res = {};
+  if (Cont.St == Continuation::Status::Ready) {
+    // Enter the function. For the compiled or host functions, the execution
+    // completes here and the PC will be the end of the instruction list.
+    if (auto GetIt = enterFunction(StackMgr, Func, Func.getInstrs().end())) {
+      Cont.PC = *GetIt;
+    } else {
+      Res = Unexpect(GetIt);
+    }
+  } else if (Cont.PendingHost) {
+    // Call the host function which suspended the execution again, and
+    // continue from its return position.
+    const auto *HostFunc = std::exchange(Cont.PendingHost, nullptr);
+    if (auto GetIt = enterFunction(StackMgr, *HostFunc, Cont.PC)) {
+      Cont.PC = *GetIt;
+    } else {
+      Res = Unexpect(GetIt);
+    }
+  }
+  if (Res) {
+    Res = execute(StackMgr, Cont.PC, Func.getInstrs().end());
+  }
+
+  if (Stat) {
+    // Give back the gas reserved by this slice.
+    flushGas();
+    if (Conf.getStatisticsConfigure().isTimeMeasuring()) {
+      Stat->stopRecordWasm();
+    }
+  }
+
+  if (!Res && Res.error() == ErrCode::Value::Suspended) {
+    Cont.PC = Preemption.ResumePC;
+    Cont.PendingHost = Preemption.ResumeHost;
+    Cont.St = Continuation::Status::Suspended;
+    ++Cont.SuspendCount;
+    return false;
+  }
+
+  // If Statistics is enabled, then dump it here.
+  if (Stat) {
+    Stat->dumpToLog(Conf);
+  }
+  if (!Res) {
+    Cont.St = Continuation::Status::Failed;
+    consumeSuspendRequest(Cont);
+    StackMgr.reset();
+    return Unexpect(Res);
+  }
+
+  // Get return values.
+  const auto &RTypes = Func.getFuncType().getReturnTypes();
+  Cont.Returns.resize(RTypes.size());
+  for (uint32_t I = 0; I < RTypes.size(); ++I) {
+    Cont.Returns[RTypes.size() - I - 1] =
+        std::make_pair(StackMgr.pop(), RTypes[RTypes.size() - I - 1]);
+  }
+  assuming(StackMgr.size() == 0);
+  Cont.St = Continuation::Status::Returned;
+  consumeSuspendRequest(Cont);
+  return true;
+}
+
+/// Request a suspension. See "include/executor/executor.h".
+bool Executor::requestSuspend(Continuation &Cont) noexcept {
+  // Count the request before publishing it, so that the count never drops
+  // below the published requests.
+  PendingSuspends.fetch_add(1);
+  Deadline.store(0, std::memory_order_relaxed);
+  if (Cont.SuspendRequested.exchange(true) &&
+      PendingSuspends.fetch_sub(1) == 1) {
+    // Already requested and consumed in the meantime.
+    restoreDeadline();
+  }
+  if (!Cont.isResumable()) {
+    // Finished before seeing the request.
+    consumeSuspendRequest(Cont);
+    return false;
+  }
+  return true;
+}
+
 } // namespace Executor
 } // namespace WasmEdge
@@ -6,7 +6,9 @@
 #include "common/log.h"
 #include "system/fault.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <utility>
 #include <vector>
 
@@ -19,8 +21,11 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
                         const AST::InstrView::iterator RetIt, bool IsTailCall) {
   // RetIt: the return position when the entered function returns.
 
-  // Check if the interruption occurs.
-  if (unlikely(StopToken.exchange(0, std::memory_order_relaxed))) {
+  // Check if the interruption occurs. Only the entry of a native function can
+  // be a suspension point.
+  const auto Point =
+      checkSafePoint(&StackMgr, &Func, RetIt, nullptr, Func.isWasmFunction());
+  if (unlikely(Point == SafePoint::Interrupt)) {
     spdlog::error(ErrCode::Value::Interrupted);
     return Unexpect(ErrCode::Value::Interrupted);
   }
@@ -33,8 +38,6 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
 
   if (Func.isHostFunction()) {
     // Host function case: Push args and call function.
-    auto &HostFunc = Func.getHostFunc();
-
     // Generate CallingFrame from current frame.
     // The module instance will be nullptr if current frame is a dummy frame.
     // For this case, use the module instance of this host function.
@@ -52,37 +55,23 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
                        IsTailCall        // For tail-call
     );
 
-    // Do the statistics if the statistics turned on.
-    if (Stat) {
-      // Check host function cost.
-      if (unlikely(!Stat->addCost(HostFunc.getCost()))) {
-        spdlog::error(ErrCode::Value::CostLimitExceeded);
-        return Unexpect(ErrCode::Value::CostLimitExceeded);
-      }
-      // Start recording time of running host function.
-      Stat->stopRecordWasm();
-      Stat->startRecordHost();
-    }
-
     // Run host function.
     Span<ValVariant> Args = StackMgr.getTopSpan(ArgsN);
     std::vector<ValVariant> Rets(RetsN);
-    auto Ret = HostFunc.run(CallFrame, std::move(Args), Rets);
-
-    // Do the statistics if the statistics turned on.
-    if (Stat) {
-      // Stop recording time of running host function.
-      Stat->stopRecordHost();
-      Stat->startRecordWasm();
-    }
-
-    // Check the host function execution status.
-    if (!Ret) {
-      if (Ret.error() == ErrCode::Value::HostFuncError ||
-          Ret.error().getCategory() != ErrCategory::WASM) {
-        spdlog::error(Ret.error());
+    if (auto Res = runHostFunction(CallFrame, Func, Args, Rets);
+        unlikely(!Res)) {
+      if (Res.error() == ErrCode::Value::Suspended) {
+        if (IsTailCall || !Preemption.Suspendable) {
+          // The caller frame is gone or not owned by a continuation.
+          spdlog::error(ErrCode::Value::Suspended);
+          return Unexpect(ErrCode::Value::HostFuncError);
+        }
+        // Leave the arguments on the stack to call the host function again.
+        StackMgr.discardFrame();
+        Preemption.ResumePC = RetIt;
+        Preemption.ResumeHost = &Func;
       }
-      return Unexpect(Ret);
+      return Unexpect(Res);
     }
 
     // Push returns back to stack.
@@ -109,23 +98,16 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
     Span<ValVariant> Args = StackMgr.getTopSpan(ArgsN);
     std::vector<ValVariant> Rets(RetsN);
 
-    {
-      // Prepare the execution context.
-      CurrentStack = &StackMgr;
-      auto *ModInst =
-          const_cast<Runtime::Instance::ModuleInstance *>(Func.getModule());
-      for (uint32_t I = 0; I < ModInst->getMemoryNum(); ++I) {
-        // Update the memory pointers to prevent from the address change due to
-        // the page growing.
-        auto MemoryPtr = reinterpret_cast<std::atomic<uint8_t *> *>(
-            &(ModInst->MemoryPtrs[I]));
-        uint8_t *const DataPtr = (*(ModInst->getMemory(I)))->getDataPtr();
-        std::atomic_store_explicit(MemoryPtr, DataPtr,
-                                   std::memory_order_relaxed);
-      }
-      ExecutionContext.Memories = ModInst->MemoryPtrs.data();
-      ExecutionContext.Globals = ModInst->GlobalPtrs.data();
-    }
+    // Prepare the execution context. The context of the caller will be
+    // restored when leaving this scope, so that the compiled caller which
+    // calls back into the runtime keeps its own memories and globals.
+    auto *ModInst =
+        const_cast<Runtime::Instance::ModuleInstance *>(Func.getModule());
+    refreshMemoryPtrs(*ModInst);
+    SavedExecutionContext Saved(StackMgr, ModInst->MemoryPtrs.data(),
+                                ModInst->GlobalPtrs.data());
+    // The compiled code cannot be suspended in the middle.
+    SavedSuspendable NoSuspend;
 
     {
       // Get symbol and execute the function.
@@ -139,7 +121,7 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
         return Unexpect(Err);
       }
       auto &Wrapper = FuncType.getSymbol();
-      Wrapper(&ExecutionContext, Func.getSymbol().get(), Args.data(),
+      Wrapper(&ExecutionContext, Func.getCompiledEntry(), Args.data(),
               Rets.data());
     }
 
@@ -171,28 +153,302 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
                        IsTailCall                  // For tail-call
     );
 
+    if (unlikely(PGOProf.load(std::memory_order_relaxed))) {
+      countPGOEntry(Func);
+    }
+
+    if (unlikely(Point == SafePoint::Suspend)) {
+      // Suspend with the frame entered and resume from the function body.
+      Preemption.ResumePC = Func.getInstrs().begin();
+      return Unexpect(ErrCode::Value::Suspended);
+    }
+
     // For native function case, the continuation will be the start of the
     // function body.
     return Func.getInstrs().begin();
   }
 }
 
+Expect<void>
+Executor::runHostFunction(const Runtime::CallingFrame &CallFrame,
+                          const Runtime::Instance::FunctionInstance &Func,
+                          Span<const ValVariant> Args, Span<ValVariant> Rets) {
+  auto &HostFunc = Func.getHostFunc();
+
+  // Do the statistics if the statistics turned on.
+  if (Stat) {
+    // Give back the gas reserved by the caller before the host function
+    // boundary, so that the total cost is exact for the host function.
+    flushGas();
+    // Check host function cost.
+    if (unlikely(!Stat->addCost(HostFunc.getCost()))) {
+      spdlog::error(ErrCode::Value::CostLimitExceeded);
+      return Unexpect(ErrCode::Value::CostLimitExceeded);
+    }
+    // Start recording time of running host function.
+    Stat->stopRecordWasm();
+    Stat->startRecordHost();
+  }
+
+  // Run host function. The host function cannot be suspended in the middle.
+  auto Ret = [&]() {
+    SavedSuspendable NoSuspend;
+    return HostFunc.run(CallFrame, Args, Rets);
+  }();
+
+  // Do the statistics if the statistics turned on.
+  if (Stat) {
+    // Stop recording time of running host function.
+    Stat->stopRecordHost();
+    Stat->startRecordWasm();
+  }
+
+  // Check the host function execution status.
+  if (!Ret) {
+    if (Ret.error() == ErrCode::Value::HostFuncError ||
+        Ret.error().getCategory() != ErrCategory::WASM) {
+      spdlog::error(Ret.error());
+    }
+    return Unexpect(Ret);
+  }
+  return {};
+}
+
+void Executor::resetGasBudget() noexcept {
+  ExecutionContext.GasLimit = kGasWindowEnd;
+  ThreadGas = GasBase = kGasWindowEnd;
+  Preemption.GasLimit = kGasWindowEnd;
+}
+
+void Executor::flushGas() noexcept {
+  if (Preemption.Fuel != UINT64_MAX) {
+    Preemption.Fuel -= std::min(Preemption.Fuel, ThreadGas - GasBase);
+  }
+  if (const uint64_t Unused = ExecutionContext.GasLimit - ThreadGas) {
+    Stat->getTotalCostRef().fetch_sub(Unused, std::memory_order_relaxed);
+  }
+  resetGasBudget();
+}
+
+bool Executor::chargeGasSlow(uint64_t Cost) noexcept {
+  if (Cost > ExecutionContext.GasLimit - ThreadGas) {
+    // The reservation is used up. Give back the rest and reserve a new chunk
+    // which covers the cost, or the remaining budget if less.
+    flushGas();
+    const uint64_t Limit = Stat->getCostLimit();
+    auto &Total = Stat->getTotalCostRef();
+    uint64_t Old = Total.load(std::memory_order_relaxed);
+    uint64_t Size;
+    do {
+      const uint64_t Remain = Limit - std::min(Limit, Old);
+      if (unlikely(Remain < Cost)) {
+        spdlog::error("Cost exceeded limit. Force terminate the execution.");
+        return false;
+      }
+      Size = std::min(Remain, std::max(Cost, kGasChunk));
+    } while (!Total.compare_exchange_weak(Old, Old + Size,
+                                          std::memory_order_relaxed));
+    // Place the reservation at the end of the window, so that the gas limit
+    // read by compiled functions stays valid.
+    ThreadGas = GasBase = kGasWindowEnd - Size;
+    Preemption.GasLimit =
+        GasBase + std::min(Preemption.Fuel, kGasWindowEnd - GasBase);
+  }
+  if (Cost > Preemption.GasLimit - ThreadGas) {
+    // The fuel of the slice is used up. Suspend at the next safe point.
+    Preemption.Requested = true;
+    Preemption.Deadline = 0;
+    Preemption.Fuel = UINT64_MAX;
+    Preemption.GasLimit = ExecutionContext.GasLimit;
+  }
+  ThreadGas += Cost;
+  return true;
+}
+
+Executor::SafePoint
+Executor::handleDeadline(Runtime::StackManager *StackMgr,
+                         const Runtime::Instance::FunctionInstance *Func,
+                         AST::InstrView::iterator PC, const void *FrameAddress,
+                         bool CanSuspend) noexcept {
+  if (SampleRequested.exchange(false, std::memory_order_relaxed)) {
+    restoreDeadline();
+    if (Prof && StackMgr) {
+      Prof->addSample(*StackMgr, Func, PC, FrameAddress, CompiledStackEnd);
+    }
+  }
+  const uint64_t Now = Epoch::current();
+  if (unlikely(Now >= Timeout.load(std::memory_order_relaxed))) {
+    clearTimeout();
+    return SafePoint::Interrupt;
+  }
+  // The slice of the continuation is used up. Keep the request until reaching
+  // a safe point which can suspend.
+  if (Now >= Preemption.Deadline ||
+      (Preemption.Current && Preemption.Current->SuspendRequested.load())) {
+    Preemption.Requested = true;
+  }
+  if (Preemption.Requested && CanSuspend && Preemption.Suspendable) {
+    Preemption.Requested = false;
+    Preemption.Deadline = Epoch::kNever;
+    consumeSuspendRequest(*Preemption.Current);
+    return SafePoint::Suspend;
+  }
+  return SafePoint::Continue;
+}
+
 Expect<void> Executor::branchToLabel(Runtime::StackManager &StackMgr,
                                      uint32_t EraseBegin, uint32_t EraseEnd,
                                      int32_t PCOffset,
                                      AST::InstrView::iterator &PC) noexcept {
-  // Check stop token
-  if (unlikely(StopToken.exchange(0, std::memory_order_relaxed))) {
-    spdlog::error(ErrCode::Value::Interrupted);
-    return Unexpect(ErrCode::Value::Interrupted);
+  // Check the deadline at loop back-edges.
+  auto Point = SafePoint::Continue;
+  if (PCOffset < 0) {
+    Point = checkSafePoint(&StackMgr, nullptr, PC, nullptr, true);
+    if (unlikely(Point == SafePoint::Interrupt)) {
+      spdlog::error(ErrCode::Value::Interrupted);
+      return Unexpect(ErrCode::Value::Interrupted);
+    }
   }
 
   StackMgr.stackErase(EraseBegin, EraseEnd);
   // PC need to -1 here because the PC will increase in the next iteration.
   PC += (PCOffset - 1);
+  if (unlikely(Point == SafePoint::Suspend)) {
+    // Suspend with the branch taken and resume from the loop.
+    Preemption.ResumePC = PC + 1;
+    return Unexpect(ErrCode::Value::Suspended);
+  }
   return {};
 }
 
+void Executor::refreshMemoryPtrs(
+    Runtime::Instance::ModuleInstance &ModInst) noexcept {
+  for (uint32_t I = 0; I < ModInst.getMemoryNum(); ++I) {
+    // Update the memory pointers to prevent from the address change due to
+    // the page growing.
+    auto MemoryPtr =
+        reinterpret_cast<std::atomic<uint8_t *> *>(&(ModInst.MemoryPtrs[I]));
+    uint8_t *const DataPtr = (*(ModInst.getMemory(I)))->getDataPtr();
+    std::atomic_store_explicit(MemoryPtr, DataPtr, std::memory_order_relaxed);
+  }
+}
+
+void PGOCounters::add(Span<const Slot> Slots, Span<std::atomic_uint64_t> Counts,
+                      const void *Key, uint32_t Target) noexcept {
+  const auto It = std::lower_bound(
+      Slots.begin(), Slots.end(), Key, [](const Slot &S, const void *K) {
+        return std::less<const void *>()(S.Key, K);
+      });
+  if (It != Slots.end() && It->Key == Key && Target < It->Num) {
+    Counts[It->Begin + Target].fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void Executor::setPGOProfile(PGO::Profile *P) {
+  std::unique_lock Lock(PGOMutex);
+  // Stop counting into the tables before adding their counts.
+  PGOGeneration.fetch_add(1, std::memory_order_relaxed);
+  if (auto *Old = PGOProf.exchange(P, std::memory_order_acq_rel)) {
+    std::vector<uint64_t> Counts;
+    for (const auto &Table : PGOTables) {
+      for (const auto &Func : Table->Funcs) {
+        if (const auto Count = Table->Counts[Func.Begin].exchange(
+                0, std::memory_order_relaxed)) {
+          Old->addEntry(Func.Id, Count);
+        }
+      }
+      for (const auto &Branch : Table->Branches) {
+        Counts.resize(Branch.Num);
+        bool Reached = false;
+        for (uint32_t I = 0; I < Branch.Num; ++I) {
+          Counts[I] = Table->Counts[Branch.Begin + I].exchange(
+              0, std::memory_order_relaxed);
+          Reached = Reached || Counts[I] != 0;
+        }
+        for (uint32_t I = 0; Reached && I < Branch.Num; ++I) {
+          Old->addBranch(Branch.Id, I, Branch.Num, Counts[I]);
+        }
+      }
+    }
+  }
+  PGOTables.clear();
+}
+
+void Executor::registerPGOModule(Runtime::Instance::ModuleInstance &ModInst) {
+  auto Table = std::make_shared<PGOCounters>();
+  Table->Generation = PGOGeneration.load(std::memory_order_relaxed);
+  uint32_t Total = 0;
+  // The imported functions are counted by the modules defining them.
+  for (uint32_t I = 0; I < ModInst.getFuncNum(); ++I) {
+    const auto *Func = ModInst.unsafeGetFunction(I);
+    if (Func->getModule() != &ModInst || !Func->isWasmFunction()) {
+      continue;
+    }
+    const auto Instrs = Func->getInstrs();
+    Table->Funcs.push_back({Instrs.data(), I, Total, 1});
+    ++Total;
+    for (const auto &Instr : Instrs) {
+      uint32_t Num = 0;
+      switch (Instr.getOpCode()) {
+      case OpCode::If:
+      case OpCode::Br_if:
+        Num = 2;
+        break;
+      case OpCode::Br_table:
+        Num = static_cast<uint32_t>(Instr.getLabelList().size());
+        break;
+      default:
+        continue;
+      }
+      Table->Branches.push_back({&Instr, Instr.getOffset(), Total, Num});
+      Total += Num;
+    }
+  }
+  const auto Less = [](const PGOCounters::Slot &L,
+                       const PGOCounters::Slot &R) {
+    return std::less<const void *>()(L.Key, R.Key);
+  };
+  std::sort(Table->Funcs.begin(), Table->Funcs.end(), Less);
+  std::sort(Table->Branches.begin(), Table->Branches.end(), Less);
+  Table->Counts = std::vector<std::atomic_uint64_t>(Total);
+
+  std::unique_lock Lock(PGOMutex);
+  if (!PGOProf.load(std::memory_order_relaxed) ||
+      Table->Generation != PGOGeneration.load(std::memory_order_relaxed)) {
+    // The profile is detached or replaced meanwhile.
+    return;
+  }
+  ModInst.PGOCounters = Table;
+  PGOTables.push_back(std::move(Table));
+}
+
+void Executor::countPGOEntry(
+    const Runtime::Instance::FunctionInstance &Func) noexcept {
+  const auto *ModInst = Func.getModule();
+  if (!ModInst) {
+    return;
+  }
+  auto *Table = ModInst->PGOCounters.get();
+  if (Table && Table->Generation ==
+                   PGOGeneration.load(std::memory_order_relaxed)) {
+    PGOCounters::add(Table->Funcs, Table->Counts, Func.getInstrs().data(), 0);
+  }
+}
+
+void Executor::countPGOBranch(const Runtime::StackManager &StackMgr,
+                              const AST::Instruction &Instr,
+                              uint32_t Target) noexcept {
+  const auto *ModInst = StackMgr.getModule();
+  if (!ModInst) {
+    return;
+  }
+  auto *Table = ModInst->PGOCounters.get();
+  if (Table && Table->Generation ==
+                   PGOGeneration.load(std::memory_order_relaxed)) {
+    PGOCounters::add(Table->Branches, Table->Counts, &Instr, Target);
+  }
+}
+
 Runtime::Instance::TableInstance *
 Executor::getTabInstByIdx(Runtime::StackManager &StackMgr,
                           const uint32_t Idx) const {
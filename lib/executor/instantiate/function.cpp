@@ -31,6 +31,12 @@ Expect<void> Executor::instantiate(Runtime::Instance::ModuleInstance &ModInst,
       auto Symbol = CodeSegs[I].getSymbol();
       ModInst.addFunc(*FuncType, std::move(Symbol));
     }
+  } else if (ModInst.getSourceModule()) {
+    // Refer to the code segments of the shared module without copying.
+    for (uint32_t I = 0; I < CodeSegs.size(); ++I) {
+      auto *FuncType = *ModInst.getFuncType(TypeIdxs[I]);
+      ModInst.addFunc(*FuncType, CodeSegs[I]);
+    }
   } else {
     // Iterate through the code segments to instantiate function instances.
     for (uint32_t I = 0; I < CodeSegs.size(); ++I) {
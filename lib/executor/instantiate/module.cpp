@@ -15,7 +15,8 @@ namespace Executor {
 // Instantiate module instance. See "include/executor/Executor.h".
 Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
 Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
-                      std::optional<std::string_view> Name) {
+                      std::optional<std::string_view> Name,
+                      std::shared_ptr<const AST::Module> SharedMod) {
   // Check the module is validated.
   if (unlikely(!Mod.getIsValidated())) {
     spdlog::error(ErrCode::Value::NotValidated);
@@ -45,9 +46,17 @@ Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
   }
 
   // Instantiate Function Types in Module Instance. (TypeSec)
-  for (auto &FuncType : Mod.getTypeSection().getContent()) {
-    // Copy param and return lists to module instance.
-    ModInst->addFuncType(FuncType);
+  if (SharedMod) {
+    // The module instance keeps the shared module alive and refers to it.
+    ModInst->setSourceModule(std::move(SharedMod));
+    for (auto &FuncType : Mod.getTypeSection().getContent()) {
+      ModInst->addSharedFuncType(FuncType);
+    }
+  } else {
+    for (auto &FuncType : Mod.getTypeSection().getContent()) {
+      // Copy param and return lists to module instance.
+      ModInst->addFuncType(FuncType);
+    }
   }
 
   // Instantiate ImportSection and do import matching. (ImportSec)
@@ -142,6 +151,17 @@ Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
     return Unexpect(Res);
   }
 
+  // Register the functions for naming the profiling samples.
+  if (Prof) {
+    Prof->registerModule(*ModInst, &Mod);
+  }
+
+  // Register the functions of the active module for the execution profile.
+  if (unlikely(PGOProf.load(std::memory_order_relaxed)) &&
+      !Name.has_value()) {
+    registerPGOModule(*ModInst);
+  }
+
   // Instantiate StartSection (StartSec)
   const AST::StartSection &StartSec = Mod.getStartSection();
   if (StartSec.getContent()) {
@@ -0,0 +1,384 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "executor/profiler.h"
+
+#include <algorithm>
+#include <string_view>
+#include <utility>
+
+namespace WasmEdge {
+namespace Executor {
+
+namespace {
+
+/// Maximum depth of the walked compiled frames.
+inline constexpr const uint32_t kMaxFrameWalkDepth = 1024;
+
+/// Minimal protocol buffer encoder for the pprof output.
+class ProtoWriter {
+public:
+  void writeVarint(uint64_t Value) {
+    while (Value >= 0x80U) {
+      Buffer.push_back(static_cast<char>((Value & 0x7FU) | 0x80U));
+      Value >>= 7;
+    }
+    Buffer.push_back(static_cast<char>(Value));
+  }
+  void writeUInt(uint32_t Field, uint64_t Value) {
+    writeVarint(static_cast<uint64_t>(Field) << 3);
+    writeVarint(Value);
+  }
+  void writeBytes(uint32_t Field, std::string_view Bytes) {
+    writeVarint((static_cast<uint64_t>(Field) << 3) | 2U);
+    writeVarint(Bytes.size());
+    Buffer.append(Bytes);
+  }
+  void writePacked(uint32_t Field, Span<const uint64_t> Values) {
+    ProtoWriter Packed;
+    for (const auto Value : Values) {
+      Packed.writeVarint(Value);
+    }
+    writeBytes(Field, Packed.str());
+  }
+  const std::string &str() const noexcept { return Buffer; }
+
+private:
+  std::string Buffer;
+};
+
+/// Add the range [Begin, End) of a function into the ranges keyed by the range
+/// end, and drop the stale ranges of the released modules overlapping it.
+template <typename T>
+void addRange(
+    std::map<T, std::pair<T, const Runtime::Instance::FunctionInstance *>>
+        &Ranges,
+    T Begin, T End, const Runtime::Instance::FunctionInstance *Func) {
+  auto It = Ranges.upper_bound(Begin);
+  while (It != Ranges.end() && It->second.first < End) {
+    It = Ranges.erase(It);
+  }
+  Ranges.emplace(End, std::make_pair(Begin, Func));
+}
+
+} // namespace
+
+void Profiler::start(std::function<void()> Request) {
+  stop();
+  std::unique_lock Lock(Mutex);
+  Done = false;
+  Thread = std::thread([this, Request = std::move(Request)]() {
+    const auto Start = std::chrono::steady_clock::now();
+    std::unique_lock Lock(Mutex);
+    while (!Cond.wait_for(Lock, Interval, [this]() { return Done; })) {
+      Lock.unlock();
+      Request();
+      Lock.lock();
+    }
+    Duration += std::chrono::steady_clock::now() - Start;
+  });
+}
+
+void Profiler::stop() noexcept {
+  {
+    std::unique_lock Lock(Mutex);
+    if (!Thread.joinable()) {
+      return;
+    }
+    Done = true;
+  }
+  Cond.notify_all();
+  Thread.join();
+}
+
+void Profiler::registerModule(const Runtime::Instance::ModuleInstance &ModInst,
+                              const AST::Module *Mod) {
+  std::map<uint32_t, std::string> FuncNames;
+  if (Mod) {
+    FuncNames = Mod->getFunctionNames();
+  }
+  ModInst.getFuncExports([&](const auto &ExpFuncs) {
+    for (const auto &[Name, Func] : ExpFuncs) {
+      for (uint32_t I = 0; I < ModInst.getFuncNum(); ++I) {
+        if (ModInst.unsafeGetFunction(I) == Func) {
+          FuncNames.try_emplace(I, Name);
+        }
+      }
+    }
+  });
+
+  std::unique_lock Lock(Mutex);
+  for (uint32_t I = 0; I < ModInst.getFuncNum(); ++I) {
+    const auto *Func = ModInst.unsafeGetFunction(I);
+    if (Func->getModule() != &ModInst) {
+      // Imported functions are named by their own modules.
+      continue;
+    }
+    std::string Name;
+    if (!ModInst.getModuleName().empty()) {
+      Name.append(ModInst.getModuleName()).push_back('.');
+    }
+    if (auto It = FuncNames.find(I); It != FuncNames.end()) {
+      Name.append(It->second);
+    } else {
+      Name.append("func[").append(std::to_string(I)).push_back(']');
+    }
+    FuncIds[Func] = addName(std::move(Name));
+
+    if (Func->isWasmFunction()) {
+      const auto Instrs = Func->getInstrs();
+      addRange(InstrRanges, Instrs.data(), Instrs.data() + Instrs.size(),
+               Func);
+    }
+  }
+
+  if (Mod == nullptr || Mod->getTexts().empty()) {
+    // The compiled frames cannot be bounded without the text sections, so
+    // the frame walks end at them.
+    return;
+  }
+  // The code sizes are not recorded, so every code ends at the next code or
+  // at the end of its text section.
+  std::vector<uintptr_t> Bounds;
+  for (const auto &Code : Mod->getCodeSection().getContent()) {
+    Bounds.push_back(reinterpret_cast<uintptr_t>(Code.getSymbol().get()));
+  }
+  for (const auto &Type : Mod->getTypeSection().getContent()) {
+    Bounds.push_back(reinterpret_cast<uintptr_t>(Type.getSymbol().get()));
+  }
+  for (const auto &[Text, Size] : Mod->getTexts()) {
+    Bounds.push_back(reinterpret_cast<uintptr_t>(Text + Size));
+  }
+  std::sort(Bounds.begin(), Bounds.end());
+  auto addCode = [&](uintptr_t Begin,
+                     const Runtime::Instance::FunctionInstance *Func) {
+    for (const auto &[Text, Size] : Mod->getTexts()) {
+      const auto TextBegin = reinterpret_cast<uintptr_t>(Text);
+      if (TextBegin <= Begin && Begin - TextBegin < Size) {
+        addRange(CodeRanges, Begin,
+                 *std::upper_bound(Bounds.begin(), Bounds.end(), Begin), Func);
+        return;
+      }
+    }
+  };
+  for (uint32_t I = 0; I < ModInst.getFuncNum(); ++I) {
+    const auto *Func = ModInst.unsafeGetFunction(I);
+    if (Func->getModule() == &ModInst && Func->isCompiledFunction()) {
+      addCode(reinterpret_cast<uintptr_t>(Func->getSymbol().get()), Func);
+    }
+  }
+  for (const auto &Type : Mod->getTypeSection().getContent()) {
+    if (const auto &Wrapper = Type.getSymbol()) {
+      addCode(reinterpret_cast<uintptr_t>(Wrapper.get()), nullptr);
+    }
+  }
+}
+
+void Profiler::addSample(const Runtime::StackManager &StackMgr,
+                         const Runtime::Instance::FunctionInstance *Func,
+                         AST::InstrView::iterator PC,
+                         const void *FrameAddress, const void *StackEnd) {
+  std::unique_lock Lock(Mutex);
+  std::vector<uint32_t> Stack;
+  const Runtime::Instance::FunctionInstance *Callee = nullptr;
+  if (Func) {
+    Stack.push_back(getFunctionId(Func));
+    Callee = Func;
+  }
+  if (FrameAddress && StackEnd) {
+    // Walk the frame records of the compiled callers. A frame record holds the
+    // frame pointer of the caller and the return address into the caller. The
+    // walk ends at the wrapper which is called from the runtime, and stops
+    // early if the frame pointers leave the stack or do not grow, in case the
+    // chain is broken by code without frame pointers.
+    auto *FP = static_cast<void *const *>(FrameAddress);
+    const auto *End = static_cast<void *const *>(StackEnd);
+    for (uint32_t Depth = 0; Depth < kMaxFrameWalkDepth && FP < End - 1;
+         ++Depth) {
+      // The return address is after the call instruction, which may be the
+      // last instruction of the caller.
+      const auto *Caller =
+          findFunction(reinterpret_cast<uintptr_t>(FP[1]) - 1);
+      if (Caller == nullptr) {
+        break;
+      }
+      Stack.push_back(getFunctionId(Caller));
+      Callee = Caller;
+      auto *Next = static_cast<void *const *>(FP[0]);
+      if (Next <= FP) {
+        break;
+      }
+      FP = Next;
+    }
+  }
+  if (PC) {
+    if (const auto *Curr = findFunction(PC)) {
+      Stack.push_back(getFunctionId(Curr));
+      Callee = Curr;
+    }
+  }
+  // The return address of each frame points into its caller, except the
+  // frames entered from the runtime, which return to the last instruction of
+  // the callee itself.
+  const auto Frames = StackMgr.getFrames();
+  for (size_t I = Frames.size(); I-- > 1;) {
+    const auto *Caller = findFunction(Frames[I].From);
+    if (Caller == nullptr) {
+      continue;
+    }
+    if (Caller == Callee && Frames[I].From + 1 == Caller->getInstrs().end()) {
+      continue;
+    }
+    Stack.push_back(getFunctionId(Caller));
+    Callee = Caller;
+  }
+  if (!Stack.empty()) {
+    ++Samples[std::move(Stack)];
+  }
+}
+
+uint64_t Profiler::getSampleCount() const noexcept {
+  std::unique_lock Lock(Mutex);
+  uint64_t Count = 0;
+  for (const auto &Sample : Samples) {
+    Count += Sample.second;
+  }
+  return Count;
+}
+
+void Profiler::dumpFolded(std::ostream &OS) const {
+  std::unique_lock Lock(Mutex);
+  for (const auto &[Stack, Count] : Samples) {
+    for (auto It = Stack.rbegin(); It != Stack.rend(); ++It) {
+      if (It != Stack.rbegin()) {
+        OS << ';';
+      }
+      OS << Names[*It];
+    }
+    OS << ' ' << Count << '\n';
+  }
+}
+
+void Profiler::dumpPprof(std::ostream &OS) const {
+  // See https://github.com/google/pprof/blob/main/proto/profile.proto
+  std::unique_lock Lock(Mutex);
+  enum : uint64_t { kEmpty, kSamples, kCount, kCPU, kNanoseconds, kNameBase };
+  const auto Period = static_cast<uint64_t>(Interval.count());
+  ProtoWriter Profile;
+  auto writeValueType = [&Profile](uint32_t Field, uint64_t Type,
+                                   uint64_t Unit) {
+    ProtoWriter ValueType;
+    ValueType.writeUInt(1, Type);
+    ValueType.writeUInt(2, Unit);
+    Profile.writeBytes(Field, ValueType.str());
+  };
+
+  // Sample types.
+  writeValueType(1, kSamples, kCount);
+  writeValueType(1, kCPU, kNanoseconds);
+  // Samples. The location ids are the function ids plus one.
+  for (const auto &[Stack, Count] : Samples) {
+    std::vector<uint64_t> Locations(Stack.begin(), Stack.end());
+    for (auto &Location : Locations) {
+      ++Location;
+    }
+    const uint64_t Values[] = {Count, Count * Period};
+    ProtoWriter Sample;
+    Sample.writePacked(1, Locations);
+    Sample.writePacked(2, Values);
+    Profile.writeBytes(2, Sample.str());
+  }
+  // Locations and functions.
+  for (uint64_t I = 0; I < Names.size(); ++I) {
+    ProtoWriter Line;
+    Line.writeUInt(1, I + 1);
+    ProtoWriter Location;
+    Location.writeUInt(1, I + 1);
+    Location.writeBytes(4, Line.str());
+    Profile.writeBytes(4, Location.str());
+  }
+  for (uint64_t I = 0; I < Names.size(); ++I) {
+    ProtoWriter Function;
+    Function.writeUInt(1, I + 1);
+    Function.writeUInt(2, kNameBase + I);
+    Function.writeUInt(3, kNameBase + I);
+    Profile.writeBytes(5, Function.str());
+  }
+  // String table.
+  for (std::string_view Str : {"", "samples", "count", "cpu", "nanoseconds"}) {
+    Profile.writeBytes(6, Str);
+  }
+  for (const auto &Name : Names) {
+    Profile.writeBytes(6, Name);
+  }
+  // Duration, period type, and period.
+  Profile.writeUInt(
+      10, static_cast<uint64_t>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(Duration)
+                  .count()));
+  writeValueType(11, kCPU, kNanoseconds);
+  Profile.writeUInt(12, Period);
+
+  OS.write(Profile.str().data(),
+           static_cast<std::streamsize>(Profile.str().size()));
+}
+
+const Runtime::Instance::FunctionInstance *
+Profiler::findFunction(const AST::Instruction *Instr) const noexcept {
+  if (Instr == nullptr) {
+    return nullptr;
+  }
+  if (auto It = InstrRanges.upper_bound(Instr);
+      It != InstrRanges.end() && It->second.first <= Instr) {
+    return It->second.second;
+  }
+  return nullptr;
+}
+
+const Runtime::Instance::FunctionInstance *
+Profiler::findFunction(uintptr_t Address) const noexcept {
+  if (auto It = CodeRanges.upper_bound(Address);
+      It != CodeRanges.end() && It->second.first <= Address) {
+    return It->second.second;
+  }
+  return nullptr;
+}
+
+uint32_t
+Profiler::getFunctionId(const Runtime::Instance::FunctionInstance *Func) {
+  if (auto It = FuncIds.find(Func); It != FuncIds.end()) {
+    return It->second;
+  }
+  // Functions of the modules not instantiated by the executor, such as the
+  // host functions, are named by their exported names.
+  std::string Name;
+  if (const auto *ModInst = Func->getModule()) {
+    Name.append(ModInst->getModuleName()).push_back('.');
+    ModInst->getFuncExports([&](const auto &ExpFuncs) {
+      for (const auto &[ExpName, ExpFunc] : ExpFuncs) {
+        if (ExpFunc == Func) {
+          Name.append(ExpName);
+          return;
+        }
+      }
+      Name.append("<unknown>");
+    });
+  } else {
+    Name = "<unknown>";
+  }
+  const uint32_t Id = addName(std::move(Name));
+  FuncIds.emplace(Func, Id);
+  return Id;
+}
+
+uint32_t Profiler::addName(std::string Name) {
+  auto [It, Added] =
+      NameIds.try_emplace(std::move(Name), static_cast<uint32_t>(Names.size()));
+  if (Added) {
+    Names.push_back(It->first);
+  }
+  return It->second;
+}
+
+} // namespace Executor
+} // namespace WasmEdge
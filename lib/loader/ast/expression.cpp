@@ -14,6 +14,8 @@ Expect<void> Loader::loadExpression(AST::Expression &Expr,
   if (auto Res = loadInstrSeq(SizeBound)) {
     // For the section size mismatch case, check in caller.
     Expr.getInstrs() = std::move(*Res);
+    // Keep a spare slot. See "include/ast/expression.h".
+    Expr.getInstrs().reserve(Expr.getInstrs().size() + 1);
   } else {
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
     return Unexpect(Res);
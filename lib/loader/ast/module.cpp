@@ -3,6 +3,10 @@
 
 #include "loader/loader.h"
 
+#include "system/cpu.h"
+#include "system/perfmap.h"
+
+#include <algorithm>
 #include <bitset>
 #include <cstddef>
 #include <cstdint>
@@ -41,6 +45,7 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
   }
 
   // Find and Read the AOT custom section first. Jump the others.
+  bool HasUnsupportedAOTSection = false;
   while (true && !IsSharedLibraryWASM) {
     // This loop only overview the custom sections and read the AOT section.
     // For the other general errors, break and handle in the sequencially
@@ -78,23 +83,32 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
 
       if (Name == "wasmedge") {
         // Found the AOT section in universal WASM. Load the AOT code.
-        // Read the content.
-        std::vector<uint8_t> Content;
-        if (auto Res = FMgr.readBytes(ContentSize - ReadSize)) {
-          Content = std::move(*Res);
-        } else {
-          break;
-        }
-
-        // Load the AOT section.
-        FileMgr VecMgr;
+        // The section is parsed in place without copying it out, so that the
+        // text sections can be mapped from the file.
         AST::AOTSection NewAOTSection;
-        VecMgr.setCode(Content);
-        if (auto Res = loadSection(VecMgr, NewAOTSection)) {
-          // Also handle the duplicated AOT sections case.
-          // If the new AOT section discovered, use the new one.
-          IsUniversalWASM = true;
-          Mod->getAOTSection() = std::move(NewAOTSection);
+        auto Res = loadSection(FMgr, NewAOTSection);
+        if (Res && unlikely(NewAOTSection.getImageOffset() +
+                                NewAOTSection.getImageSize() >
+                            StartOffset + ContentSize)) {
+          spdlog::error(ErrCode::Value::MalformedSection);
+          spdlog::error("    AOT image out of the section.");
+          Res = Unexpect(ErrCode::Value::MalformedSection);
+        }
+        FMgr.seek(StartOffset + ContentSize);
+        if (Res) {
+          // The AOT sections are the code variants for different CPUs. Skip
+          // the ones needing the features not on the host, and use the one
+          // with the most features. For the same features, use the new one.
+          const std::bitset<64> Features(NewAOTSection.getCPUFeatures());
+          if ((Features.to_ullong() & ~CPU::hostFeatures()) != 0) {
+            HasUnsupportedAOTSection = true;
+          } else if (!IsUniversalWASM ||
+                     Features.count() >=
+                         std::bitset<64>(Mod->getAOTSection().getCPUFeatures())
+                             .count()) {
+            IsUniversalWASM = true;
+            Mod->getAOTSection() = std::move(NewAOTSection);
+          }
         } else {
           // If the new AOT section load failed, use the old one or the
           // interpreter mode.
@@ -117,6 +131,10 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
       }
     }
   }
+  if (!IsUniversalWASM && HasUnsupportedAOTSection) {
+    spdlog::info("    AOT code not compiled for this CPU. Use interpreter mode "
+                 "instead.");
+  }
 
   // Seek to the position after the binary header.
   FMgr.seek(8);
@@ -154,6 +172,15 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
         spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
         return Unexpect(Res);
       }
+      if (Mod->getCustomSections().back().getName() == "name") {
+        // The name section is only for diagnostics. Ignore it if malformed.
+        FileMgr VecMgr;
+        AST::NameSection NewNameSection;
+        VecMgr.setCode(Mod->getCustomSections().back().getContent());
+        if (loadSection(VecMgr, NewNameSection)) {
+          Mod->getNameSection() = std::move(NewNameSection);
+        }
+      }
       break;
     case 0x01:
       if (auto Res = loadSection(Mod->getTypeSection()); !Res) {
@@ -273,50 +300,9 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
 
   // Load library from AOT Section for the universal WASM case.
   if (IsUniversalWASM) {
-    auto Library = std::make_shared<SharedLibrary>();
-    if (auto Res = Library->load(Mod->getAOTSection()); unlikely(!Res)) {
-      spdlog::error("    AOT section -- library load failed:{} , use "
-                    "interpreter mode instead.",
-                    Res.error());
-      IsUniversalWASM = false;
-    }
-
-    // Check the symbols.
-    auto FuncTypeSymbols = Library->getTypes<AST::FunctionType::Wrapper>();
-    auto CodeSymbols = Library->getCodes<void>();
-    auto IntrinsicsSymbol =
-        Library->getIntrinsics<const AST::Module::IntrinsicsTable *>();
-    auto &FuncTypes = Mod->getTypeSection().getContent();
-    auto &CodeSegs = Mod->getCodeSection().getContent();
-    if (IsUniversalWASM &&
-        unlikely(FuncTypeSymbols.size() != FuncTypes.size())) {
-      spdlog::error("    AOT section -- number of types not matching:{} {}, "
-                    "use interpreter mode instead.",
-                    FuncTypeSymbols.size(), FuncTypes.size());
+    if (auto Res = loadAOTSection(*Mod); unlikely(!Res)) {
+      spdlog::error("    AOT section -- use interpreter mode instead.");
       IsUniversalWASM = false;
-    }
-    if (IsUniversalWASM && unlikely(CodeSymbols.size() != CodeSegs.size())) {
-      spdlog::error("    AOT section -- number of codes not matching:{} {}, "
-                    "use interpreter mode instead.",
-                    CodeSymbols.size(), CodeSegs.size());
-      IsUniversalWASM = false;
-    }
-    if (IsUniversalWASM && unlikely(!IntrinsicsSymbol)) {
-      spdlog::error("    AOT section -- intrinsics table symbol not found, use "
-                    "interpreter mode instead.");
-      IsUniversalWASM = false;
-    }
-
-    // Set the symbols into the module.
-    if (IsUniversalWASM) {
-      for (size_t I = 0; I < FuncTypes.size(); ++I) {
-        FuncTypes[I].setSymbol(std::move(FuncTypeSymbols[I]));
-      }
-      for (size_t I = 0; I < CodeSegs.size(); ++I) {
-        CodeSegs[I].setSymbol(std::move(CodeSymbols[I]));
-      }
-      Mod->setSymbol(std::move(IntrinsicsSymbol));
-    } else {
       // Fallback to the interpreter mode case: Re-read the code section.
       FMgr.seek(Mod->getCodeSection().getStartOffset());
       if (auto Res = loadSection(Mod->getCodeSection()); !Res) {
@@ -329,6 +315,119 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
   return Mod;
 }
 
+// Load the code in the AOT section. See "include/loader/loader.h".
+Expect<void> Loader::loadAOTSection(AST::Module &Mod) {
+  std::lock_guard Lock(Mutex);
+  auto Library = std::make_shared<SharedLibrary>();
+  if (auto Res = Library->load(Mod.getAOTSection()); unlikely(!Res)) {
+    spdlog::error("    AOT section -- library load failed:{}", Res.error());
+    return Unexpect(Res);
+  }
+
+  // Check the symbols.
+  auto FuncTypeSymbols = Library->getTypes<AST::FunctionType::Wrapper>();
+  auto CodeSymbols = Library->getCodes<void>();
+  auto IntrinsicsSymbol =
+      Library->getIntrinsics<const AST::Module::IntrinsicsTable *>();
+  auto &FuncTypes = Mod.getTypeSection().getContent();
+  auto &CodeSegs = Mod.getCodeSection().getContent();
+  if (unlikely(FuncTypeSymbols.size() != FuncTypes.size())) {
+    spdlog::error("    AOT section -- number of types not matching:{} {}",
+                  FuncTypeSymbols.size(), FuncTypes.size());
+    return Unexpect(ErrCode::Value::MalformedSection);
+  }
+  if (unlikely(CodeSymbols.size() != CodeSegs.size())) {
+    spdlog::error("    AOT section -- number of codes not matching:{} {}",
+                  CodeSymbols.size(), CodeSegs.size());
+    return Unexpect(ErrCode::Value::MalformedSection);
+  }
+  if (unlikely(!IntrinsicsSymbol)) {
+    spdlog::error("    AOT section -- intrinsics table symbol not found");
+    return Unexpect(ErrCode::Value::MalformedSection);
+  }
+
+  // Set the symbols into the module.
+  for (size_t I = 0; I < FuncTypes.size(); ++I) {
+    FuncTypes[I].setSymbol(std::move(FuncTypeSymbols[I]));
+  }
+  for (size_t I = 0; I < CodeSegs.size(); ++I) {
+    CodeSegs[I].setSymbol(std::move(CodeSymbols[I]));
+  }
+  *IntrinsicsSymbol = IntrinsicsTable;
+  Mod.setSymbol(std::move(IntrinsicsSymbol));
+  Mod.setTexts(Library->getTexts());
+  if (Conf.getRuntimeConfigure().isPerfMap() ||
+      Conf.getRuntimeConfigure().isJitDump()) {
+    writePerfMap(Mod, *Library);
+  }
+  return {};
+}
+
+// Write the symbols of the AOT code in the universal WASM, which is loaded into
+// anonymous memory. See "include/loader/loader.h".
+void Loader::writePerfMap(const AST::Module &Mod,
+                          const SharedLibrary &Library) {
+  uint32_t ImportFuncNum = 0;
+  for (const auto &ImpDesc : Mod.getImportSection().getContent()) {
+    if (ImpDesc.getExternalType() == ExternalType::Function) {
+      ++ImportFuncNum;
+    }
+  }
+  const auto FuncNames = Mod.getFunctionNames();
+
+  std::vector<PerfMap::Entry> Entries;
+  const auto &CodeSegs = Mod.getCodeSection().getContent();
+  for (uint32_t I = 0; I < CodeSegs.size(); ++I) {
+    const uint32_t FuncIdx = I + ImportFuncNum;
+    std::string Name = "wasm:";
+    if (auto It = FuncNames.find(FuncIdx); It != FuncNames.end()) {
+      Name.append(It->second);
+    } else {
+      Name.append("func[").append(std::to_string(FuncIdx)).push_back(']');
+    }
+    Entries.push_back({CodeSegs[I].getSymbol().get(), 0, std::move(Name)});
+  }
+  const auto &FuncTypes = Mod.getTypeSection().getContent();
+  for (uint32_t I = 0; I < FuncTypes.size(); ++I) {
+    auto *Wrapper = FuncTypes[I].getSymbol().get();
+    Entries.push_back({reinterpret_cast<const void *>(Wrapper), 0,
+                       "wasm:wrapper[" + std::to_string(I) + "]"});
+  }
+
+  // The code sizes are not recorded, so every code ends at the next code or
+  // at the end of its text section.
+  std::sort(Entries.begin(), Entries.end(),
+            [](const PerfMap::Entry &LHS, const PerfMap::Entry &RHS) {
+              return LHS.Address < RHS.Address;
+            });
+  for (size_t I = 0; I < Entries.size(); ++I) {
+    const auto *Begin = static_cast<const uint8_t *>(Entries[I].Address);
+    for (const auto &[Text, Size] : Library.getTexts()) {
+      if (Text <= Begin && Begin < Text + Size) {
+        const uint8_t *End = Text + Size;
+        if (I + 1 < Entries.size()) {
+          End = std::min(
+              End, static_cast<const uint8_t *>(Entries[I + 1].Address));
+        }
+        Entries[I].Size = static_cast<uint64_t>(End - Begin);
+        break;
+      }
+    }
+  }
+  Entries.erase(std::remove_if(Entries.begin(), Entries.end(),
+                               [](const PerfMap::Entry &Entry) {
+                                 return Entry.Size == 0;
+                               }),
+                Entries.end());
+
+  if (Conf.getRuntimeConfigure().isPerfMap()) {
+    PerfMap::writePerfMap(Entries);
+  }
+  if (Conf.getRuntimeConfigure().isJitDump()) {
+    PerfMap::writeJitDump(Entries);
+  }
+}
+
 // Load compiled function from loadable manager. See "include/loader/loader.h".
 Expect<void> Loader::loadCompiled(AST::Module &Mod) {
   auto &FuncTypes = Mod.getTypeSection().getContent();
@@ -352,6 +451,7 @@ Expect<void> Loader::loadCompiled(AST::Module &Mod) {
       CodeSegs[I].setSymbol(std::move(Symbol));
     }
   }
+  Mod.setTexts(LMgr.getTexts());
   return {};
 }
 
@@ -42,6 +42,17 @@ Expect<void> Loader::loadSection(AST::CustomSection &Sec) {
       return logLoadError(ErrCode::Value::UnexpectedEnd, FMgr.getLastOffset(),
                           ASTNodeAttr::Sec_Custom);
     }
+    if (Sec.getName() == "wasmedge") {
+      // The AOT section is parsed in place by loadModule(). Skip the content
+      // instead of copying the code out.
+      if (unlikely(FMgr.getRemainSize() < Sec.getContentSize() - ReadSize)) {
+        return logLoadError(ErrCode::Value::UnexpectedEnd,
+                            FMgr.getOffset() + FMgr.getRemainSize(),
+                            ASTNodeAttr::Sec_Custom);
+      }
+      FMgr.seek(StartOffset + Sec.getContentSize());
+      return {};
+    }
     if (auto Res = FMgr.readBytes(Sec.getContentSize() - ReadSize)) {
       Sec.getContent().insert(Sec.getContent().end(), (*Res).begin(),
                               (*Res).end());
@@ -208,6 +219,8 @@ inline constexpr uint8_t HostArchType() noexcept {
 } // namespace
 
 Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
+  // The image offset is relative to the start of the AOT section.
+  const uint64_t Base = VecMgr.getOffset();
   if (auto Res = VecMgr.readU32(); unlikely(!Res)) {
     spdlog::error(Res.error());
     spdlog::error("    AOT binary version read error:{}", Res.error());
@@ -215,6 +228,7 @@ Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
   } else {
     Sec.setVersion(*Res);
   }
+  // Only the exact version is compatible. See "include/aot/version.h".
   if (unlikely(Sec.getVersion() != HostVersion())) {
     spdlog::error(ErrCode::Value::MalformedSection);
     spdlog::error("    AOT binary version unmatched.");
@@ -247,6 +261,16 @@ Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
     return Unexpect(ErrCode::Value::MalformedSection);
   }
 
+  // The CPU features are checked by the caller, which selects one of the
+  // code variants.
+  if (auto Res = VecMgr.readU64(); unlikely(!Res)) {
+    spdlog::error(Res.error());
+    spdlog::error("    AOT CPU features read error:{}", Res.error());
+    return Unexpect(Res);
+  } else {
+    Sec.setCPUFeatures(*Res);
+  }
+
   if (auto Res = VecMgr.readU64(); unlikely(!Res)) {
     spdlog::error(Res.error());
     spdlog::error("    AOT version address read error:{}", Res.error());
@@ -324,15 +348,54 @@ Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
     } else {
       std::get<2>(Section) = *Res;
     }
-    uint32_t ContentSize;
-    if (auto Res = VecMgr.readU32(); unlikely(!Res)) {
-      spdlog::error(Res.error());
-      spdlog::error("    AOT section data size read error:{}", Res.error());
-      return Unexpect(Res);
-    } else {
-      ContentSize = *Res;
+  }
+
+  // The section contents are placed in an image at their addresses. The image
+  // starts at a page boundary of the file, so that the text sections can be
+  // mapped from the file instead of being read.
+  if (auto Res = VecMgr.readU64(); unlikely(!Res)) {
+    spdlog::error(Res.error());
+    spdlog::error("    AOT image offset read error:{}", Res.error());
+    return Unexpect(Res);
+  } else {
+    Sec.setImageOffset(Base + *Res);
+  }
+  if (auto Res = VecMgr.readU64(); unlikely(!Res)) {
+    spdlog::error(Res.error());
+    spdlog::error("    AOT image size read error:{}", Res.error());
+    return Unexpect(Res);
+  } else {
+    Sec.setImageSize(*Res);
+  }
+  const uint64_t End = VecMgr.getOffset() + VecMgr.getRemainSize();
+  if (unlikely(Sec.getImageOffset() < VecMgr.getOffset() ||
+               Sec.getImageOffset() > End ||
+               Sec.getImageSize() > End - Sec.getImageOffset())) {
+    spdlog::error(ErrCode::Value::MalformedSection);
+    spdlog::error("    AOT image out of the section.");
+    return Unexpect(ErrCode::Value::MalformedSection);
+  }
+
+  const bool Mapped = VecMgr.getFileMap() != nullptr;
+  for (auto &Section : Sec.getSections()) {
+    const auto Kind = std::get<0>(Section);
+    const auto Offset = std::get<1>(Section);
+    const auto Size = std::get<2>(Section);
+    if (Kind == 3) {
+      // BSS has no content.
+      continue;
+    }
+    if (unlikely(Offset > Sec.getImageSize() ||
+                 Size > Sec.getImageSize() - Offset)) {
+      spdlog::error(ErrCode::Value::MalformedSection);
+      spdlog::error("    AOT section out of the image.");
+      return Unexpect(ErrCode::Value::MalformedSection);
+    }
+    if (Kind == 1 && Mapped) {
+      continue;
     }
-    if (auto Res = VecMgr.readBytes(ContentSize); unlikely(!Res)) {
+    VecMgr.seek(Sec.getImageOffset() + Offset);
+    if (auto Res = VecMgr.readBytes(Size); unlikely(!Res)) {
       spdlog::error(Res.error());
       spdlog::error("    AOT section data read error:{}", Res.error());
       return Unexpect(Res);
@@ -340,6 +403,58 @@ Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
       std::get<3>(Section) = std::move(*Res);
     }
   }
+  if (Mapped) {
+    Sec.setImageFile(VecMgr.getFileMap());
+  }
+  VecMgr.seek(Sec.getImageOffset() + Sec.getImageSize());
+  return {};
+}
+
+Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::NameSection &Sec) {
+  // Read the subsections until the end of the name section.
+  while (VecMgr.getRemainSize() > 0) {
+    uint8_t SubSectionId = 0x00;
+    if (auto Res = VecMgr.readByte()) {
+      SubSectionId = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+    if (SubSectionId != 0x01U) {
+      // Only the function names subsection is used. Jump the others.
+      if (auto Res = VecMgr.jumpContent(); unlikely(!Res)) {
+        return Unexpect(Res);
+      }
+      continue;
+    }
+
+    // Read the function names subsection, which is a name map.
+    uint64_t EndOffset = 0;
+    if (auto Res = VecMgr.readU32()) {
+      EndOffset = VecMgr.getOffset() + *Res;
+    } else {
+      return Unexpect(Res);
+    }
+    uint32_t VecCnt = 0;
+    if (auto Res = VecMgr.readU32()) {
+      VecCnt = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+    for (uint32_t I = 0; I < VecCnt; ++I) {
+      uint32_t FuncIdx = 0;
+      if (auto Res = VecMgr.readU32()) {
+        FuncIdx = *Res;
+      } else {
+        return Unexpect(Res);
+      }
+      if (auto Res = VecMgr.readName()) {
+        Sec.getFunctionNames().insert_or_assign(FuncIdx, std::move(*Res));
+      } else {
+        return Unexpect(Res);
+      }
+    }
+    VecMgr.seek(EndOffset);
+  }
   return {};
 }
 
@@ -21,9 +21,11 @@ Expect<void> FileMgr::setPath(const std::filesystem::path &FilePath) {
       Status = ErrCode::Value::IllegalPath;
       return Unexpect(Status);
     }
-    FileMap.emplace(FilePath);
+    FileMap = std::make_shared<MMap>(FilePath);
     if (auto *Pointer = FileMap->address(); likely(Pointer)) {
       Data = reinterpret_cast<const Byte *>(Pointer);
+      // Bound the reads by the mapped size in case the file has changed.
+      Size = FileMap->size();
       Status = ErrCode::Value::Success;
     } else {
       // File size is 0, mmap failed.
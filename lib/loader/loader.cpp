@@ -85,6 +85,7 @@ Loader::parseModule(const std::filesystem::path &FilePath) {
       return Unexpect(Res);
     }
     if (auto Res = LMgr.getVersion()) {
+      // Only the exact version is compatible. See "include/aot/version.h".
       if (*Res != AOT::kBinaryVersion) {
         spdlog::error(ErrInfo::InfoMismatch(AOT::kBinaryVersion, *Res));
         spdlog::error(ErrInfo::InfoFile(FilePath));
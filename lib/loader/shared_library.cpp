@@ -5,6 +5,7 @@
 
 #include "common/log.h"
 #include "system/allocator.h"
+#include "system/mmap.h"
 
 #include <algorithm>
 #include <cerrno>
@@ -18,7 +19,10 @@
 #include <boost/winapi/error_handling.hpp>
 #include <boost/winapi/local_memory.hpp>
 namespace winapi = boost::winapi;
-#elif WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+#elif WASMEDGE_OS_LINUX
+#include <dlfcn.h>
+#include <link.h>
+#elif WASMEDGE_OS_MACOS
 #include <dlfcn.h>
 #else
 #error Unsupported os!
@@ -76,6 +80,33 @@ Expect<void> SharedLibrary::load(const std::filesystem::path &Path) noexcept {
 #endif
     return Unexpect(ErrCode::Value::IllegalPath);
   }
+
+  Texts.clear();
+#if WASMEDGE_OS_LINUX
+  // Record the executable segments, which bound the compiled code.
+  struct link_map *Map = nullptr;
+  if (::dlinfo(Handle, RTLD_DI_LINKMAP, &Map) == 0 && Map) {
+    std::pair<const struct link_map *, decltype(Texts) *> Data(Map, &Texts);
+    ::dl_iterate_phdr(
+        [](struct dl_phdr_info *Info, size_t, void *Arg) -> int {
+          auto &[Lib, Out] = *static_cast<decltype(Data) *>(Arg);
+          if (Info->dlpi_addr != Lib->l_addr ||
+              std::strcmp(Info->dlpi_name, Lib->l_name) != 0) {
+            return 0;
+          }
+          for (ElfW(Half) I = 0; I < Info->dlpi_phnum; ++I) {
+            const auto &Phdr = Info->dlpi_phdr[I];
+            if (Phdr.p_type == PT_LOAD && (Phdr.p_flags & PF_X)) {
+              Out->emplace_back(reinterpret_cast<const uint8_t *>(
+                                      Info->dlpi_addr + Phdr.p_vaddr),
+                                  Phdr.p_memsz);
+            }
+          }
+          return 1;
+        },
+        &Data);
+  }
+#endif
   return {};
 }
 
@@ -94,6 +125,8 @@ Expect<void> SharedLibrary::load(const AST::AOTSection &AOTSec) noexcept {
   }
 
   std::vector<std::pair<uint8_t *, uint64_t>> ExecutableRanges;
+  std::vector<std::pair<uint64_t, uint64_t>> UnreadTexts;
+  Texts.clear();
   for (const auto &Section : AOTSec.getSections()) {
     const auto Offset = std::get<1>(Section);
     const auto Size = std::get<2>(Section);
@@ -104,6 +137,10 @@ Expect<void> SharedLibrary::load(const AST::AOTSection &AOTSec) noexcept {
       const auto O = roundDownPageBoundary(Offset);
       const auto S = roundUpPageBoundary(Size + (Offset - O));
       ExecutableRanges.emplace_back(Binary + O, S);
+      Texts.emplace_back(Binary + Offset, Size);
+      if (Content.size() < Size) {
+        UnreadTexts.emplace_back(Offset, Size);
+      }
       break;
     }
     case 2: // Data
@@ -113,6 +150,45 @@ Expect<void> SharedLibrary::load(const AST::AOTSection &AOTSec) noexcept {
     }
   }
 
+  if (!UnreadTexts.empty()) {
+    // The text sections are left in the file by the loader, which keeps the
+    // file open. The image in the file has the same layout as the chunk, so
+    // the pages can be mapped in place and shared with every process running
+    // the same file.
+    const auto &File = AOTSec.getImageFile();
+    const auto *Image =
+        File ? reinterpret_cast<const uint8_t *>(File->address()) : nullptr;
+    const uint64_t FileSize = File ? File->size() : 0;
+    const auto ImageOffset = AOTSec.getImageOffset();
+    for (const auto &[Offset, Size] : UnreadTexts) {
+      if (unlikely(!Image || ImageOffset > FileSize ||
+                   Offset > FileSize - ImageOffset ||
+                   Size > FileSize - ImageOffset - Offset)) {
+        spdlog::error(ErrCode::Value::IllegalPath);
+        spdlog::error("    AOT text section out of the file.");
+        return Unexpect(ErrCode::Value::IllegalPath);
+      }
+    }
+    bool Mapped = roundDownPageBoundary(ImageOffset) == ImageOffset;
+    for (const auto &[Offset, Size] : UnreadTexts) {
+      if (!Mapped) {
+        break;
+      }
+      const auto O = roundDownPageBoundary(Offset);
+      const auto S = roundUpPageBoundary(Size + (Offset - O));
+      Mapped = File->mapExecutable(Binary + O, S, ImageOffset + O);
+    }
+    if (!Mapped) {
+      // Read the text sections from the file instead.
+      for (const auto &[Pointer, Size] : ExecutableRanges) {
+        Allocator::set_chunk_readable_writable(Pointer, Size);
+      }
+      for (const auto &[Offset, Size] : UnreadTexts) {
+        std::copy_n(Image + ImageOffset + Offset, Size, Binary + Offset);
+      }
+    }
+  }
+
   for (const auto &[Pointer, Size] : ExecutableRanges) {
     if (!Allocator::set_chunk_executable(Pointer, Size)) {
       spdlog::error(ErrCode::Value::MemoryOutOfBounds);
@@ -7,6 +7,8 @@
 #include "common/defines.h"
 #include "common/errcode.h"
 
+#include <cstring>
+
 #if defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||       \
     defined(__arm__)
 #include <sys/mman.h>
@@ -34,10 +36,12 @@ using ::VirtualProtect;
 #if defined(BOOST_USE_WINDOWS_H)
 BOOST_CONSTEXPR_OR_CONST DWORD_ MEM_COMMIT_ = MEM_COMMIT;
 BOOST_CONSTEXPR_OR_CONST DWORD_ MEM_RESERVE_ = MEM_RESERVE;
+BOOST_CONSTEXPR_OR_CONST DWORD_ MEM_DECOMMIT_ = MEM_DECOMMIT;
 BOOST_CONSTEXPR_OR_CONST DWORD_ MEM_RELEASE_ = MEM_RELEASE;
 #else
 BOOST_CONSTEXPR_OR_CONST DWORD_ MEM_COMMIT_ = 0x00001000;
 BOOST_CONSTEXPR_OR_CONST DWORD_ MEM_RESERVE_ = 0x00002000;
+BOOST_CONSTEXPR_OR_CONST DWORD_ MEM_DECOMMIT_ = 0x00004000;
 BOOST_CONSTEXPR_OR_CONST DWORD_ MEM_RELEASE_ = 0x00008000;
 #endif
 } // namespace winapi
@@ -144,6 +148,46 @@ Allocator::resize(uint8_t *Pointer, uint32_t OldPageCount,
 #endif
 }
 
+[[gnu::visibility("default")]] uint8_t *
+Allocator::reset(uint8_t *Pointer, uint32_t OldPageCount,
+                 uint32_t NewPageCount) noexcept {
+  assuming(NewPageCount <= OldPageCount);
+#if defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__)
+  // Private anonymous pages read back as zero after MADV_DONTNEED, and the
+  // pages past the new size go back to the reserved inaccessible state.
+  if (NewPageCount > 0 &&
+      madvise(Pointer, NewPageCount * kPageSize, MADV_DONTNEED) != 0) {
+    return nullptr;
+  }
+  if (NewPageCount < OldPageCount &&
+      mmap(Pointer + NewPageCount * kPageSize,
+           (OldPageCount - NewPageCount) * kPageSize, PROT_NONE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1,
+           0) == MAP_FAILED) {
+    return nullptr;
+  }
+  return Pointer;
+#elif WASMEDGE_OS_WINDOWS
+  std::memset(Pointer, 0, NewPageCount * kPageSize);
+  if (NewPageCount < OldPageCount &&
+      boost::winapi::VirtualFree(Pointer + NewPageCount * kPageSize,
+                                 (OldPageCount - NewPageCount) * kPageSize,
+                                 boost::winapi::MEM_DECOMMIT_) == 0) {
+    return nullptr;
+  }
+  return Pointer;
+#else
+  std::memset(Pointer, 0, NewPageCount * kPageSize);
+  if (NewPageCount < OldPageCount && NewPageCount > 0) {
+    if (auto Result = reinterpret_cast<uint8_t *>(
+            std::realloc(Pointer, NewPageCount * kPageSize))) {
+      return Result;
+    }
+  }
+  return Pointer;
+#endif
+}
+
 uint8_t *Allocator::allocate_chunk(uint64_t Size) noexcept {
 #if defined(HAVE_MMAP)
   if (auto Pointer = mmap(nullptr, Size, PROT_READ | PROT_WRITE,
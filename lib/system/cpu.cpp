@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "system/cpu.h"
+
+#include "common/defines.h"
+
+#include <array>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(__aarch64__) && WASMEDGE_OS_LINUX
+#include <sys/auxv.h>
+#endif
+
+namespace WasmEdge {
+
+namespace {
+using namespace std::literals;
+
+#if defined(__x86_64__) || defined(_M_X64)
+inline constexpr uint64_t kSSE3 = UINT64_C(1) << 0;
+inline constexpr uint64_t kSSSE3 = UINT64_C(1) << 1;
+inline constexpr uint64_t kSSE4_1 = UINT64_C(1) << 2;
+inline constexpr uint64_t kSSE4_2 = UINT64_C(1) << 3;
+inline constexpr uint64_t kPOPCNT = UINT64_C(1) << 4;
+inline constexpr uint64_t kCX16 = UINT64_C(1) << 5;
+inline constexpr uint64_t kSAHF = UINT64_C(1) << 6;
+inline constexpr uint64_t kAVX = UINT64_C(1) << 7;
+inline constexpr uint64_t kAVX2 = UINT64_C(1) << 8;
+inline constexpr uint64_t kBMI = UINT64_C(1) << 9;
+inline constexpr uint64_t kBMI2 = UINT64_C(1) << 10;
+inline constexpr uint64_t kF16C = UINT64_C(1) << 11;
+inline constexpr uint64_t kFMA = UINT64_C(1) << 12;
+inline constexpr uint64_t kLZCNT = UINT64_C(1) << 13;
+inline constexpr uint64_t kMOVBE = UINT64_C(1) << 14;
+inline constexpr uint64_t kAVX512F = UINT64_C(1) << 15;
+inline constexpr uint64_t kAVX512BW = UINT64_C(1) << 16;
+inline constexpr uint64_t kAVX512CD = UINT64_C(1) << 17;
+inline constexpr uint64_t kAVX512DQ = UINT64_C(1) << 18;
+inline constexpr uint64_t kAVX512VL = UINT64_C(1) << 19;
+inline constexpr uint64_t kXOP = UINT64_C(1) << 20;
+
+inline constexpr std::array<std::string_view, 21> kFeatureNames = {
+    "sse3"sv,     "ssse3"sv,    "sse4.1"sv,   "sse4.2"sv,   "popcnt"sv,
+    "cx16"sv,     "sahf"sv,     "avx"sv,      "avx2"sv,     "bmi"sv,
+    "bmi2"sv,     "f16c"sv,     "fma"sv,      "lzcnt"sv,    "movbe"sv,
+    "avx512f"sv,  "avx512bw"sv, "avx512cd"sv, "avx512dq"sv, "avx512vl"sv,
+    "xop"sv,
+};
+
+/// The micro-architecture levels of the x86-64 psABI.
+inline constexpr uint64_t kV2 = kSSE3 | kSSSE3 | kSSE4_1 | kSSE4_2 | kPOPCNT |
+                                kCX16 | kSAHF;
+inline constexpr uint64_t kV3 =
+    kV2 | kAVX | kAVX2 | kBMI | kBMI2 | kF16C | kFMA | kLZCNT | kMOVBE;
+inline constexpr uint64_t kV4 =
+    kV3 | kAVX512F | kAVX512BW | kAVX512CD | kAVX512DQ | kAVX512VL;
+
+inline constexpr std::array<std::string_view, 4> kLevelNames = {
+    "x86-64"sv, "x86-64-v2"sv, "x86-64-v3"sv, "x86-64-v4"sv};
+inline constexpr std::array<uint64_t, 4> kLevelFeatures = {0, kV2, kV3, kV4};
+
+struct CPUIDResult {
+  uint32_t EAX = 0, EBX = 0, ECX = 0, EDX = 0;
+};
+
+CPUIDResult cpuid(uint32_t Leaf, uint32_t SubLeaf = 0) noexcept {
+  CPUIDResult R;
+#if defined(_MSC_VER) && !defined(__clang__)
+  int Regs[4];
+  __cpuidex(Regs, static_cast<int>(Leaf), static_cast<int>(SubLeaf));
+  R.EAX = static_cast<uint32_t>(Regs[0]);
+  R.EBX = static_cast<uint32_t>(Regs[1]);
+  R.ECX = static_cast<uint32_t>(Regs[2]);
+  R.EDX = static_cast<uint32_t>(Regs[3]);
+#else
+  __cpuid_count(Leaf, SubLeaf, R.EAX, R.EBX, R.ECX, R.EDX);
+#endif
+  return R;
+}
+
+uint64_t xgetbv() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+  return _xgetbv(0);
+#else
+  uint32_t EAX, EDX;
+  __asm__("xgetbv" : "=a"(EAX), "=d"(EDX) : "c"(0));
+  return (static_cast<uint64_t>(EDX) << 32) | EAX;
+#endif
+}
+
+uint64_t detect() noexcept {
+  const auto Bit = [](uint32_t Reg, uint32_t I) { return (Reg >> I) & 1U; };
+  const uint32_t MaxLeaf = cpuid(0).EAX;
+  const uint32_t MaxExtLeaf = cpuid(0x80000000U).EAX;
+  uint64_t Features = 0;
+
+  const auto Leaf1 = cpuid(1);
+  Features |= Bit(Leaf1.ECX, 0) ? kSSE3 : 0;
+  Features |= Bit(Leaf1.ECX, 9) ? kSSSE3 : 0;
+  Features |= Bit(Leaf1.ECX, 13) ? kCX16 : 0;
+  Features |= Bit(Leaf1.ECX, 19) ? kSSE4_1 : 0;
+  Features |= Bit(Leaf1.ECX, 20) ? kSSE4_2 : 0;
+  Features |= Bit(Leaf1.ECX, 22) ? kMOVBE : 0;
+  Features |= Bit(Leaf1.ECX, 23) ? kPOPCNT : 0;
+
+  // The kAVX registers must also be enabled by the OS.
+  const uint64_t XCR0 = Bit(Leaf1.ECX, 27) ? xgetbv() : 0;
+  const bool HasAVXState = (XCR0 & 0x6U) == 0x6U;
+  const bool HasAVX512State = (XCR0 & 0xE6U) == 0xE6U;
+  if (HasAVXState) {
+    Features |= Bit(Leaf1.ECX, 12) ? kFMA : 0;
+    Features |= Bit(Leaf1.ECX, 28) ? kAVX : 0;
+    Features |= Bit(Leaf1.ECX, 29) ? kF16C : 0;
+  }
+
+  if (MaxLeaf >= 7) {
+    const auto Leaf7 = cpuid(7);
+    Features |= Bit(Leaf7.EBX, 3) ? kBMI : 0;
+    Features |= Bit(Leaf7.EBX, 8) ? kBMI2 : 0;
+    if (HasAVXState) {
+      Features |= Bit(Leaf7.EBX, 5) ? kAVX2 : 0;
+    }
+    if (HasAVX512State) {
+      Features |= Bit(Leaf7.EBX, 16) ? kAVX512F : 0;
+      Features |= Bit(Leaf7.EBX, 17) ? kAVX512DQ : 0;
+      Features |= Bit(Leaf7.EBX, 28) ? kAVX512CD : 0;
+      Features |= Bit(Leaf7.EBX, 30) ? kAVX512BW : 0;
+      Features |= Bit(Leaf7.EBX, 31) ? kAVX512VL : 0;
+    }
+  }
+
+  if (MaxExtLeaf >= 0x80000001U) {
+    const auto Ext1 = cpuid(0x80000001U);
+    Features |= Bit(Ext1.ECX, 0) ? kSAHF : 0;
+    Features |= Bit(Ext1.ECX, 5) ? kLZCNT : 0;
+    if (HasAVXState) {
+      Features |= Bit(Ext1.ECX, 11) ? kXOP : 0;
+    }
+  }
+  return Features;
+}
+
+#elif defined(__aarch64__)
+inline constexpr uint64_t kNEON = UINT64_C(1) << 0;
+inline constexpr uint64_t kCRC = UINT64_C(1) << 1;
+inline constexpr uint64_t kLSE = UINT64_C(1) << 2;
+inline constexpr uint64_t kFULLFP16 = UINT64_C(1) << 3;
+inline constexpr uint64_t kRCPC = UINT64_C(1) << 4;
+inline constexpr uint64_t kDOTPROD = UINT64_C(1) << 5;
+
+inline constexpr std::array<std::string_view, 6> kFeatureNames = {
+    "neon"sv, "crc"sv, "lse"sv, "fullfp16"sv, "rcpc"sv, "dotprod"sv,
+};
+
+/// The baseline and the Neoverse N1 class servers.
+inline constexpr std::array<std::string_view, 2> kLevelNames = {
+    "generic"sv, "neoverse-n1"sv};
+inline constexpr std::array<uint64_t, 2> kLevelFeatures = {
+    kNEON, kNEON | kCRC | kLSE | kFULLFP16 | kRCPC | kDOTPROD};
+
+uint64_t detect() noexcept {
+#if WASMEDGE_OS_LINUX
+  const auto HWCap = getauxval(AT_HWCAP);
+  const auto Bit = [HWCap](uint32_t I) { return (HWCap >> I) & 1U; };
+  uint64_t Features = 0;
+  Features |= Bit(1) ? kNEON : 0;
+  Features |= Bit(7) ? kCRC : 0;
+  Features |= Bit(8) ? kLSE : 0;
+  Features |= Bit(10) ? kFULLFP16 : 0;
+  Features |= Bit(15) ? kRCPC : 0;
+  Features |= Bit(20) ? kDOTPROD : 0;
+  return Features;
+#elif WASMEDGE_OS_MACOS
+  // The Apple silicon supports all the features.
+  return kLevelFeatures[1];
+#else
+  return kNEON;
+#endif
+}
+
+#else
+inline constexpr std::array<std::string_view, 0> kFeatureNames = {};
+inline constexpr std::array<std::string_view, 1> kLevelNames = {"generic"sv};
+inline constexpr std::array<uint64_t, 1> kLevelFeatures = {0};
+
+uint64_t detect() noexcept { return 0; }
+#endif
+} // namespace
+
+Span<const std::string_view> CPU::featureNames() noexcept {
+  return kFeatureNames;
+}
+
+uint64_t CPU::hostFeatures() noexcept {
+  static const uint64_t Features = detect();
+  return Features;
+}
+
+Span<const std::string_view> CPU::levelNames() noexcept { return kLevelNames; }
+
+std::optional<uint64_t> CPU::levelFeatures(std::string_view Name) noexcept {
+  for (size_t I = 0; I < kLevelNames.size(); ++I) {
+    if (kLevelNames[I] == Name) {
+      return kLevelFeatures[I];
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace WasmEdge
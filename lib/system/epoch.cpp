@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "system/epoch.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace WasmEdge {
+
+std::atomic_uint64_t Epoch::Counter = 0;
+
+namespace {
+
+/// Timer thread for advancing the epoch counter while any deadline is armed.
+class EpochTimer {
+public:
+  EpochTimer(std::atomic_uint64_t &Counter)
+      : Counter(Counter), Start(Epoch::Clock::now()) {}
+  ~EpochTimer() noexcept {
+    {
+      std::unique_lock Lock(Mutex);
+      Done = true;
+    }
+    Cond.notify_all();
+    if (Thread.joinable()) {
+      Thread.join();
+    }
+  }
+
+  Epoch::Clock::time_point getStart() const noexcept { return Start; }
+
+  void arm() noexcept {
+    {
+      std::unique_lock Lock(Mutex);
+      if (Armed++ > 0) {
+        return;
+      }
+      if (!Thread.joinable()) {
+        Thread = std::thread([this]() { run(); });
+      }
+    }
+    Cond.notify_all();
+  }
+
+  void disarm() noexcept {
+    std::unique_lock Lock(Mutex);
+    --Armed;
+  }
+
+private:
+  void run() noexcept {
+    std::unique_lock Lock(Mutex);
+    while (!Done) {
+      if (Armed == 0) {
+        Cond.wait(Lock, [this]() { return Done || Armed > 0; });
+      } else {
+        Cond.wait_until(Lock, Epoch::Clock::now() + Epoch::kTick,
+                        [this]() { return Done; });
+      }
+      // Count the epochs from the start time, so that a late wake-up or
+      // parking does not make the counter drift.
+      Counter.store(static_cast<uint64_t>((Epoch::Clock::now() - Start) /
+                                          Epoch::kTick),
+                    std::memory_order_relaxed);
+    }
+  }
+
+  std::atomic_uint64_t &Counter;
+  const Epoch::Clock::time_point Start;
+  std::mutex Mutex;
+  std::condition_variable Cond;
+  uint64_t Armed = 0;
+  bool Done = false;
+  std::thread Thread;
+};
+
+EpochTimer &getTimer(std::atomic_uint64_t &Counter) noexcept {
+  static EpochTimer Timer(Counter);
+  return Timer;
+}
+
+} // namespace
+
+uint64_t Epoch::deadline(Clock::time_point Timeout) noexcept {
+  const auto Start = getTimer(Counter).getStart();
+  if (Timeout <= Start) {
+    return 0;
+  }
+  // Round up so that the deadline is never earlier than the timeout.
+  const auto Ticks = (Timeout - Start + kTick - Clock::duration(1)) / kTick;
+  return static_cast<uint64_t>(Ticks);
+}
+
+Epoch::Clock::time_point Epoch::timePoint(uint64_t Value) noexcept {
+  const auto Start = getTimer(Counter).getStart();
+  if (Value >= static_cast<uint64_t>((Clock::time_point::max() - Start) /
+                                     kTick)) {
+    return Clock::time_point::max();
+  }
+  return Start + kTick * static_cast<Clock::rep>(Value);
+}
+
+void Epoch::arm() noexcept { getTimer(Counter).arm(); }
+
+void Epoch::disarm() noexcept { getTimer(Counter).disarm(); }
+
+} // namespace WasmEdge
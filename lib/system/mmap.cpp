@@ -64,6 +64,7 @@ struct Implement {
   void *Address = nullptr;
   boost::winapi::HANDLE_ File = nullptr;
   boost::winapi::HANDLE_ Map = nullptr;
+  uint64_t Size = 0;
   Implement(const std::filesystem::path &Path) noexcept {
     File = boost::winapi::create_file(
         Path.native().c_str(), boost::winapi::GENERIC_READ_,
@@ -74,13 +75,14 @@ struct Implement {
       return;
     }
 
-    boost::winapi::LARGE_INTEGER_ Size;
-    boost::winapi::GetFileSizeEx(File, &Size);
+    boost::winapi::LARGE_INTEGER_ FileSize;
+    boost::winapi::GetFileSizeEx(File, &FileSize);
+    Size = static_cast<uint64_t>(FileSize.QuadPart);
 
     Map = boost::winapi::CreateFileMappingW(
         File, nullptr, boost::winapi::PAGE_READONLY_,
-        static_cast<boost::winapi::ULONG_>(Size.HighPart), Size.LowPart,
-        nullptr);
+        static_cast<boost::winapi::ULONG_>(FileSize.HighPart),
+        FileSize.LowPart, nullptr);
     if (Map == nullptr) {
       Map = boost::winapi::invalid_handle_value;
       return;
@@ -139,6 +141,39 @@ void *MMap::address() const noexcept {
   return reinterpret_cast<const Implement *>(Handle)->Address;
 }
 
+uint64_t MMap::size() const noexcept {
+  if (!Handle) {
+    return 0;
+  }
+  return reinterpret_cast<const Implement *>(Handle)->Size;
+}
+
+bool MMap::mapExecutable(void *Pointer [[maybe_unused]],
+                         uint64_t Size [[maybe_unused]],
+                         uint64_t Offset [[maybe_unused]]) const noexcept {
+#if defined(HAVE_MMAP) && WASMEDGE_OS_LINUX
+  if (!Handle) {
+    return false;
+  }
+  // Map from the descriptor kept open, so the pages are from the same file
+  // as the mapping even if the path is replaced.
+  const auto *NativeHandle = reinterpret_cast<const Implement *>(Handle);
+  auto *Result =
+      mmap(Pointer, Size, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_FIXED,
+           NativeHandle->File, static_cast<off_t>(Offset));
+  if (Result == MAP_FAILED) {
+    // Put the anonymous pages back in case the old mapping has been removed.
+    mmap(Pointer, Size, PROT_READ | PROT_WRITE,
+         MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    return false;
+  }
+  return true;
+#else
+  // Executable file mappings need code signing on MacOS and are not used.
+  return false;
+#endif
+}
+
 bool MMap::supported() noexcept { return kSupported; }
 
 } // namespace WasmEdge
@@ -0,0 +1,229 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "system/perfmap.h"
+
+#include "common/defines.h"
+#include "common/log.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+#if WASMEDGE_OS_LINUX
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace WasmEdge {
+
+namespace {
+#if WASMEDGE_OS_LINUX
+/// Records of the jitdump format. See the jitdump specification in the
+/// documents of the Linux perf tool.
+struct JitHeader {
+  uint32_t Magic;
+  uint32_t Version;
+  uint32_t TotalSize;
+  uint32_t ElfMach;
+  uint32_t Pad1;
+  uint32_t Pid;
+  uint64_t Timestamp;
+  uint64_t Flags;
+};
+struct JitCodeLoad {
+  uint32_t Id;
+  uint32_t TotalSize;
+  uint64_t Timestamp;
+  uint32_t Pid;
+  uint32_t Tid;
+  uint64_t Vma;
+  uint64_t CodeAddr;
+  uint64_t CodeSize;
+  uint64_t CodeIndex;
+};
+inline constexpr const uint32_t kJitMagic = 0x4A695444;
+inline constexpr const uint32_t kJitVersion = 1;
+inline constexpr const uint32_t kJitCodeLoadId = 0;
+
+inline constexpr uint32_t elfMachine() noexcept {
+#if defined(__x86_64__)
+  return EM_X86_64;
+#elif defined(__aarch64__)
+  return EM_AARCH64;
+#elif defined(__riscv)
+  return EM_RISCV;
+#else
+  return EM_NONE;
+#endif
+}
+
+uint64_t timestamp() noexcept {
+  struct timespec TS;
+  clock_gettime(CLOCK_MONOTONIC, &TS);
+  return static_cast<uint64_t>(TS.tv_sec) * UINT64_C(1000000000) +
+         static_cast<uint64_t>(TS.tv_nsec);
+}
+
+bool writeAll(int Fd, const void *Data, size_t Size) noexcept {
+  const auto *Ptr = static_cast<const char *>(Data);
+  while (Size > 0) {
+    const auto Written = ::write(Fd, Ptr, Size);
+    if (Written < 0) {
+      return false;
+    }
+    Ptr += Written;
+    Size -= static_cast<size_t>(Written);
+  }
+  return true;
+}
+
+/// Create a new file only readable by the user. The files are in the shared
+/// /tmp, so an existing file or a symbolic link planted by another user must
+/// not be opened.
+int createFile(const std::string &Path, int Flags) noexcept {
+  return open(Path.c_str(),
+              Flags | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC,
+              S_IRUSR | S_IWUSR);
+}
+
+/// Process-wide owner of the opened files.
+class Writer {
+public:
+  static Writer &getInstance() noexcept {
+    static Writer Instance;
+    return Instance;
+  }
+
+  ~Writer() noexcept {
+    if (MapFile) {
+      std::fclose(MapFile);
+    }
+    if (Marker != MAP_FAILED) {
+      munmap(Marker, MarkerSize);
+    }
+    if (JitFd >= 0) {
+      close(JitFd);
+    }
+  }
+
+  void writePerfMap(Span<const PerfMap::Entry> Entries) noexcept {
+    std::unique_lock Lock(Mutex);
+    if (!MapFile) {
+      const auto Path = "/tmp/perf-" + std::to_string(getpid()) + ".map";
+      const int Fd = createFile(Path, O_WRONLY | O_APPEND);
+      if (Fd < 0) {
+        spdlog::warn("    Failed to create the perf map {}.", Path);
+        return;
+      }
+      if (MapFile = fdopen(Fd, "a"); !MapFile) {
+        spdlog::warn("    Failed to open the perf map {}.", Path);
+        close(Fd);
+        return;
+      }
+    }
+    for (const auto &Entry : Entries) {
+      std::fprintf(MapFile, "%" PRIxPTR " %" PRIx64 " %s\n",
+                   reinterpret_cast<uintptr_t>(Entry.Address), Entry.Size,
+                   Entry.Name.c_str());
+    }
+    std::fflush(MapFile);
+  }
+
+  void writeJitDump(Span<const PerfMap::Entry> Entries) noexcept {
+    std::unique_lock Lock(Mutex);
+    if (JitFd < 0 && !openJitDump()) {
+      return;
+    }
+    const auto Tid = static_cast<uint32_t>(syscall(SYS_gettid));
+    for (const auto &Entry : Entries) {
+      const auto Address = reinterpret_cast<uintptr_t>(Entry.Address);
+      JitCodeLoad Record{};
+      Record.Id = kJitCodeLoadId;
+      Record.TotalSize = static_cast<uint32_t>(
+          sizeof(Record) + Entry.Name.size() + 1 + Entry.Size);
+      Record.Timestamp = timestamp();
+      Record.Pid = static_cast<uint32_t>(getpid());
+      Record.Tid = Tid;
+      Record.Vma = Address;
+      Record.CodeAddr = Address;
+      Record.CodeSize = Entry.Size;
+      Record.CodeIndex = CodeIndex++;
+      if (!writeAll(JitFd, &Record, sizeof(Record)) ||
+          !writeAll(JitFd, Entry.Name.c_str(), Entry.Name.size() + 1) ||
+          !writeAll(JitFd, Entry.Address, Entry.Size)) {
+        spdlog::warn("    Failed to write the jitdump records.");
+        return;
+      }
+    }
+  }
+
+private:
+  Writer() noexcept = default;
+
+  bool openJitDump() noexcept {
+    const auto Path = "/tmp/jit-" + std::to_string(getpid()) + ".dump";
+    JitFd = createFile(Path, O_RDWR);
+    if (JitFd < 0) {
+      spdlog::warn("    Failed to create the jitdump {}.", Path);
+      return false;
+    }
+    JitHeader Header{};
+    Header.Magic = kJitMagic;
+    Header.Version = kJitVersion;
+    Header.TotalSize = sizeof(Header);
+    Header.ElfMach = elfMachine();
+    Header.Pid = static_cast<uint32_t>(getpid());
+    Header.Timestamp = timestamp();
+    if (!writeAll(JitFd, &Header, sizeof(Header))) {
+      spdlog::warn("    Failed to write the jitdump {}.", Path);
+      close(JitFd);
+      JitFd = -1;
+      return false;
+    }
+    // The perf tool finds the jitdump file by the executable mapping of it.
+    MarkerSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    Marker = mmap(nullptr, MarkerSize, PROT_READ | PROT_EXEC, MAP_PRIVATE,
+                  JitFd, 0);
+    return true;
+  }
+
+  std::mutex Mutex;
+  std::FILE *MapFile = nullptr;
+  int JitFd = -1;
+  void *Marker = MAP_FAILED;
+  size_t MarkerSize = 0;
+  uint64_t CodeIndex = 0;
+};
+#endif
+} // namespace
+
+void PerfMap::writePerfMap(
+    [[maybe_unused]] Span<const Entry> Entries) noexcept {
+#if WASMEDGE_OS_LINUX
+  Writer::getInstance().writePerfMap(Entries);
+#endif
+}
+
+void PerfMap::writeJitDump(
+    [[maybe_unused]] Span<const Entry> Entries) noexcept {
+#if WASMEDGE_OS_LINUX
+  Writer::getInstance().writeJitDump(Entries);
+#endif
+}
+
+bool PerfMap::supported() noexcept {
+#if WASMEDGE_OS_LINUX
+  return true;
+#else
+  return false;
+#endif
+}
+
+} // namespace WasmEdge
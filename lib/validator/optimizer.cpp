@@ -0,0 +1,741 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "validator/optimizer.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace WasmEdge {
+namespace Validator {
+
+namespace {
+
+/// Integer operations in the order of the i32 and the i64 opcodes.
+enum class IntOp : uint8_t {
+  Add,
+  Sub,
+  Mul,
+  DivS,
+  DivU,
+  RemS,
+  RemU,
+  And,
+  Or,
+  Xor,
+  Shl,
+  ShrS,
+  ShrU,
+  Rotl,
+  Rotr,
+  Eq,
+  Ne,
+  LtS,
+  LtU,
+  GtS,
+  GtU,
+  LeS,
+  LeU,
+  GeS,
+  GeU,
+};
+
+constexpr uint16_t toU16(OpCode Code) noexcept {
+  return static_cast<uint16_t>(Code);
+}
+
+/// Get the integer operation of a binary instruction on the constants of the
+/// given opcode.
+std::optional<IntOp> getIntOp(OpCode Const, OpCode Code) noexcept {
+  const bool Is32 = Const == OpCode::I32__const;
+  const uint16_t Arith = toU16(Is32 ? OpCode::I32__add : OpCode::I64__add);
+  const uint16_t Cmp = toU16(Is32 ? OpCode::I32__eq : OpCode::I64__eq);
+  const uint16_t C = toU16(Code);
+  if (C >= Arith && C <= Arith + toU16(OpCode::I32__rotr) -
+                                toU16(OpCode::I32__add)) {
+    return static_cast<IntOp>(C - Arith);
+  }
+  if (C >= Cmp &&
+      C <= Cmp + toU16(OpCode::I32__ge_u) - toU16(OpCode::I32__eq)) {
+    return static_cast<IntOp>(C - Cmp + static_cast<uint16_t>(IntOp::Eq));
+  }
+  return std::nullopt;
+}
+
+bool isCompare(IntOp Op) noexcept { return Op >= IntOp::Eq; }
+
+/// Fold an integer operation. Return nullopt if it traps.
+template <typename T>
+std::optional<T> foldIntOp(IntOp Op, T A, T B) noexcept {
+  using S = std::make_signed_t<T>;
+  constexpr T Bits = sizeof(T) * 8;
+  const S SA = static_cast<S>(A);
+  const S SB = static_cast<S>(B);
+  const T K = B % Bits;
+  switch (Op) {
+  case IntOp::Add:
+    return static_cast<T>(A + B);
+  case IntOp::Sub:
+    return static_cast<T>(A - B);
+  case IntOp::Mul:
+    return static_cast<T>(A * B);
+  case IntOp::DivS:
+    if (B == 0 || (SA == std::numeric_limits<S>::min() && SB == -1)) {
+      return std::nullopt;
+    }
+    return static_cast<T>(SA / SB);
+  case IntOp::DivU:
+    if (B == 0) {
+      return std::nullopt;
+    }
+    return static_cast<T>(A / B);
+  case IntOp::RemS:
+    if (B == 0) {
+      return std::nullopt;
+    }
+    return SB == -1 ? T(0) : static_cast<T>(SA % SB);
+  case IntOp::RemU:
+    if (B == 0) {
+      return std::nullopt;
+    }
+    return static_cast<T>(A % B);
+  case IntOp::And:
+    return static_cast<T>(A & B);
+  case IntOp::Or:
+    return static_cast<T>(A | B);
+  case IntOp::Xor:
+    return static_cast<T>(A ^ B);
+  case IntOp::Shl:
+    return static_cast<T>(A << K);
+  case IntOp::ShrS:
+    return static_cast<T>(SA >> K);
+  case IntOp::ShrU:
+    return static_cast<T>(A >> K);
+  case IntOp::Rotl:
+    return K == 0 ? A : static_cast<T>((A << K) | (A >> (Bits - K)));
+  case IntOp::Rotr:
+    return K == 0 ? A : static_cast<T>((A >> K) | (A << (Bits - K)));
+  case IntOp::Eq:
+    return T(A == B);
+  case IntOp::Ne:
+    return T(A != B);
+  case IntOp::LtS:
+    return T(SA < SB);
+  case IntOp::LtU:
+    return T(A < B);
+  case IntOp::GtS:
+    return T(SA > SB);
+  case IntOp::GtU:
+    return T(A > B);
+  case IntOp::LeS:
+    return T(SA <= SB);
+  case IntOp::LeU:
+    return T(A <= B);
+  case IntOp::GeS:
+    return T(SA >= SB);
+  case IntOp::GeU:
+    return T(A >= B);
+  }
+  return std::nullopt;
+}
+
+/// Check whether an operation with the constant B as the right operand
+/// returns the left operand.
+template <typename T> bool isIdentity(IntOp Op, T B) noexcept {
+  constexpr T Bits = sizeof(T) * 8;
+  switch (Op) {
+  case IntOp::Add:
+  case IntOp::Sub:
+  case IntOp::Or:
+  case IntOp::Xor:
+    return B == 0;
+  case IntOp::Mul:
+  case IntOp::DivS:
+  case IntOp::DivU:
+    return B == 1;
+  case IntOp::And:
+    return B == std::numeric_limits<T>::max();
+  case IntOp::Shl:
+  case IntOp::ShrS:
+  case IntOp::ShrU:
+  case IntOp::Rotl:
+  case IntOp::Rotr:
+    return B % Bits == 0;
+  default:
+    return false;
+  }
+}
+
+uint64_t getConst(const AST::Instruction &Instr) noexcept {
+  if (Instr.getOpCode() == OpCode::I32__const) {
+    return Instr.getNum().get<uint32_t>();
+  }
+  return Instr.getNum().get<uint64_t>();
+}
+
+AST::Instruction makeConst(OpCode Code, uint64_t Value, uint32_t Offset) {
+  AST::Instruction Instr(Code, Offset);
+  if (Code == OpCode::I32__const) {
+    Instr.setNum(static_cast<uint128_t>(static_cast<uint32_t>(Value)));
+  } else {
+    Instr.setNum(static_cast<uint128_t>(Value));
+  }
+  return Instr;
+}
+
+bool isIntConst(OpCode Code) noexcept {
+  return Code == OpCode::I32__const || Code == OpCode::I64__const;
+}
+
+/// Fold an unary instruction on an integer constant.
+std::optional<std::pair<OpCode, uint64_t>> foldUnary(OpCode Const, uint64_t A,
+                                                     OpCode Code) noexcept {
+  const bool Is32 = Const == OpCode::I32__const;
+  switch (Code) {
+  case OpCode::I32__eqz:
+  case OpCode::I64__eqz:
+    return std::make_pair(OpCode::I32__const, uint64_t(A == 0));
+  case OpCode::I32__wrap_i64:
+    return std::make_pair(OpCode::I32__const, A & UINT32_MAX);
+  case OpCode::I64__extend_i32_s:
+    return std::make_pair(
+        OpCode::I64__const,
+        static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(A))));
+  case OpCode::I64__extend_i32_u:
+    return std::make_pair(OpCode::I64__const, A & UINT32_MAX);
+  case OpCode::I32__extend8_s:
+  case OpCode::I64__extend8_s:
+    A = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int8_t>(A)));
+    break;
+  case OpCode::I32__extend16_s:
+  case OpCode::I64__extend16_s:
+    A = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int16_t>(A)));
+    break;
+  case OpCode::I64__extend32_s:
+    A = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(A)));
+    break;
+  default:
+    return std::nullopt;
+  }
+  return std::make_pair(Const, Is32 ? A & UINT32_MAX : A);
+}
+
+/// Check whether an instruction pushes a value without side effects.
+bool isPureValue(OpCode Code) noexcept {
+  switch (Code) {
+  case OpCode::Local__get:
+  case OpCode::Global__get:
+  case OpCode::I32__const:
+  case OpCode::I64__const:
+  case OpCode::F32__const:
+  case OpCode::F64__const:
+  case OpCode::Ref__null:
+  case OpCode::Ref__func:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool isLocalAccess(OpCode Code) noexcept {
+  return Code == OpCode::Local__get || Code == OpCode::Local__set ||
+         Code == OpCode::Local__tee;
+}
+
+/// Get the access size of a scalar memory instruction, or 0 for others.
+uint32_t getAccessSize(OpCode Code, bool &IsStore) noexcept {
+  IsStore = false;
+  switch (Code) {
+  case OpCode::I32__load8_s:
+  case OpCode::I32__load8_u:
+  case OpCode::I64__load8_s:
+  case OpCode::I64__load8_u:
+    return 1;
+  case OpCode::I32__load16_s:
+  case OpCode::I32__load16_u:
+  case OpCode::I64__load16_s:
+  case OpCode::I64__load16_u:
+    return 2;
+  case OpCode::I32__load:
+  case OpCode::F32__load:
+  case OpCode::I64__load32_s:
+  case OpCode::I64__load32_u:
+    return 4;
+  case OpCode::I64__load:
+  case OpCode::F64__load:
+    return 8;
+  case OpCode::I32__store8:
+  case OpCode::I64__store8:
+    IsStore = true;
+    return 1;
+  case OpCode::I32__store16:
+  case OpCode::I64__store16:
+    IsStore = true;
+    return 2;
+  case OpCode::I32__store:
+  case OpCode::F32__store:
+  case OpCode::I64__store32:
+    IsStore = true;
+    return 4;
+  case OpCode::I64__store:
+  case OpCode::F64__store:
+    IsStore = true;
+    return 8;
+  default:
+    return 0;
+  }
+}
+
+/// Check whether the control never reaches the next instruction.
+bool isUnconditionalBranch(OpCode Code) noexcept {
+  switch (Code) {
+  case OpCode::Unreachable:
+  case OpCode::Br:
+  case OpCode::Br_table:
+  case OpCode::Return:
+  case OpCode::Return_call:
+  case OpCode::Return_call_indirect:
+    return true;
+  default:
+    return false;
+  }
+}
+
+uint32_t getLocalNum(const AST::CodeSegment &CodeSeg, uint32_t ParamNum) {
+  uint64_t Num = ParamNum;
+  for (const auto &[Count, Type] : CodeSeg.getLocals()) {
+    Num += Count;
+  }
+  return static_cast<uint32_t>(
+      std::min<uint64_t>(Num, std::numeric_limits<uint32_t>::max()));
+}
+
+/// Inline the calls of the inlinable functions. The parameters of each callee
+/// are stored into new locals of the caller before its body.
+bool inlineCalls(AST::CodeSegment &CodeSeg, uint32_t ParamNum,
+                 const AST::Module &Mod, Span<const uint32_t> FuncTypes,
+                 const std::vector<bool> &Inlinable) {
+  const auto &Types = Mod.getTypeSection().getContent();
+  const auto &Codes = Mod.getCodeSection().getContent();
+  const size_t ImportNum = FuncTypes.size() - Codes.size();
+  auto &Instrs = CodeSeg.getExpr().getInstrs();
+  auto &Locals = CodeSeg.getLocals();
+  uint32_t LocalNum = getLocalNum(CodeSeg, ParamNum);
+  // The first local of the parameters of each callee.
+  std::unordered_map<uint32_t, uint32_t> Bases;
+  AST::InstrVec Out;
+  bool Changed = false;
+  for (const auto &Instr : Instrs) {
+    const uint32_t Callee = Instr.getTargetIndex();
+    if (Instr.getOpCode() != OpCode::Call || Callee < ImportNum ||
+        !Inlinable[Callee - ImportNum]) {
+      Out.push_back(Instr);
+      continue;
+    }
+    const auto &Params = Types[FuncTypes[Callee]].getParamTypes();
+    if (LocalNum > std::numeric_limits<uint32_t>::max() - Params.size()) {
+      Out.push_back(Instr);
+      continue;
+    }
+    auto [It, Added] = Bases.try_emplace(Callee, LocalNum);
+    if (Added) {
+      for (const auto Type : Params) {
+        if (!Locals.empty() && Locals.back().second == Type) {
+          ++Locals.back().first;
+        } else {
+          Locals.emplace_back(1, Type);
+        }
+      }
+      LocalNum += static_cast<uint32_t>(Params.size());
+    }
+    const uint32_t Base = It->second;
+    for (uint32_t I = static_cast<uint32_t>(Params.size()); I-- > 0;) {
+      auto &Set = Out.emplace_back(OpCode::Local__set, Instr.getOffset());
+      Set.getTargetIndex() = Base + I;
+    }
+    const auto Body = Codes[Callee - ImportNum].getExpr().getInstrs();
+    for (size_t I = 0; I + 1 < Body.size(); ++I) {
+      auto &Copy = Out.emplace_back(Body[I]);
+      if (isLocalAccess(Copy.getOpCode())) {
+        Copy.getTargetIndex() += Base;
+      }
+    }
+    Changed = true;
+  }
+  if (Changed) {
+    Instrs = std::move(Out);
+  }
+  return Changed;
+}
+
+/// Remove the locals which are never read. The writes of them become drops.
+bool removeDeadLocals(AST::CodeSegment &CodeSeg, uint32_t ParamNum) {
+  auto &Instrs = CodeSeg.getExpr().getInstrs();
+  const uint32_t LocalNum = getLocalNum(CodeSeg, ParamNum);
+  if (LocalNum == ParamNum) {
+    return false;
+  }
+  std::vector<bool> IsRead(LocalNum, false);
+  for (const auto &Instr : Instrs) {
+    if (Instr.getOpCode() == OpCode::Local__get) {
+      IsRead[Instr.getTargetIndex()] = true;
+    }
+  }
+  if (std::all_of(IsRead.begin() + ParamNum, IsRead.end(),
+                  [](bool B) { return B; })) {
+    return false;
+  }
+
+  // Renumber the locals which are read.
+  std::vector<uint32_t> NewIndex(LocalNum);
+  std::vector<std::pair<uint32_t, ValType>> NewLocals;
+  uint32_t Index = 0;
+  for (uint32_t I = 0; I < ParamNum; ++I) {
+    NewIndex[I] = Index++;
+  }
+  uint32_t Local = ParamNum;
+  for (const auto &[Count, Type] : CodeSeg.getLocals()) {
+    for (uint32_t I = 0; I < Count && Local < LocalNum; ++I, ++Local) {
+      if (!IsRead[Local]) {
+        continue;
+      }
+      NewIndex[Local] = Index++;
+      if (!NewLocals.empty() && NewLocals.back().second == Type) {
+        ++NewLocals.back().first;
+      } else {
+        NewLocals.emplace_back(1, Type);
+      }
+    }
+  }
+
+  AST::InstrVec Out;
+  Out.reserve(Instrs.size());
+  for (const auto &Instr : Instrs) {
+    if (!isLocalAccess(Instr.getOpCode())) {
+      Out.push_back(Instr);
+      continue;
+    }
+    const uint32_t Target = Instr.getTargetIndex();
+    if (IsRead[Target]) {
+      Out.emplace_back(Instr).getTargetIndex() = NewIndex[Target];
+    } else if (Instr.getOpCode() == OpCode::Local__set) {
+      Out.emplace_back(OpCode::Drop, Instr.getOffset());
+    }
+    // The tee of an unread local leaves its operand as is.
+  }
+  Instrs = std::move(Out);
+  CodeSeg.getLocals() = std::move(NewLocals);
+  return true;
+}
+
+void popBack(AST::InstrVec &Instrs, size_t N) {
+  for (size_t I = 0; I < N; ++I) {
+    Instrs.pop_back();
+  }
+}
+
+/// Apply the peephole rules to the end of the instructions until none
+/// applies. The instructions in the rules are adjacent, so that no branch can
+/// target the middle of them.
+void simplifyTail(AST::InstrVec &Out) {
+  while (Out.size() >= 2) {
+    const auto &Last = Out[Out.size() - 1];
+    const auto &Prev = Out[Out.size() - 2];
+    const OpCode Code = Last.getOpCode();
+    const OpCode PrevCode = Prev.getOpCode();
+
+    // Drop a value without side effects.
+    if (Code == OpCode::Drop && isPureValue(PrevCode)) {
+      popBack(Out, 2);
+      continue;
+    }
+    // `local.set x; local.get x` is `local.tee x`.
+    if (Code == OpCode::Local__get && PrevCode == OpCode::Local__set &&
+        Last.getTargetIndex() == Prev.getTargetIndex()) {
+      AST::Instruction Tee(OpCode::Local__tee, Prev.getOffset());
+      Tee.getTargetIndex() = Prev.getTargetIndex();
+      popBack(Out, 2);
+      Out.push_back(std::move(Tee));
+      continue;
+    }
+    if (!isIntConst(PrevCode)) {
+      break;
+    }
+    const uint64_t B = getConst(Prev);
+    const uint32_t Offset = Prev.getOffset();
+
+    // A constant condition of a branch or a select.
+    if (PrevCode == OpCode::I32__const) {
+      if (Code == OpCode::Br_if && B == 0) {
+        popBack(Out, 2);
+        continue;
+      }
+      if ((Code == OpCode::Select || Code == OpCode::Select_t) && B != 0) {
+        // Keep the first operand.
+        popBack(Out, 2);
+        Out.emplace_back(OpCode::Drop, Offset);
+        continue;
+      }
+    }
+    // An unary operation on a constant.
+    if (auto Res = foldUnary(PrevCode, B, Code)) {
+      auto Folded = makeConst(Res->first, Res->second, Offset);
+      popBack(Out, 2);
+      Out.push_back(std::move(Folded));
+      continue;
+    }
+    const auto Op = getIntOp(PrevCode, Code);
+    if (!Op) {
+      break;
+    }
+    // An operation which returns the left operand.
+    if (PrevCode == OpCode::I32__const
+            ? isIdentity<uint32_t>(*Op, static_cast<uint32_t>(B))
+            : isIdentity<uint64_t>(*Op, B)) {
+      popBack(Out, 2);
+      continue;
+    }
+    // A binary operation on two constants.
+    if (Out.size() < 3 || Out[Out.size() - 3].getOpCode() != PrevCode) {
+      break;
+    }
+    const uint64_t A = getConst(Out[Out.size() - 3]);
+    std::optional<uint64_t> Res;
+    if (PrevCode == OpCode::I32__const) {
+      Res = foldIntOp<uint32_t>(*Op, static_cast<uint32_t>(A),
+                                static_cast<uint32_t>(B));
+    } else {
+      Res = foldIntOp<uint64_t>(*Op, A, B);
+    }
+    if (!Res) {
+      // Leave the trap to the execution.
+      break;
+    }
+    auto Folded = makeConst(isCompare(*Op) ? OpCode::I32__const : PrevCode,
+                            *Res, Out[Out.size() - 3].getOffset());
+    popBack(Out, 3);
+    Out.push_back(std::move(Folded));
+  }
+}
+
+/// Fold the constants and remove the unreachable code.
+bool simplify(AST::InstrVec &Instrs) {
+  AST::InstrVec Out;
+  Out.reserve(Instrs.size());
+  for (size_t I = 0; I < Instrs.size(); ++I) {
+    Out.push_back(Instrs[I]);
+    simplifyTail(Out);
+    if (!isUnconditionalBranch(Instrs[I].getOpCode())) {
+      continue;
+    }
+    // Skip to the else or the end of the current block.
+    uint32_t Depth = 0;
+    while (I + 1 < Instrs.size()) {
+      const OpCode Code = Instrs[I + 1].getOpCode();
+      if (Code == OpCode::Block || Code == OpCode::Loop ||
+          Code == OpCode::If) {
+        ++Depth;
+      } else if (Code == OpCode::End || Code == OpCode::Else) {
+        if (Depth == 0) {
+          break;
+        }
+        if (Code == OpCode::End) {
+          --Depth;
+        }
+      }
+      ++I;
+    }
+  }
+  if (Out.size() == Instrs.size()) {
+    bool Same = true;
+    for (size_t I = 0; I < Out.size() && Same; ++I) {
+      Same = Out[I].getOpCode() == Instrs[I].getOpCode();
+    }
+    if (Same) {
+      return false;
+    }
+  }
+  Instrs = std::move(Out);
+  return true;
+}
+
+/// Mark the memory accesses whose address is a local, and whose range is
+/// covered by a previous access with the same local in the same basic block.
+/// The previous access has trapped if out of bounds, and the memory never
+/// shrinks.
+bool markInBoundsAccesses(AST::InstrVec &Instrs) {
+  // The checked end offsets of the accesses by the local and the memory.
+  std::map<std::pair<uint32_t, uint32_t>, uint64_t> Checked;
+  bool Changed = false;
+  for (size_t I = 0; I < Instrs.size(); ++I) {
+    auto &Instr = Instrs[I];
+    bool IsStore = false;
+    if (const uint32_t Size = getAccessSize(Instr.getOpCode(), IsStore)) {
+      const bool WasInBounds = Instr.isInBounds();
+      Instr.setInBounds(false);
+      // The address operand of a store is below the stored value.
+      const size_t Operands = IsStore ? 2 : 1;
+      if (I >= Operands &&
+          Instrs[I - Operands].getOpCode() == OpCode::Local__get &&
+          (!IsStore || isPureValue(Instrs[I - 1].getOpCode()))) {
+        const auto Key = std::make_pair(Instrs[I - Operands].getTargetIndex(),
+                                        Instr.getTargetIndex());
+        const uint64_t End =
+            static_cast<uint64_t>(Instr.getMemoryOffset()) + Size;
+        if (auto It = Checked.find(Key); It != Checked.end()) {
+          if (End <= It->second) {
+            Instr.setInBounds(true);
+          } else {
+            It->second = End;
+          }
+        } else {
+          Checked.emplace(Key, End);
+        }
+      }
+      Changed |= WasInBounds != Instr.isInBounds();
+      continue;
+    }
+    switch (Instr.getOpCode()) {
+    case OpCode::Local__set:
+    case OpCode::Local__tee:
+      for (auto It = Checked.begin(); It != Checked.end();) {
+        if (It->first.first == Instr.getTargetIndex()) {
+          It = Checked.erase(It);
+        } else {
+          ++It;
+        }
+      }
+      break;
+    case OpCode::Loop:
+    case OpCode::Else:
+    case OpCode::End:
+      // The branches join here.
+      Checked.clear();
+      break;
+    default:
+      break;
+    }
+  }
+  return Changed;
+}
+
+/// Update the jumps of the blocks, as in the loader.
+void relink(AST::InstrVec &Instrs) {
+  std::vector<uint32_t> BlockStack;
+  for (uint32_t I = 0; I < static_cast<uint32_t>(Instrs.size()); ++I) {
+    auto &Instr = Instrs[I];
+    switch (Instr.getOpCode()) {
+    case OpCode::If:
+      Instr.setJumpElse(0);
+      [[fallthrough]];
+    case OpCode::Block:
+    case OpCode::Loop:
+      BlockStack.push_back(I);
+      break;
+    case OpCode::Else:
+      Instrs[BlockStack.back()].setJumpElse(I - BlockStack.back());
+      break;
+    case OpCode::End: {
+      if (BlockStack.empty()) {
+        Instr.setLast(true);
+        break;
+      }
+      Instr.setLast(false);
+      const uint32_t Pos = BlockStack.back();
+      BlockStack.pop_back();
+      Instrs[Pos].setJumpEnd(I - Pos);
+      if (Instrs[Pos].getOpCode() == OpCode::If) {
+        if (Instrs[Pos].getJumpElse() == 0) {
+          Instrs[Pos].setJumpElse(I - Pos);
+        } else {
+          const uint32_t ElsePos = Pos + Instrs[Pos].getJumpElse();
+          Instrs[ElsePos].setJumpEnd(I - ElsePos);
+        }
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+}
+
+} // namespace
+
+bool Optimizer::isInlinable(const AST::CodeSegment &CodeSeg) noexcept {
+  const auto Instrs = CodeSeg.getExpr().getInstrs();
+  if (!CodeSeg.getLocals().empty() || Instrs.empty() ||
+      Instrs.size() - 1 > kMaxInlineSize) {
+    return false;
+  }
+  for (size_t I = 0; I + 1 < Instrs.size(); ++I) {
+    const uint16_t Code = toU16(Instrs[I].getOpCode());
+    // The parametric, variable, memory, and numeric instructions.
+    const bool Allowed =
+        (Code >= toU16(OpCode::Drop) && Code <= toU16(OpCode::Select_t)) ||
+        (Code >= toU16(OpCode::Local__get) &&
+         Code <= toU16(OpCode::Global__set)) ||
+        (Code >= toU16(OpCode::I32__load) &&
+         Code <= toU16(OpCode::I64__extend32_s));
+    if (!Allowed) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<uint32_t> Optimizer::optimize(AST::Module &Mod) {
+  // The type indices of the functions, with the imported ones first.
+  std::vector<uint32_t> FuncTypes;
+  for (const auto &ImpDesc : Mod.getImportSection().getContent()) {
+    if (ImpDesc.getExternalType() == ExternalType::Function) {
+      FuncTypes.push_back(ImpDesc.getExternalFuncTypeIdx());
+    }
+  }
+  const auto ImportNum = static_cast<uint32_t>(FuncTypes.size());
+  const auto &FuncSec = Mod.getFunctionSection().getContent();
+  FuncTypes.insert(FuncTypes.end(), FuncSec.begin(), FuncSec.end());
+
+  const auto &Types = Mod.getTypeSection().getContent();
+  auto &Codes = Mod.getCodeSection().getContent();
+  std::vector<uint32_t> Changed;
+  if (FuncTypes.size() != ImportNum + Codes.size()) {
+    return Changed;
+  }
+  std::vector<bool> Inlinable(Codes.size());
+  for (size_t I = 0; I < Codes.size(); ++I) {
+    Inlinable[I] = isInlinable(Codes[I]);
+  }
+
+  for (uint32_t I = 0; I < static_cast<uint32_t>(Codes.size()); ++I) {
+    auto &CodeSeg = Codes[I];
+    auto &Instrs = CodeSeg.getExpr().getInstrs();
+    const auto ParamNum = static_cast<uint32_t>(
+        Types[FuncTypes[ImportNum + I]].getParamTypes().size());
+    bool IsChanged = false;
+    // The inlined bodies are taken before or after the callee is optimized,
+    // which are both valid.
+    IsChanged |= inlineCalls(CodeSeg, ParamNum, Mod, FuncTypes, Inlinable);
+    IsChanged |= removeDeadLocals(CodeSeg, ParamNum);
+    IsChanged |= simplify(Instrs);
+    // The simplified tees may leave more locals unread.
+    while (removeDeadLocals(CodeSeg, ParamNum)) {
+      simplify(Instrs);
+      IsChanged = true;
+    }
+    IsChanged |= markInBoundsAccesses(Instrs);
+    if (IsChanged) {
+      relink(Instrs);
+      Changed.push_back(I);
+    }
+  }
+  return Changed;
+}
+
+} // namespace Validator
+} // namespace WasmEdge
@@ -5,6 +5,7 @@
 
 #include "common/errinfo.h"
 #include "common/log.h"
+#include "validator/optimizer.h"
 
 #include <array>
 #include <cstdint>
@@ -112,6 +113,24 @@ Expect<void> Validator::validate(const AST::Module &Mod) {
     return Unexpect(ErrCode::Value::MultiMemories);
   }
 
+  // Optimize the functions once, and validate the changed ones again to
+  // update the jumps and the stack offsets of their instructions.
+  if (Conf.getCompilerConfigure().isWasmOptimization() &&
+      !Mod.getIsValidated()) {
+    const auto &CodeVec = Mod.getCodeSection().getContent();
+    const auto &FuncVec = Checker.getFunctions();
+    const auto ImportNum = Checker.getNumImportFuncs();
+    Optimizer Opt;
+    for (const uint32_t Id : Opt.optimize(const_cast<AST::Module &>(Mod))) {
+      if (auto Res = validate(CodeVec[Id], FuncVec[ImportNum + Id]); !Res) {
+        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
+        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Code));
+        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+        return Unexpect(Res);
+      }
+    }
+  }
+
   // Set the validated flag.
   const_cast<AST::Module &>(Mod).setIsValidated();
   return {};
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "vm/pool.h"
+
+#include <chrono>
+
+namespace WasmEdge {
+namespace VM {
+
+namespace {
+uint64_t elapsedNanos(std::chrono::steady_clock::time_point Start) noexcept {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - Start)
+          .count());
+}
+} // namespace
+
+Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
+InstancePool::instantiate() {
+  const auto Start = std::chrono::steady_clock::now();
+  auto Res = ExecutorEngine.instantiateModule(StoreRef, Mod);
+  if (!Res) {
+    return Unexpect(Res);
+  }
+  const uint64_t Nanos = elapsedNanos(Start);
+
+  // Forget the instance if it is destroyed directly instead of released.
+  (*Res)->setDestroyCallback(
+      [Weak = std::weak_ptr<AcquiredSet>(Acquired)](
+          const Runtime::Instance::ModuleInstance *ModInst) {
+        if (auto Set = Weak.lock()) {
+          std::unique_lock Lock(Set->Mutex);
+          Set->Instances.erase(ModInst);
+        }
+      });
+
+  std::unique_lock Lock(Mutex);
+  Stat.InstantiateNanos += Nanos;
+  if (!Snapshot) {
+    // Capture the first instance before it is handed out and runs anything.
+    Snapshot = std::make_unique<const Runtime::ModuleSnapshot>(**Res);
+  }
+  return std::move(*Res);
+}
+
+void InstancePool::markAcquired(
+    const Runtime::Instance::ModuleInstance *ModInst) {
+  std::unique_lock Lock(Acquired->Mutex);
+  Acquired->Instances.insert(ModInst);
+}
+
+Expect<void> InstancePool::fill() {
+  while (true) {
+    {
+      std::unique_lock Lock(Mutex);
+      if (Idle.size() >= Capacity) {
+        return {};
+      }
+    }
+    if (auto Res = instantiate()) {
+      std::unique_lock Lock(Mutex);
+      Idle.push_back(std::move(*Res));
+    } else {
+      return Unexpect(Res);
+    }
+  }
+}
+
+Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
+InstancePool::acquire() {
+  {
+    std::unique_lock Lock(Mutex);
+    if (!Idle.empty()) {
+      auto ModInst = std::move(Idle.back());
+      Idle.pop_back();
+      markAcquired(ModInst.get());
+      ++Stat.Hits;
+      return ModInst;
+    }
+  }
+  auto Res = instantiate();
+  if (!Res) {
+    return Unexpect(Res);
+  }
+  markAcquired((*Res).get());
+  std::unique_lock Lock(Mutex);
+  ++Stat.Misses;
+  return std::move(*Res);
+}
+
+void InstancePool::release(
+    std::unique_ptr<Runtime::Instance::ModuleInstance> ModInst) {
+  if (!ModInst) {
+    return;
+  }
+  {
+    std::unique_lock Lock(Acquired->Mutex);
+    if (Acquired->Instances.erase(ModInst.get()) == 0) {
+      // Not acquired from this pool. Destroy it outside the lock.
+      Lock.unlock();
+      ModInst.reset();
+      return;
+    }
+  }
+  const Runtime::ModuleSnapshot *Snap;
+  {
+    std::unique_lock Lock(Mutex);
+    if (Idle.size() >= Capacity) {
+      ++Stat.Discards;
+      Lock.unlock();
+      ModInst.reset();
+      return;
+    }
+    Snap = Snapshot.get();
+  }
+
+  // The snapshot is set before the first instance is handed out and never
+  // replaced, so it can be used without holding the lock.
+  const auto Start = std::chrono::steady_clock::now();
+  const bool Restored = Snap->restore(*ModInst);
+  const uint64_t Nanos = elapsedNanos(Start);
+
+  std::unique_lock Lock(Mutex);
+  Stat.ResetNanos += Nanos;
+  // The other releases may have filled the pool during the reset.
+  if (Restored && Idle.size() < Capacity) {
+    ++Stat.Resets;
+    Idle.push_back(std::move(ModInst));
+  } else {
+    ++Stat.Discards;
+    Lock.unlock();
+    ModInst.reset();
+  }
+}
+
+InstancePool::Statistics InstancePool::getStatistics() const {
+  std::unique_lock Lock(Mutex);
+  Statistics Result = Stat;
+  Result.Idle = static_cast<uint32_t>(Idle.size());
+  std::unique_lock AcquiredLock(Acquired->Mutex);
+  Result.InUse = static_cast<uint32_t>(Acquired->Instances.size());
+  return Result;
+}
+
+} // namespace VM
+} // namespace WasmEdge
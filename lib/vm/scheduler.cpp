@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "vm/scheduler.h"
+
+#include "system/epoch.h"
+
+#include <algorithm>
+
+namespace WasmEdge {
+namespace VM {
+
+Expect<std::vector<std::pair<ValVariant, ValType>>>
+Scheduler::Task::wait() const {
+  std::unique_lock Lock(Mutex);
+  Cond.wait(Lock, [this]() { return Finished; });
+  if (Result != ErrCode::Value::Success) {
+    return Unexpect(Result);
+  }
+  const auto Returns = Cont->getReturns();
+  return std::vector<std::pair<ValVariant, ValType>>(Returns.begin(),
+                                                      Returns.end());
+}
+
+bool Scheduler::Task::isFinished() const noexcept {
+  std::unique_lock Lock(Mutex);
+  return Finished;
+}
+
+uint64_t Scheduler::Task::getSliceCount() const noexcept {
+  std::unique_lock Lock(Mutex);
+  return Slices;
+}
+
+std::chrono::nanoseconds Scheduler::Task::getRunTime() const noexcept {
+  std::unique_lock Lock(Mutex);
+  return RunTime;
+}
+
+void Scheduler::Task::finish(ErrCode Code) noexcept {
+  {
+    std::unique_lock Lock(Mutex);
+    Finished = true;
+    Result = Code;
+  }
+  Cond.notify_all();
+}
+
+Scheduler::Scheduler(const Options &O) : Opts(O) {
+  const uint32_t Num = std::max(Opts.Workers, UINT32_C(1));
+  Workers.reserve(Num);
+  for (uint32_t I = 0; I < Num; ++I) {
+    Workers.emplace_back([this]() { runWorker(); });
+  }
+}
+
+Scheduler::~Scheduler() noexcept {
+  {
+    std::unique_lock Lock(Mutex);
+    Stopped = true;
+  }
+  Cond.notify_all();
+  for (auto &Worker : Workers) {
+    Worker.join();
+  }
+  // The running slices have completed. Fail the tasks left in the queue.
+  for (auto &E : Ready) {
+    E.T->finish(ErrCode::Value::Interrupted);
+  }
+  Ready.clear();
+}
+
+void Scheduler::setTenantWeight(uint32_t Tenant, uint32_t Weight) {
+  std::unique_lock Lock(Mutex);
+  Tenants[Tenant].Weight = std::max(Weight, UINT32_C(1));
+}
+
+Expect<std::shared_ptr<Scheduler::Task>>
+Scheduler::submit(Executor::Executor &Exec,
+                  const Runtime::Instance::FunctionInstance &Func,
+                  Span<const ValVariant> Params,
+                  Span<const ValType> ParamTypes, uint32_t Tenant,
+                  int32_t Priority) {
+  auto Cont = Exec.createContinuation(Func, Params, ParamTypes);
+  if (!Cont) {
+    return Unexpect(Cont);
+  }
+  return submit(Exec, std::move(*Cont), Tenant, Priority);
+}
+
+Expect<std::shared_ptr<Scheduler::Task>>
+Scheduler::submit(VM &TargetVM, std::string_view Func,
+                  Span<const ValVariant> Params,
+                  Span<const ValType> ParamTypes, uint32_t Tenant,
+                  int32_t Priority) {
+  auto Cont = TargetVM.createContinuation(Func, Params, ParamTypes);
+  if (!Cont) {
+    return Unexpect(Cont);
+  }
+  return submit(TargetVM.getExecutor(), std::move(*Cont), Tenant, Priority);
+}
+
+std::shared_ptr<Scheduler::Task>
+Scheduler::submit(Executor::Executor &Exec,
+                  std::unique_ptr<Executor::Continuation> Cont,
+                  uint32_t Tenant, int32_t Priority) {
+  // The constructor is private, so the task cannot be made by make_shared.
+  std::shared_ptr<Task> T(new Task(Exec, std::move(Cont), Tenant, Priority));
+
+  std::unique_lock Lock(Mutex);
+  ++Stat.Submitted;
+  enqueue(T);
+  return T;
+}
+
+Scheduler::Statistics Scheduler::getStatistics() const {
+  std::unique_lock Lock(Mutex);
+  return Stat;
+}
+
+void Scheduler::enqueue(std::shared_ptr<Task> T) {
+  auto &Tenant = Tenants[T->Tenant];
+  // Do not let a tenant bank the time it has been idle.
+  Tenant.VRuntime = std::max(Tenant.VRuntime, MinVRuntime);
+  Ready.insert(Entry{T->Priority, Tenant.VRuntime, NextSeq++, std::move(T)});
+  Cond.notify_one();
+}
+
+void Scheduler::runWorker() {
+  std::unique_lock Lock(Mutex);
+  while (true) {
+    Cond.wait(Lock, [this]() { return Stopped || !Ready.empty(); });
+    if (Stopped) {
+      return;
+    }
+    auto Node = Ready.extract(Ready.begin());
+    auto T = std::move(Node.value().T);
+    MinVRuntime = std::max(MinVRuntime, Node.value().VRuntime);
+    Lock.unlock();
+
+    // Run a slice on this worker.
+    const auto Start = std::chrono::steady_clock::now();
+    const uint64_t SliceDeadline = Opts.Quantum.count() > 0
+                                       ? Epoch::deadline(Start + Opts.Quantum)
+                                       : Epoch::kNever;
+    auto Res = T->Exec.resume(*T->Cont, Opts.Fuel, SliceDeadline);
+    const auto Elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - Start);
+    {
+      std::unique_lock TaskLock(T->Mutex);
+      ++T->Slices;
+      T->RunTime += Elapsed;
+    }
+
+    Lock.lock();
+    ++Stat.Slices;
+    auto &Tenant = Tenants[T->Tenant];
+    Tenant.VRuntime +=
+        static_cast<uint64_t>(Elapsed.count()) * kWeightScale / Tenant.Weight;
+    if (!Res) {
+      ++Stat.Failed;
+      T->finish(Res.error());
+    } else if (*Res) {
+      ++Stat.Finished;
+      T->finish(ErrCode::Value::Success);
+    } else {
+      ++Stat.Suspends;
+      enqueue(std::move(T));
+    }
+  }
+}
+
+} // namespace VM
+} // namespace WasmEdge
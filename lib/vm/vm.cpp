@@ -257,6 +257,7 @@ VM::asyncRunWasmFile(const AST::Module &Module, std::string_view Func,
 Expect<void> VM::unsafeLoadWasm(const std::filesystem::path &Path) {
   // If not load successfully, the previous status will be reserved.
   if (auto Res = LoaderEngine.parseModule(Path)) {
+    Pool.reset();
     Mod = std::move(*Res);
     Stage = VMStage::Loaded;
   } else {
@@ -268,6 +269,7 @@ Expect<void> VM::unsafeLoadWasm(const std::filesystem::path &Path) {
 Expect<void> VM::unsafeLoadWasm(Span<const Byte> Code) {
   // If not load successfully, the previous status will be reserved.
   if (auto Res = LoaderEngine.parseModule(Code)) {
+    Pool.reset();
     Mod = std::move(*Res);
     Stage = VMStage::Loaded;
   } else {
@@ -277,17 +279,38 @@ Expect<void> VM::unsafeLoadWasm(Span<const Byte> Code) {
 }
 
 Expect<void> VM::unsafeLoadWasm(const AST::Module &Module) {
-  Mod = std::make_unique<AST::Module>(Module);
+  Pool.reset();
+  // Own a mutable copy, since the validation updates the instructions.
+  Mod = std::make_shared<AST::Module>(Module);
   Stage = VMStage::Loaded;
   return {};
 }
 
+Expect<void> VM::unsafeLoadWasm(std::shared_ptr<const AST::Module> Module) {
+  Pool.reset();
+  if (Module->getIsValidated()) {
+    // The validated module is immutable and never validated again.
+    Mod = std::move(Module);
+    Stage = VMStage::Validated;
+  } else {
+    // The module may be shared but is not validated yet, and the validation
+    // updates the instructions. Validate a copy owned by this VM instead.
+    Mod = std::make_shared<AST::Module>(*Module);
+    Stage = VMStage::Loaded;
+  }
+  return {};
+}
+
 Expect<void> VM::unsafeValidate() {
   if (Stage < VMStage::Loaded) {
     // When module is not loaded, not validate.
     spdlog::error(ErrCode::Value::WrongVMWorkflow);
     return Unexpect(ErrCode::Value::WrongVMWorkflow);
   }
+  if (Stage >= VMStage::Validated && Mod->getIsValidated()) {
+    // The validated module may be shared with other VMs, and it is immutable.
+    return {};
+  }
   if (auto Res = ValidatorEngine.validate(*Mod.get())) {
     Stage = VMStage::Validated;
     return {};
@@ -302,7 +325,7 @@ Expect<void> VM::unsafeInstantiate() {
     spdlog::error(ErrCode::Value::WrongVMWorkflow);
     return Unexpect(ErrCode::Value::WrongVMWorkflow);
   }
-  if (auto Res = ExecutorEngine.instantiateModule(StoreRef, *Mod.get())) {
+  if (auto Res = ExecutorEngine.instantiateModule(StoreRef, Mod)) {
     Stage = VMStage::Instantiated;
     ActiveModInst = std::move(*Res);
     return {};
@@ -311,6 +334,33 @@ Expect<void> VM::unsafeInstantiate() {
   }
 }
 
+Expect<void> VM::unsafeCreateInstancePool(uint32_t Capacity) {
+  if (Stage < VMStage::Validated) {
+    // When module is not validated, not instantiate.
+    spdlog::error(ErrCode::Value::WrongVMWorkflow);
+    return Unexpect(ErrCode::Value::WrongVMWorkflow);
+  }
+  Pool = std::make_unique<InstancePool>(ExecutorEngine, StoreRef, Mod,
+                                        Capacity);
+  return Pool->fill();
+}
+
+Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
+VM::unsafeAcquireInstance() {
+  if (!Pool) {
+    spdlog::error(ErrCode::Value::WrongVMWorkflow);
+    return Unexpect(ErrCode::Value::WrongVMWorkflow);
+  }
+  return Pool->acquire();
+}
+
+void VM::unsafeReleaseInstance(
+    std::unique_ptr<Runtime::Instance::ModuleInstance> ModInst) {
+  if (Pool) {
+    Pool->release(std::move(ModInst));
+  }
+}
+
 Expect<std::vector<std::pair<ValVariant, ValType>>>
 VM::unsafeExecute(std::string_view Func, Span<const ValVariant> Params,
                   Span<const ValType> ParamTypes) {
@@ -365,6 +415,25 @@ VM::unsafeExecute(const Runtime::Instance::ModuleInstance *ModInst,
   }
 }
 
+Expect<std::unique_ptr<Executor::Continuation>>
+VM::createContinuation(std::string_view Func, Span<const ValVariant> Params,
+                       Span<const ValType> ParamTypes) {
+  std::shared_lock Lock(Mutex);
+  const auto *ModInst = unsafeGetActiveModule();
+  if (unlikely(ModInst == nullptr)) {
+    spdlog::error(ErrCode::Value::WrongInstanceAddress);
+    spdlog::error(ErrInfo::InfoExecuting("", Func));
+    return Unexpect(ErrCode::Value::WrongInstanceAddress);
+  }
+  const auto *FuncInst = ModInst->findFuncExports(Func);
+  if (unlikely(FuncInst == nullptr)) {
+    spdlog::error(ErrCode::Value::FuncNotFound);
+    spdlog::error(ErrInfo::InfoExecuting(ModInst->getModuleName(), Func));
+    return Unexpect(ErrCode::Value::FuncNotFound);
+  }
+  return ExecutorEngine.createContinuation(*FuncInst, Params, ParamTypes);
+}
+
 Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>
 VM::asyncExecute(std::string_view Func, Span<const ValVariant> Params,
                  Span<const ValType> ParamTypes) {
@@ -392,6 +461,7 @@ VM::asyncExecute(std::string_view ModName, std::string_view Func,
 }
 
 void VM::unsafeCleanup() {
+  Pool.reset();
   Mod.reset();
   ActiveModInst.reset();
   Stat.clear();
@@ -75,7 +75,7 @@ Plugin::Plugin::PluginDescriptor Descriptor{
 } // namespace
 
 Plugin::PluginRegister WasiCrypto::Context::Register(&Descriptor);
-std::shared_mutex WasiCrypto::Context::Mutex;
+std::mutex WasiCrypto::Context::Mutex;
 std::weak_ptr<WasiCrypto::Context> WasiCrypto::Context::Instance;
 
 } // namespace Host
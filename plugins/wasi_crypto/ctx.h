@@ -36,7 +36,6 @@
 
 #include <memory>
 #include <mutex>
-#include <shared_mutex>
 
 namespace WasmEdge {
 namespace Host {
@@ -356,7 +355,7 @@ private:
                    Signatures::VerificationStateVariant>
       VerificationStateManager{0x02};
 
-  static std::shared_mutex Mutex;
+  static std::mutex Mutex;
   static std::weak_ptr<Context> Instance;
   static Plugin::PluginRegister Register;
 };
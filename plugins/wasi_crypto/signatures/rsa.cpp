@@ -89,7 +89,7 @@ Rsa<PadMode, KeyBits, ShaNid>::PublicKey::openVerificationState()
     const noexcept {
   EvpMdCtxPtr SignCtx{EVP_MD_CTX_create()};
   opensslCheck(EVP_DigestVerifyInit(
-      SignCtx.get(), nullptr, EVP_get_digestbynid(ShaNid), nullptr, Ctx.get()));
+      SignCtx.get(), nullptr, getShaCtx(), nullptr, Ctx.get()));
   opensslCheck(EVP_PKEY_CTX_set_rsa_padding(EVP_MD_CTX_pkey_ctx(SignCtx.get()),
                                             PadMode));
   return SignCtx;
@@ -218,7 +218,7 @@ WasiCryptoExpect<typename Rsa<PadMode, KeyBits, ShaNid>::SignState>
 Rsa<PadMode, KeyBits, ShaNid>::KeyPair::openSignState() const noexcept {
   EvpMdCtxPtr SignCtx{EVP_MD_CTX_create()};
   opensslCheck(EVP_DigestSignInit(
-      SignCtx.get(), nullptr, EVP_get_digestbynid(ShaNid), nullptr, Ctx.get()));
+      SignCtx.get(), nullptr, getShaCtx(), nullptr, Ctx.get()));
   opensslCheck(EVP_PKEY_CTX_set_rsa_padding(EVP_MD_CTX_pkey_ctx(SignCtx.get()),
                                             PadMode));
   return SignCtx;
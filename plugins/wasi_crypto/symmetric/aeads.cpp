@@ -71,9 +71,10 @@ Cipher<CipherNid>::State::open(const Key &Key,
   ensureOrReturn(getKeySize() == Key.ref().size(),
                  __WASI_CRYPTO_ERRNO_INVALID_HANDLE);
 
-  EvpCipherCtxPtr Ctx{EVP_CIPHER_CTX_new()};
-  opensslCheck(EVP_CipherInit_ex(Ctx.get(), EVP_get_cipherbynid(CipherNid),
-                                 nullptr, Key.ref().data(), Nonce.data(),
+  EvpCipherCtxPtr Ctx = acquireEvpCipherCtx();
+  opensslCheck(Ctx);
+  opensslCheck(EVP_CipherInit_ex(Ctx.get(), getEvpCipher<CipherNid>(), nullptr,
+                                 Key.ref().data(), Nonce.data(),
                                  Mode::Unchanged));
 
   return State{std::move(Ctx), Nonce};
@@ -211,7 +212,8 @@ Cipher<CipherNid>::State::decryptImpl(Span<uint8_t> Out,
 template <int CipherNid>
 WasiCryptoExpect<typename Cipher<CipherNid>::State>
 Cipher<CipherNid>::State::clone() const noexcept {
-  EvpCipherCtxPtr CloneCtx{EVP_CIPHER_CTX_new()};
+  EvpCipherCtxPtr CloneCtx = acquireEvpCipherCtx();
+  opensslCheck(CloneCtx);
 
   {
     std::scoped_lock Lock{Ctx->Mutex};
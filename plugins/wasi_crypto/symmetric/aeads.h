@@ -159,6 +159,7 @@ public:
       Inner(EvpCipherCtxPtr RawCtx,
             std::array<uint8_t, NonceSize> Nonce) noexcept
           : RawCtx(std::move(RawCtx)), Nonce(Nonce) {}
+      ~Inner() noexcept { releaseEvpCipherCtx(std::move(RawCtx)); }
       EvpCipherCtxPtr RawCtx;
       const std::array<uint8_t, NonceSize> Nonce;
       std::mutex Mutex;
@@ -25,8 +25,9 @@ template <int ShaNid> constexpr size_t Sha2<ShaNid>::getDigestSize() noexcept {
 template <int ShaNid>
 WasiCryptoExpect<typename Sha2<ShaNid>::State>
 Sha2<ShaNid>::State::open(OptionalRef<const Options>) noexcept {
-  EvpMdCtxPtr Ctx{EVP_MD_CTX_new()};
-  opensslCheck(EVP_DigestInit(Ctx.get(), EVP_get_digestbynid(ShaNid)));
+  EvpMdCtxPtr Ctx = acquireEvpMdCtx();
+  opensslCheck(Ctx);
+  opensslCheck(EVP_DigestInit_ex(Ctx.get(), getEvpMd<ShaNid>(), nullptr));
   return Ctx;
 }
 
@@ -44,7 +45,9 @@ Sha2<ShaNid>::State::squeeze(Span<uint8_t> Out) noexcept {
   ensureOrReturn(getDigestSize() >= Out.size(),
                  __WASI_CRYPTO_ERRNO_INVALID_LENGTH);
 
-  EvpMdCtxPtr CopyCtx{EVP_MD_CTX_new()};
+  // Finalize on a copy from the context cache, the state is unchanged.
+  EvpMdCtxPtr CopyCtx = acquireEvpMdCtx();
+  opensslCheck(CopyCtx);
 
   {
     std::shared_lock Lock{Ctx->Mutex};
@@ -68,13 +71,15 @@ Sha2<ShaNid>::State::squeeze(Span<uint8_t> Out) noexcept {
               Out.data());
   }
 
+  releaseEvpMdCtx(std::move(CopyCtx));
   return {};
 }
 
 template <int ShaNid>
 WasiCryptoExpect<typename Sha2<ShaNid>::State>
 Sha2<ShaNid>::State::clone() const noexcept {
-  EvpMdCtxPtr CloneCtx{EVP_MD_CTX_new()};
+  EvpMdCtxPtr CloneCtx = acquireEvpMdCtx();
+  opensslCheck(CloneCtx);
 
   {
     std::shared_lock Lock{Ctx->Mutex};
@@ -118,6 +118,7 @@ public:
   private:
     struct Inner {
       Inner(EvpMdCtxPtr Ctx) noexcept : RawCtx(std::move(Ctx)) {}
+      ~Inner() noexcept { releaseEvpMdCtx(std::move(RawCtx)); }
       EvpMdCtxPtr RawCtx;
       std::shared_mutex Mutex;
     };
@@ -25,8 +25,8 @@ template <int ShaNid> constexpr uint32_t Hkdf<ShaNid>::getKeySize() noexcept {
 }
 
 template <int ShaNid>
-constexpr const EVP_MD *Hkdf<ShaNid>::getShaCtx() noexcept {
-  return EVP_get_digestbynid(ShaNid);
+const EVP_MD *Hkdf<ShaNid>::getShaCtx() noexcept {
+  return getEvpMd<ShaNid>();
 }
 
 template <int ShaNid>
@@ -42,10 +42,11 @@ Hmac<ShaNid>::State::open(const Key &Key, OptionalRef<const Options>) noexcept {
       EVP_PKEY_HMAC, nullptr, Key.ref().data(), Key.ref().size())};
   opensslCheck(HmacKey);
 
-  EvpMdCtxPtr Ctx{EVP_MD_CTX_new()};
+  EvpMdCtxPtr Ctx = acquireEvpMdCtx();
+  opensslCheck(Ctx);
 
-  opensslCheck(EVP_DigestSignInit(
-      Ctx.get(), nullptr, EVP_get_digestbynid(ShaNid), nullptr, HmacKey.get()));
+  opensslCheck(EVP_DigestSignInit(Ctx.get(), nullptr, getEvpMd<ShaNid>(),
+                                  nullptr, HmacKey.get()));
 
   return Ctx;
 }
@@ -79,7 +80,8 @@ WasiCryptoExpect<Tag> Hmac<ShaNid>::State::squeezeTag() noexcept {
 template <int ShaNid>
 WasiCryptoExpect<typename Hmac<ShaNid>::State>
 Hmac<ShaNid>::State::clone() const noexcept {
-  EvpMdCtxPtr CloneCtx{EVP_MD_CTX_new()};
+  EvpMdCtxPtr CloneCtx = acquireEvpMdCtx();
+  opensslCheck(CloneCtx);
 
   {
     std::scoped_lock Lock{Ctx->Mutex};
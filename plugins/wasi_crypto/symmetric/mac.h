@@ -131,6 +131,7 @@ public:
   private:
     struct Inner {
       Inner(EvpMdCtxPtr RawCtx) noexcept : RawCtx(std::move(RawCtx)) {}
+      ~Inner() noexcept { releaseEvpMdCtx(std::move(RawCtx)); }
       EvpMdCtxPtr RawCtx;
       std::mutex Mutex;
     };
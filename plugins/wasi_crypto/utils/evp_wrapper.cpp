@@ -8,11 +8,81 @@
 #include <openssl/ec.h>
 
 #include <limits>
+#include <vector>
 
 namespace WasmEdge {
 namespace Host {
 namespace WasiCrypto {
 
+namespace {
+/// The maximum number of contexts cached per thread and per context type.
+constexpr const size_t kCtxCacheSize = 16;
+
+template <typename PtrType> std::vector<PtrType> &ctxCache() noexcept {
+  thread_local std::vector<PtrType> Cache;
+  return Cache;
+}
+
+template <typename PtrType, auto NewFn> PtrType acquireCtx() noexcept {
+  auto &Cache = ctxCache<PtrType>();
+  if (Cache.empty()) {
+    return PtrType{NewFn()};
+  }
+  PtrType Ctx = std::move(Cache.back());
+  Cache.pop_back();
+  return Ctx;
+}
+
+template <typename PtrType> void releaseCtx(PtrType Ctx) noexcept {
+  auto &Cache = ctxCache<PtrType>();
+  if (Cache.size() < kCtxCacheSize) {
+    Cache.push_back(std::move(Ctx));
+  }
+}
+} // namespace
+
+const EVP_MD *fetchEvpMd(int Nid) noexcept {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+  // The fetched digest is never freed, as it is shared until the process
+  // exits.
+  if (auto *Md = EVP_MD_fetch(nullptr, OBJ_nid2sn(Nid), nullptr)) {
+    return Md;
+  }
+#endif
+  return EVP_get_digestbynid(Nid);
+}
+
+const EVP_CIPHER *fetchEvpCipher(int Nid) noexcept {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+  // The fetched cipher is never freed, as it is shared until the process
+  // exits.
+  if (auto *Cipher = EVP_CIPHER_fetch(nullptr, OBJ_nid2sn(Nid), nullptr)) {
+    return Cipher;
+  }
+#endif
+  return EVP_get_cipherbynid(Nid);
+}
+
+EvpMdCtxPtr acquireEvpMdCtx() noexcept {
+  return acquireCtx<EvpMdCtxPtr, EVP_MD_CTX_new>();
+}
+
+void releaseEvpMdCtx(EvpMdCtxPtr Ctx) noexcept {
+  if (Ctx && EVP_MD_CTX_reset(Ctx.get())) {
+    releaseCtx(std::move(Ctx));
+  }
+}
+
+EvpCipherCtxPtr acquireEvpCipherCtx() noexcept {
+  return acquireCtx<EvpCipherCtxPtr, EVP_CIPHER_CTX_new>();
+}
+
+void releaseEvpCipherCtx(EvpCipherCtxPtr Ctx) noexcept {
+  if (Ctx && EVP_CIPHER_CTX_reset(Ctx.get())) {
+    releaseCtx(std::move(Ctx));
+  }
+}
+
 EVP_PKEY *pemReadPUBKEY(Span<const uint8_t> Encoded) {
   BioPtr Bio{BIO_new(BIO_s_mem())};
 
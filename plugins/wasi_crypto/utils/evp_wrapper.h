@@ -82,6 +82,42 @@ using RsaPtr = OpenSSLUniquePtr<RSA, RSA_free>;
           OPENSSL_die("assertion failed: " #Cond, __FILE__, __LINE__)))
 #endif
 
+/// Fetch the digest of the NID. On OpenSSL 3.0, it is explicitly fetched from
+/// the default provider, so the later init calls skip the implicit fetch.
+const EVP_MD *fetchEvpMd(int Nid) noexcept;
+
+/// Fetch the cipher of the NID. Same as `fetchEvpMd`.
+const EVP_CIPHER *fetchEvpCipher(int Nid) noexcept;
+
+/// The cached digest of the NID, fetched once per process.
+template <int Nid> const EVP_MD *getEvpMd() noexcept {
+  static const EVP_MD *const Md = fetchEvpMd(Nid);
+  return Md;
+}
+
+/// The cached cipher of the NID, fetched once per process.
+template <int Nid> const EVP_CIPHER *getEvpCipher() noexcept {
+  static const EVP_CIPHER *const Cipher = fetchEvpCipher(Nid);
+  return Cipher;
+}
+
+/// Get a digest context from the cache of the current thread, or a new one.
+/// The context must be initialized by the `EVP_Digest*Init_ex` functions or
+/// `EVP_MD_CTX_copy_ex` before use.
+EvpMdCtxPtr acquireEvpMdCtx() noexcept;
+
+/// Reset the digest context and keep it in the cache of the current thread.
+void releaseEvpMdCtx(EvpMdCtxPtr Ctx) noexcept;
+
+/// Get a cipher context from the cache of the current thread, or a new one.
+/// The context must be initialized by `EVP_CipherInit_ex` or
+/// `EVP_CIPHER_CTX_copy` before use.
+EvpCipherCtxPtr acquireEvpCipherCtx() noexcept;
+
+/// Reset the cipher context and keep it in the cache of the current thread.
+/// The reset cleanses the key material.
+void releaseEvpCipherCtx(EvpCipherCtxPtr Ctx) noexcept;
+
 /// OpenSSL encoding parse api is too confusing, simplify them.
 /// For example, `PEM_read_bio_PUBKEY` is equal to `pemReadPUBKEY`.
 
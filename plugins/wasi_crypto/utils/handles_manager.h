@@ -17,26 +17,53 @@
 
 #include "utils/error.h"
 
-#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstddef>
-#include <limits>
-#include <shared_mutex>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <type_traits>
-#include <unordered_map>
 #include <utility>
+#include <variant>
 
 namespace WasmEdge {
 namespace Host {
 namespace WasiCrypto {
 namespace detail {
 
+/// Index of the free list shard used by the current thread. The threads are
+/// spread over the shards in the order of their first use.
+inline size_t currentShard() noexcept {
+  static std::atomic<size_t> Counter = 0;
+  static thread_local const size_t Shard =
+      Counter.fetch_add(1, std::memory_order_relaxed);
+  return Shard;
+}
+
 /// The Handles Manager base class.
 ///
 /// @tparam HandleType This is the type of handle, notice it must be `32-bit
 /// long`.
 /// @tparam ManagerType The managed content type.
 ///
-/// HandlesManager uses handle as index to represent the managed contents.
+/// HandlesManager stores the managed contents in a slab of slots, which are
+/// allocated by segments and never move. A handle holds the slot index and the
+/// generation of the slot, so a closed handle is rejected after the slot is
+/// reused. Lookups only touch the state of their own slot, and the free slots
+/// are kept in FIFO lists sharded by thread. A slot is only reused after the
+/// other free slots of its list, so a stale handle aliases a new one only
+/// after millions of reuses.
+///
+/// A manager holds at most 65536 open handles, where the former map took 2^24
+/// handle numbers. The 32-bit handle cannot hold a wider index besides the
+/// type id and a generation wide enough to reject the stale handles, and the
+/// open handles of one type of a guest stay far below the limit in practice.
+/// Opening more fails with `__WASI_CRYPTO_ERRNO_TOO_MANY_HANDLES`.
 ///
 /// Referenced from:
 /// https://github.com/WebAssembly/wasi-crypto/blob/main/implementations/hostcalls/rust/src/handles.rs
@@ -47,79 +74,203 @@ public:
   BaseHandlesManager(BaseHandlesManager &&) noexcept = delete;
   BaseHandlesManager &operator=(BaseHandlesManager &&) noexcept = delete;
 
-  /// @param TypeID A unique number
-  BaseHandlesManager(uint8_t TypeID) noexcept : LastHandle{TypeID, 0} {}
+  /// @param TypeID A unique number less than 16
+  BaseHandlesManager(uint8_t TypeID) noexcept : TypeID(TypeID) {
+    assuming(TypeID < 16);
+  }
 
-  WasiCryptoExpect<void> close(HandleType Handle) noexcept {
-    std::unique_lock<std::shared_mutex> Lock{Mutex};
+  ~BaseHandlesManager() noexcept {
+    for (auto &Segment : Segments) {
+      delete Segment.load(std::memory_order_relaxed);
+    }
+  }
 
-    if (!Map.erase(HandleWrapper(Handle)))
+  WasiCryptoExpect<void> close(HandleType Handle) noexcept {
+    Slot *S = findSlot(Handle);
+    if (S == nullptr) {
       return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_CLOSED);
-
+    }
+    // Clear the occupied bit. The new readers are rejected from now on.
+    uint64_t State = S->State.load(std::memory_order_relaxed);
+    do {
+      if (!Slot::isHolding(State, Handle)) {
+        return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_CLOSED);
+      }
+    } while (!S->State.compare_exchange_weak(State, State & ~Slot::kOccupied,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed));
+    // Wait for the readers which have entered.
+    while (S->State.load(std::memory_order_acquire) & Slot::kReaderMask) {
+      std::this_thread::yield();
+    }
+    S->Value.reset();
+    freeIndex(HandleWrapper(Handle).Index);
     return {};
   }
 
   /// Constructor a new manager.
   template <typename... Args>
   WasiCryptoExpect<HandleType> registerManager(Args &&...Manager) noexcept {
-    std::unique_lock<std::shared_mutex> Lock{Mutex};
-
-    // Find a handle that can be used and emplace.
-    // Assume that LastHandle is 0x01000000, NextHandle is 0x01000001.
-    auto NextHandle = LastHandle.nextHandle();
-    while (true) {
-      // Try to emplace NextHandle.
-      if (Map.try_emplace(NextHandle, std::forward<Args>(Manager)...).second) {
-        // If success, emplace which indicate the NextHandle not exists in the
-        // managed content. Update the last handle and return it.
-        LastHandle = NextHandle;
-        return LastHandle.Handle;
-      }
-      // Otherwise, the NextHandle Map already exists a content, call NextHandle
-      // and loop.
-      NextHandle = NextHandle.nextHandle();
-
-      // If after looping `many times(2^24 - 1)`, we get 0x01000000 again.
-      if (NextHandle == LastHandle) {
-        // It indicates the hashmap is full.
-        return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_TOO_MANY_HANDLES);
-      }
+    const auto Index = allocIndex();
+    if (!Index) {
+      return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_TOO_MANY_HANDLES);
     }
+    Slot *S = getSlot(*Index);
+    // The generation is bumped on each reuse of the slot and skips 0, so no
+    // handle has the number 0.
+    const uint64_t State = S->State.load(std::memory_order_relaxed);
+    const HandleWrapper Last(static_cast<HandleType>(State >> 32));
+    uint16_t Generation = (Last.Generation + 1) & kGenerationMask;
+    if (Generation == 0) {
+      Generation = 1;
+    }
+    const HandleWrapper Handle(TypeID, Generation, *Index);
+    S->Value.emplace(std::forward<Args>(Manager)...);
+    S->State.store((static_cast<uint64_t>(Handle.Handle) << 32) |
+                       Slot::kOccupied,
+                   std::memory_order_release);
+    return Handle.Handle;
   }
 
 protected:
-  /// The handle internal representation as [-TypeID-|------CurrentNumber------]
+  static inline constexpr const uint32_t kGenerationMask = (1 << 12) - 1;
+
+  /// The handle internal representation as
+  /// [TypeID|--Generation--|------Index------] in 4, 12, and 16 bits.
   union HandleWrapper {
     static_assert(sizeof(HandleType) == 4, "HandleType must be 4 byte");
-    HandleWrapper(uint8_t TypeID, uint32_t CurrentNumber) noexcept
-        : TypeID(TypeID), CurrentNumber(CurrentNumber) {}
+    HandleWrapper(uint8_t TypeID, uint16_t Generation, uint16_t Index) noexcept
+        : Index(Index), Generation(Generation), TypeID(TypeID) {}
     explicit HandleWrapper(HandleType Handle) : Handle(Handle) {}
 
-    HandleWrapper nextHandle() noexcept {
-      return {TypeID, static_cast<uint32_t>(CurrentNumber + 1)};
+    struct {
+      uint32_t Index : 16;
+      uint32_t Generation : 12;
+      uint32_t TypeID : 4;
+    };
+    HandleType Handle;
+  };
+
+  /// Slot of the managed content.
+  struct Slot {
+    /// The state as [------Handle------|Occupied|-----Readers-----]
+    static inline constexpr const uint64_t kOccupied = UINT64_C(1) << 31;
+    static inline constexpr const uint64_t kReaderMask = kOccupied - 1;
+    static bool isHolding(uint64_t State, HandleType Handle) noexcept {
+      return (State & kOccupied) &&
+             static_cast<HandleType>(State >> 32) == Handle;
     }
 
-    struct Hash {
-      size_t operator()(const HandleWrapper &Wrapper) const noexcept {
-        return static_cast<size_t>(Wrapper.Handle);
+    std::atomic<uint64_t> State = 0;
+    std::optional<ManagerType> Value;
+  };
+
+  /// Read the content of the handle, if the handle is open.
+  template <typename Func>
+  auto read(HandleType Handle, Func &&F) noexcept
+      -> std::optional<decltype(F(std::declval<ManagerType &>()))> {
+    Slot *S = findSlot(Handle);
+    if (S == nullptr) {
+      return std::nullopt;
+    }
+    // Enter as a reader, which defers the closing of the slot.
+    uint64_t State = S->State.load(std::memory_order_relaxed);
+    do {
+      if (!Slot::isHolding(State, Handle)) {
+        return std::nullopt;
       }
-    };
+    } while (!S->State.compare_exchange_weak(State, State + 1,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed));
+    auto Result = F(*S->Value);
+    S->State.fetch_sub(1, std::memory_order_release);
+    return Result;
+  }
 
-    bool operator==(const HandleWrapper &Wrapper) const noexcept {
-      return Wrapper.Handle == this->Handle;
+  /// Get the slot of the handle. The slot may hold another handle.
+  Slot *findSlot(HandleType Handle) noexcept {
+    const HandleWrapper Wrapper(Handle);
+    if (Wrapper.TypeID != TypeID) {
+      return nullptr;
+    }
+    auto *Seg =
+        Segments[Wrapper.Index / kSegmentSize].load(std::memory_order_acquire);
+    if (Seg == nullptr) {
+      return nullptr;
     }
+    return &(*Seg)[Wrapper.Index % kSegmentSize];
+  }
 
-    struct {
-      uint8_t TypeID : 8;
-      uint32_t CurrentNumber : 24;
-    };
-    HandleType Handle;
+private:
+  static inline constexpr const size_t kMaxSlots = size_t(1) << 16;
+  static inline constexpr const size_t kSegmentSize = 256;
+  static inline constexpr const size_t kShardCount = 16;
+  /// Count of the free slots of a list kept before they are reused, while
+  /// there are unused slots.
+  static inline constexpr const size_t kMinFree = 256;
+  using Segment = std::array<Slot, kSegmentSize>;
+
+  /// Free list of a shard.
+  struct alignas(64) FreeList {
+    std::mutex Mutex;
+    std::deque<uint16_t> Indices;
   };
 
-  std::shared_mutex Mutex;
-  HandleWrapper LastHandle;
-  std::unordered_map<HandleWrapper, ManagerType, typename HandleWrapper::Hash>
-      Map;
+  Slot *getSlot(uint16_t Index) noexcept {
+    auto &Entry = Segments[Index / kSegmentSize];
+    auto *Seg = Entry.load(std::memory_order_acquire);
+    if (Seg == nullptr) {
+      auto *NewSeg = new Segment();
+      if (Entry.compare_exchange_strong(Seg, NewSeg,
+                                        std::memory_order_acq_rel)) {
+        Seg = NewSeg;
+      } else {
+        delete NewSeg;
+      }
+    }
+    return &(*Seg)[Index % kSegmentSize];
+  }
+
+  std::optional<uint16_t> allocIndex() noexcept {
+    const size_t Shard = currentShard();
+    // The oldest free slot of this thread if there are enough of them, then
+    // the unused slots, then any free slot.
+    if (auto Index = popFree(FreeLists[Shard % kShardCount], kMinFree)) {
+      return Index;
+    }
+    if (auto Index = NextIndex.fetch_add(1, std::memory_order_relaxed);
+        Index < kMaxSlots) {
+      return static_cast<uint16_t>(Index);
+    }
+    for (size_t I = 0; I < kShardCount; ++I) {
+      if (auto Index = popFree(FreeLists[(Shard + I) % kShardCount], 0)) {
+        return Index;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// Take the oldest index of the list if it has more than `Keep` indices.
+  static std::optional<uint16_t> popFree(FreeList &List, size_t Keep) noexcept {
+    std::unique_lock Lock(List.Mutex);
+    if (List.Indices.size() <= Keep) {
+      return std::nullopt;
+    }
+    const auto Index = List.Indices.front();
+    List.Indices.pop_front();
+    return Index;
+  }
+
+  void freeIndex(uint16_t Index) noexcept {
+    auto &List = FreeLists[currentShard() % kShardCount];
+    std::unique_lock Lock(List.Mutex);
+    List.Indices.push_back(Index);
+  }
+
+  const uint8_t TypeID;
+  std::atomic<size_t> NextIndex = 0;
+  std::array<std::atomic<Segment *>, kMaxSlots / kSegmentSize> Segments = {};
+  std::array<FreeList, kShardCount> FreeLists;
 };
 
 template <typename T, typename VariantType> struct IsVariantMember;
@@ -135,43 +286,40 @@ template <typename HandleType, typename ManagerType,
               false>
 class RcHandlesManager
     : public detail::BaseHandlesManager<HandleType, ManagerType> {
-  using HandleWrapper =
-      typename detail::BaseHandlesManager<HandleType,
-                                          ManagerType>::HandleWrapper;
-
 public:
+  using detail::BaseHandlesManager<HandleType, ManagerType>::BaseHandlesManager;
+
   /// Get the return copy.
   WasiCryptoExpect<ManagerType> get(HandleType Handle) noexcept {
-    std::shared_lock<std::shared_mutex> Lock{this->Mutex};
-
-    auto HandleValue = this->Map.find(HandleWrapper(Handle));
-    if (HandleValue == this->Map.end()) {
+    auto Value =
+        this->read(Handle, [](ManagerType &Value) noexcept { return Value; });
+    if (!Value) {
       return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_INVALID_HANDLE);
     }
-    return HandleValue->second;
+    return std::move(*Value);
   }
 
   /// Get as different variant type.
   template <typename RequiredVariantType>
   WasiCryptoExpect<RequiredVariantType> getAs(HandleType Handle) noexcept {
-    std::shared_lock<std::shared_mutex> Lock{this->Mutex};
+    auto Value = this->read(Handle, [](ManagerType &Value) noexcept {
+      return std::visit(
+          [](auto &&Value) noexcept -> WasiCryptoExpect<RequiredVariantType> {
+            using T = std::decay_t<decltype(Value)>;
+            if constexpr (detail::IsVariantMember<T,
+                                                  RequiredVariantType>::value) {
 
-    auto HandleValue = this->Map.find(HandleWrapper(Handle));
-    if (HandleValue == this->Map.end()) {
+              return Value;
+            } else {
+              return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_INVALID_HANDLE);
+            }
+          },
+          Value);
+    });
+    if (!Value) {
       return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_INVALID_HANDLE);
     }
-    return std::visit(
-        [](auto &&Value) noexcept -> WasiCryptoExpect<RequiredVariantType> {
-          using T = std::decay_t<decltype(Value)>;
-          if constexpr (detail::IsVariantMember<T,
-                                                RequiredVariantType>::value) {
-
-            return Value;
-          } else {
-            return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_INVALID_HANDLE);
-          }
-        },
-        HandleValue->second);
+    return std::move(*Value);
   }
 };
 
@@ -179,21 +327,19 @@ public:
 template <typename HandleType, typename ManagerType>
 class RefHandlesManager
     : public detail::BaseHandlesManager<HandleType, ManagerType> {
-  using HandleWrapper =
-      typename detail::BaseHandlesManager<HandleType,
-                                          ManagerType>::HandleWrapper;
-
 public:
+  using detail::BaseHandlesManager<HandleType, ManagerType>::BaseHandlesManager;
+
   /// Get the return reference.
   WasiCryptoExpect<std::reference_wrapper<ManagerType>>
   get(HandleType Handle) noexcept {
-    std::shared_lock<std::shared_mutex> Lock{this->Mutex};
-
-    auto HandleValue = this->Map.find(HandleWrapper(Handle));
-    if (HandleValue == this->Map.end()) {
+    auto Value = this->read(Handle, [](ManagerType &Value) noexcept {
+      return std::ref(Value);
+    });
+    if (!Value) {
       return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_INVALID_HANDLE);
     }
-    return HandleValue->second;
+    return *Value;
   }
 };
 
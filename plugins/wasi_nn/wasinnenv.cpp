@@ -2,6 +2,7 @@
 // SPDX-FileCopyrightText: 2019-2022 Second State INC
 
 #include "wasinnenv.h"
+#include "aot/blake3.h"
 #include "wasinnmodule.h"
 
 namespace WasmEdge {
@@ -33,6 +34,27 @@ Plugin::Plugin::PluginDescriptor Descriptor{
 
 } // namespace
 
+WASINN::GraphCache::Key
+WASINN::GraphCache::getKey(Backend BE, uint32_t Target,
+                           Span<const Span<const Byte>> Builders) noexcept {
+  // Length-prefix every builder so that different splits of the same bytes
+  // never collide.
+  AOT::Blake3 Hasher;
+  auto UpdateU32 = [&Hasher](uint32_t V) {
+    Hasher.update({reinterpret_cast<const Byte *>(&V), sizeof(V)});
+  };
+  UpdateU32(static_cast<uint32_t>(BE));
+  UpdateU32(Target);
+  UpdateU32(static_cast<uint32_t>(Builders.size()));
+  for (const auto &Builder : Builders) {
+    UpdateU32(static_cast<uint32_t>(Builder.size()));
+    Hasher.update(Builder);
+  }
+  Key Result;
+  Hasher.finalize(Result);
+  return Result;
+}
+
 Plugin::PluginRegister WASINN::WasiNNEnvironment::Register(&Descriptor);
 
 } // namespace Host
@@ -4,8 +4,14 @@
 #pragma once
 
 #include "common/log.h"
+#include "common/span.h"
 #include "plugin/plugin.h"
+
+#include <array>
 #include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
@@ -41,6 +47,8 @@ public:
     OpenVINOWeightBlob = nullptr;
 #endif
   }
+  Graph(const Graph &) = delete;
+  Graph &operator=(const Graph &) = delete;
   ~Graph() noexcept {
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
     if (OpenVINONetwork) {
@@ -67,6 +75,9 @@ public:
 
   Backend GraphBackend;
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
+  /// The core which loaded this graph. Held so that a cached graph outlives
+  /// the environment that created it.
+  std::shared_ptr<ie_core_t> OpenVINOCore;
   ie_network_t *OpenVINONetwork;
   ie_executable_network_t *OpenVINOExecNetwork;
   ie_blob_t *OpenVINOWeightBlob;
@@ -82,11 +93,12 @@ class Context {
 public:
   Context() = delete;
 
-  Context(Graph &G) noexcept : GraphRef(G) {
-    if (G.GraphBackend == Backend::OpenVINO) {
+  Context(std::shared_ptr<Graph> G) noexcept
+      : GraphPtr(std::move(G)), GraphRef(*GraphPtr) {
+    if (GraphRef.GraphBackend == Backend::OpenVINO) {
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
       IEStatusCode Status = ie_exec_network_create_infer_request(
-          G.OpenVINOExecNetwork, &OpenVINOInferRequest);
+          GraphRef.OpenVINOExecNetwork, &OpenVINOInferRequest);
       if (Status != IEStatusCode::OK) {
         OpenVINOInferRequest = nullptr;
         spdlog::error("[WASI-NN] Unable to create infer request for OpenVINO");
@@ -103,6 +115,7 @@ public:
 #endif
   }
 
+  std::shared_ptr<Graph> GraphPtr;
   Graph &GraphRef;
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
   ie_infer_request_t *OpenVINOInferRequest = nullptr;
@@ -113,13 +126,73 @@ public:
 #endif
 };
 
+/// Process-wide cache of loaded graphs, keyed by a BLAKE3 digest of the
+/// backend, target and graph builder bytes. A loaded graph is immutable and
+/// only read by the contexts created from it, so every environment loading
+/// the same model shares one compiled copy. Entries are weak; a graph is
+/// released once the last environment and context holding it are gone.
+class GraphCache {
+public:
+  using Key = std::array<Byte, 32>;
+
+  static GraphCache &getInstance() noexcept {
+    static GraphCache Instance;
+    return Instance;
+  }
+
+  /// Compute the cache key of a graph load request.
+  static Key getKey(Backend BE, uint32_t Target,
+                    Span<const Span<const Byte>> Builders) noexcept;
+
+  /// Find a live cached graph, or return nullptr.
+  std::shared_ptr<Graph> find(const Key &K) noexcept {
+    std::unique_lock Lock(Mutex);
+    if (auto Iter = Graphs.find(K); Iter != Graphs.end()) {
+      if (auto G = Iter->second.lock()) {
+        return G;
+      }
+      Graphs.erase(Iter);
+    }
+    return nullptr;
+  }
+
+  /// Publish a newly loaded graph. If another environment published the same
+  /// graph in the meantime, that one is returned and \p G is dropped.
+  std::shared_ptr<Graph> insert(const Key &K,
+                                std::shared_ptr<Graph> G) noexcept {
+    std::unique_lock Lock(Mutex);
+    for (auto Iter = Graphs.begin(); Iter != Graphs.end();) {
+      if (Iter->second.expired()) {
+        Iter = Graphs.erase(Iter);
+      } else {
+        ++Iter;
+      }
+    }
+    auto &Entry = Graphs[K];
+    if (auto Existing = Entry.lock()) {
+      return Existing;
+    }
+    Entry = G;
+    return G;
+  }
+
+private:
+  GraphCache() noexcept = default;
+
+  std::mutex Mutex;
+  std::map<Key, std::weak_ptr<Graph>> Graphs;
+};
+
 class WasiNNEnvironment {
 public:
   WasiNNEnvironment() noexcept {
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
-    if (ie_core_create("", &OpenVINOCore) != IEStatusCode::OK) {
+    ie_core_t *Core = nullptr;
+    if (ie_core_create("", &Core) != IEStatusCode::OK) {
       spdlog::error(
           "[WASI-NN] Error happened when initializing OpenVINO core.");
+    } else {
+      OpenVINOCore.reset(Core, [](ie_core_t *C) { ie_core_free(&C); });
     }
 #endif
     NNGraph.reserve(16U);
@@ -128,17 +201,12 @@ public:
   ~WasiNNEnvironment() noexcept {
     NNContext.clear();
     NNGraph.clear();
-#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
-    if (OpenVINOCore) {
-      ie_core_free(&OpenVINOCore);
-    }
-#endif
   }
 
-  std::vector<Graph> NNGraph;
+  std::vector<std::shared_ptr<Graph>> NNGraph;
   std::vector<Context> NNContext;
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
-  ie_core_t *OpenVINOCore = nullptr;
+  std::shared_ptr<ie_core_t> OpenVINOCore;
 #endif
 
   static Plugin::PluginRegister Register;
@@ -4,11 +4,13 @@
 #include "wasinnfunc.h"
 #include "common/log.h"
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
 #include <string>
 
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
-#include <algorithm>
-
 #include <c_api/ie_c_api.h>
 #endif
 
@@ -39,6 +41,328 @@ std::string FindDevice(const uint32_t Target) {
   }
   return DeviceName;
 }
+
+WASINN::ErrNo setInput(Runtime::Instance::MemoryInstance &MemInst
+                       [[maybe_unused]],
+                       WASINN::Context &CxtRef, uint32_t Index [[maybe_unused]],
+                       uint32_t TensorPtr [[maybe_unused]]) {
+  if (CxtRef.GraphRef.GraphBackend == WASINN::Backend::OpenVINO) {
+#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
+    // Check the infer request and the network.
+    auto *Network = CxtRef.GraphRef.OpenVINONetwork;
+    if (Network == nullptr || CxtRef.OpenVINOInferRequest == nullptr) {
+      spdlog::error("[WASI-NN] The founded openvino session is empty");
+      return WASINN::ErrNo::MissingMemory;
+    }
+
+    // Check the input index.
+    if (CxtRef.GraphRef.OpenVINOInputNames.size() <= Index) {
+      spdlog::error(
+          "[WASI-NN] The input index {} exceeds the inputs number {}.", Index,
+          CxtRef.GraphRef.OpenVINOInputNames.size());
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    char *InputName = CxtRef.GraphRef.OpenVINOInputNames[Index];
+
+    // Get the tensor.
+    // Tensor's Layout:
+    //   | dim buf | dim buf len | rtype | data buf | data buf len |
+    uint32_t *Tensor = MemInst.getPointer<uint32_t *>(TensorPtr, 5);
+    if (unlikely(Tensor == nullptr)) {
+      spdlog::error("[WASI-NN] Failed when accessing the Tensor memory.");
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    uint32_t DimensionLen = Tensor[1];
+    if (DimensionLen > 8) {
+      spdlog::error(
+          "[WASI-NN] Tensor dimension is out of range, expect it under 8-dim, "
+          "but got {}-dim.",
+          DimensionLen);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    uint32_t *DimensionBuf =
+        MemInst.getPointer<uint32_t *>(Tensor[0], DimensionLen);
+    if (unlikely(DimensionBuf == nullptr)) {
+      spdlog::error("[WASI-NN] Failed when accessing the Dimension memory.");
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    uint32_t TensorDataLen = Tensor[4];
+    uint8_t *TensorDataBuf =
+        MemInst.getPointer<uint8_t *>(Tensor[3], TensorDataLen);
+    if (unlikely(TensorDataBuf == nullptr)) {
+      spdlog::error("[WASI-NN] Failed when accessing the TensorData memory.");
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    uint32_t RType = Tensor[2];
+    if (RType != 1) {
+      spdlog::error(
+          "[WASI-NN] Only F32 inputs and outputs are supported for now.");
+      return WASINN::ErrNo::InvalidArgument;
+    }
+
+    // The network is configured at load time and shared by the contexts, so
+    // the tensor is only checked against the NHWC layout set there.
+    if (unlikely(DimensionLen != 4)) {
+      spdlog::error("[WASI-NN] Tensor dimension must be 4 for the NHWC "
+                    "layout, but got {}-dim.",
+                    DimensionLen);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+
+    // Set the dimensions and the tensor description.
+    dimensions_t Dimens;
+    Dimens.ranks = DimensionLen;
+    uint64_t ElementCount = 1;
+    for (size_t I = 0; I < Dimens.ranks; I++) {
+      Dimens.dims[I] = static_cast<size_t>(DimensionBuf[I]);
+      ElementCount *= DimensionBuf[I];
+    }
+    tensor_desc_t TensorDesc = {layout_e::NHWC, Dimens, precision_e::FP32};
+
+    if (unlikely(ElementCount * 4 != TensorDataLen)) {
+      spdlog::error("[WASI-NN] Tensor size {} and the dimensions {} not "
+                    "matched.",
+                    TensorDataLen, ElementCount * 4);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+
+    // Create the input blob memory. The data is copied, because the infer
+    // request keeps the blob after this call, and the linear memory can be
+    // changed or grown until the next compute.
+    ie_blob_t *InputBlob = nullptr;
+    IEStatusCode Status = ie_blob_make_memory(&TensorDesc, &InputBlob);
+    if (Status != IEStatusCode::OK) {
+      spdlog::error("[WASI-NN] Unable to allocated input tensor correctly, "
+                    "error code: {}",
+                    Status);
+      return WASINN::ErrNo::Busy;
+    }
+
+    // Get the blob buffer size and compare with the tensor size.
+    int BlobSize;
+    Status = ie_blob_size(InputBlob, &BlobSize);
+    if (unlikely(Status != IEStatusCode::OK)) {
+      spdlog::error(
+          "[WASI-NN] Unable to get the input blob size, error code: {}",
+          Status);
+      ie_blob_free(&InputBlob);
+      return WASINN::ErrNo::Busy;
+    }
+    if (unlikely(static_cast<uint64_t>(BlobSize) * 4 != TensorDataLen)) {
+      spdlog::error(
+          "[WASI-NN] Blob size {} and the Tensor size {} not matched.",
+          static_cast<uint64_t>(BlobSize) * 4, TensorDataLen);
+      ie_blob_free(&InputBlob);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+
+    // Copy the data into the input blob buffer.
+    ie_blob_buffer_t BlobBuffer;
+    Status = ie_blob_get_buffer(InputBlob, &BlobBuffer);
+    if (unlikely(Status != IEStatusCode::OK)) {
+      spdlog::error("[WASI-NN] Unable to find input tensor buffer");
+      ie_blob_free(&InputBlob);
+      return WASINN::ErrNo::MissingMemory;
+    }
+    std::copy_n(TensorDataBuf, TensorDataLen,
+                static_cast<uint8_t *>(BlobBuffer.buffer));
+
+    // Set input blob.
+    Status = ie_infer_request_set_blob(CxtRef.OpenVINOInferRequest, InputName,
+                                       InputBlob);
+    if (Status != IEStatusCode::OK) {
+      spdlog::error("[WASI-NN] Unable to set input tensor to model correctly, "
+                    "error code: {}",
+                    Status);
+      ie_blob_free(&InputBlob);
+      return WASINN::ErrNo::Busy;
+    }
+
+    ie_blob_free(&InputBlob);
+
+    return WASINN::ErrNo::Success;
+#else
+    spdlog::error("[WASI-NN] OpenVINO backend is not built. use "
+                  "-WASMEDGE_PLUGIN_WASI_NN_BACKEND=\"OpenVINO\" to build it.");
+#endif
+  } else if (CxtRef.GraphRef.GraphBackend == WASINN::Backend::PyTorch) {
+#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_TORCH
+    if (Index >= CxtRef.TorchInputs.size()) {
+      CxtRef.TorchInputs.resize(Index + 1);
+    }
+    uint32_t *Tensor = MemInst.getPointer<uint32_t *>(TensorPtr, 5);
+    if (unlikely(Tensor == nullptr)) {
+      spdlog::error("[WASI-NN] Failed when accessing the Tensor memory.");
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    uint32_t DimensionLen = Tensor[1];
+    uint32_t *DimensionBuf =
+        MemInst.getPointer<uint32_t *>(Tensor[0], DimensionLen);
+    if (unlikely(DimensionBuf == nullptr)) {
+      spdlog::error("[WASI-NN] Failed when accessing the Dimension memory.");
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    uint32_t TensorDataLen = Tensor[4];
+    uint8_t *TensorDataBuf =
+        MemInst.getPointer<uint8_t *>(Tensor[3], TensorDataLen);
+    if (unlikely(TensorDataBuf == nullptr)) {
+      spdlog::error("[WASI-NN] Failed when accessing the TensorData memory.");
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    uint32_t RType = Tensor[2];
+    if (RType != 1) {
+      spdlog::error(
+          "[WASI-NN] Only F32 inputs and outputs are supported for now.");
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    auto Options =
+        torch::TensorOptions().dtype(torch::kFloat32).requires_grad(false);
+    std::vector<int64_t> Dims;
+    uint64_t ElementCount = 1;
+    for (size_t I = 0; I < DimensionLen; I++) {
+      Dims.push_back(static_cast<int64_t>(DimensionBuf[I]));
+      ElementCount *= DimensionBuf[I];
+    }
+    if (unlikely(ElementCount * 4 != TensorDataLen)) {
+      spdlog::error("[WASI-NN] Tensor size {} and the dimensions {} not "
+                    "matched.",
+                    TensorDataLen, ElementCount * 4);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+
+    // The input is kept until the next compute, while the linear memory can
+    // be changed or grown, so the data is copied instead of aliased.
+    torch::Tensor InTensor = torch::empty(Dims, Options);
+    std::copy_n(TensorDataBuf, TensorDataLen,
+                static_cast<uint8_t *>(InTensor.data_ptr()));
+    CxtRef.TorchInputs[Index] = std::move(InTensor);
+    return WASINN::ErrNo::Success;
+#else
+    spdlog::error("[WASI-NN] PyTorch backend is not built. use "
+                  "-WASMEDGE_PLUGIN_WASI_NN_BACKEND=\"PyTorch\" to build it.");
+#endif
+  } else {
+    spdlog::error("[WASI-NN] Current backend is not supported.");
+  }
+  return WASINN::ErrNo::InvalidArgument;
+}
+
+WASINN::ErrNo getOutput(Runtime::Instance::MemoryInstance &MemInst
+                        [[maybe_unused]],
+                        WASINN::Context &CxtRef,
+                        uint32_t Index [[maybe_unused]],
+                        uint32_t OutBufferPtr [[maybe_unused]],
+                        uint32_t OutBufferMaxSize [[maybe_unused]],
+                        uint32_t BytesWrittenPtr [[maybe_unused]]) {
+  if (CxtRef.GraphRef.GraphBackend == WASINN::Backend::OpenVINO) {
+#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
+    // Check the output index.
+    if (CxtRef.GraphRef.OpenVINOOutputNames.size() <= Index) {
+      spdlog::error(
+          "[WASI-NN] The output index {} exceeds the outputs number {}.", Index,
+          CxtRef.GraphRef.OpenVINOOutputNames.size());
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    char *OutputName = CxtRef.GraphRef.OpenVINOOutputNames[Index];
+
+    // Get output blob buffer, which is FP32 as configured at load time.
+    ie_blob_t *OutputBlob = nullptr;
+    IEStatusCode Status = ie_infer_request_get_blob(
+        CxtRef.OpenVINOInferRequest, OutputName, &OutputBlob);
+    if (Status != IEStatusCode::OK) {
+      spdlog::error("[WASI-NN] Unable to retrieve output tensor correctly",
+                    Index);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+
+    // Get the blob size and copy the output buffer.
+    int BlobSize;
+    Status = ie_blob_size(OutputBlob, &BlobSize);
+    ie_blob_buffer_t BlobCBuffer;
+    Status = ie_blob_get_cbuffer(OutputBlob, &BlobCBuffer);
+    if (Status != IEStatusCode::OK) {
+      spdlog::error("[WASI-NN] Unable to retrieve output tensor correctly",
+                    Index);
+      ie_blob_free(&OutputBlob);
+      return WASINN::ErrNo::MissingMemory;
+    }
+    uint32_t BytesToWrite =
+        std::min(static_cast<uint32_t>(BlobSize * 4), OutBufferMaxSize);
+    uint8_t *OutBuffer =
+        MemInst.getPointer<uint8_t *>(OutBufferPtr, BytesToWrite);
+    if (unlikely(OutBuffer == nullptr)) {
+      spdlog::error(
+          "[WASI-NN] Failed when accessing the Output Buffer memory.");
+      ie_blob_free(&OutputBlob);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    std::copy_n(static_cast<const uint8_t *>(BlobCBuffer.cbuffer), BytesToWrite,
+                OutBuffer);
+
+    // Write the bytes written result.
+    uint32_t *BytesWritten =
+        MemInst.getPointer<uint32_t *>(BytesWrittenPtr, 1);
+    if (unlikely(BytesWritten == nullptr)) {
+      spdlog::error("[WASI-NN] Failed when accessing the BytesWritten memory.");
+      ie_blob_free(&OutputBlob);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    *BytesWritten = BytesToWrite;
+
+    ie_blob_free(&OutputBlob);
+
+    return WASINN::ErrNo::Success;
+#else
+    spdlog::error("[WASI-NN] OpenVINO backend is not built. use "
+                  "-WASMEDGE_PLUGIN_WASI_NN_BACKEND=\"OpenVINO\" to build it.");
+#endif
+  } else if (CxtRef.GraphRef.GraphBackend == WASINN::Backend::PyTorch) {
+#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_TORCH
+    if (CxtRef.TorchOutputs.size() <= Index) {
+      spdlog::error(
+          "[WASI-NN] The output index {} exceeds the outputs number {}.", Index,
+          CxtRef.TorchOutputs.size());
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    // The outputs are converted to contiguous F32 tensors in compute.
+    const torch::Tensor &OutTensor = CxtRef.TorchOutputs[Index];
+    const float *TensorBuffer = OutTensor.data_ptr<float>();
+    const size_t BlobSize = static_cast<size_t>(OutTensor.numel());
+    uint32_t BytesToWrite =
+        std::min(static_cast<uint32_t>(BlobSize * 4), OutBufferMaxSize);
+    uint8_t *OutBuffer =
+        MemInst.getPointer<uint8_t *>(OutBufferPtr, BytesToWrite);
+    if (unlikely(OutBuffer == nullptr)) {
+      spdlog::error(
+          "[WASI-NN] Failed when accessing the Output Buffer memory.");
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    std::copy_n(reinterpret_cast<const uint8_t *>(TensorBuffer), BytesToWrite,
+                OutBuffer);
+    uint32_t *BytesWritten =
+        MemInst.getPointer<uint32_t *>(BytesWrittenPtr, 1);
+    if (unlikely(BytesWritten == nullptr)) {
+      spdlog::error("[WASI-NN] Failed when accessing the BytesWritten memory.");
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    *BytesWritten = BytesToWrite;
+    return WASINN::ErrNo::Success;
+#else
+    spdlog::error("[WASI-NN] PyTorch backend is not built. use "
+                  "-WASMEDGE_PLUGIN_WASI_NN_BACKEND=\"PyTorch\" to build it.");
+#endif
+  } else {
+    spdlog::error("[WASI-NN] Current backend is not supported.");
+  }
+  return WASINN::ErrNo::InvalidArgument;
+}
+
+[[maybe_unused]] uint32_t addGraph(WASINN::WasiNNEnvironment &Env,
+                                   std::shared_ptr<WASINN::Graph> G) noexcept {
+  Env.NNGraph.push_back(std::move(G));
+  return static_cast<uint32_t>(Env.NNGraph.size() - 1);
+}
+
 } // namespace
 
 Expect<uint32_t> WasiNNLoad::body(const Runtime::CallingFrame &Frame,
@@ -110,9 +434,21 @@ Expect<uint32_t> WasiNNLoad::body(const Runtime::CallingFrame &Frame,
       return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
     }
 
-    // Add a new graph.
-    Env.NNGraph.emplace_back(static_cast<WASINN::Backend>(Encoding));
-    auto &Graph = Env.NNGraph.back();
+    // Reuse the graph if the same model was already loaded in this process.
+    const auto Key = WASINN::GraphCache::getKey(
+        WASINN::Backend::OpenVINO, Target,
+        std::array<Span<const Byte>, 2>{
+            Span<const Byte>(XMLPtr, XMLStringLen),
+            Span<const Byte>(BinPtr, WeightsBinLen)});
+    if (auto Cached = WASINN::GraphCache::getInstance().find(Key)) {
+      *GraphId = addGraph(Env, std::move(Cached));
+      return static_cast<uint32_t>(WASINN::ErrNo::Success);
+    }
+
+    // Create a new graph.
+    auto NewGraph = std::make_shared<WASINN::Graph>(WASINN::Backend::OpenVINO);
+    auto &Graph = *NewGraph;
+    Graph.OpenVINOCore = Env.OpenVINOCore;
 
     // Create the weights blob memory.
     tensor_desc_t WeightsDesc{
@@ -123,7 +459,6 @@ Expect<uint32_t> WasiNNLoad::body(const Runtime::CallingFrame &Frame,
       spdlog::error(
           "[WASI-NN] Unable to create the model's weight blob, error code: {}",
           Status);
-      Env.NNGraph.pop_back();
       return static_cast<uint32_t>(WASINN::ErrNo::Busy);
     }
 
@@ -134,7 +469,6 @@ Expect<uint32_t> WasiNNLoad::body(const Runtime::CallingFrame &Frame,
       spdlog::error(
           "[WASI-NN] Unable to find the weight blob's buffer, error code: {}",
           Status);
-      Env.NNGraph.pop_back();
       return static_cast<uint32_t>(WASINN::ErrNo::MissingMemory);
     }
     std::copy_n(BinPtr, WeightsBinLen,
@@ -142,13 +476,12 @@ Expect<uint32_t> WasiNNLoad::body(const Runtime::CallingFrame &Frame,
 
     // Read network from memory.
     Status = ie_core_read_network_from_memory(
-        Env.OpenVINOCore, XMLPtr, XMLStringLen, Graph.OpenVINOWeightBlob,
-        &(Graph.OpenVINONetwork));
+        Env.OpenVINOCore.get(), XMLPtr, XMLStringLen,
+        Graph.OpenVINOWeightBlob, &(Graph.OpenVINONetwork));
     if (Status != IEStatusCode::OK) {
       spdlog::error("[WASI-NN] Unable to read network from the XML and "
                     "Weights, error code: {}",
                     Status);
-      Env.NNGraph.pop_back();
       return static_cast<uint32_t>(WASINN::ErrNo::Busy);
     }
 
@@ -160,7 +493,6 @@ Expect<uint32_t> WasiNNLoad::body(const Runtime::CallingFrame &Frame,
       spdlog::error("[WASI-NN] Unable to get the inputs number from the "
                     "network, error code: {}",
                     Status);
-      Env.NNGraph.pop_back();
       return static_cast<uint32_t>(WASINN::ErrNo::MissingMemory);
     }
     spdlog::debug("[WASI-NN] Got input size: {}", NetworkInputSize);
@@ -171,7 +503,6 @@ Expect<uint32_t> WasiNNLoad::body(const Runtime::CallingFrame &Frame,
       spdlog::error("[WASI-NN] Unable to get the outputs number from the "
                     "network, error code: {}",
                     Status);
-      Env.NNGraph.pop_back();
       return static_cast<uint32_t>(WASINN::ErrNo::MissingMemory);
     }
     spdlog::debug("[WASI-NN] Got output size: {}", NetworkOutputSize);
@@ -185,7 +516,6 @@ Expect<uint32_t> WasiNNLoad::body(const Runtime::CallingFrame &Frame,
         spdlog::error("[WASI-NN] Unable to find input name correctly with "
                       "Index {}, error code: {}",
                       I, Status);
-        Env.NNGraph.pop_back();
         return static_cast<uint32_t>(WASINN::ErrNo::MissingMemory);
       }
       spdlog::debug("[WASI-NN] Got input name: {}",
@@ -199,47 +529,79 @@ Expect<uint32_t> WasiNNLoad::body(const Runtime::CallingFrame &Frame,
         spdlog::error("[WASI-NN] Unable to find output name correctly with "
                       "Index {}, error code: {}",
                       I, Status);
-        Env.NNGraph.pop_back();
         return static_cast<uint32_t>(WASINN::ErrNo::MissingMemory);
       }
       spdlog::debug("[WASI-NN] Got output name: {}",
                     Graph.OpenVINOOutputNames[I]);
     }
 
-    // Set the input layout.
+    // Configure the inputs and the outputs before the network is loaded. The
+    // graph is shared by the contexts through the graph cache, so it is not
+    // changed after this.
     // FIXME: this is a temporary workaround. We need a more eligant way to
     // specify the layout in the long run. However, without this newer versions
     // of OpenVINO will fail due to parameter mismatch.
     for (size_t I = 0; I < NetworkInputSize; I++) {
+      char *InputName = Graph.OpenVINOInputNames[I];
+      // Mark the input as resizable by setting a resize algorithm. In this
+      // case the input blob of any shape can be set to an infer request.
+      // Resizing and layout conversions are executed automatically when
+      // inferring.
+      Status = ie_network_set_input_resize_algorithm(
+          Graph.OpenVINONetwork, InputName, RESIZE_BILINEAR);
+      if (Status != IEStatusCode::OK) {
+        spdlog::error("[WASI-NN] Unable to set input resize with the input "
+                      "name {}, error code: {}",
+                      InputName, Status);
+        return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
+      }
       // More layouts should be supported.
-      Status = ie_network_set_input_layout(
-          Graph.OpenVINONetwork, Graph.OpenVINOInputNames[I], layout_e::NHWC);
-      spdlog::debug("[WASI-NN] Setting [{}] to NHWC",
-                    Graph.OpenVINOInputNames[I]);
+      Status = ie_network_set_input_layout(Graph.OpenVINONetwork, InputName,
+                                           layout_e::NHWC);
+      spdlog::debug("[WASI-NN] Setting [{}] to NHWC", InputName);
       if (Status != IEStatusCode::OK) {
         spdlog::error("[WASI-NN] Unable to set input layout with the input "
                       "name {}, error code: {}",
-                      Graph.OpenVINOInputNames[I], Status);
-        Env.NNGraph.pop_back();
+                      InputName, Status);
         return static_cast<uint32_t>(WASINN::ErrNo::MissingMemory);
       }
+      // More types should be supported.
+      Status = ie_network_set_input_precision(Graph.OpenVINONetwork,
+                                              InputName, precision_e::FP32);
+      if (Status != IEStatusCode::OK) {
+        spdlog::error("[WASI-NN] Unable to set input precision with the input "
+                      "name {}, error code: {}",
+                      InputName, Status);
+        return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
+      }
+    }
+    for (size_t I = 0; I < NetworkOutputSize; I++) {
+      Status = ie_network_set_output_precision(
+          Graph.OpenVINONetwork, Graph.OpenVINOOutputNames[I],
+          precision_e::FP32);
+      if (Status != IEStatusCode::OK) {
+        spdlog::error("[WASI-NN] Unable to set output precision with the "
+                      "output name {}, error code: {}",
+                      Graph.OpenVINOOutputNames[I], Status);
+        return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
+      }
     }
 
     // Load network.
     ie_config_t Config = {nullptr, nullptr, nullptr};
-    Status = ie_core_load_network(Env.OpenVINOCore, Graph.OpenVINONetwork,
-                                  DeviceName.c_str(), &Config,
-                                  &(Graph.OpenVINOExecNetwork));
+    Status = ie_core_load_network(
+        Env.OpenVINOCore.get(), Graph.OpenVINONetwork, DeviceName.c_str(),
+        &Config, &(Graph.OpenVINOExecNetwork));
     if (Status != IEStatusCode::OK) {
       spdlog::error(
           "[WASI-NN] Unable to create executable Network, error code: {}",
           Status);
-      Env.NNGraph.pop_back();
       return static_cast<uint32_t>(WASINN::ErrNo::Busy);
     }
 
     // Store the loaded graph.
-    *GraphId = Env.NNGraph.size() - 1;
+    *GraphId = addGraph(Env, WASINN::GraphCache::getInstance().insert(
+                                 Key, std::move(NewGraph)));
 
     return static_cast<uint32_t>(WASINN::ErrNo::Success);
 #else
@@ -274,9 +636,19 @@ Expect<uint32_t> WasiNNLoad::body(const Runtime::CallingFrame &Frame,
       spdlog::error("[WASI-NN] Failed when accessing the Weight memory.");
       return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
     }
-    // Add a new graph.
-    Env.NNGraph.emplace_back(static_cast<WASINN::Backend>(Encoding));
-    auto &Graph = Env.NNGraph.back();
+
+    // Reuse the graph if the same model was already loaded in this process.
+    const auto Key = WASINN::GraphCache::getKey(
+        WASINN::Backend::PyTorch, Target,
+        std::array<Span<const Byte>, 1>{Span<const Byte>(BinPtr, BinLen)});
+    if (auto Cached = WASINN::GraphCache::getInstance().find(Key)) {
+      *GraphId = addGraph(Env, std::move(Cached));
+      return static_cast<uint32_t>(WASINN::ErrNo::Success);
+    }
+
+    // Create a new graph.
+    auto NewGraph = std::make_shared<WASINN::Graph>(WASINN::Backend::PyTorch);
+    auto &Graph = *NewGraph;
     std::string BinString((char *)BinPtr, BinLen);
     std::stringstream BinRead;
     BinRead.str(BinString);
@@ -285,11 +657,11 @@ Expect<uint32_t> WasiNNLoad::body(const Runtime::CallingFrame &Frame,
       Graph.TorchModel = torch::jit::load(BinRead);
     } catch (const c10::Error &e) {
       spdlog::error("[WASI-NN] Failed when load the TorchScript model.");
-      Env.NNGraph.pop_back();
       return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
     }
     // Store the loaded graph.
-    *GraphId = Env.NNGraph.size() - 1;
+    *GraphId = addGraph(Env, WASINN::GraphCache::getInstance().insert(
+                                 Key, std::move(NewGraph)));
     return static_cast<uint32_t>(WASINN::ErrNo::Success);
 
 #else
@@ -320,11 +692,11 @@ Expect<uint32_t> WasiNNInitExecCtx::body(const Runtime::CallingFrame &Frame,
     spdlog::error("[WASI-NN] Failed when accessing the Context memory.");
     return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
   }
-  if (Env.NNGraph[GraphId].GraphBackend == WASINN::Backend::OpenVINO) {
+  if (Env.NNGraph[GraphId]->GraphBackend == WASINN::Backend::OpenVINO) {
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
     // Check the network and the execution network with the graph ID.
-    if (Env.NNGraph[GraphId].OpenVINONetwork == nullptr ||
-        Env.NNGraph[GraphId].OpenVINOExecNetwork == nullptr) {
+    if (Env.NNGraph[GraphId]->OpenVINONetwork == nullptr ||
+        Env.NNGraph[GraphId]->OpenVINOExecNetwork == nullptr) {
       spdlog::error("[WASI-NN] Model for Graph:{} is empty!", GraphId);
       return static_cast<uint32_t>(WASINN::ErrNo::MissingMemory);
     }
@@ -344,7 +716,7 @@ Expect<uint32_t> WasiNNInitExecCtx::body(const Runtime::CallingFrame &Frame,
     spdlog::error("[WASI-NN] OpenVINO backend is not built. use "
                   "-WASMEDGE_PLUGIN_WASI_NN_BACKEND=\"OpenVINO\" to build it.");
 #endif
-  } else if (Env.NNGraph[GraphId].GraphBackend == WASINN::Backend::PyTorch) {
+  } else if (Env.NNGraph[GraphId]->GraphBackend == WASINN::Backend::PyTorch) {
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_TORCH
     Env.NNContext.emplace_back(Env.NNGraph[GraphId]);
 
@@ -362,9 +734,8 @@ Expect<uint32_t> WasiNNInitExecCtx::body(const Runtime::CallingFrame &Frame,
 }
 
 Expect<uint32_t> WasiNNSetInput::body(const Runtime::CallingFrame &Frame,
-                                      uint32_t Context,
-                                      uint32_t Index [[maybe_unused]],
-                                      uint32_t TensorPtr [[maybe_unused]]) {
+                                      uint32_t Context, uint32_t Index,
+                                      uint32_t TensorPtr) {
   auto *MemInst = Frame.getMemoryByIndex(0);
   if (MemInst == nullptr) {
     return Unexpect(ErrCode::Value::HostFuncError);
@@ -375,215 +746,15 @@ Expect<uint32_t> WasiNNSetInput::body(const Runtime::CallingFrame &Frame,
     return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
   }
 
-  auto &CxtRef = Env.NNContext[Context];
-  if (CxtRef.GraphRef.GraphBackend == WASINN::Backend::OpenVINO) {
-#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
-    // Check the infer request and the network.
-    auto *Network = CxtRef.GraphRef.OpenVINONetwork;
-    if (Network == nullptr || CxtRef.OpenVINOInferRequest == nullptr) {
-      spdlog::error("[WASI-NN] The founded openvino session is empty");
-      return static_cast<uint32_t>(WASINN::ErrNo::MissingMemory);
-    }
-
-    // Check the input index.
-    if (CxtRef.GraphRef.OpenVINOInputNames.size() <= Index) {
-      spdlog::error(
-          "[WASI-NN] The input index {} exceeds the inputs number {}.", Index,
-          CxtRef.GraphRef.OpenVINOInputNames.size());
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-    char *InputName = CxtRef.GraphRef.OpenVINOInputNames[Index];
-
-    // Get the tensor.
-    // Tensor's Layout:
-    //   | dim buf | dim buf len | rtype | data buf | data buf len |
-    uint32_t *Tensor = MemInst->getPointer<uint32_t *>(TensorPtr, 5);
-    if (unlikely(Tensor == nullptr)) {
-      spdlog::error("[WASI-NN] Failed when accessing the Tensor memory.");
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-    uint32_t DimensionLen = Tensor[1];
-    if (DimensionLen > 8) {
-      spdlog::error(
-          "[WASI-NN] Tensor dimension is out of range, expect it under 8-dim, "
-          "but got {}-dim.",
-          DimensionLen);
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-    uint32_t *DimensionBuf =
-        MemInst->getPointer<uint32_t *>(Tensor[0], DimensionLen);
-    if (unlikely(DimensionBuf == nullptr)) {
-      spdlog::error("[WASI-NN] Failed when accessing the Dimension memory.");
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-    uint32_t TensorDataLen = Tensor[4];
-    uint8_t *TensorDataBuf =
-        MemInst->getPointer<uint8_t *>(Tensor[3], TensorDataLen);
-    if (unlikely(TensorDataBuf == nullptr)) {
-      spdlog::error("[WASI-NN] Failed when accessing the TensorData memory.");
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-    uint32_t RType = Tensor[2];
-    if (RType != 1) {
-      spdlog::error(
-          "[WASI-NN] Only F32 inputs and outputs are supported for now.");
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-
-    // Set the input resize algorithm.
-    // Mark the input as resizable by setting a resize algorithm.
-    // In this case we will be able to set an input blob of any shape to an
-    // infer request. Resizing and layout conversions are executed automatically
-    // when inferring.
-    IEStatusCode Status = ie_network_set_input_resize_algorithm(
-        Network, InputName, RESIZE_BILINEAR);
-    if (Status != IEStatusCode::OK) {
-      spdlog::error(
-          "[WASI-NN] Unable to set input resize correctly, error code: {}",
-          Status);
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-
-    // Set the input layout.
-    // More layouts should be supported.
-    Status = ie_network_set_input_layout(Network, InputName, layout_e::NHWC);
-    if (Status != IEStatusCode::OK) {
-      spdlog::error(
-          "[WASI-NN] Unable to set input layout correctly, error code: {}",
-          Status);
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-
-    // Set the input precision.
-    // More types should be supported.
-    Status =
-        ie_network_set_input_precision(Network, InputName, precision_e::FP32);
-    if (Status != IEStatusCode::OK) {
-      spdlog::error(
-          "[WASI-NN] Unable to set input precision correctly, error code: {}",
-          Status);
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-
-    // Set the dimensions and the tensor description.
-    dimensions_t Dimens;
-    Dimens.ranks = DimensionLen;
-    for (size_t I = 0; I < Dimens.ranks; I++) {
-      Dimens.dims[I] = static_cast<size_t>(DimensionBuf[I]);
-    }
-    tensor_desc_t TensorDesc = {layout_e::NHWC, Dimens, precision_e::FP32};
-
-    // Create the input blob memory.
-    ie_blob_t *InputBlob = nullptr;
-    Status = ie_blob_make_memory(&TensorDesc, &InputBlob);
-    if (Status != IEStatusCode::OK) {
-      spdlog::error("[WASI-NN] Unable to allocated input tensor correctly, "
-                    "error code: {}",
-                    Status);
-      return static_cast<uint32_t>(WASINN::ErrNo::Busy);
-    }
-
-    // Get the blob buffer size and compare with the tensor size.
-    int BlobSize;
-    Status = ie_blob_size(InputBlob, &BlobSize);
-    if (unlikely(Status != IEStatusCode::OK)) {
-      spdlog::error(
-          "[WASI-NN] Unable to get the input blob size, error code: {}",
-          Status);
-      return static_cast<uint32_t>(WASINN::ErrNo::Busy);
-    }
-    if (unlikely(static_cast<uint32_t>(BlobSize * 4) != TensorDataLen)) {
-      spdlog::error(
-          "[WASI-NN] Blob size {} and the Tensor size {} not matched.",
-          BlobSize * 4, TensorDataLen);
-    }
-
-    // Copy the data into the input blob buffer.
-    ie_blob_buffer_t BlobBuffer;
-    Status = ie_blob_get_buffer(InputBlob, &BlobBuffer);
-    if (unlikely(Status != IEStatusCode::OK)) {
-      spdlog::error("[WASI-NN] Unable to find input tensor buffer");
-      ie_blob_free(&InputBlob);
-      return static_cast<uint32_t>(WASINN::ErrNo::MissingMemory);
-    }
-    std::copy_n(TensorDataBuf, TensorDataLen,
-                static_cast<uint8_t *>(BlobBuffer.buffer));
-
-    // Set input blob.
-    Status = ie_infer_request_set_blob(CxtRef.OpenVINOInferRequest, InputName,
-                                       InputBlob);
-    if (Status != IEStatusCode::OK) {
-      spdlog::error("[WASI-NN] Unable to set input tensor to model correctly, "
-                    "error code: {}",
-                    Status);
-      ie_blob_free(&InputBlob);
-      return static_cast<uint32_t>(WASINN::ErrNo::Busy);
-    }
-
-    ie_blob_free(&InputBlob);
-
-    return static_cast<uint32_t>(WASINN::ErrNo::Success);
-#else
-    spdlog::error("[WASI-NN] OpenVINO backend is not built. use "
-                  "-WASMEDGE_PLUGIN_WASI_NN_BACKEND=\"OpenVINO\" to build it.");
-#endif
-  } else if (CxtRef.GraphRef.GraphBackend == WASINN::Backend::PyTorch) {
-#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_TORCH
-    if (Index >= CxtRef.TorchInputs.size()) {
-      CxtRef.TorchInputs.resize(Index + 1);
-    }
-    uint32_t *Tensor = MemInst->getPointer<uint32_t *>(TensorPtr, 5);
-    if (unlikely(Tensor == nullptr)) {
-      spdlog::error("[WASI-NN] Failed when accessing the Tensor memory.");
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-    uint32_t DimensionLen = Tensor[1];
-    uint32_t *DimensionBuf =
-        MemInst->getPointer<uint32_t *>(Tensor[0], DimensionLen);
-    if (unlikely(DimensionBuf == nullptr)) {
-      spdlog::error("[WASI-NN] Failed when accessing the Dimension memory.");
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-    uint32_t TensorDataLen = Tensor[4];
-    uint8_t *TensorDataBuf =
-        MemInst->getPointer<uint8_t *>(Tensor[3], TensorDataLen);
-    if (unlikely(TensorDataBuf == nullptr)) {
-      spdlog::error("[WASI-NN] Failed when accessing the TensorData memory.");
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-    uint32_t RType = Tensor[2];
-    if (RType != 1) {
-      spdlog::error(
-          "[WASI-NN] Only F32 inputs and outputs are supported for now.");
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-    auto Options =
-        torch::TensorOptions().dtype(torch::kFloat32).requires_grad(false);
-    std::vector<int64_t> Dims;
-    for (size_t I = 0; I < DimensionLen; I++) {
-      Dims.push_back(static_cast<int64_t>(DimensionBuf[I]));
-    }
-    torch::Tensor InTensor = torch::from_blob(
-        reinterpret_cast<float *>(TensorDataBuf), Dims, Options);
-
-    CxtRef.TorchInputs[Index] = InTensor.clone();
-    return static_cast<uint32_t>(WASINN::ErrNo::Success);
-#else
-    spdlog::error("[WASI-NN] PyTorch backend is not built. use "
-                  "-WASMEDGE_PLUGIN_WASI_NN_BACKEND=\"PyTorch\" to build it.");
-#endif
-  } else {
-    spdlog::error("[WASI-NN] Current backend is not supported.");
-  }
-  return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
+  return static_cast<uint32_t>(
+      setInput(*MemInst, Env.NNContext[Context], Index, TensorPtr));
 }
 
-Expect<uint32_t>
-WasiNNGetOuput::body(const Runtime::CallingFrame &Frame, uint32_t Context,
-                     uint32_t Index [[maybe_unused]],
-                     uint32_t OutBufferPtr [[maybe_unused]],
-                     uint32_t OutBufferMaxSize [[maybe_unused]],
-                     uint32_t BytesWrittenPtr [[maybe_unused]]) {
+Expect<uint32_t> WasiNNGetOuput::body(const Runtime::CallingFrame &Frame,
+                                      uint32_t Context, uint32_t Index,
+                                      uint32_t OutBufferPtr,
+                                      uint32_t OutBufferMaxSize,
+                                      uint32_t BytesWrittenPtr) {
   auto *MemInst = Frame.getMemoryByIndex(0);
   if (MemInst == nullptr) {
     return Unexpect(ErrCode::Value::HostFuncError);
@@ -594,124 +765,87 @@ WasiNNGetOuput::body(const Runtime::CallingFrame &Frame, uint32_t Context,
     return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
   }
 
-  auto &CxtRef = Env.NNContext[Context];
-  if (CxtRef.GraphRef.GraphBackend == WASINN::Backend::OpenVINO) {
-#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
-    auto *Network = CxtRef.GraphRef.OpenVINONetwork;
+  return static_cast<uint32_t>(getOutput(*MemInst, Env.NNContext[Context],
+                                        Index, OutBufferPtr, OutBufferMaxSize,
+                                        BytesWrittenPtr));
+}
 
-    // Check the output index.
-    if (CxtRef.GraphRef.OpenVINOOutputNames.size() <= Index) {
-      spdlog::error(
-          "[WASI-NN] The output index {} exceeds the outputs number {}.", Index,
-          CxtRef.GraphRef.OpenVINOOutputNames.size());
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-    char *OutputName = CxtRef.GraphRef.OpenVINOOutputNames[Index];
+Expect<uint32_t> WasiNNSetInputs::body(const Runtime::CallingFrame &Frame,
+                                       uint32_t Context, uint32_t TensorsPtr,
+                                       uint32_t TensorsLen) {
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  if (MemInst == nullptr) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
 
-    // Set output precision.
-    IEStatusCode Status =
-        ie_network_set_output_precision(Network, OutputName, precision_e::FP32);
-    if (Status != IEStatusCode::OK) {
-      spdlog::error(
-          "[WASI-NN] Unable to set output precision correctly with Index:{}",
-          Index);
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
+  if (Env.NNContext.size() <= Context) {
+    spdlog::error("[WASI-NN] set_inputs: Execution Context does not exist.");
+    return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
+  }
 
-    // Get output blob buffer.
-    ie_blob_t *OutputBlob = nullptr;
-    Status = ie_infer_request_get_blob(CxtRef.OpenVINOInferRequest, OutputName,
-                                       &OutputBlob);
-    if (Status != IEStatusCode::OK) {
-      spdlog::error("[WASI-NN] Unable to retrieve output tensor correctly",
-                    Index);
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
+  // Check the tensor array. Each tensor takes 5 uint32 in the layout of
+  // set_input.
+  if (TensorsLen > std::numeric_limits<uint32_t>::max() / 20 ||
+      MemInst->getPointer<uint32_t *>(TensorsPtr, TensorsLen * 5) == nullptr) {
+    spdlog::error("[WASI-NN] Failed when accessing the Tensors memory.");
+    return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
+  }
 
-    // Get the blob size and copy the output buffer.
-    int BlobSize;
-    Status = ie_blob_size(OutputBlob, &BlobSize);
-    ie_blob_buffer_t BlobCBuffer;
-    Status = ie_blob_get_cbuffer(OutputBlob, &BlobCBuffer);
-    if (Status != IEStatusCode::OK) {
-      spdlog::error("[WASI-NN] Unable to retrieve output tensor correctly",
-                    Index);
-      ie_blob_free(&OutputBlob);
-      return static_cast<uint32_t>(WASINN::ErrNo::MissingMemory);
-    }
-    uint32_t BytesToWrite =
-        std::min(static_cast<uint32_t>(BlobSize * 4), OutBufferMaxSize);
-    uint8_t *OutBuffer =
-        MemInst->getPointer<uint8_t *>(OutBufferPtr, BytesToWrite);
-    if (unlikely(OutBuffer == nullptr)) {
-      spdlog::error(
-          "[WASI-NN] Failed when accessing the Output Buffer memory.");
-      ie_blob_free(&OutputBlob);
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
+  // The I-th tensor is set to the I-th input.
+  auto &CxtRef = Env.NNContext[Context];
+  for (uint32_t I = 0; I < TensorsLen; ++I) {
+    if (auto Res = setInput(*MemInst, CxtRef, I, TensorsPtr + I * 20);
+        Res != WASINN::ErrNo::Success) {
+      return static_cast<uint32_t>(Res);
     }
-    std::copy_n(static_cast<const uint8_t *>(BlobCBuffer.cbuffer), BytesToWrite,
-                OutBuffer);
+  }
+  return static_cast<uint32_t>(WASINN::ErrNo::Success);
+}
 
-    // Write the bytes written result.
-    uint32_t *BytesWritten =
-        MemInst->getPointer<uint32_t *>(BytesWrittenPtr, 1);
-    if (unlikely(BytesWritten == nullptr)) {
-      spdlog::error("[WASI-NN] Failed when accessing the BytesWritten memory.");
-      ie_blob_free(&OutputBlob);
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-    *BytesWritten = BytesToWrite;
+Expect<uint32_t> WasiNNGetOutputs::body(const Runtime::CallingFrame &Frame,
+                                        uint32_t Context,
+                                        uint32_t OutBuffersPtr,
+                                        uint32_t OutBuffersLen,
+                                        uint32_t BytesWrittenPtr) {
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  if (MemInst == nullptr) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
 
-    ie_blob_free(&OutputBlob);
+  if (Env.NNContext.size() <= Context) {
+    spdlog::error("[WASI-NN] get_outputs: Execution Context does not exist.");
+    return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
+  }
 
-    return static_cast<uint32_t>(WASINN::ErrNo::Success);
-#else
-    spdlog::error("[WASI-NN] OpenVINO backend is not built. use "
-                  "-WASMEDGE_PLUGIN_WASI_NN_BACKEND=\"OpenVINO\" to build it.");
-#endif
-  } else if (CxtRef.GraphRef.GraphBackend == WASINN::Backend::PyTorch) {
-#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_TORCH
-    if (CxtRef.TorchOutputs.size() <= Index) {
-      spdlog::error(
-          "[WASI-NN] The output index {} exceeds the outputs number {}.", Index,
-          CxtRef.TorchOutputs.size());
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-    torch::Tensor OutTensor =
-        CxtRef.TorchOutputs[Index].toType(torch::kFloat32);
-    float *TensorBuffer = OutTensor.data_ptr<float>();
+  // Check the output buffer array and the bytes written array.
+  // OutBuffers' Layout:
+  //   | buffer-0 | buffer-0 max size | buffer-1 | buffer-1 max size | ...
+  if (OutBuffersLen > std::numeric_limits<uint32_t>::max() / 8) {
+    spdlog::error("[WASI-NN] Too many output buffers {}.", OutBuffersLen);
+    return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
+  }
+  const uint32_t *OutBuffers =
+      MemInst->getPointer<const uint32_t *>(OutBuffersPtr, OutBuffersLen * 2);
+  if (unlikely(OutBuffers == nullptr)) {
+    spdlog::error("[WASI-NN] Failed when accessing the OutBuffers memory.");
+    return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
+  }
+  if (unlikely(MemInst->getPointer<uint32_t *>(BytesWrittenPtr,
+                                               OutBuffersLen) == nullptr)) {
+    spdlog::error("[WASI-NN] Failed when accessing the BytesWritten memory.");
+    return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
+  }
 
-    size_t BlobSize = 1;
-    for (auto I : OutTensor.sizes()) {
-      BlobSize *= I;
-    }
-    uint32_t BytesToWrite =
-        std::min(static_cast<uint32_t>(BlobSize * 4), OutBufferMaxSize);
-    uint8_t *OutBuffer =
-        MemInst->getPointer<uint8_t *>(OutBufferPtr, BytesToWrite);
-    if (unlikely(OutBuffer == nullptr)) {
-      spdlog::error(
-          "[WASI-NN] Failed when accessing the Output Buffer memory.");
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
-    }
-    std::copy_n(reinterpret_cast<const uint8_t *>(TensorBuffer), BytesToWrite,
-                OutBuffer);
-    uint32_t *BytesWritten =
-        MemInst->getPointer<uint32_t *>(BytesWrittenPtr, 1);
-    if (unlikely(BytesWritten == nullptr)) {
-      spdlog::error("[WASI-NN] Failed when accessing the BytesWritten memory.");
-      return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
+  // The I-th output is written to the I-th buffer.
+  auto &CxtRef = Env.NNContext[Context];
+  for (uint32_t I = 0; I < OutBuffersLen; ++I) {
+    if (auto Res = getOutput(*MemInst, CxtRef, I, OutBuffers[I * 2],
+                             OutBuffers[I * 2 + 1], BytesWrittenPtr + I * 4);
+        Res != WASINN::ErrNo::Success) {
+      return static_cast<uint32_t>(Res);
     }
-    *BytesWritten = BytesToWrite;
-    return static_cast<uint32_t>(WASINN::ErrNo::Success);
-#else
-    spdlog::error("[WASI-NN] PyTorch backend is not built. use "
-                  "-WASMEDGE_PLUGIN_WASI_NN_BACKEND=\"PyTorch\" to build it.");
-#endif
-  } else {
-    spdlog::error("[WASI-NN] Current backend is not supported.");
   }
-  return static_cast<uint32_t>(WASINN::ErrNo::InvalidArgument);
+  return static_cast<uint32_t>(WASINN::ErrNo::Success);
 }
 
 Expect<uint32_t> WasiNNCompute::body(const Runtime::CallingFrame &Frame,
@@ -756,15 +890,21 @@ Expect<uint32_t> WasiNNCompute::body(const Runtime::CallingFrame &Frame,
     }
     torch::jit::IValue RawOutput =
         CxtRef.GraphRef.TorchModel.forward(CxtRef.TorchInputs);
+    // The outputs of the last compute are replaced. They are converted to
+    // contiguous F32 tensors once here, and copied out by get_output without
+    // any conversion. The conversion is a no-op for the F32 outputs.
+    CxtRef.TorchOutputs.clear();
     // TODO: more output type should be supported here
     if (RawOutput.isTensorList()) {
       auto OutTensors = RawOutput.toTensorVector();
       for (auto &OneOf : OutTensors) {
-        CxtRef.TorchOutputs.push_back(OneOf.clone());
+        CxtRef.TorchOutputs.push_back(
+            OneOf.to(torch::kFloat32).contiguous());
       }
     } else if (RawOutput.isTensor()) {
       auto OutTensor = RawOutput.toTensor();
-      CxtRef.TorchOutputs.push_back(OutTensor.clone());
+      CxtRef.TorchOutputs.push_back(
+          OutTensor.to(torch::kFloat32).contiguous());
     } else {
       spdlog::error("[WASI-NN] PyTorch backend only supports output a tensor "
                     "or a list of tensor");
@@ -41,6 +41,26 @@ public:
                         uint32_t OutBufferMaxSize, uint32_t BytesWrittenPtr);
 };
 
+/// Set the inputs from 0 to TensorsLen - 1 in one call. The tensors are in
+/// the same layout as set_input, and their data is copied into the backend as
+/// by set_input, not aliased from the linear memory.
+class WasiNNSetInputs : public WasiNN<WasiNNSetInputs> {
+public:
+  WasiNNSetInputs(WASINN::WasiNNEnvironment &HostEnv) : WasiNN(HostEnv) {}
+  Expect<uint32_t> body(const Runtime::CallingFrame &, uint32_t Context,
+                        uint32_t TensorsPtr, uint32_t TensorsLen);
+};
+
+/// Get the outputs from 0 to OutBuffersLen - 1 in one call. The written
+/// sizes are stored in the uint32 array at BytesWrittenPtr.
+class WasiNNGetOutputs : public WasiNN<WasiNNGetOutputs> {
+public:
+  WasiNNGetOutputs(WASINN::WasiNNEnvironment &HostEnv) : WasiNN(HostEnv) {}
+  Expect<uint32_t> body(const Runtime::CallingFrame &, uint32_t Context,
+                        uint32_t OutBuffersPtr, uint32_t OutBuffersLen,
+                        uint32_t BytesWrittenPtr);
+};
+
 class WasiNNCompute : public WasiNN<WasiNNCompute> {
 public:
   WasiNNCompute(WASINN::WasiNNEnvironment &HostEnv) : WasiNN(HostEnv) {}
@@ -14,6 +14,8 @@ WasiNNModule::WasiNNModule() : ModuleInstance("wasi_ephemeral_nn") {
   addHostFunc("set_input", std::make_unique<WasiNNSetInput>(Env));
   addHostFunc("get_output", std::make_unique<WasiNNGetOuput>(Env));
   addHostFunc("compute", std::make_unique<WasiNNCompute>(Env));
+  addHostFunc("set_inputs", std::make_unique<WasiNNSetInputs>(Env));
+  addHostFunc("get_outputs", std::make_unique<WasiNNGetOutputs>(Env));
 }
 
 } // namespace Host
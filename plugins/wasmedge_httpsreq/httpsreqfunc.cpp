@@ -3,17 +3,11 @@
 
 #include "httpsreqfunc.h"
 
-#include <openssl/err.h>
-#include <openssl/ssl.h>
+#include "httpsreqpool.h"
 
 #include <algorithm>
-#include <cstdio>
-#include <errno.h>
-#include <netdb.h>
-#include <resolv.h>
-#include <string.h>
-#include <string>
-#include <unistd.h>
+#include <cstdint>
+#include <string_view>
 
 namespace WasmEdge {
 namespace Host {
@@ -27,8 +21,8 @@ Expect<void> WasmEdgeHttpsReqSendData::body(const Runtime::CallingFrame &Frame,
     return Unexpect(ErrCode::Value::HostFuncError);
   }
 
-  const char *Host = MemInst->getPointer<const char *>(HostPtr);
-  const char *Body = MemInst->getPointer<const char *>(BodyPtr);
+  const char *Host = MemInst->getPointer<const char *>(HostPtr, HostLen);
+  const char *Body = MemInst->getPointer<const char *>(BodyPtr, BodyLen);
   if (Host == nullptr) {
     spdlog::error("[WasmEdge Httpsreq] Fail to get Host");
     return Unexpect(ErrCode::Value::HostFuncError);
@@ -37,87 +31,15 @@ Expect<void> WasmEdgeHttpsReqSendData::body(const Runtime::CallingFrame &Frame,
     spdlog::error("[WasmEdge Httpsreq] Fail to get Body");
     return Unexpect(ErrCode::Value::HostFuncError);
   }
-  std::string HostStr, BodyStr, PortStr = std::to_string(Port);
-  std::copy_n(Host, HostLen, std::back_inserter(HostStr));
-  std::copy_n(Body, BodyLen, std::back_inserter(BodyStr));
-
-  const SSL_METHOD *Method = TLS_client_method();
-  SSL_CTX *Ctx = SSL_CTX_new(Method);
-  if (Ctx == nullptr) {
-    ERR_print_errors_fp(stderr);
-    spdlog::error("[WasmEdge Httpsreq] SSL_CTX_new() failed");
-    return Unexpect(ErrCode::Value::HostFuncError);
-  }
-  SSL *Ssl = SSL_new(Ctx);
-  if (Ssl == nullptr) {
-    spdlog::error("[WasmEdge Httpsreq] SSL_new() failed");
+  if (Port > UINT16_MAX) {
+    spdlog::error("[WasmEdge Httpsreq] Invalid port {}", Port);
     return Unexpect(ErrCode::Value::HostFuncError);
   }
 
-  // open connection
-  int Sfd, Err;
-  struct addrinfo Hints = {}, *Addrs;
-
-  Hints.ai_family = AF_INET;
-  Hints.ai_socktype = SOCK_STREAM;
-  Hints.ai_protocol = IPPROTO_TCP;
-
-  Err = getaddrinfo(HostStr.c_str(), PortStr.c_str(), &Hints, &Addrs);
-  if (Err != 0) {
-    spdlog::error("[WasmEdge Httpsreq] {}", gai_strerror(Err));
-    return Unexpect(ErrCode::Value::HostFuncError);
-  }
-
-  for (struct addrinfo *Addr = Addrs; Addr != NULL; Addr = Addr->ai_next) {
-    Sfd = socket(Addr->ai_family, Addr->ai_socktype, Addr->ai_protocol);
-    if (Sfd == -1) {
-      Err = errno;
-      break;
-    }
-    if (connect(Sfd, Addr->ai_addr, Addr->ai_addrlen) == 0)
-      break;
-    Err = errno;
-    close(Sfd);
-    Sfd = -1;
-  }
-
-  freeaddrinfo(Addrs);
-
-  if (Sfd == -1) {
-    spdlog::error("[WasmEdge Httpsreq] {}", strerror(Err));
-    return Unexpect(ErrCode::Value::HostFuncError);
-  }
-
-  SSL_set_fd(Ssl, Sfd);
-
-  const int Status = SSL_connect(Ssl);
-  if (Status != 1) {
-    SSL_get_error(Ssl, Status);
-    ERR_print_errors_fp(stderr);
-    spdlog::error("[WasmEdge Httpsreq] SSL_get_error code {}", Status);
-    return Unexpect(ErrCode::Value::HostFuncError);
-  }
-
-  SSL_write(Ssl, BodyStr.c_str(), BodyLen);
-
-  // Receive
-  char Buffer[1024];
-  int Nbytes = 0;
-  Env.Rcv = "";
-  while (true) {
-    Nbytes = SSL_read(Ssl, Buffer, 1024);
-    if (Nbytes <= 0) {
-      break;
-    }
-    std::string Buf(Buffer, Nbytes);
-    Env.Rcv = Env.Rcv + Buf;
-  }
-
-  SSL_free(Ssl);
-  close(Sfd);
-  SSL_CTX_free(Ctx);
-
-  return {};
+  // The request is sent directly from the linear memory.
+  return WasmEdgeHttpsReqPool::getInstance().send(
+      std::string_view(Host, HostLen), static_cast<uint16_t>(Port),
+      std::string_view(Body, BodyLen), Env.Rcv);
 }
 
 Expect<void> WasmEdgeHttpsReqGetRcv::body(const Runtime::CallingFrame &Frame,
@@ -126,7 +48,12 @@ Expect<void> WasmEdgeHttpsReqGetRcv::body(const Runtime::CallingFrame &Frame,
   if (MemInst == nullptr) {
     return Unexpect(ErrCode::Value::HostFuncError);
   }
-  char *Buf = MemInst->getPointer<char *>(BufPtr);
+  char *Buf = MemInst->getPointer<char *>(
+      BufPtr, static_cast<uint32_t>(Env.Rcv.size()));
+  if (Buf == nullptr) {
+    spdlog::error("[WasmEdge Httpsreq] Fail to get Buf");
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
   std::copy_n(Env.Rcv.begin(), Env.Rcv.size(), Buf);
   return {};
 }
@@ -0,0 +1,579 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "httpsreqpool.h"
+
+#include "common/log.h"
+
+#include <openssl/err.h>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <csignal>
+#include <cstring>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+
+namespace WasmEdge {
+namespace Host {
+
+namespace {
+
+/// Size of each read from the connection, one maximum TLS record.
+inline constexpr const size_t kReadSize = 16384;
+
+bool equalsIgnoreCase(std::string_view LHS, std::string_view RHS) noexcept {
+  return LHS.size() == RHS.size() &&
+         std::equal(LHS.begin(), LHS.end(), RHS.begin(), [](char A, char B) {
+           return std::tolower(static_cast<unsigned char>(A)) ==
+                  std::tolower(static_cast<unsigned char>(B));
+         });
+}
+
+bool containsIgnoreCase(std::string_view Str, std::string_view Token) noexcept {
+  return std::search(Str.begin(), Str.end(), Token.begin(), Token.end(),
+                     [](char A, char B) {
+                       return std::tolower(static_cast<unsigned char>(A)) ==
+                              std::tolower(static_cast<unsigned char>(B));
+                     }) != Str.end();
+}
+
+/// Call the function with the name and value of each header field in the
+/// header block. The first line, which is the request or status line, is
+/// skipped. Both the CRLF and the bare LF line endings are accepted.
+template <typename Func>
+void forEachHeader(std::string_view Block, Func &&F) noexcept {
+  size_t Pos = Block.find('\n');
+  while (Pos != std::string_view::npos && Pos + 1 < Block.size()) {
+    const size_t Begin = Pos + 1;
+    Pos = Block.find('\n', Begin);
+    auto Line = Block.substr(Begin, Pos == std::string_view::npos
+                                        ? std::string_view::npos
+                                        : Pos - Begin);
+    if (!Line.empty() && Line.back() == '\r') {
+      Line.remove_suffix(1);
+    }
+    if (Line.empty()) {
+      break;
+    }
+    const auto Colon = Line.find(':');
+    if (Colon == std::string_view::npos) {
+      continue;
+    }
+    auto Value = Line.substr(Colon + 1);
+    while (!Value.empty() && (Value.front() == ' ' || Value.front() == '\t')) {
+      Value.remove_prefix(1);
+    }
+    while (!Value.empty() && (Value.back() == ' ' || Value.back() == '\t')) {
+      Value.remove_suffix(1);
+    }
+    F(Line.substr(0, Colon), Value);
+  }
+}
+
+/// Incremental parser of the framing of an HTTP/1.x response. It only finds
+/// where the response ends and whether the connection can be kept alive.
+class ResponseParser {
+public:
+  explicit ResponseParser(bool IsHead) noexcept : IsHead(IsHead) {}
+
+  /// Advance over the received data. Returns true when the response is
+  /// complete.
+  bool parse(std::string_view Data) noexcept {
+    while (true) {
+      switch (St) {
+      case State::Header: {
+        const auto End = Data.find("\r\n\r\n", Pos);
+        if (End == std::string_view::npos) {
+          return false;
+        }
+        parseHeader(Data.substr(Pos, End - Pos));
+        Pos = End + 4;
+        break;
+      }
+      case State::Body:
+      case State::ChunkData:
+        if (Data.size() - Pos < Remain) {
+          return false;
+        }
+        Pos += Remain;
+        St = St == State::Body ? State::Done : State::ChunkSize;
+        break;
+      case State::ChunkSize: {
+        const auto End = Data.find("\r\n", Pos);
+        if (End == std::string_view::npos) {
+          return false;
+        }
+        uint64_t Size = 0;
+        const auto *First = Data.data() + Pos;
+        const auto *Last = Data.data() + End;
+        if (auto Res = std::from_chars(First, Last, Size, 16);
+            Res.ec != std::errc() || Res.ptr == First) {
+          St = State::UntilClose;
+          KeepAlive = false;
+          return false;
+        }
+        Pos = End + 2;
+        if (Size == 0) {
+          St = State::Trailer;
+        } else {
+          Remain = Size + 2;
+          St = State::ChunkData;
+        }
+        break;
+      }
+      case State::Trailer: {
+        const auto End = Data.find("\r\n", Pos);
+        if (End == std::string_view::npos) {
+          return false;
+        }
+        St = End == Pos ? State::Done : State::Trailer;
+        Pos = End + 2;
+        break;
+      }
+      case State::UntilClose:
+        return false;
+      case State::Done:
+        return true;
+      }
+    }
+  }
+
+  /// The connection can be reused only if the response is delimited by its
+  /// framing and ends exactly at the received data.
+  bool isKeepAlive(std::string_view Data) const noexcept {
+    return KeepAlive && St == State::Done && Pos == Data.size();
+  }
+
+private:
+  enum class State {
+    Header,
+    Body,
+    ChunkSize,
+    ChunkData,
+    Trailer,
+    UntilClose,
+    Done
+  };
+
+  void parseHeader(std::string_view Block) noexcept {
+    // Status line: HTTP/1.x NNN reason
+    uint32_t Status = 0;
+    if (Block.size() >= 12 && Block.substr(0, 7) == "HTTP/1.") {
+      std::from_chars(Block.data() + 9, Block.data() + 12, Status);
+    }
+    const bool IsHTTP11 = Block.size() >= 8 && Block[7] == '1';
+    bool Chunked = false, HasLength = false, Close = false, Alive = false;
+    forEachHeader(Block, [&](std::string_view Name, std::string_view Value) {
+      if (equalsIgnoreCase(Name, "Transfer-Encoding")) {
+        Chunked = containsIgnoreCase(Value, "chunked");
+      } else if (equalsIgnoreCase(Name, "Content-Length")) {
+        HasLength = std::from_chars(Value.data(), Value.data() + Value.size(),
+                                    Remain)
+                        .ec == std::errc();
+      } else if (equalsIgnoreCase(Name, "Connection")) {
+        Close |= containsIgnoreCase(Value, "close");
+        Alive |= containsIgnoreCase(Value, "keep-alive");
+      }
+    });
+    if (Status >= 100 && Status < 200 && Status != 101) {
+      // Interim response. The final response follows.
+      return;
+    }
+    KeepAlive = IsHTTP11 ? !Close : Alive;
+    if (Status == 101) {
+      St = State::UntilClose;
+      KeepAlive = false;
+    } else if (IsHead || Status == 204 || Status == 304) {
+      Remain = 0;
+      St = State::Done;
+    } else if (Chunked) {
+      St = State::ChunkSize;
+    } else if (HasLength) {
+      St = State::Body;
+    } else {
+      St = State::UntilClose;
+      KeepAlive = false;
+    }
+  }
+
+  const bool IsHead;
+  State St = State::Header;
+  size_t Pos = 0;
+  uint64_t Remain = 0;
+  bool KeepAlive = false;
+};
+
+/// Block SIGPIPE in this thread, so that writing to a connection closed by
+/// the server fails with EPIPE instead of terminating the host process.
+class SigPipeGuard {
+public:
+  SigPipeGuard() noexcept {
+    sigemptyset(&PipeSet);
+    sigaddset(&PipeSet, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &PipeSet, &OldSet);
+  }
+  ~SigPipeGuard() noexcept {
+    // Consume the pending SIGPIPE raised by this thread and restore the mask.
+    if (sigset_t Pending; sigpending(&Pending) == 0 &&
+                          sigismember(&Pending, SIGPIPE) == 1 &&
+                          sigismember(&OldSet, SIGPIPE) == 0) {
+      int Sig;
+      sigwait(&PipeSet, &Sig);
+    }
+    pthread_sigmask(SIG_SETMASK, &OldSet, nullptr);
+  }
+
+private:
+  sigset_t PipeSet, OldSet;
+};
+
+/// Write the data, and return the size written before an error.
+size_t writeAll(SSL *Ssl, std::string_view Data) noexcept {
+  size_t Total = 0;
+  while (Total < Data.size()) {
+    const int Size = static_cast<int>(
+        std::min(Data.size() - Total, static_cast<size_t>(INT_MAX)));
+    const int Written = SSL_write(Ssl, Data.data() + Total, Size);
+    if (Written <= 0) {
+      break;
+    }
+    Total += static_cast<size_t>(Written);
+  }
+  return Total;
+}
+
+/// The idempotent methods in RFC 9110, which can be sent again without
+/// changing the result on the server.
+bool isIdempotent(std::string_view Request) noexcept {
+  const auto Method = Request.substr(0, Request.find(' '));
+  return Method == "GET" || Method == "HEAD" || Method == "PUT" ||
+         Method == "DELETE" || Method == "OPTIONS" || Method == "TRACE";
+}
+
+std::string makeKey(std::string_view Host, uint16_t Port) {
+  std::string Key(Host);
+  Key.push_back(':');
+  Key.append(std::to_string(Port));
+  return Key;
+}
+
+} // namespace
+
+WasmEdgeHttpsReqPool::Connection::~Connection() noexcept {
+  if (Ssl) {
+    SSL_free(Ssl);
+  }
+  if (Fd >= 0) {
+    close(Fd);
+  }
+}
+
+bool WasmEdgeHttpsReqPool::Connection::isAlive() const noexcept {
+  // An idle connection has nothing to read. A readable one is either closed
+  // by the server or out of sync.
+  struct pollfd PollFd = {Fd, POLLIN, 0};
+  return poll(&PollFd, 1, 0) == 0;
+}
+
+WasmEdgeHttpsReqPool &WasmEdgeHttpsReqPool::getInstance() noexcept {
+  static WasmEdgeHttpsReqPool Instance;
+  return Instance;
+}
+
+WasmEdgeHttpsReqPool::WasmEdgeHttpsReqPool() noexcept {
+  Ctx = SSL_CTX_new(TLS_client_method());
+  if (Ctx == nullptr) {
+    ERR_print_errors_fp(stderr);
+    spdlog::error("[WasmEdge Httpsreq] SSL_CTX_new() failed");
+    return;
+  }
+  // The sessions are cached by the pool per host and port.
+  SSL_CTX_set_session_cache_mode(Ctx, SSL_SESS_CACHE_CLIENT |
+                                          SSL_SESS_CACHE_NO_INTERNAL_STORE);
+}
+
+WasmEdgeHttpsReqPool::~WasmEdgeHttpsReqPool() noexcept {
+  Idle.clear();
+  for (auto &[Key, Session] : Sessions) {
+    SSL_SESSION_free(Session);
+  }
+  if (Ctx) {
+    SSL_CTX_free(Ctx);
+  }
+}
+
+Expect<void> WasmEdgeHttpsReqPool::send(std::string_view Host, uint16_t Port,
+                                        std::string_view Request,
+                                        std::string &Response) noexcept {
+  if (Ctx == nullptr) {
+    spdlog::error("[WasmEdge Httpsreq] SSL_CTX_new() failed");
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  const std::string HostStr(Host);
+  const std::string Key = makeKey(Host, Port);
+
+  // The request decides whether the connection may be kept alive.
+  const bool IsHead = Request.substr(0, 5) == "HEAD ";
+  const bool Idempotent = isIdempotent(Request);
+  bool RequestClose = false;
+  forEachHeader(Request, [&](std::string_view Name, std::string_view Value) {
+    if (equalsIgnoreCase(Name, "Connection")) {
+      RequestClose |= containsIgnoreCase(Value, "close");
+    }
+  });
+
+  SigPipeGuard Guard;
+  ERR_clear_error();
+  Connection Conn = acquire(Key);
+  while (true) {
+    const bool Reused = static_cast<bool>(Conn);
+    if (!Reused) {
+      if (auto Res = connect(Key, HostStr, Port); !Res) {
+        return Unexpect(Res);
+      } else {
+        Conn = std::move(*Res);
+      }
+    }
+
+    Response.clear();
+    ResponseParser Parser(IsHead);
+    bool Complete = false;
+    const size_t Sent = writeAll(Conn.Ssl, Request);
+    if (Sent == Request.size()) {
+      while (!Complete) {
+        const size_t Size = Response.size();
+        Response.resize(Size + kReadSize);
+        size_t Read = 0;
+        if (SSL_read_ex(Conn.Ssl, Response.data() + Size, kReadSize, &Read) !=
+            1) {
+          Response.resize(Size);
+          break;
+        }
+        Response.resize(Size + Read);
+        Complete = Parser.parse(Response);
+      }
+    }
+    if (Response.empty()) {
+      ERR_clear_error();
+      if (Reused && (Idempotent || Sent == 0)) {
+        // The server closed the idle connection before the request arrived.
+        // The other requests may have been processed, so they are not sent
+        // again.
+        Conn = Connection();
+        continue;
+      }
+      spdlog::error("[WasmEdge Httpsreq] Connection closed without response");
+      return Unexpect(ErrCode::Value::HostFuncError);
+    }
+
+    saveSession(Key, Conn.Ssl);
+    if (!RequestClose && Parser.isKeepAlive(Response)) {
+      release(Key, std::move(Conn));
+    }
+    ERR_clear_error();
+    return {};
+  }
+}
+
+WasmEdgeHttpsReqPool::Connection
+WasmEdgeHttpsReqPool::acquire(const std::string &Key) noexcept {
+  std::unique_lock Lock(Mutex);
+  pruneIdle(std::chrono::steady_clock::now());
+  auto It = Idle.find(Key);
+  if (It == Idle.end()) {
+    return {};
+  }
+  auto &Conns = It->second;
+  Connection Conn;
+  while (!Conns.empty() && !Conn) {
+    Conn = std::move(Conns.back());
+    Conns.pop_back();
+    if (!Conn.isAlive()) {
+      Conn = Connection();
+    }
+  }
+  if (Conns.empty()) {
+    Idle.erase(It);
+  }
+  return Conn;
+}
+
+void WasmEdgeHttpsReqPool::release(const std::string &Key,
+                                   Connection Conn) noexcept {
+  const auto Now = std::chrono::steady_clock::now();
+  Conn.IdleSince = Now;
+  std::unique_lock Lock(Mutex);
+  pruneIdle(Now);
+  if (Idle.size() >= MAX_IDLE_HOSTS && Idle.count(Key) == 0) {
+    // Drop the host which has been idle for the longest time. The newest
+    // connection of each host is at the back.
+    Idle.erase(std::min_element(Idle.begin(), Idle.end(),
+                                [](const auto &LHS, const auto &RHS) {
+                                  return LHS.second.back().IdleSince <
+                                         RHS.second.back().IdleSince;
+                                }));
+  }
+  auto &Conns = Idle[Key];
+  if (Conns.size() >= MAX_IDLE_PER_HOST) {
+    // Drop the oldest one.
+    Conns.erase(Conns.begin());
+  }
+  Conns.push_back(std::move(Conn));
+}
+
+void WasmEdgeHttpsReqPool::pruneIdle(
+    std::chrono::steady_clock::time_point Now) noexcept {
+  for (auto It = Idle.begin(); It != Idle.end();) {
+    auto &Conns = It->second;
+    // The connections are in the order of the release time.
+    Conns.erase(Conns.begin(),
+                std::find_if(Conns.begin(), Conns.end(),
+                             [Now](const Connection &Conn) {
+                               return Now - Conn.IdleSince < IDLE_TIMEOUT;
+                             }));
+    It = Conns.empty() ? Idle.erase(It) : std::next(It);
+  }
+}
+
+Expect<WasmEdgeHttpsReqPool::Connection>
+WasmEdgeHttpsReqPool::connect(const std::string &Key, const std::string &Host,
+                              uint16_t Port) noexcept {
+  auto Addrs = resolve(Key, Host, Port);
+  if (!Addrs) {
+    return Unexpect(Addrs);
+  }
+
+  int Sfd = -1, Err = 0;
+  for (const auto &[Addr, AddrLen] : *Addrs) {
+    Sfd = socket(Addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (Sfd == -1) {
+      Err = errno;
+      break;
+    }
+    if (::connect(Sfd, reinterpret_cast<const sockaddr *>(&Addr), AddrLen) ==
+        0) {
+      break;
+    }
+    Err = errno;
+    close(Sfd);
+    Sfd = -1;
+  }
+  if (Sfd == -1) {
+    // The cached addresses may be stale.
+    std::unique_lock Lock(Mutex);
+    DNSCache.erase(Key);
+    spdlog::error("[WasmEdge Httpsreq] {}", strerror(Err));
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  // The requests are written in one piece and wait for the response.
+  const int NoDelay = 1;
+  setsockopt(Sfd, IPPROTO_TCP, TCP_NODELAY, &NoDelay, sizeof(NoDelay));
+
+  SSL *Ssl = SSL_new(Ctx);
+  if (Ssl == nullptr) {
+    close(Sfd);
+    spdlog::error("[WasmEdge Httpsreq] SSL_new() failed");
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  Connection Conn(Sfd, Ssl);
+  SSL_set_fd(Ssl, Sfd);
+  SSL_set_tlsext_host_name(Ssl, Host.c_str());
+  {
+    std::unique_lock Lock(Mutex);
+    if (auto It = Sessions.find(Key); It != Sessions.end()) {
+      SSL_set_session(Ssl, It->second);
+    }
+  }
+
+  const int Status = SSL_connect(Ssl);
+  if (Status != 1) {
+    const int Code = SSL_get_error(Ssl, Status);
+    ERR_print_errors_fp(stderr);
+    spdlog::error("[WasmEdge Httpsreq] SSL_get_error code {}", Code);
+    std::unique_lock Lock(Mutex);
+    if (auto It = Sessions.find(Key); It != Sessions.end()) {
+      SSL_SESSION_free(It->second);
+      Sessions.erase(It);
+    }
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  return Conn;
+}
+
+Expect<std::vector<std::pair<sockaddr_storage, socklen_t>>>
+WasmEdgeHttpsReqPool::resolve(const std::string &Key, const std::string &Host,
+                              uint16_t Port) noexcept {
+  const auto Now = std::chrono::steady_clock::now();
+  {
+    std::unique_lock Lock(Mutex);
+    if (auto It = DNSCache.find(Key);
+        It != DNSCache.end() && Now < It->second.Expiry) {
+      return It->second.Addrs;
+    }
+  }
+
+  struct addrinfo Hints = {}, *Res;
+  Hints.ai_family = AF_INET;
+  Hints.ai_socktype = SOCK_STREAM;
+  Hints.ai_protocol = IPPROTO_TCP;
+  const std::string PortStr = std::to_string(Port);
+  if (const int Err = getaddrinfo(Host.c_str(), PortStr.c_str(), &Hints, &Res);
+      Err != 0) {
+    spdlog::error("[WasmEdge Httpsreq] {}", gai_strerror(Err));
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  DNSEntry Entry;
+  for (struct addrinfo *Addr = Res; Addr != nullptr; Addr = Addr->ai_next) {
+    sockaddr_storage Storage = {};
+    std::memcpy(&Storage, Addr->ai_addr, Addr->ai_addrlen);
+    Entry.Addrs.emplace_back(Storage, Addr->ai_addrlen);
+  }
+  freeaddrinfo(Res);
+  Entry.Expiry = Now + DNS_TTL;
+
+  std::unique_lock Lock(Mutex);
+  if (DNSCache.size() >= MAX_DNS_ENTRIES) {
+    for (auto It = DNSCache.begin(); It != DNSCache.end();) {
+      It = Now < It->second.Expiry ? std::next(It) : DNSCache.erase(It);
+    }
+    if (DNSCache.size() >= MAX_DNS_ENTRIES) {
+      DNSCache.erase(DNSCache.begin());
+    }
+  }
+  return DNSCache.insert_or_assign(Key, std::move(Entry)).first->second.Addrs;
+}
+
+void WasmEdgeHttpsReqPool::saveSession(const std::string &Key,
+                                       SSL *Ssl) noexcept {
+  // With TLS 1.3 the session tickets arrive after the handshake, so the
+  // session is taken after the response has been read.
+  SSL_SESSION *Session = SSL_get1_session(Ssl);
+  if (Session == nullptr) {
+    return;
+  }
+  if (!SSL_SESSION_is_resumable(Session)) {
+    SSL_SESSION_free(Session);
+    return;
+  }
+  std::unique_lock Lock(Mutex);
+  if (Sessions.size() >= MAX_SESSIONS && Sessions.count(Key) == 0) {
+    SSL_SESSION_free(Sessions.begin()->second);
+    Sessions.erase(Sessions.begin());
+  }
+  auto [It, Added] = Sessions.try_emplace(Key, Session);
+  if (!Added) {
+    SSL_SESSION_free(It->second);
+    It->second = Session;
+  }
+}
+
+} // namespace Host
+} // namespace WasmEdge
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#pragma once
+
+#include "common/errcode.h"
+
+#include <openssl/ssl.h>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+
+namespace WasmEdge {
+namespace Host {
+
+/// Process-wide TLS client state shared by all httpsreq module instances.
+///
+/// It owns the only SSL_CTX, a small DNS cache, the last TLS session of each
+/// server for resumption, and the idle keep-alive connections keyed by the
+/// host and port.
+class WasmEdgeHttpsReqPool {
+public:
+  /// Time to live of the resolved addresses.
+  static inline constexpr const std::chrono::seconds DNS_TTL{30};
+  /// Maximum count of the cached host names.
+  static inline constexpr const size_t MAX_DNS_ENTRIES = 64;
+  /// Time before an idle connection is dropped.
+  static inline constexpr const std::chrono::seconds IDLE_TIMEOUT{30};
+  /// Maximum count of the idle connections per host and port.
+  static inline constexpr const size_t MAX_IDLE_PER_HOST = 4;
+  /// Maximum count of the hosts and ports with idle connections.
+  static inline constexpr const size_t MAX_IDLE_HOSTS = 64;
+  /// Maximum count of the cached TLS sessions.
+  static inline constexpr const size_t MAX_SESSIONS = 64;
+
+  static WasmEdgeHttpsReqPool &getInstance() noexcept;
+
+  ~WasmEdgeHttpsReqPool() noexcept;
+
+  /// Send the raw HTTP/1.x request and receive the whole response.
+  ///
+  /// A keep-alive connection to the same host and port is reused if there is
+  /// one. A request on a reused connection which the server has closed in the
+  /// meantime is retried on a new connection, only if the method is
+  /// idempotent or nothing of the request has been sent.
+  ///
+  /// \param Host the host name to connect.
+  /// \param Port the port to connect.
+  /// \param Request the bytes of the request, which are sent without copying.
+  /// \param Response the received bytes of the response.
+  ///
+  /// \returns void when success, ErrCode when failed.
+  Expect<void> send(std::string_view Host, uint16_t Port,
+                    std::string_view Request, std::string &Response) noexcept;
+
+private:
+  /// An opened TLS connection.
+  class Connection {
+  public:
+    Connection() noexcept = default;
+    Connection(int Fd, SSL *Ssl) noexcept : Fd(Fd), Ssl(Ssl) {}
+    Connection(Connection &&RHS) noexcept
+        : Fd(std::exchange(RHS.Fd, -1)), Ssl(std::exchange(RHS.Ssl, nullptr)),
+          IdleSince(RHS.IdleSince) {}
+    Connection &operator=(Connection &&RHS) noexcept {
+      std::swap(Fd, RHS.Fd);
+      std::swap(Ssl, RHS.Ssl);
+      IdleSince = RHS.IdleSince;
+      return *this;
+    }
+    ~Connection() noexcept;
+
+    explicit operator bool() const noexcept { return Ssl != nullptr; }
+    /// Check the idle connection is not closed by the server.
+    bool isAlive() const noexcept;
+
+    int Fd = -1;
+    SSL *Ssl = nullptr;
+    std::chrono::steady_clock::time_point IdleSince;
+  };
+
+  /// Resolved addresses of a host and port.
+  struct DNSEntry {
+    std::vector<std::pair<sockaddr_storage, socklen_t>> Addrs;
+    std::chrono::steady_clock::time_point Expiry;
+  };
+
+  WasmEdgeHttpsReqPool() noexcept;
+
+  Connection acquire(const std::string &Key) noexcept;
+  void release(const std::string &Key, Connection Conn) noexcept;
+  /// Drop the idle connections over the idle timeout. The mutex is held.
+  void pruneIdle(std::chrono::steady_clock::time_point Now) noexcept;
+  Expect<Connection> connect(const std::string &Key, const std::string &Host,
+                             uint16_t Port) noexcept;
+  Expect<std::vector<std::pair<sockaddr_storage, socklen_t>>>
+  resolve(const std::string &Key, const std::string &Host,
+          uint16_t Port) noexcept;
+  void saveSession(const std::string &Key, SSL *Ssl) noexcept;
+
+  /// \name Data of the pool.
+  /// @{
+  SSL_CTX *Ctx = nullptr;
+  std::mutex Mutex;
+  std::unordered_map<std::string, DNSEntry> DNSCache;
+  std::unordered_map<std::string, SSL_SESSION *> Sessions;
+  std::unordered_map<std::string, std::vector<Connection>> Idle;
+  /// @}
+};
+
+} // namespace Host
+} // namespace WasmEdge
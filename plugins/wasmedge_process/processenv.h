@@ -23,7 +23,8 @@ public:
 
   /// Default timeout in milliseconds.
   static inline const uint32_t DEFAULT_TIMEOUT = 10000;
-  /// Default polling time in milliseconds.
+  /// Polling time in milliseconds for waiting the child process when pidfd
+  /// is not supported.
   static inline const uint32_t DEFAULT_POLLTIME = 1;
 
   /// Commands
@@ -5,23 +5,98 @@
 
 #include "common/defines.h"
 
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
 #if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
 #include <errno.h>
 #include <fcntl.h>
-#include <limits.h>
+#include <poll.h>
 #include <signal.h>
-#include <sys/select.h>
-#include <sys/stat.h>
-#include <sys/time.h>
+#include <spawn.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
+#if WASMEDGE_OS_LINUX
+#include <sys/syscall.h>
+#endif
 #elif WASMEDGE_OS_WINDOWS
 #endif
 
 namespace WasmEdge {
 namespace Host {
 
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+namespace {
+
+/// Initial capacity of the output buffers.
+inline constexpr const size_t kInitOutputSize = 4096;
+
+/// Create a pipe whose both ends are closed on exec. The read end is
+/// non-blocking for the parent process if `NonBlockRead` is set, otherwise
+/// the write end is.
+bool createPipe(int (&FD)[2], bool NonBlockRead) noexcept {
+#if WASMEDGE_OS_LINUX
+  if (pipe2(FD, O_CLOEXEC) == -1) {
+    return false;
+  }
+#else
+  if (pipe(FD) == -1) {
+    return false;
+  }
+  fcntl(FD[0], F_SETFD, FD_CLOEXEC);
+  fcntl(FD[1], F_SETFD, FD_CLOEXEC);
+#endif
+  const int ParentFD = NonBlockRead ? FD[0] : FD[1];
+  fcntl(ParentFD, F_SETFL, fcntl(ParentFD, F_GETFL) | O_NONBLOCK);
+  return true;
+}
+
+void closeFD(int &FD) noexcept {
+  if (FD != -1) {
+    close(FD);
+    FD = -1;
+  }
+}
+
+/// Read all available bytes of the non-blocking pipe into the tail of the
+/// buffer. Close the pipe at the end of file.
+void readPipe(int &FD, std::vector<uint8_t> &Buf) noexcept {
+  while (FD != -1) {
+    if (Buf.capacity() - Buf.size() < kInitOutputSize) {
+      Buf.reserve(std::max(Buf.capacity() * 2, kInitOutputSize));
+    }
+    const size_t Size = Buf.size();
+    Buf.resize(Buf.capacity());
+    const ssize_t RBytes = read(FD, Buf.data() + Size, Buf.size() - Size);
+    Buf.resize(Size + static_cast<size_t>(std::max<ssize_t>(RBytes, 0)));
+    if (RBytes > 0) {
+      continue;
+    }
+    if (RBytes == -1 && errno == EINTR) {
+      continue;
+    }
+    if (RBytes == 0 || errno != EAGAIN) {
+      closeFD(FD);
+    }
+    return;
+  }
+}
+
+/// Open a file descriptor which becomes readable when the child process
+/// exits, or return -1 if not supported.
+int openPidFD([[maybe_unused]] pid_t PID) noexcept {
+#if WASMEDGE_OS_LINUX && defined(SYS_pidfd_open)
+  return static_cast<int>(syscall(SYS_pidfd_open, PID, 0));
+#else
+  return -1;
+#endif
+}
+
+} // namespace
+#endif
+
 Expect<void>
 WasmEdgeProcessSetProgName::body(const Runtime::CallingFrame &Frame,
                                  uint32_t NamePtr, uint32_t NameLen) {
@@ -119,188 +194,202 @@ Expect<uint32_t> WasmEdgeProcessRun::body(const Runtime::CallingFrame &) {
     return Env.ExitCode;
   }
 
+  runCommand();
+
+  // Reset inputs.
+  Env.Name.clear();
+  Env.Args.clear();
+  Env.Envs.clear();
+  Env.StdIn.clear();
+  Env.TimeOut = Env.DEFAULT_TIMEOUT;
+  return Env.ExitCode;
+#elif WASMEDGE_OS_WINDOWS
+  spdlog::error("wasmedge_process doesn't support windows now.");
+  return Unexpect(ErrCode::Value::HostFuncError);
+#endif
+}
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+void WasmEdgeProcessRun::runCommand() {
+  // Prepare arguments and environment variables before spawning.
+  std::vector<std::string> EnvStr;
+  EnvStr.reserve(Env.Envs.size());
+  for (auto &It : Env.Envs) {
+    EnvStr.push_back(It.first + "=" + It.second);
+  }
+  std::vector<char *> Argv, Envp;
+  Argv.reserve(Env.Args.size() + 2);
+  Envp.reserve(EnvStr.size() + 1);
+  Argv.push_back(Env.Name.data());
+  std::transform(Env.Args.begin(), Env.Args.end(), std::back_inserter(Argv),
+                 [](std::string &S) { return S.data(); });
+  std::transform(EnvStr.begin(), EnvStr.end(), std::back_inserter(Envp),
+                 [](std::string &S) { return S.data(); });
+  Argv.push_back(nullptr);
+  Envp.push_back(nullptr);
+
   // Create pipes for stdin, stdout, and stderr.
   int FDStdIn[2], FDStdOut[2], FDStdErr[2];
-  if (pipe(FDStdIn) == -1) {
-    // Create stdin pipe failed.
-    return Env.ExitCode;
+  if (!createPipe(FDStdIn, false)) {
+    return;
   }
-  if (pipe(FDStdOut) == -1) {
-    // Create stdout pipe failed.
+  if (!createPipe(FDStdOut, true)) {
     close(FDStdIn[0]);
     close(FDStdIn[1]);
-    return Env.ExitCode;
+    return;
   }
-  if (pipe(FDStdErr) == -1) {
-    // Create stderr pipe failed.
+  if (!createPipe(FDStdErr, true)) {
     close(FDStdIn[0]);
     close(FDStdIn[1]);
     close(FDStdOut[0]);
     close(FDStdOut[1]);
-    return Env.ExitCode;
+    return;
   }
 
-  // Create a child process for executing command.
-  pid_t PID = fork();
-  if (PID == -1) {
-    // Create process failed.
-    close(FDStdIn[0]);
-    close(FDStdIn[1]);
-    close(FDStdOut[0]);
-    close(FDStdOut[1]);
-    close(FDStdErr[0]);
-    close(FDStdErr[1]);
-    return Env.ExitCode;
-  } else if (PID == 0) {
-    // Child process. Setup pipes.
-    dup2(FDStdIn[0], 0);
-    dup2(FDStdOut[1], 1);
-    dup2(FDStdErr[1], 2);
-    close(FDStdIn[0]);
+  // Spawn the child process without copying the page tables of this process.
+  // The pipes are closed on exec except the duplicated standard streams.
+  pid_t PID = -1;
+  int Err = 0;
+  {
+    posix_spawn_file_actions_t Actions;
+    posix_spawn_file_actions_init(&Actions);
+    posix_spawn_file_actions_adddup2(&Actions, FDStdIn[0], 0);
+    posix_spawn_file_actions_adddup2(&Actions, FDStdOut[1], 1);
+    posix_spawn_file_actions_adddup2(&Actions, FDStdErr[1], 2);
+    Err = posix_spawnp(&PID, Env.Name.c_str(), &Actions, nullptr, Argv.data(),
+                       Envp.data());
+    posix_spawn_file_actions_destroy(&Actions);
+  }
+  close(FDStdIn[0]);
+  close(FDStdOut[1]);
+  close(FDStdErr[1]);
+  if (Err != 0) {
+    switch (Err) {
+    case EACCES:
+      spdlog::error("Permission denied.");
+      break;
+    case ENOENT:
+      spdlog::error("Command not found.");
+      break;
+    default:
+      spdlog::error("Unknown error.");
+      break;
+    }
     close(FDStdIn[1]);
     close(FDStdOut[0]);
-    close(FDStdOut[1]);
     close(FDStdErr[0]);
-    close(FDStdErr[1]);
+    Env.ExitCode = static_cast<uint32_t>(-1);
+    return;
+  }
 
-    // Prepare arguments and environment variables.
-    std::vector<std::string> EnvStr;
-    for (auto &It : Env.Envs) {
-      EnvStr.push_back(It.first + "=" + It.second);
+  // Block SIGPIPE in this thread, so that writing the stdin of an exited child
+  // process fails with EPIPE instead of terminating the host process.
+  sigset_t PipeSet, OldSet;
+  sigemptyset(&PipeSet);
+  sigaddset(&PipeSet, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &PipeSet, &OldSet);
+
+  // Wait for the child process and transfer the streams in one poll loop.
+  int InFD = FDStdIn[1], OutFD = FDStdOut[0], ErrFD = FDStdErr[0];
+  int PidFD = openPidFD(PID);
+  if (Env.StdIn.empty()) {
+    closeFD(InFD);
+  }
+  Env.StdOut.reserve(kInitOutputSize);
+  Env.StdErr.reserve(kInitOutputSize);
+  size_t WBytes = 0;
+  int ChildStat = 0;
+  bool Exited = false;
+  const auto Deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(Env.TimeOut);
+  while (!Exited) {
+    const auto Now = std::chrono::steady_clock::now();
+    if (Now >= Deadline) {
+      // Over timeout. Interrupt child process.
+      kill(PID, SIGKILL);
+      waitpid(PID, &ChildStat, 0);
+      Env.ExitCode = static_cast<uint32_t>(ETIMEDOUT);
+      break;
     }
-    std::vector<char *> Argv, Envp;
-    Argv.push_back(Env.Name.data());
-    std::transform(Env.Args.begin(), Env.Args.end(), std::back_inserter(Argv),
-                   [](std::string &S) { return S.data(); });
-    std::transform(EnvStr.begin(), EnvStr.end(), std::back_inserter(Envp),
-                   [](std::string &S) { return S.data(); });
-    Argv.push_back(nullptr);
-    Envp.push_back(nullptr);
-#if defined(__GLIBC_PREREQ)
-#if __GLIBC_PREREQ(2, 11)
-    if (execvpe(Env.Name.c_str(), &Argv[0], &Envp[0]) == -1) {
-#else
-    if (execve(Env.Name.c_str(), &Argv[0], &Envp[0]) == -1) {
-#endif
-#else
-    if (execve(Env.Name.c_str(), &Argv[0], &Envp[0]) == -1) {
-#endif
-      switch (errno) {
-      case EACCES:
-        spdlog::error("Permission denied.");
-        break;
-      case ENOENT:
-        spdlog::error("Command not found.");
-        break;
-      default:
-        spdlog::error("Unknown error.");
-        break;
-      }
-      _exit(-1);
+    auto Timeout = std::chrono::ceil<std::chrono::milliseconds>(Deadline - Now);
+    if (PidFD == -1) {
+      // Without pidfd, check the child process periodically.
+      Timeout = std::min(Timeout,
+                         std::chrono::milliseconds(Env.DEFAULT_POLLTIME));
     }
-  } else {
-    // Parent process. Close unused file descriptors.
-    close(FDStdIn[0]);
-    close(FDStdOut[1]);
-    close(FDStdErr[1]);
 
-    // Send inputs.
-    uint32_t WBytes = 0;
-    while (WBytes < Env.StdIn.size()) {
-      uint32_t WriteNum =
-          std::min(static_cast<size_t>(PIPE_BUF), Env.StdIn.size() - WBytes);
-      if (auto Res = write(FDStdIn[1], &Env.StdIn[WBytes], WriteNum); Res > 0) {
-        WBytes += Res;
-      } else {
-        break;
+    const struct pollfd Watches[] = {
+        {InFD, POLLOUT, 0}, {OutFD, POLLIN, 0}, {ErrFD, POLLIN, 0}};
+    struct pollfd FDs[4];
+    nfds_t NFDs = 0;
+    for (const auto &Watch : Watches) {
+      if (Watch.fd != -1) {
+        FDs[NFDs++] = Watch;
       }
     }
-    close(FDStdIn[1]);
-
-    // Waiting for child process and get outputs.
-    uint8_t Buf[PIPE_BUF];
-    ssize_t RBytes;
-    int ChildStat;
-    struct timeval TStart, TCurr;
-    gettimeofday(&TStart, NULL);
-    while (true) {
-      gettimeofday(&TCurr, NULL);
-      if ((TCurr.tv_sec - TStart.tv_sec) * 1000U +
-              (TCurr.tv_usec - TStart.tv_usec) / 1000000U >
-          Env.TimeOut) {
-        // Over timeout. Interrupt child process.
-        kill(PID, SIGKILL);
-        Env.ExitCode = static_cast<uint32_t>(ETIMEDOUT);
-        break;
-      }
-
-      // Wait for child process.
-      pid_t WPID = waitpid(PID, &ChildStat, WNOHANG);
-      if (WPID == -1) {
-        // waitpid failed.
-        Env.ExitCode = static_cast<uint32_t>(EINVAL);
-        break;
-      } else if (WPID > 0) {
-        // Child process returned.
-        Env.ExitCode = static_cast<int8_t>(WEXITSTATUS(ChildStat));
-        break;
-      }
+    if (PidFD != -1) {
+      FDs[NFDs++] = {PidFD, POLLIN, 0};
+    }
+    if (poll(FDs, NFDs, static_cast<int>(Timeout.count())) == -1 &&
+        errno != EINTR) {
+      kill(PID, SIGKILL);
+      waitpid(PID, &ChildStat, 0);
+      Env.ExitCode = static_cast<uint32_t>(EINVAL);
+      break;
+    }
 
-      // Read stdout and stderr.
-      fd_set FDSet;
-      int NFD = std::max(FDStdOut[0], FDStdErr[0]) + 1;
-      FD_ZERO(&FDSet);
-      FD_SET(FDStdOut[0], &FDSet);
-      FD_SET(FDStdErr[0], &FDSet);
-      struct timeval TSelect = {.tv_sec = 0, .tv_usec = 0};
-      if (select(NFD, &FDSet, NULL, NULL, &TSelect) > 0) {
-        if (FD_ISSET(FDStdOut[0], &FDSet)) {
-          if (RBytes = read(FDStdOut[0], Buf, sizeof(Buf)); RBytes > 0) {
-            Env.StdOut.reserve(Env.StdOut.size() + RBytes);
-            std::copy_n(Buf, RBytes, std::back_inserter(Env.StdOut));
-          }
+    // Send inputs.
+    while (InFD != -1) {
+      const ssize_t Res =
+          write(InFD, Env.StdIn.data() + WBytes, Env.StdIn.size() - WBytes);
+      if (Res > 0) {
+        WBytes += static_cast<size_t>(Res);
+        if (WBytes == Env.StdIn.size()) {
+          closeFD(InFD);
         }
-        if (FD_ISSET(FDStdErr[0], &FDSet)) {
-          if (RBytes = read(FDStdErr[0], Buf, sizeof(Buf)); RBytes > 0) {
-            Env.StdErr.reserve(Env.StdErr.size() + RBytes);
-            std::copy_n(Buf, RBytes, std::back_inserter(Env.StdErr));
-          }
+      } else if (Res == -1 && errno == EINTR) {
+        continue;
+      } else {
+        if (Res == -1 && errno != EAGAIN) {
+          closeFD(InFD);
         }
+        break;
       }
-      usleep(Env.DEFAULT_POLLTIME * 1000);
     }
 
-    // Read remained stdout and stderr.
-    do {
-      RBytes = read(FDStdOut[0], Buf, sizeof(Buf));
-      if (RBytes > 0) {
-        Env.StdOut.reserve(Env.StdOut.size() + RBytes);
-        std::copy_n(Buf, RBytes, std::back_inserter(Env.StdOut));
-      }
-    } while (RBytes > 0);
-    do {
-      RBytes = read(FDStdErr[0], Buf, sizeof(Buf));
-      if (RBytes > 0) {
-        Env.StdErr.reserve(Env.StdErr.size() + RBytes);
-        std::copy_n(Buf, RBytes, std::back_inserter(Env.StdErr));
-      }
-    } while (RBytes > 0);
-    close(FDStdOut[0]);
-    close(FDStdErr[0]);
+    // Read outputs.
+    readPipe(OutFD, Env.StdOut);
+    readPipe(ErrFD, Env.StdErr);
+
+    // Wait for child process.
+    if (pid_t WPID = waitpid(PID, &ChildStat, WNOHANG); WPID == -1) {
+      // waitpid failed.
+      Env.ExitCode = static_cast<uint32_t>(EINVAL);
+      break;
+    } else if (WPID > 0) {
+      // Child process returned.
+      Env.ExitCode = static_cast<int8_t>(WEXITSTATUS(ChildStat));
+      Exited = true;
+    }
   }
 
-  // Reset inputs.
-  Env.Name.clear();
-  Env.Args.clear();
-  Env.Envs.clear();
-  Env.StdIn.clear();
-  Env.TimeOut = Env.DEFAULT_TIMEOUT;
-  return Env.ExitCode;
-#elif WASMEDGE_OS_WINDOWS
-  spdlog::error("wasmedge_process doesn't support windows now.");
-  return Unexpect(ErrCode::Value::HostFuncError);
-#endif
+  // Read remained stdout and stderr.
+  readPipe(OutFD, Env.StdOut);
+  readPipe(ErrFD, Env.StdErr);
+  closeFD(InFD);
+  closeFD(OutFD);
+  closeFD(ErrFD);
+  closeFD(PidFD);
+
+  // Consume the pending SIGPIPE raised by this thread and restore the mask.
+  if (sigset_t Pending; sigpending(&Pending) == 0 &&
+                        sigismember(&Pending, SIGPIPE) == 1) {
+    int Sig;
+    sigwait(&PipeSet, &Sig);
+  }
+  pthread_sigmask(SIG_SETMASK, &OldSet, nullptr);
 }
+#endif
 
 Expect<uint32_t>
 WasmEdgeProcessGetExitCode::body(const Runtime::CallingFrame &) {
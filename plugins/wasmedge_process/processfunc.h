@@ -60,6 +60,10 @@ public:
   WasmEdgeProcessRun(WasmEdgeProcessEnvironment &HostEnv)
       : WasmEdgeProcess(HostEnv) {}
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame);
+
+private:
+  /// Spawn the command and wait for it with the timeout.
+  void runCommand();
 };
 
 class WasmEdgeProcessGetExitCode
@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/aot/AOTIncrementalTest.cpp - incremental tests ------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the incremental compilation.
+///
+//===----------------------------------------------------------------------===//
+
+#include "aot/cache.h"
+#include "aot/compiler.h"
+
+#include "common/defines.h"
+#include "common/filesystem.h"
+#include "loader/loader.h"
+#include "validator/validator.h"
+#include "vm/vm.h"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+using ObjectList =
+    std::map<std::filesystem::path, std::filesystem::file_time_type>;
+
+// A module with three functions, where `sum` calls the other two:
+//
+//   (global i32 (i32.const Salt))
+//   (func (result i32) i32.const 1)
+//   (func (result i32) i32.const Two)
+//   (func (export "sum") (result i32) call 0 call 1 i32.add)
+//
+// The global is in the context of the functions, so the salt gives the cache
+// entries of each test run keys of their own.
+std::vector<WasmEdge::Byte> createWasm(uint32_t Salt, uint8_t Two) {
+  return {
+      0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00,
+      // Type section.
+      0x01, 0x05, 0x01, 0x60, 0x00, 0x01, 0x7F,
+      // Function section.
+      0x03, 0x04, 0x03, 0x00, 0x00, 0x00,
+      // Global section, with the salt in the padded 5-byte form.
+      0x06, 0x0A, 0x01, 0x7F, 0x00, 0x41,
+      static_cast<WasmEdge::Byte>((Salt & 0x7FU) | 0x80U),
+      static_cast<WasmEdge::Byte>(((Salt >> 7) & 0x7FU) | 0x80U),
+      static_cast<WasmEdge::Byte>(((Salt >> 14) & 0x7FU) | 0x80U),
+      static_cast<WasmEdge::Byte>(((Salt >> 21) & 0x7FU) | 0x80U),
+      static_cast<WasmEdge::Byte>((Salt >> 28) & 0x07U), 0x0B,
+      // Export section.
+      0x07, 0x07, 0x01, 0x03, 0x73, 0x75, 0x6D, 0x00, 0x02,
+      // Code section.
+      0x0A, 0x13, 0x03, 0x04, 0x00, 0x41, 0x01, 0x0B, 0x04, 0x00, 0x41, Two,
+      0x0B, 0x07, 0x00, 0x10, 0x00, 0x10, 0x01, 0x6A, 0x0B};
+}
+
+// Get the cached function objects with their modification times.
+ObjectList listObjects(const std::filesystem::path &Dir) {
+  ObjectList Objects;
+  std::error_code ErrCode;
+  for (std::filesystem::directory_iterator It(Dir, ErrCode), End;
+       !ErrCode && It != End; It.increment(ErrCode)) {
+    Objects.emplace(It->path(), It->last_write_time());
+  }
+  return Objects;
+}
+
+// Get the entries of the list which are not in the base.
+std::vector<std::filesystem::path> added(const ObjectList &List,
+                                         const ObjectList &Base) {
+  std::vector<std::filesystem::path> Paths;
+  for (const auto &Entry : List) {
+    if (Base.count(Entry.first) == 0) {
+      Paths.push_back(Entry.first);
+    }
+  }
+  return Paths;
+}
+
+void compileAndRun(const WasmEdge::Configure &Conf,
+                   const std::vector<WasmEdge::Byte> &Wasm,
+                   const std::filesystem::path &Path, uint32_t Expected) {
+  WasmEdge::Loader::Loader Loader(Conf);
+  WasmEdge::Validator::Validator ValidatorEngine(Conf);
+  WasmEdge::AOT::Compiler Compiler(Conf);
+  auto Module = Loader.parseModule(Wasm);
+  ASSERT_TRUE(Module);
+  ASSERT_TRUE(ValidatorEngine.validate(**Module));
+  ASSERT_TRUE(Compiler.compile(Wasm, **Module, Path));
+
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Path));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  auto Res = VM.execute("sum");
+  ASSERT_TRUE(Res);
+  ASSERT_EQ(Res->size(), 1U);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), Expected);
+}
+
+TEST(IncrementalCompilerTest, RebuildChanged) {
+  WasmEdge::Configure Conf;
+  Conf.getCompilerConfigure().setIncremental(true);
+  Conf.getCompilerConfigure().setOutputFormat(
+      WasmEdge::CompilerConfigure::OutputFormat::Native);
+  const auto ObjectPath = WasmEdge::AOT::Cache::getPath(
+      {}, WasmEdge::AOT::Cache::StorageScope::Local, "objects"sv);
+  ASSERT_TRUE(ObjectPath);
+  const auto Dir = ObjectPath->parent_path();
+  const uint32_t Salt = std::random_device()() & UINT32_C(0x7FFFFFFF);
+  const auto TempDir = std::filesystem::temp_directory_path();
+  const auto Path = TempDir / std::filesystem::u8path(
+                                  "AOTIncrementalTest" WASMEDGE_LIB_EXTENSION);
+  const auto ChangedPath =
+      TempDir / std::filesystem::u8path(
+                    "AOTIncrementalTestChanged" WASMEDGE_LIB_EXTENSION);
+
+  // Every function is compiled into a new cache entry at first.
+  const auto Base = listObjects(Dir);
+  compileAndRun(Conf, createWasm(Salt, 0x02), Path, 3U);
+  const auto First = listObjects(Dir);
+  const auto FirstAdded = added(First, Base);
+  EXPECT_EQ(FirstAdded.size(), 3U);
+
+  // Only the changed function is compiled again, and the unchanged ones are
+  // linked from their cache entries with the call into the new one.
+  compileAndRun(Conf, createWasm(Salt, 0x14), ChangedPath, 21U);
+  const auto Second = listObjects(Dir);
+  const auto SecondAdded = added(Second, First);
+  EXPECT_EQ(SecondAdded.size(), 1U);
+  for (const auto &Object : FirstAdded) {
+    const auto It = Second.find(Object);
+    ASSERT_NE(It, Second.end());
+    EXPECT_EQ(It->second, First.at(Object));
+  }
+
+  for (const auto &Object : FirstAdded) {
+    std::filesystem::remove(Object);
+  }
+  for (const auto &Object : SecondAdded) {
+    std::filesystem::remove(Object);
+  }
+  std::filesystem::remove(Path);
+  std::filesystem::remove(ChangedPath);
+}
+
+} // namespace
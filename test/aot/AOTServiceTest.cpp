@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/aot/AOTServiceTest.cpp - compiler service tests -----===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of compiling WASM concurrently.
+///
+//===----------------------------------------------------------------------===//
+
+#include "aot/service.h"
+
+#include "common/defines.h"
+#include "common/filesystem.h"
+
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::literals::string_literals;
+
+// A module with one function `(func (result i32) i32.const 42)`.
+const std::vector<WasmEdge::Byte> AnswerWasm = {
+    0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01,
+    0x60, 0x00, 0x01, 0x7F, 0x03, 0x02, 0x01, 0x00, 0x0A, 0x06, 0x01,
+    0x04, 0x00, 0x41, 0x2A, 0x0B};
+
+std::filesystem::path outputPath(uint32_t Index) {
+  return std::filesystem::temp_directory_path() /
+         ("AOTServiceTest"s + std::to_string(Index) +
+          WASMEDGE_LIB_EXTENSION);
+}
+
+TEST(CompilerServiceTest, Concurrent) {
+  WasmEdge::Configure Conf;
+  WasmEdge::AOT::CompilerService Service(Conf, {4, 2});
+  std::atomic<uint32_t> Calls = 0;
+  std::vector<std::shared_ptr<WasmEdge::AOT::CompilerService::Job>> Jobs;
+  for (uint32_t I = 0; I < 8; ++I) {
+    auto Res = Service.submit(AnswerWasm, outputPath(I),
+                              [&Calls](uint64_t Done, uint64_t Total) {
+                                EXPECT_LE(Done, Total);
+                                ++Calls;
+                              });
+    ASSERT_TRUE(Res);
+    Jobs.push_back(std::move(*Res));
+  }
+  for (uint32_t I = 0; I < 8; ++I) {
+    EXPECT_TRUE(Jobs[I]->wait());
+    EXPECT_TRUE(Jobs[I]->isFinished());
+    const auto [Done, Total] = Jobs[I]->getProgress();
+    EXPECT_EQ(Done, Total);
+    EXPECT_GT(Total, 0U);
+    std::error_code Error;
+    EXPECT_TRUE(std::filesystem::exists(outputPath(I), Error));
+    std::filesystem::remove(outputPath(I), Error);
+  }
+  EXPECT_GE(Calls.load(), 8U);
+}
+
+TEST(CompilerServiceTest, Invalid) {
+  WasmEdge::Configure Conf;
+  WasmEdge::AOT::CompilerService Service(Conf);
+  auto Res = Service.submit({0x00, 0x61, 0x73, 0x6D}, outputPath(0));
+  ASSERT_TRUE(Res);
+  EXPECT_FALSE((*Res)->wait());
+}
+
+TEST(CompilerServiceTest, Cancel) {
+  WasmEdge::Configure Conf;
+  WasmEdge::AOT::CompilerService Service(Conf);
+  // Cancel the job at its first step.
+  std::atomic<WasmEdge::AOT::CompilerService::Job *> Job = nullptr;
+  auto Res = Service.submit(AnswerWasm, outputPath(0),
+                            [&Job](uint64_t, uint64_t) {
+                              while (!Job.load()) {
+                                std::this_thread::yield();
+                              }
+                              Job.load()->cancel();
+                            });
+  ASSERT_TRUE(Res);
+  Job.store(Res->get());
+  auto Result = (*Res)->wait();
+  ASSERT_FALSE(Result);
+  EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::Cancelled);
+  std::error_code Error;
+  std::filesystem::remove(outputPath(0), Error);
+}
+
+} // namespace
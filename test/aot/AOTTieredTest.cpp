@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/aot/AOTTieredTest.cpp - tiered compiler tests -------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the tiered compilation.
+///
+//===----------------------------------------------------------------------===//
+
+#include "aot/tiered.h"
+
+#include "common/filesystem.h"
+#include "vm/vm.h"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// A module with `(func (export "answer") (result i32) i32.const 42)`.
+const std::vector<WasmEdge::Byte> AnswerWasm = {
+    0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01,
+    0x60, 0x00, 0x01, 0x7F, 0x03, 0x02, 0x01, 0x00, 0x07, 0x0A, 0x01,
+    0x06, 0x61, 0x6E, 0x73, 0x77, 0x65, 0x72, 0x00, 0x00, 0x0A, 0x06,
+    0x01, 0x04, 0x00, 0x41, 0x2A, 0x0B};
+
+// Get an empty cache root in the temporary directory.
+std::filesystem::path createCacheRoot(std::string_view Name) {
+  const auto Root = std::filesystem::temp_directory_path() /
+                    std::filesystem::u8path(Name);
+  std::filesystem::remove_all(Root);
+  return Root;
+}
+
+void expectAnswer(WasmEdge::VM::VM &VM) {
+  auto Res = VM.execute("answer");
+  ASSERT_TRUE(Res);
+  ASSERT_EQ(Res->size(), 1U);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 42U);
+}
+
+TEST(TieredCompilerTest, Upgrade) {
+  const auto Root = createCacheRoot("wasmedge-tiered-upgrade");
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  WasmEdge::AOT::TieredCompiler Tiered(
+      Conf, &WasmEdge::Executor::Executor::Intrinsics, Root);
+
+  auto Mod = Tiered.compile(AnswerWasm);
+  ASSERT_TRUE(Mod);
+  EXPECT_TRUE((*Mod)->getSymbol());
+  ASSERT_TRUE(VM.loadWasm(std::shared_ptr<const WasmEdge::AST::Module>(
+      std::move(*Mod))));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  Tiered.attach(*VM.getActiveModule());
+  expectAnswer(VM);
+
+  // The function runs the optimized code after the upgrade.
+  ASSERT_TRUE(Tiered.wait());
+  EXPECT_TRUE(Tiered.isOptimized());
+  const auto *FuncInst = VM.getActiveModule()->findFuncExports("answer");
+  ASSERT_NE(FuncInst, nullptr);
+  EXPECT_NE(FuncInst->getCompiledEntry(), FuncInst->getSymbol().get());
+  expectAnswer(VM);
+  std::filesystem::remove_all(Root);
+}
+
+TEST(TieredCompilerTest, Cached) {
+  const auto Root = createCacheRoot("wasmedge-tiered-cached");
+  WasmEdge::Configure Conf;
+  {
+    WasmEdge::AOT::TieredCompiler Tiered(
+        Conf, &WasmEdge::Executor::Executor::Intrinsics, Root);
+    ASSERT_TRUE(Tiered.compile(AnswerWasm));
+    ASSERT_TRUE(Tiered.wait());
+  }
+
+  // The optimized code is loaded from the cache without compiling.
+  WasmEdge::VM::VM VM(Conf);
+  WasmEdge::AOT::TieredCompiler Tiered(
+      Conf, &WasmEdge::Executor::Executor::Intrinsics, Root);
+  auto Mod = Tiered.compile(AnswerWasm);
+  ASSERT_TRUE(Mod);
+  EXPECT_TRUE(Tiered.isOptimized());
+  ASSERT_TRUE(VM.loadWasm(std::shared_ptr<const WasmEdge::AST::Module>(
+      std::move(*Mod))));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  Tiered.attach(*VM.getActiveModule());
+  expectAnswer(VM);
+
+  // The code compiled with another configuration is cached apart.
+  WasmEdge::Configure Interruptible;
+  Interruptible.getCompilerConfigure().setInterruptible(true);
+  {
+    WasmEdge::AOT::TieredCompiler Other(
+        Interruptible, &WasmEdge::Executor::Executor::Intrinsics, Root);
+    ASSERT_TRUE(Other.compile(AnswerWasm));
+    ASSERT_TRUE(Other.wait());
+  }
+  const std::filesystem::directory_iterator Keys(Root / "tiered");
+  EXPECT_EQ(std::distance(begin(Keys), end(Keys)), 2);
+  std::filesystem::remove_all(Root);
+}
+
+TEST(TieredCompilerTest, Invalid) {
+  const auto Root = createCacheRoot("wasmedge-tiered-invalid");
+  WasmEdge::Configure Conf;
+  WasmEdge::AOT::TieredCompiler Tiered(
+      Conf, &WasmEdge::Executor::Executor::Intrinsics, Root);
+  const std::vector<WasmEdge::Byte> Invalid = {0x00, 0x61, 0x73, 0x6D};
+  EXPECT_FALSE(Tiered.compile(Invalid));
+  EXPECT_FALSE(Tiered.wait());
+  EXPECT_FALSE(Tiered.isOptimized());
+  std::filesystem::remove_all(Root);
+}
+
+} // namespace
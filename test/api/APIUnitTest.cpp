@@ -454,6 +454,14 @@ TEST(APICoreTest, Configure) {
   WasmEdge_ConfigureCompilerSetInterruptible(Conf, true);
   EXPECT_NE(WasmEdge_ConfigureCompilerIsInterruptible(ConfNull), true);
   EXPECT_EQ(WasmEdge_ConfigureCompilerIsInterruptible(Conf), true);
+  WasmEdge_ConfigureCompilerSetIncremental(ConfNull, true);
+  WasmEdge_ConfigureCompilerSetIncremental(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureCompilerIsIncremental(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerIsIncremental(Conf), true);
+  WasmEdge_ConfigureCompilerSetWasmOptimization(ConfNull, true);
+  WasmEdge_ConfigureCompilerSetWasmOptimization(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureCompilerIsWasmOptimization(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerIsWasmOptimization(Conf), true);
   // Tests for Statistics configurations.
   WasmEdge_ConfigureStatisticsSetInstructionCounting(ConfNull, true);
   WasmEdge_ConfigureStatisticsSetInstructionCounting(Conf, true);
@@ -983,6 +991,42 @@ TEST(APICoreTest, Compiler) {
   OutFile.close();
   EXPECT_FALSE(std::equal(WASMMagic, WASMMagic + 4, Buf));
 
+  // Compile from buffer into memory
+  WasmEdge_ASTModuleContext *Mod = nullptr;
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_CompilerCompileFromBufferToASTModule(
+      Compiler, &Mod, Data.data(), Data.size())));
+  ASSERT_NE(Mod, nullptr);
+  // Run the compiled code, whose indirect call goes through the intrinsics.
+  WasmEdge_VMContext *VM = WasmEdge_VMCreate(nullptr, nullptr);
+  WasmEdge_ModuleInstanceContext *HostMod = createExternModule("extern");
+  EXPECT_TRUE(
+      WasmEdge_ResultOK(WasmEdge_VMRegisterModuleFromImport(VM, HostMod)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMLoadWasmFromASTModule(VM, Mod)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMValidate(VM)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMInstantiate(VM)));
+  WasmEdge_Value P[2], R[2];
+  P[0] = WasmEdge_ValueGenI32(123);
+  P[1] = WasmEdge_ValueGenI32(456);
+  WasmEdge_String FuncName = WasmEdge_StringCreateByCString("func-add");
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMExecute(VM, FuncName, P, 2, R, 1)));
+  EXPECT_EQ(579, WasmEdge_ValueGetI32(R[0]));
+  WasmEdge_StringDelete(FuncName);
+  P[0] = WasmEdge_ValueGenI32(4);
+  FuncName = WasmEdge_StringCreateByCString("func-call-indirect");
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMExecute(VM, FuncName, P, 1, R, 1)));
+  EXPECT_EQ(3, WasmEdge_ValueGetI32(R[0]));
+  WasmEdge_StringDelete(FuncName);
+  WasmEdge_VMDelete(VM);
+  WasmEdge_ModuleInstanceDelete(HostMod);
+  WasmEdge_ASTModuleDelete(Mod);
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_CompilerCompileFromBufferToASTModule(
+                             Compiler, nullptr, Data.data(), Data.size())));
+  EXPECT_TRUE(
+      isErrMatch(WasmEdge_ErrCode_UnexpectedEnd,
+                 WasmEdge_CompilerCompileFromBufferToASTModule(
+                     Compiler, &Mod, Data.data(), 4)));
+
   WasmEdge_CompilerDelete(Compiler);
   WasmEdge_ConfigureDelete(Conf);
 }
@@ -1400,6 +1444,51 @@ TEST(APICoreTest, ExecutorWithStatistics) {
       isErrMatch(WasmEdge_ErrCategory_UserLevelError, 0x5678U,
                  WasmEdge_ExecutorInvoke(ExecCxt, FuncCxt, nullptr, 0, R, 1)));
 
+  // Create and resume continuations
+  FuncName = WasmEdge_StringCreateByCString("func-mul-2");
+  FuncCxt = WasmEdge_ModuleInstanceFindFunction(ModCxt, FuncName);
+  EXPECT_NE(FuncCxt, nullptr);
+  WasmEdge_StringDelete(FuncName);
+  WasmEdge_ContinuationContext *ContCxt = nullptr;
+  P[0] = WasmEdge_ValueGenI32(123);
+  P[1] = WasmEdge_ValueGenI32(456);
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_ExecutorCreateContinuation(
+                             nullptr, &ContCxt, FuncCxt, P, 2)));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_FuncSigMismatch,
+                         WasmEdge_ExecutorCreateContinuation(
+                             ExecCxt, &ContCxt, FuncCxt, P, 1)));
+  EXPECT_EQ(ContCxt, nullptr);
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_ExecutorCreateContinuation(ExecCxt, &ContCxt, FuncCxt, P, 2)));
+  ASSERT_NE(ContCxt, nullptr);
+  EXPECT_TRUE(WasmEdge_ContinuationIsResumable(ContCxt));
+  EXPECT_TRUE(WasmEdge_ExecutorRequestSuspend(ExecCxt, ContCxt));
+  EXPECT_FALSE(WasmEdge_ExecutorRequestSuspend(nullptr, ContCxt));
+  EXPECT_TRUE(isErrMatch(
+      WasmEdge_ErrCode_Suspended,
+      WasmEdge_ExecutorResume(ExecCxt, ContCxt, UINT64_MAX, UINT64_MAX)));
+  EXPECT_EQ(WasmEdge_ContinuationGetSuspendCount(ContCxt), 1U);
+  EXPECT_EQ(WasmEdge_ContinuationGetReturnsLength(ContCxt), 0U);
+  EXPECT_TRUE(isErrMatch(
+      WasmEdge_ErrCode_WrongVMWorkflow,
+      WasmEdge_ExecutorResume(ExecCxt, nullptr, UINT64_MAX, UINT64_MAX)));
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_ExecutorResume(ExecCxt, ContCxt, UINT64_MAX, 1000)));
+  EXPECT_FALSE(WasmEdge_ContinuationIsResumable(ContCxt));
+  EXPECT_EQ(WasmEdge_ContinuationGetReturnsLength(ContCxt), 2U);
+  EXPECT_EQ(WasmEdge_ContinuationGetReturns(ContCxt, R, 2), 2U);
+  EXPECT_EQ(246, WasmEdge_ValueGetI32(R[0]));
+  EXPECT_EQ(912, WasmEdge_ValueGetI32(R[1]));
+  EXPECT_TRUE(isErrMatch(
+      WasmEdge_ErrCode_WrongVMWorkflow,
+      WasmEdge_ExecutorResume(ExecCxt, ContCxt, UINT64_MAX, UINT64_MAX)));
+  EXPECT_FALSE(WasmEdge_ExecutorRequestSuspend(ExecCxt, ContCxt));
+  EXPECT_FALSE(WasmEdge_ContinuationIsResumable(nullptr));
+  EXPECT_EQ(WasmEdge_ContinuationGetReturns(nullptr, R, 2), 0U);
+  WasmEdge_ContinuationDelete(ContCxt);
+  WasmEdge_ContinuationDelete(nullptr);
+
   // Statistics get instruction count
   EXPECT_GT(WasmEdge_StatisticsGetInstrCount(Stat), 0ULL);
   EXPECT_EQ(WasmEdge_StatisticsGetInstrCount(nullptr), 0ULL);
@@ -3121,6 +3210,146 @@ TEST(APICoreTest, VM) {
   WasmEdge_StoreDelete(Store);
   WasmEdge_VMDelete(VM);
 }
+
+TEST(APICoreTest, VMInstancePool) {
+  WasmEdge_ModuleInstanceContext *HostMod = createExternModule("extern");
+  WasmEdge_ModuleInstanceContext *ModInst = nullptr, *ModInst2 = nullptr,
+                                 *ModInst3 = nullptr;
+  WasmEdge_InstancePoolStatistics Stat;
+  WasmEdge_String Name;
+  WasmEdge_Value P[2], R[2];
+  uint8_t Bytes[10];
+
+  WasmEdge_VMContext *VM = WasmEdge_VMCreate(nullptr, nullptr);
+  EXPECT_TRUE(
+      WasmEdge_ResultOK(WasmEdge_VMRegisterModuleFromImport(VM, HostMod)));
+
+  // Pool creation before validation
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_VMCreateInstancePool(VM, 2)));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_VMAcquireInstance(VM, &ModInst)));
+  EXPECT_FALSE(WasmEdge_VMGetInstancePoolStatistics(VM, &Stat));
+
+  // Pool creation
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMLoadWasmFromFile(VM, TPath)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMValidate(VM)));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_VMCreateInstancePool(nullptr, 2)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMCreateInstancePool(VM, 2)));
+  EXPECT_TRUE(WasmEdge_VMGetInstancePoolStatistics(VM, &Stat));
+  EXPECT_EQ(Stat.Idle, 2U);
+  EXPECT_EQ(Stat.InUse, 0U);
+
+  // Acquire and dirty an instance
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMAcquireInstance(VM, &ModInst)));
+  ASSERT_NE(ModInst, nullptr);
+  P[0] = WasmEdge_ValueGenI32(123);
+  P[1] = WasmEdge_ValueGenI32(456);
+  Name = WasmEdge_StringCreateByCString("func-add");
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_VMExecuteInstance(VM, ModInst, Name, P, 2, R, 2)));
+  EXPECT_EQ(WasmEdge_ValueGetI32(R[0]), 579);
+  WasmEdge_StringDelete(Name);
+  Name = WasmEdge_StringCreateByCString("mem");
+  WasmEdge_MemoryInstanceContext *MemCxt =
+      WasmEdge_ModuleInstanceFindMemory(ModInst, Name);
+  WasmEdge_StringDelete(Name);
+  ASSERT_NE(MemCxt, nullptr);
+  std::fill_n(Bytes, 10, UINT8_C(0xFF));
+  EXPECT_TRUE(
+      WasmEdge_ResultOK(WasmEdge_MemoryInstanceSetData(MemCxt, Bytes, 10, 10)));
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_MemoryInstanceSetData(MemCxt, Bytes, 40000, 10)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_MemoryInstanceGrowPage(MemCxt, 1)));
+  EXPECT_EQ(WasmEdge_MemoryInstanceGetPageSize(MemCxt), 2U);
+  Name = WasmEdge_StringCreateByCString("glob-mut-i32");
+  WasmEdge_GlobalInstanceContext *GlobCxt =
+      WasmEdge_ModuleInstanceFindGlobal(ModInst, Name);
+  WasmEdge_StringDelete(Name);
+  ASSERT_NE(GlobCxt, nullptr);
+  WasmEdge_GlobalInstanceSetValue(GlobCxt, WasmEdge_ValueGenI32(999));
+  Name = WasmEdge_StringCreateByCString("tab-func");
+  WasmEdge_TableInstanceContext *TabCxt =
+      WasmEdge_ModuleInstanceFindTable(ModInst, Name);
+  WasmEdge_StringDelete(Name);
+  ASSERT_NE(TabCxt, nullptr);
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_TableInstanceGrow(TabCxt, 2)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_TableInstanceSetData(
+      TabCxt, WasmEdge_ValueGenNullRef(WasmEdge_RefType_FuncRef), 2)));
+  EXPECT_TRUE(WasmEdge_VMGetInstancePoolStatistics(VM, &Stat));
+  EXPECT_EQ(Stat.Idle, 1U);
+  EXPECT_EQ(Stat.InUse, 1U);
+  EXPECT_EQ(Stat.Hits, 1U);
+
+  // Release and acquire the reset instance
+  WasmEdge_VMReleaseInstance(VM, ModInst);
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMAcquireInstance(VM, &ModInst2)));
+  EXPECT_EQ(ModInst2, ModInst);
+  std::fill_n(Bytes, 10, UINT8_C(0xFF));
+  EXPECT_TRUE(
+      WasmEdge_ResultOK(WasmEdge_MemoryInstanceGetData(MemCxt, Bytes, 10, 10)));
+  for (uint8_t I = 0; I < 10; I++) {
+    EXPECT_EQ(Bytes[I], I);
+  }
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_MemoryInstanceGetData(MemCxt, Bytes, 40000, 10)));
+  EXPECT_EQ(std::count(Bytes, Bytes + 10, UINT8_C(0)), 10);
+  EXPECT_EQ(WasmEdge_MemoryInstanceGetPageSize(MemCxt), 1U);
+  EXPECT_EQ(WasmEdge_ValueGetI32(WasmEdge_GlobalInstanceGetValue(GlobCxt)),
+            142);
+  EXPECT_EQ(WasmEdge_TableInstanceGetSize(TabCxt), 10U);
+  EXPECT_TRUE(
+      WasmEdge_ResultOK(WasmEdge_TableInstanceGetData(TabCxt, &R[0], 2)));
+  Name = WasmEdge_StringCreateByCString("func-1");
+  EXPECT_EQ(WasmEdge_ValueGetFuncRef(R[0]),
+            WasmEdge_ModuleInstanceFindFunction(ModInst2, Name));
+  WasmEdge_StringDelete(Name);
+  P[0] = WasmEdge_ValueGenI32(2);
+  Name = WasmEdge_StringCreateByCString("func-call-indirect");
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_VMExecuteInstance(VM, ModInst2, Name, P, 1, R, 1)));
+  WasmEdge_StringDelete(Name);
+
+  // Acquire over the capacity
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMAcquireInstance(VM, &ModInst3)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMAcquireInstance(VM, &ModInst)));
+  EXPECT_TRUE(WasmEdge_VMGetInstancePoolStatistics(VM, &Stat));
+  EXPECT_EQ(Stat.Idle, 0U);
+  EXPECT_EQ(Stat.InUse, 3U);
+  EXPECT_EQ(Stat.Hits, 3U);
+  EXPECT_EQ(Stat.Misses, 1U);
+  EXPECT_EQ(Stat.Resets, 1U);
+  WasmEdge_VMReleaseInstance(VM, ModInst);
+  WasmEdge_VMReleaseInstance(VM, ModInst2);
+  EXPECT_TRUE(WasmEdge_VMGetInstancePoolStatistics(VM, &Stat));
+  EXPECT_EQ(Stat.Idle, 2U);
+  EXPECT_EQ(Stat.InUse, 1U);
+  EXPECT_EQ(Stat.Resets, 3U);
+  EXPECT_EQ(Stat.Discards, 0U);
+  WasmEdge_VMReleaseInstance(VM, ModInst3);
+  EXPECT_TRUE(WasmEdge_VMGetInstancePoolStatistics(VM, &Stat));
+  EXPECT_EQ(Stat.Idle, 2U);
+  EXPECT_EQ(Stat.InUse, 0U);
+  EXPECT_EQ(Stat.Discards, 1U);
+
+  // Delete an acquired instance directly
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMAcquireInstance(VM, &ModInst)));
+  WasmEdge_ModuleInstanceDelete(ModInst);
+  EXPECT_TRUE(WasmEdge_VMGetInstancePoolStatistics(VM, &Stat));
+  EXPECT_EQ(Stat.Idle, 1U);
+  EXPECT_EQ(Stat.InUse, 0U);
+
+  // Cleanup drops the pool before the acquired instance
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMAcquireInstance(VM, &ModInst3)));
+  WasmEdge_VMCleanup(VM);
+  WasmEdge_ModuleInstanceDelete(ModInst3);
+  EXPECT_FALSE(WasmEdge_VMGetInstancePoolStatistics(VM, &Stat));
+  WasmEdge_VMReleaseInstance(VM, nullptr);
+
+  WasmEdge_ModuleInstanceDelete(HostMod);
+  WasmEdge_VMDelete(VM);
+}
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "common/pgo.h"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+TEST(PGOTest, CountTest) {
+  WasmEdge::PGO::Profile Prof;
+  EXPECT_TRUE(Prof.empty());
+  Prof.addEntry(3);
+  Prof.addEntry(3, 4);
+  Prof.addBranch(42, 0, 2);
+  Prof.addBranch(42, 1, 2, 5);
+  // Targets out of range are dropped.
+  Prof.addBranch(42, 7, 2);
+  EXPECT_FALSE(Prof.empty());
+  EXPECT_EQ(Prof.getEntryCount(3), 5U);
+  EXPECT_EQ(Prof.getEntryCount(4), 0U);
+  const auto Counts = Prof.getBranchCounts(42);
+  EXPECT_EQ(std::vector<uint64_t>(Counts.begin(), Counts.end()),
+            (std::vector<uint64_t>{1, 5}));
+  EXPECT_TRUE(Prof.getBranchCounts(43).empty());
+
+  WasmEdge::PGO::Profile Other;
+  Other.addEntry(1);
+  Other.addBranch(42, 2, 3);
+  Prof.merge(Other);
+  EXPECT_EQ(Prof.getEntryCount(1), 1U);
+  const auto Merged = Prof.getBranchCounts(42);
+  EXPECT_EQ(std::vector<uint64_t>(Merged.begin(), Merged.end()),
+            (std::vector<uint64_t>{1, 5, 1}));
+}
+
+TEST(PGOTest, TextFormatTest) {
+  WasmEdge::PGO::Profile Prof;
+  Prof.addEntry(0, 2);
+  Prof.addEntry(5, UINT64_C(10000000000));
+  Prof.addBranch(17, 1, 2, 3);
+  Prof.addBranch(30, 3, 4, 9);
+
+  std::stringstream SS;
+  Prof.dump(SS);
+  EXPECT_EQ(SS.str(), "wasmedge-profile 1\n"
+                      "function 0 2\n"
+                      "function 5 10000000000\n"
+                      "branch 17 0 3\n"
+                      "branch 30 0 0 0 9\n");
+
+  auto Res = WasmEdge::PGO::Profile::load(SS);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(Res->getEntries(), Prof.getEntries());
+  EXPECT_EQ(Res->getBranches(), Prof.getBranches());
+
+  std::istringstream BadHeader("wasmedge-profile 2\n");
+  EXPECT_FALSE(WasmEdge::PGO::Profile::load(BadHeader));
+  std::istringstream BadLine("wasmedge-profile 1\nfunction 1\n");
+  EXPECT_FALSE(WasmEdge::PGO::Profile::load(BadLine));
+  std::istringstream BadCount("wasmedge-profile 1\nbranch 1 2 x\n");
+  EXPECT_FALSE(WasmEdge::PGO::Profile::load(BadCount));
+}
+
+} // namespace
@@ -14,9 +14,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "loader/loader.h"
+#include "system/cpu.h"
 
 #include <cstdint>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
+#include <string>
 #include <vector>
 
 namespace {
@@ -220,6 +224,189 @@ TEST(ModuleTest, LoadDupSecModule) {
   EXPECT_FALSE(Ldr.parseModule(Vec));
 }
 
+// Append an AOT section of an empty module, compiled for the CPU features
+// in LEB128. The section has a text section at the address 0 holding the byte
+// Text, and a data section holding the intrinsics table at the address 4096.
+// The image is placed at the next page boundary of the file.
+void appendAOTSection(std::vector<uint8_t> &Vec,
+                      const std::vector<uint8_t> &Features, uint8_t Text) {
+  const size_t Start = Vec.size();
+  Vec.insert(Vec.end(), {
+      0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, // Custom section, padded size
+      0x08U, 'w',   'a',   's',   'm',   'e',   'd',   'g',   'e', // Name
+      0x05U, // Binary version
+#if WASMEDGE_OS_LINUX
+      0x01U, // OS type
+#elif WASMEDGE_OS_MACOS
+      0x02U, // OS type
+#else
+      0x03U, // OS type
+#endif
+#if defined(__aarch64__)
+      0x02U, // Arch type
+#else
+      0x01U, // Arch type
+#endif
+  });
+  const size_t VersionOffset = Start + 1 + 5 + 9;
+  Vec.insert(Vec.end(), Features.begin(), Features.end());
+  Vec.insert(Vec.end(), {
+      0x00U,                      // Version address
+      0x80U, 0x20U,               // Intrinsics address
+      0x00U,                      // Types count
+      0x00U,                      // Codes count
+      0x02U,                      // Section count
+      0x01U, 0x00U, 0x01U,        // Text section
+      0x02U, 0x80U, 0x20U, 0x08U, // Data section
+  });
+  // Image offset from the binary version, in padded LEB128, and image size.
+  const size_t ImageStart = (Vec.size() + 4 + 2 + 4095) / 4096 * 4096;
+  const auto ImageOffset = static_cast<uint32_t>(ImageStart - VersionOffset);
+  for (uint32_t I = 0; I < 4; ++I) {
+    Vec.push_back(static_cast<uint8_t>(((ImageOffset >> (I * 7)) & 0x7FU) |
+                                       (I < 3 ? 0x80U : 0x00U)));
+  }
+  Vec.insert(Vec.end(), {0x88U, 0x20U});
+  Vec.resize(ImageStart, 0x00U);
+  Vec.push_back(Text);
+  Vec.resize(ImageStart + 4104, 0x00U);
+  const uint32_t SecSize = static_cast<uint32_t>(Vec.size() - Start - 6);
+  for (uint32_t I = 0; I < 5; ++I) {
+    Vec[Start + 1 + I] = static_cast<uint8_t>(((SecSize >> (I * 7)) & 0x7FU) |
+                                              (I < 4 ? 0x80U : 0x00U));
+  }
+}
+
+// Get the first byte of the text section of the loaded AOT section.
+uint8_t getAOTText(const WasmEdge::AST::Module &Mod) {
+  const auto *Image =
+      reinterpret_cast<const uint8_t *>(Mod.getSymbol().get()) - 4096;
+  return Image[0];
+}
+
+TEST(ModuleTest, LoadAOTImage) {
+  // Universal wasm of an empty module with an AOT section, which has the
+  // image at the file offset 4096.
+  std::vector<uint8_t> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU, // Magic
+      0x01U, 0x00U, 0x00U, 0x00U  // Version
+  };
+  appendAOTSection(Vec, {0x00U}, 0xC3U);
+
+  // 1. Test load from the buffer, which reads the text section.
+  {
+    auto Res = Ldr.parseModule(Vec);
+    ASSERT_TRUE(Res);
+    ASSERT_TRUE((*Res)->getSymbol());
+    EXPECT_EQ(getAOTText(**Res), 0xC3U);
+  }
+
+  // 2. Test load from the file, which maps the text section.
+  const auto Path =
+      std::filesystem::temp_directory_path() / "wasmedgeLoadAOTImage.wasm";
+  {
+    std::ofstream Fout(Path, std::ios::out | std::ios::binary);
+    Fout.write(reinterpret_cast<const char *>(Vec.data()),
+               static_cast<std::streamsize>(Vec.size()));
+  }
+  {
+    auto Res = Ldr.parseModule(Path);
+    ASSERT_TRUE(Res);
+    ASSERT_TRUE((*Res)->getSymbol());
+    EXPECT_EQ(getAOTText(**Res), 0xC3U);
+#if WASMEDGE_OS_LINUX
+    std::ifstream Maps("/proc/self/maps");
+    const std::string Content(std::istreambuf_iterator<char>(Maps), {});
+    EXPECT_NE(Content.find("r-xp 00001000"), std::string::npos);
+    EXPECT_NE(Content.find(Path.filename().u8string()), std::string::npos);
+#endif
+  }
+  std::filesystem::remove(Path);
+}
+
+TEST(ModuleTest, LoadAOTVariants) {
+  const std::vector<uint8_t> Header = {
+      0x00U, 0x61U, 0x73U, 0x6DU, // Magic
+      0x01U, 0x00U, 0x00U, 0x00U  // Version
+  };
+  // Features not on any CPU, in LEB128.
+  const std::vector<uint8_t> Unsupported = {
+      0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x01U};
+  std::vector<uint8_t> HostFeatures;
+  for (uint64_t F = WasmEdge::CPU::hostFeatures();; F >>= 7) {
+    HostFeatures.push_back(static_cast<uint8_t>((F & 0x7FU) |
+                                                (F >= 0x80U ? 0x80U : 0x00U)));
+    if (F < 0x80U) {
+      break;
+    }
+  }
+
+  // 1. Test selecting the variant with the most features on the host.
+  {
+    std::vector<uint8_t> Vec = Header;
+    appendAOTSection(Vec, {0x00U}, 0x90U);
+    appendAOTSection(Vec, HostFeatures, 0xC3U);
+    appendAOTSection(Vec, Unsupported, 0xCCU);
+    auto Res = Ldr.parseModule(Vec);
+    ASSERT_TRUE(Res);
+    ASSERT_TRUE((*Res)->getSymbol());
+    EXPECT_EQ(getAOTText(**Res), 0xC3U);
+  }
+
+  // 2. Test falling back to the interpreter without a supported variant.
+  {
+    std::vector<uint8_t> Vec = Header;
+    appendAOTSection(Vec, Unsupported, 0xCCU);
+    auto Res = Ldr.parseModule(Vec);
+    ASSERT_TRUE(Res);
+    EXPECT_FALSE((*Res)->getSymbol());
+  }
+}
+
+TEST(ModuleTest, LoadAOTSection) {
+  // Module of a function `(func)`.
+  const std::vector<uint8_t> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU,               // Magic
+      0x01U, 0x00U, 0x00U, 0x00U,               // Version
+      0x01U, 0x04U, 0x01U, 0x60U, 0x00U, 0x00U, // Type section
+      0x03U, 0x02U, 0x01U, 0x00U,               // Function section
+      0x0AU, 0x04U, 0x01U, 0x02U, 0x00U, 0x0BU  // Code section
+  };
+  // AOT section compiled in memory, with the function and the type wrapper at
+  // the address 0, and the intrinsics table at the address 4096.
+  WasmEdge::AST::AOTSection AOTSec;
+  AOTSec.setIntrinsicsAddress(4096);
+  AOTSec.getTypesAddress() = {0};
+  AOTSec.getCodesAddress() = {0};
+  AOTSec.getSections().emplace_back(UINT8_C(1), UINT64_C(0), UINT64_C(1),
+                                    std::vector<WasmEdge::Byte>{0xC3U});
+  AOTSec.getSections().emplace_back(UINT8_C(2), UINT64_C(4096), UINT64_C(8),
+                                    std::vector<WasmEdge::Byte>{});
+
+  // 1. Test load the AOT section into the module.
+  {
+    auto Res = Ldr.parseModule(Vec);
+    ASSERT_TRUE(Res);
+    EXPECT_FALSE((*Res)->getSymbol());
+    (*Res)->getAOTSection() = AOTSec;
+    ASSERT_TRUE(Ldr.loadAOTSection(**Res));
+    ASSERT_TRUE((*Res)->getSymbol());
+    EXPECT_TRUE((*Res)->getCodeSection().getContent()[0].getSymbol());
+    EXPECT_EQ(getAOTText(**Res), 0xC3U);
+  }
+
+  // 2. Test load the AOT section with the codes not matching.
+  {
+    auto Res = Ldr.parseModule(Vec);
+    ASSERT_TRUE(Res);
+    (*Res)->getAOTSection() = AOTSec;
+    (*Res)->getAOTSection().getCodesAddress().clear();
+    EXPECT_FALSE(Ldr.loadAOTSection(**Res));
+    EXPECT_FALSE((*Res)->getSymbol());
+    EXPECT_FALSE((*Res)->getCodeSection().getContent()[0].getSymbol());
+  }
+}
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "utils/handles_manager.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace WasmEdge {
+namespace Host {
+namespace WasiCrypto {
+
+namespace {
+using Manager = RcHandlesManager<int32_t, std::shared_ptr<int>>;
+} // namespace
+
+TEST(WasiCryptoHandlesManager, Lifetime) {
+  Manager Handles{0x08};
+  auto Handle = Handles.registerManager(std::make_shared<int>(42));
+  ASSERT_TRUE(Handle);
+  auto Value = Handles.get(*Handle);
+  ASSERT_TRUE(Value);
+  EXPECT_EQ(**Value, 42);
+
+  EXPECT_TRUE(Handles.close(*Handle));
+  EXPECT_EQ(Handles.get(*Handle).error(), __WASI_CRYPTO_ERRNO_INVALID_HANDLE);
+  EXPECT_EQ(Handles.close(*Handle).error(), __WASI_CRYPTO_ERRNO_CLOSED);
+  // The closed content outlives the handle by its reference count.
+  EXPECT_EQ(**Value, 42);
+
+  // The reused slot rejects the stale handle.
+  auto NewHandle = Handles.registerManager(std::make_shared<int>(7));
+  ASSERT_TRUE(NewHandle);
+  EXPECT_NE(*NewHandle, *Handle);
+  EXPECT_EQ(Handles.get(*Handle).error(), __WASI_CRYPTO_ERRNO_INVALID_HANDLE);
+  EXPECT_EQ(**Handles.get(*NewHandle), 7);
+
+  // Handles of the other managers are rejected.
+  Manager Others{0x09};
+  EXPECT_EQ(Others.get(*NewHandle).error(),
+            __WASI_CRYPTO_ERRNO_INVALID_HANDLE);
+  EXPECT_EQ(Others.close(*NewHandle).error(), __WASI_CRYPTO_ERRNO_CLOSED);
+  EXPECT_EQ(Handles.get(9999).error(), __WASI_CRYPTO_ERRNO_INVALID_HANDLE);
+}
+
+TEST(WasiCryptoHandlesManager, TooManyHandles) {
+  Manager Handles{0x08};
+  std::vector<int32_t> Opened;
+  while (true) {
+    auto Handle = Handles.registerManager(nullptr);
+    if (!Handle) {
+      EXPECT_EQ(Handle.error(), __WASI_CRYPTO_ERRNO_TOO_MANY_HANDLES);
+      break;
+    }
+    Opened.push_back(*Handle);
+  }
+  EXPECT_EQ(Opened.size(), 65536U);
+  EXPECT_TRUE(Handles.close(Opened.back()));
+  EXPECT_TRUE(Handles.registerManager(nullptr));
+}
+
+TEST(WasiCryptoHandlesManager, StaleHandleAfterReuse) {
+  Manager Handles{0x08};
+  auto Stale = Handles.registerManager(std::make_shared<int>(-1));
+  ASSERT_TRUE(Stale);
+  ASSERT_TRUE(Handles.close(*Stale));
+
+  // Reuse the slots many more times than an 8-bit generation could tell
+  // apart. The closed handle never comes back.
+  for (int I = 0; I < 100000; ++I) {
+    auto Handle = Handles.registerManager(std::make_shared<int>(I));
+    ASSERT_TRUE(Handle);
+    ASSERT_NE(*Handle, *Stale);
+    ASSERT_EQ(Handles.get(*Stale).error(), __WASI_CRYPTO_ERRNO_INVALID_HANDLE);
+    ASSERT_EQ(**Handles.get(*Handle), I);
+    ASSERT_TRUE(Handles.close(*Handle));
+  }
+}
+
+} // namespace WasiCrypto
+} // namespace Host
+} // namespace WasmEdge
@@ -3,6 +3,9 @@
 
 #include "helper.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace WasmEdge {
 namespace Host {
 namespace WasiCrypto {
@@ -115,6 +118,43 @@ TEST_F(WasiCryptoTest, Hash) {
       "d1def71920a44d8b6c83b2eaa99379a16047cc82cec8d80689fbf02fbd0624"_u8v);
 }
 
+/// The contexts are reused from a cache, so no state of a closed hash may leak
+/// into the next one, of the same or another algorithm.
+TEST_F(WasiCryptoTest, HashContextReuse) {
+  const auto Sha256 =
+      "13c40eec22541a155e172010c7fd6ef654e4e138a0c20923f9a91062a27f57b6"_u8v;
+  const auto Sha512 =
+      "78d0b55eeb3a07754f0967a6e960b5b7488b09ec4d2a62d832a45d80f814aef88e5414e2115165012ac592ff050651e956089a5aacd4ea52cf247c3cc2f6add2"_u8v;
+
+  for (int I = 0; I < 64; ++I) {
+    const bool Is256 = I % 2 == 0;
+    const auto &Expected = Is256 ? Sha256 : Sha512;
+    SCOPED_TRACE(I);
+    WASI_CRYPTO_EXPECT_SUCCESS(
+        StateHandle, symmetricStateOpen(Is256 ? "SHA-256"sv : "SHA-512"sv,
+                                        std::nullopt, std::nullopt));
+    WASI_CRYPTO_EXPECT_TRUE(symmetricStateAbsorb(StateHandle, "data"_u8));
+    // The clone continues from the absorbed data, and outlives the original.
+    WASI_CRYPTO_EXPECT_SUCCESS(CloneHandle, symmetricStateClone(StateHandle));
+    WASI_CRYPTO_EXPECT_TRUE(symmetricStateAbsorb(StateHandle, "more_data"_u8));
+
+    // Squeezing leaves the state unchanged.
+    std::vector<uint8_t> Out(Expected.size());
+    WASI_CRYPTO_EXPECT_TRUE(symmetricStateSqueeze(StateHandle, Out));
+    EXPECT_EQ(Out, Expected);
+    std::fill(Out.begin(), Out.end(), 0);
+    WASI_CRYPTO_EXPECT_TRUE(symmetricStateSqueeze(StateHandle, Out));
+    EXPECT_EQ(Out, Expected);
+    WASI_CRYPTO_EXPECT_TRUE(symmetricStateClose(StateHandle));
+
+    std::fill(Out.begin(), Out.end(), 0);
+    WASI_CRYPTO_EXPECT_TRUE(symmetricStateAbsorb(CloneHandle, "more_data"_u8));
+    WASI_CRYPTO_EXPECT_TRUE(symmetricStateSqueeze(CloneHandle, Out));
+    EXPECT_EQ(Out, Expected);
+    WASI_CRYPTO_EXPECT_TRUE(symmetricStateClose(CloneHandle));
+  }
+}
+
 } // namespace WasiCrypto
 } // namespace Host
 } // namespace WasmEdge
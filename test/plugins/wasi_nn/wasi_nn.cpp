@@ -10,6 +10,7 @@
 #include <cstdint>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <memory>
 #include <numeric>
 #include <vector>
 
@@ -116,7 +117,7 @@ TEST(WasiNNTest, OpenVINOBackend) {
   std::array<WasmEdge::ValVariant, 1> Errno = {UINT32_C(0)};
 
   // Temp. values.
-  std::vector<WasmEdge::Host::WASINN::Graph> NNGraphTmp;
+  std::vector<std::shared_ptr<WasmEdge::Host::WASINN::Graph>> NNGraphTmp;
   std::vector<WasmEdge::Host::WASINN::Context> NNContextTmp;
 
   // Get the function "load".
@@ -149,6 +150,18 @@ TEST(WasiNNTest, OpenVINOBackend) {
   EXPECT_TRUE(FuncInst->isHostFunction());
   auto &HostFuncCompute =
       dynamic_cast<WasmEdge::Host::WasiNNCompute &>(FuncInst->getHostFunc());
+  // Get the function "set_inputs".
+  FuncInst = NNMod->findFuncExports("set_inputs");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &HostFuncSetInputs =
+      dynamic_cast<WasmEdge::Host::WasiNNSetInputs &>(FuncInst->getHostFunc());
+  // Get the function "get_outputs".
+  FuncInst = NNMod->findFuncExports("get_outputs");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &HostFuncGetOutputs = dynamic_cast<WasmEdge::Host::WasiNNGetOutputs &>(
+      FuncInst->getHostFunc());
 
   // OpenVINO WASI-NN load tests.
   // Test: load -- meaningless binaries.
@@ -265,6 +278,29 @@ TEST(WasiNNTest, OpenVINOBackend) {
     BuilderPtr += 4;
   }
 
+  // Test: load -- the same model is shared between graphs and environments.
+  {
+    auto &NNGraph = NNMod->getEnv().NNGraph;
+    EXPECT_EQ(NNGraph[0], NNGraph[1]);
+    std::unique_ptr<WasmEdge::Host::WasiNNModule> NNMod2(
+        dynamic_cast<WasmEdge::Host::WasiNNModule *>(createModule()));
+    ASSERT_TRUE(NNMod2 != nullptr);
+    auto *FuncInst2 = NNMod2->findFuncExports("load");
+    ASSERT_NE(FuncInst2, nullptr);
+    auto &HostFuncLoad2 =
+        dynamic_cast<WasmEdge::Host::WasiNNLoad &>(FuncInst2->getHostFunc());
+    EXPECT_TRUE(HostFuncLoad2.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{
+            LoadEntryPtr, UINT32_C(2), UINT32_C(0), UINT32_C(0), BuilderPtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), static_cast<uint32_t>(ErrNo::Success));
+    EXPECT_EQ(*MemInst.getPointer<uint32_t *>(BuilderPtr), 0);
+    EXPECT_EQ(NNMod2->getEnv().NNGraph[0], NNGraph[0]);
+    NNMod2.reset();
+    EXPECT_EQ(NNGraph[0].use_count(), 2);
+  }
+
   // OpenVINO WASI-NN init_execution_context tests.
   // Test: init_execution_context -- graph id invalid.
   {
@@ -277,7 +313,8 @@ TEST(WasiNNTest, OpenVINOBackend) {
   }
 
   // Swap to the tmp. env.
-  NNGraphTmp.emplace_back(Backend::OpenVINO);
+  NNGraphTmp.emplace_back(
+      std::make_shared<WasmEdge::Host::WASINN::Graph>(Backend::OpenVINO));
   NNGraphTmp.swap(NNMod->getEnv().NNGraph);
   NNContextTmp.swap(NNMod->getEnv().NNContext);
   // Test: init_execution_context -- graph id exceeds.
@@ -380,6 +417,22 @@ TEST(WasiNNTest, OpenVINOBackend) {
               static_cast<uint32_t>(ErrNo::InvalidArgument));
   }
 
+  // Test: set_input -- tensor data size not matched with the dimensions.
+  BuilderPtr = SetInputEntryPtr;
+  writeFatPointer(MemInst, StorePtr, TensorDim.size(), BuilderPtr);
+  writeUInt32(MemInst, UINT32_C(1), BuilderPtr);
+  writeFatPointer(MemInst, StorePtr + TensorDim.size() * 4,
+                  TensorData.size() - 4, BuilderPtr);
+  {
+    EXPECT_TRUE(
+        HostFuncSetInput.run(CallFrame,
+                             std::initializer_list<WasmEdge::ValVariant>{
+                                 UINT32_C(1), UINT32_C(0), SetInputEntryPtr},
+                             Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(),
+              static_cast<uint32_t>(ErrNo::InvalidArgument));
+  }
+
   // Test: set_input -- set input successfully.
   BuilderPtr = SetInputEntryPtr;
   writeFatPointer(MemInst, StorePtr, TensorDim.size(), BuilderPtr);
@@ -481,6 +534,72 @@ TEST(WasiNNTest, OpenVINOBackend) {
       EXPECT_EQ(SortedIndex[I], CorrectClasses[I]);
     }
   }
+
+  // OpenVINO WASI-NN set_inputs and get_outputs tests.
+  // Test: set_inputs -- tensors ptr out of bounds.
+  {
+    EXPECT_TRUE(
+        HostFuncSetInputs.run(CallFrame,
+                              std::initializer_list<WasmEdge::ValVariant>{
+                                  UINT32_C(1), OutBoundPtr, UINT32_C(1)},
+                              Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(),
+              static_cast<uint32_t>(ErrNo::InvalidArgument));
+  }
+
+  // Test: set_inputs -- set inputs successfully.
+  {
+    EXPECT_TRUE(
+        HostFuncSetInputs.run(CallFrame,
+                              std::initializer_list<WasmEdge::ValVariant>{
+                                  UINT32_C(1), SetInputEntryPtr, UINT32_C(1)},
+                              Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), static_cast<uint32_t>(ErrNo::Success));
+  }
+
+  // Test: compute -- compute again with the same context.
+  {
+    EXPECT_TRUE(HostFuncCompute.run(
+        CallFrame, std::initializer_list<WasmEdge::ValVariant>{UINT32_C(1)},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), static_cast<uint32_t>(ErrNo::Success));
+  }
+
+  // Test: get_outputs -- output buffers ptr out of bounds.
+  {
+    EXPECT_TRUE(HostFuncGetOutputs.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{UINT32_C(1), OutBoundPtr,
+                                                    UINT32_C(1), BuilderPtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(),
+              static_cast<uint32_t>(ErrNo::InvalidArgument));
+  }
+
+  // Test: get_outputs -- get outputs successfully.
+  {
+    uint32_t OutBuffersPtr = BuilderPtr;
+    uint32_t BytesWrittenPtr = BuilderPtr + 8;
+    std::fill_n(MemInst.getPointer<uint8_t *>(StorePtr, 4004), 4004,
+                UINT8_C(0));
+    writeFatPointer(MemInst, StorePtr, 65532, BuilderPtr);
+    EXPECT_TRUE(HostFuncGetOutputs.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{
+            UINT32_C(1), OutBuffersPtr, UINT32_C(1), BytesWrittenPtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), static_cast<uint32_t>(ErrNo::Success));
+    EXPECT_EQ(*MemInst.getPointer<uint32_t *>(BytesWrittenPtr),
+              UINT32_C(4004));
+    std::vector<float> OutputClassification(
+        MemInst.getPointer<float *>(StorePtr, 1001) + 1,
+        MemInst.getPointer<float *>(StorePtr, 1001) + 1001);
+    std::vector<size_t> SortedIndex, CorrectClasses{963, 762, 909, 926, 567};
+    SortedIndex = classSort<float>(OutputClassification);
+    for (size_t I = 0; I < CorrectClasses.size(); I++) {
+      EXPECT_EQ(SortedIndex[I], CorrectClasses[I]);
+    }
+  }
 }
 #endif // WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
 
@@ -517,7 +636,7 @@ TEST(WasiNNTest, PyTorchBackend) {
   std::array<WasmEdge::ValVariant, 1> Errno = {UINT32_C(0)};
 
   // Temp. values.
-  std::vector<WasmEdge::Host::WASINN::Graph> NNGraphTmp;
+  std::vector<std::shared_ptr<WasmEdge::Host::WASINN::Graph>> NNGraphTmp;
   std::vector<WasmEdge::Host::WASINN::Context> NNContextTmp;
 
   // Get the function "load".
@@ -550,6 +669,18 @@ TEST(WasiNNTest, PyTorchBackend) {
   EXPECT_TRUE(FuncInst->isHostFunction());
   auto &HostFuncCompute =
       dynamic_cast<WasmEdge::Host::WasiNNCompute &>(FuncInst->getHostFunc());
+  // Get the function "set_inputs".
+  FuncInst = NNMod->findFuncExports("set_inputs");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &HostFuncSetInputs =
+      dynamic_cast<WasmEdge::Host::WasiNNSetInputs &>(FuncInst->getHostFunc());
+  // Get the function "get_outputs".
+  FuncInst = NNMod->findFuncExports("get_outputs");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &HostFuncGetOutputs = dynamic_cast<WasmEdge::Host::WasiNNGetOutputs &>(
+      FuncInst->getHostFunc());
 
   // Torch WASI-NN load tests.
   // Test: load -- meaningless binaries.
@@ -655,6 +786,30 @@ TEST(WasiNNTest, PyTorchBackend) {
     BuilderPtr += 4;
   }
 
+  // Test: load -- the same model is shared between graphs and environments.
+  {
+    auto &NNGraph = NNMod->getEnv().NNGraph;
+    EXPECT_EQ(NNGraph[0], NNGraph[1]);
+    std::unique_ptr<WasmEdge::Host::WasiNNModule> NNMod2(
+        dynamic_cast<WasmEdge::Host::WasiNNModule *>(createModule()));
+    ASSERT_TRUE(NNMod2 != nullptr);
+    auto *FuncInst2 = NNMod2->findFuncExports("load");
+    ASSERT_NE(FuncInst2, nullptr);
+    auto &HostFuncLoad2 =
+        dynamic_cast<WasmEdge::Host::WasiNNLoad &>(FuncInst2->getHostFunc());
+    EXPECT_TRUE(HostFuncLoad2.run(CallFrame,
+                                  std::initializer_list<WasmEdge::ValVariant>{
+                                      LoadEntryPtr, UINT32_C(1),
+                                      static_cast<uint32_t>(Backend::PyTorch),
+                                      UINT32_C(0), BuilderPtr},
+                                  Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), static_cast<uint32_t>(ErrNo::Success));
+    EXPECT_EQ(*MemInst.getPointer<uint32_t *>(BuilderPtr), 0);
+    EXPECT_EQ(NNMod2->getEnv().NNGraph[0], NNGraph[0]);
+    NNMod2.reset();
+    EXPECT_EQ(NNGraph[0].use_count(), 2);
+  }
+
   // Torch WASI-NN init_execution_context tests.
   // Test: init_execution_context -- graph id invalid.
   {
@@ -667,7 +822,8 @@ TEST(WasiNNTest, PyTorchBackend) {
   }
 
   // Swap to the tmp. env.
-  NNGraphTmp.emplace_back(Backend::PyTorch);
+  NNGraphTmp.emplace_back(
+      std::make_shared<WasmEdge::Host::WASINN::Graph>(Backend::PyTorch));
   // Test: init_execution_context -- graph id exceeds.
   // TODO: not null test for pytorch now
   //   NNGraphTmp.swap(NNMod->getEnv().NNGraph);
@@ -744,6 +900,22 @@ TEST(WasiNNTest, PyTorchBackend) {
               static_cast<uint32_t>(ErrNo::InvalidArgument));
   }
 
+  // Test: set_input -- tensor data size not matched with the dimensions.
+  BuilderPtr = SetInputEntryPtr;
+  writeFatPointer(MemInst, StorePtr, TensorDim.size(), BuilderPtr);
+  writeUInt32(MemInst, UINT32_C(1), BuilderPtr);
+  writeFatPointer(MemInst, StorePtr + TensorDim.size() * 4,
+                  TensorData.size() - 4, BuilderPtr);
+  {
+    EXPECT_TRUE(
+        HostFuncSetInput.run(CallFrame,
+                             std::initializer_list<WasmEdge::ValVariant>{
+                                 UINT32_C(1), UINT32_C(0), SetInputEntryPtr},
+                             Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(),
+              static_cast<uint32_t>(ErrNo::InvalidArgument));
+  }
+
   // Test: set_input -- set input successfully.
   BuilderPtr = SetInputEntryPtr;
   writeFatPointer(MemInst, StorePtr, TensorDim.size(), BuilderPtr);
@@ -846,5 +1018,71 @@ TEST(WasiNNTest, PyTorchBackend) {
       EXPECT_EQ(SortedIndex[I], CorrectClasses[I]);
     }
   }
+
+  // Torch WASI-NN set_inputs and get_outputs tests.
+  // Test: set_inputs -- tensors ptr out of bounds.
+  {
+    EXPECT_TRUE(
+        HostFuncSetInputs.run(CallFrame,
+                              std::initializer_list<WasmEdge::ValVariant>{
+                                  UINT32_C(1), OutBoundPtr, UINT32_C(1)},
+                              Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(),
+              static_cast<uint32_t>(ErrNo::InvalidArgument));
+  }
+
+  // Test: set_inputs -- set inputs successfully.
+  {
+    EXPECT_TRUE(
+        HostFuncSetInputs.run(CallFrame,
+                              std::initializer_list<WasmEdge::ValVariant>{
+                                  UINT32_C(1), SetInputEntryPtr, UINT32_C(1)},
+                              Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), static_cast<uint32_t>(ErrNo::Success));
+  }
+
+  // Test: compute -- compute again with the same context.
+  {
+    EXPECT_TRUE(HostFuncCompute.run(
+        CallFrame, std::initializer_list<WasmEdge::ValVariant>{UINT32_C(1)},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), static_cast<uint32_t>(ErrNo::Success));
+  }
+
+  // Test: get_outputs -- output buffers ptr out of bounds.
+  {
+    EXPECT_TRUE(HostFuncGetOutputs.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{UINT32_C(1), OutBoundPtr,
+                                                    UINT32_C(1), BuilderPtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(),
+              static_cast<uint32_t>(ErrNo::InvalidArgument));
+  }
+
+  // Test: get_outputs -- get outputs successfully.
+  {
+    uint32_t OutBuffersPtr = BuilderPtr;
+    uint32_t BytesWrittenPtr = BuilderPtr + 8;
+    std::fill_n(MemInst.getPointer<uint8_t *>(StorePtr, 4000), 4000,
+                UINT8_C(0));
+    writeFatPointer(MemInst, StorePtr, 65532, BuilderPtr);
+    EXPECT_TRUE(HostFuncGetOutputs.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{
+            UINT32_C(1), OutBuffersPtr, UINT32_C(1), BytesWrittenPtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), static_cast<uint32_t>(ErrNo::Success));
+    EXPECT_EQ(*MemInst.getPointer<uint32_t *>(BytesWrittenPtr),
+              UINT32_C(4000));
+    std::vector<float> OutputClassification(
+        MemInst.getPointer<float *>(StorePtr, 1000),
+        MemInst.getPointer<float *>(StorePtr, 1000) + 1000);
+    std::vector<size_t> SortedIndex, CorrectClasses{954, 940, 951, 950, 953};
+    SortedIndex = classSort<float>(OutputClassification);
+    for (size_t I = 0; I < CorrectClasses.size(); I++) {
+      EXPECT_EQ(SortedIndex[I], CorrectClasses[I]);
+    }
+  }
 }
 #endif // WASMEDGE_PLUGIN_WASI_NN_BACKEND_TORCH
\ No newline at end of file
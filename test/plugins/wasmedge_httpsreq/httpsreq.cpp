@@ -6,13 +6,26 @@
 #include "httpsreqmodule.h"
 #include "runtime/instance/module.h"
 
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <charconv>
+#include <csignal>
 #include <cstdint>
 #include <gtest/gtest.h>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 namespace {
 WasmEdge::Runtime::Instance::ModuleInstance *createModule() {
   using namespace std::literals::string_view_literals;
@@ -39,8 +52,204 @@ void fillMemContent(WasmEdge::Runtime::Instance::MemoryInstance &MemInst,
   std::copy_n(Str.c_str(), Str.length(), Buf);
 }
 
+/// Local TLS server with a self-signed certificate. It answers the first
+/// request on each connection with a keep-alive response, and closes the
+/// connection without response on the later requests, as a server closing an
+/// idle connection at the same time.
+class TLSServer {
+public:
+  TLSServer() {
+    EVP_PKEY *Key = EVP_EC_gen("P-256");
+    X509 *Cert = X509_new();
+    ASN1_INTEGER_set(X509_get_serialNumber(Cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(Cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(Cert), 3600);
+    X509_set_pubkey(Cert, Key);
+    X509_NAME *Name = X509_get_subject_name(Cert);
+    X509_NAME_add_entry_by_txt(
+        Name, "CN", MBSTRING_ASC,
+        reinterpret_cast<const unsigned char *>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(Cert, Name);
+    X509_sign(Cert, Key, EVP_sha256());
+    Ctx = SSL_CTX_new(TLS_server_method());
+    SSL_CTX_use_certificate(Ctx, Cert);
+    SSL_CTX_use_PrivateKey(Ctx, Key);
+    X509_free(Cert);
+    EVP_PKEY_free(Key);
+
+    ListenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in Addr = {};
+    Addr.sin_family = AF_INET;
+    Addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t AddrLen = sizeof(Addr);
+    bind(ListenFd, reinterpret_cast<sockaddr *>(&Addr), AddrLen);
+    listen(ListenFd, 4);
+    getsockname(ListenFd, reinterpret_cast<sockaddr *>(&Addr), &AddrLen);
+    Port = ntohs(Addr.sin_port);
+    Worker = std::thread([this]() { run(); });
+  }
+  ~TLSServer() {
+    // Wake up the blocking accept, or the read on the connection kept alive by
+    // the client.
+    Stopped = true;
+    shutdown(ListenFd, SHUT_RDWR);
+    if (const int Fd = ConnFd.load(); Fd >= 0) {
+      shutdown(Fd, SHUT_RDWR);
+    }
+    Worker.join();
+    close(ListenFd);
+    SSL_CTX_free(Ctx);
+  }
+
+  uint16_t Port = 0;
+  std::atomic_uint32_t Connections = 0;
+  std::atomic_uint32_t Requests = 0;
+
+private:
+  void run() {
+    // The connections are shut down while the server may write to them.
+    sigset_t PipeSet;
+    sigemptyset(&PipeSet);
+    sigaddset(&PipeSet, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &PipeSet, nullptr);
+    while (true) {
+      const int Fd = accept(ListenFd, nullptr, nullptr);
+      if (Fd < 0) {
+        return;
+      }
+      ++Connections;
+      ConnFd = Fd;
+      SSL *Ssl = SSL_new(Ctx);
+      SSL_set_fd(Ssl, Fd);
+      if (!Stopped && SSL_accept(Ssl) == 1) {
+        serve(Ssl);
+      }
+      SSL_free(Ssl);
+      ConnFd = -1;
+      close(Fd);
+    }
+  }
+
+  void serve(SSL *Ssl) {
+    for (uint32_t Served = 0;; ++Served) {
+      if (!readRequest(Ssl)) {
+        return;
+      }
+      ++Requests;
+      if (Served > 0) {
+        return;
+      }
+      const std::string_view Response =
+          "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+      SSL_write(Ssl, Response.data(), static_cast<int>(Response.size()));
+    }
+  }
+
+  static bool readRequest(SSL *Ssl) {
+    std::string Data;
+    size_t End = std::string::npos, Length = 0;
+    while (End == std::string::npos || Data.size() < End + 4 + Length) {
+      char Buf[1024];
+      const int Read = SSL_read(Ssl, Buf, sizeof(Buf));
+      if (Read <= 0) {
+        return false;
+      }
+      Data.append(Buf, static_cast<size_t>(Read));
+      if (End == std::string::npos &&
+          (End = Data.find("\r\n\r\n")) != std::string::npos) {
+        if (const auto Pos = Data.find("Content-Length: ");
+            Pos != std::string::npos && Pos < End) {
+          std::from_chars(Data.data() + Pos + 16, Data.data() + End, Length);
+        }
+      }
+    }
+    return true;
+  }
+
+  SSL_CTX *Ctx = nullptr;
+  int ListenFd = -1;
+  std::atomic_int ConnFd = -1;
+  std::atomic_bool Stopped = false;
+  std::thread Worker;
+};
+
+/// Send the request to the local server by the host functions, and get the
+/// response.
+bool sendLocal(WasmEdge::Host::WasmEdgeHttpsReqModule &HttpMod, uint16_t Port,
+               const std::string &Request, std::string &Response) {
+  WasmEdge::Runtime::Instance::ModuleInstance Mod("");
+  Mod.addHostMemory(
+      "memory", std::make_unique<WasmEdge::Runtime::Instance::MemoryInstance>(
+                    WasmEdge::AST::MemoryType(1)));
+  auto &MemInst = *Mod.findMemoryExports("memory");
+  WasmEdge::Runtime::CallingFrame CallFrame(nullptr, &Mod);
+  fillMemContent(MemInst, 0, std::string("localhost"));
+  fillMemContent(MemInst, 64, Request);
+
+  auto &SendData = dynamic_cast<WasmEdge::Host::WasmEdgeHttpsReqSendData &>(
+      HttpMod.findFuncExports("wasmedge_httpsreq_send_data")->getHostFunc());
+  auto &GetRcvLen = dynamic_cast<WasmEdge::Host::WasmEdgeHttpsReqGetRcvLen &>(
+      HttpMod.findFuncExports("wasmedge_httpsreq_get_rcv_len")->getHostFunc());
+  auto &GetRcv = dynamic_cast<WasmEdge::Host::WasmEdgeHttpsReqGetRcv &>(
+      HttpMod.findFuncExports("wasmedge_httpsreq_get_rcv")->getHostFunc());
+  if (!SendData.run(CallFrame,
+                    std::initializer_list<WasmEdge::ValVariant>{
+                        UINT32_C(0), UINT32_C(9), static_cast<uint32_t>(Port),
+                        UINT32_C(64), static_cast<uint32_t>(Request.size())},
+                    {})) {
+    return false;
+  }
+  std::array<WasmEdge::ValVariant, 1> RetVal;
+  if (!GetRcvLen.run(CallFrame, {}, RetVal) ||
+      !GetRcv.run(CallFrame,
+                  std::initializer_list<WasmEdge::ValVariant>{UINT32_C(4096)},
+                  {})) {
+    return false;
+  }
+  Response.assign(MemInst.getPointer<const char *>(4096),
+                  RetVal[0].get<uint32_t>());
+  return true;
+}
+
 } // namespace
 
+TEST(wasmedgeHttpsReqTests, RetryIdempotent) {
+  std::unique_ptr<WasmEdge::Host::WasmEdgeHttpsReqModule> HttpMod(
+      dynamic_cast<WasmEdge::Host::WasmEdgeHttpsReqModule *>(createModule()));
+  ASSERT_TRUE(HttpMod);
+  TLSServer Server;
+  const std::string Request = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+  std::string Response;
+
+  ASSERT_TRUE(sendLocal(*HttpMod, Server.Port, Request, Response));
+  EXPECT_EQ(Response.substr(Response.size() - 2), "ok");
+  // The kept connection is reused and closed by the server, so the request is
+  // sent again on a new connection.
+  Response.clear();
+  ASSERT_TRUE(sendLocal(*HttpMod, Server.Port, Request, Response));
+  EXPECT_EQ(Response.substr(Response.size() - 2), "ok");
+  EXPECT_EQ(Server.Connections.load(), 2U);
+  EXPECT_EQ(Server.Requests.load(), 3U);
+}
+
+TEST(wasmedgeHttpsReqTests, NoRetryPost) {
+  std::unique_ptr<WasmEdge::Host::WasmEdgeHttpsReqModule> HttpMod(
+      dynamic_cast<WasmEdge::Host::WasmEdgeHttpsReqModule *>(createModule()));
+  ASSERT_TRUE(HttpMod);
+  TLSServer Server;
+  const std::string Request = "POST / HTTP/1.1\r\nHost: localhost\r\n"
+                              "Content-Length: 4\r\n\r\ndata";
+  std::string Response;
+
+  ASSERT_TRUE(sendLocal(*HttpMod, Server.Port, Request, Response));
+  EXPECT_EQ(Response.substr(Response.size() - 2), "ok");
+  // The server may have processed the request on the closed connection, so
+  // it fails instead of being sent twice.
+  EXPECT_FALSE(sendLocal(*HttpMod, Server.Port, Request, Response));
+  EXPECT_EQ(Server.Connections.load(), 1U);
+  EXPECT_EQ(Server.Requests.load(), 2U);
+}
+
 TEST(wasmedgeHttpsReqTests, SendData) {
   // Create the wasmedge httpsreq module instance.
   auto *HttpMod =
@@ -8,6 +8,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cerrno>
+#include <chrono>
 #include <cstdint>
 #include <gtest/gtest.h>
 #include <string>
@@ -375,6 +377,29 @@ TEST(WasmEdgeProcessTest, Run) {
   EXPECT_TRUE(std::equal(ProcMod->getEnv().StdOut.begin(),
                          ProcMod->getEnv().StdOut.end(), OutStr.begin()));
 
+  // Test: Run function successfully to pipe a large input through "/bin/cat".
+  ProcMod->getEnv().AllowedCmd.insert("/bin/cat");
+  ProcMod->getEnv().Name = "/bin/cat";
+  ProcMod->getEnv().StdIn.resize(1024 * 1024);
+  for (size_t I = 0; I < ProcMod->getEnv().StdIn.size(); ++I) {
+    ProcMod->getEnv().StdIn[I] = static_cast<uint8_t>(I * 7);
+  }
+  std::vector<uint8_t> InBytes = ProcMod->getEnv().StdIn;
+  EXPECT_TRUE(HostFuncInst.run(DummyCallFrame, {}, RetVal));
+  EXPECT_EQ(RetVal[0].get<int32_t>(), 0);
+  EXPECT_EQ(ProcMod->getEnv().StdOut, InBytes);
+  EXPECT_TRUE(ProcMod->getEnv().StdErr.size() == 0);
+
+  // Test: Run function to interrupt "/bin/sleep" by the timeout.
+  ProcMod->getEnv().AllowedCmd.insert("/bin/sleep");
+  ProcMod->getEnv().Name = "/bin/sleep";
+  ProcMod->getEnv().Args.push_back("10");
+  ProcMod->getEnv().TimeOut = 100;
+  const auto Start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(HostFuncInst.run(DummyCallFrame, {}, RetVal));
+  EXPECT_LT(std::chrono::steady_clock::now() - Start, std::chrono::seconds(5));
+  EXPECT_EQ(RetVal[0].get<int32_t>(), ETIMEDOUT);
+
   delete ProcMod;
 }
 
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "system/perfmap.h"
+#include "common/defines.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if WASMEDGE_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if WASMEDGE_OS_LINUX
+using namespace std::literals;
+
+std::string readFile(const std::filesystem::path &Path) {
+  std::ifstream File(Path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(File),
+          std::istreambuf_iterator<char>()};
+}
+
+void writeFile(const std::filesystem::path &Path, const std::string &Content) {
+  std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+  File << Content;
+}
+
+// The files are opened once per process, so the refused and the created cases
+// are in the same test in order.
+TEST(PerfMapTest, CreateFiles) {
+  namespace fs = std::filesystem;
+  const auto Pid = std::to_string(getpid());
+  const fs::path MapPath = "/tmp/perf-"s + Pid + ".map";
+  const fs::path DumpPath = "/tmp/jit-"s + Pid + ".dump";
+  const auto Dir = fs::temp_directory_path() / ("wasmedge-perfmap-"s + Pid);
+  fs::remove_all(Dir);
+  fs::create_directories(Dir);
+  fs::remove(MapPath);
+  fs::remove(DumpPath);
+
+  const std::array<uint8_t, 4> Code = {0x90, 0x90, 0x90, 0xC3};
+  const std::vector<WasmEdge::PerfMap::Entry> Entries = {
+      {Code.data(), Code.size(), "wasm-function[0]"}};
+
+  // A symbolic link planted at the path is not followed.
+  const auto Target = Dir / "target";
+  writeFile(Target, "keep");
+  fs::create_symlink(Target, MapPath);
+  WasmEdge::PerfMap::writePerfMap(Entries);
+  EXPECT_EQ(readFile(Target), "keep");
+  EXPECT_TRUE(fs::is_symlink(fs::symlink_status(MapPath)));
+
+  // An existing file is not reused.
+  writeFile(DumpPath, "keep");
+  WasmEdge::PerfMap::writeJitDump(Entries);
+  EXPECT_EQ(readFile(DumpPath), "keep");
+
+  // The files are created for the user only.
+  fs::remove(MapPath);
+  fs::remove(DumpPath);
+  WasmEdge::PerfMap::writePerfMap(Entries);
+  WasmEdge::PerfMap::writeJitDump(Entries);
+  ASSERT_TRUE(fs::exists(MapPath));
+  ASSERT_TRUE(fs::exists(DumpPath));
+  const auto Owner = fs::perms::owner_read | fs::perms::owner_write;
+  EXPECT_EQ(fs::status(MapPath).permissions(), Owner);
+  EXPECT_EQ(fs::status(DumpPath).permissions(), Owner);
+  const auto Map = readFile(MapPath);
+  EXPECT_NE(Map.find(" 4 wasm-function[0]\n"), std::string::npos);
+  const auto Dump = readFile(DumpPath);
+  ASSERT_GE(Dump.size(), 4U);
+  EXPECT_EQ(Dump.substr(0, 4), "DTiJ"s);
+
+  fs::remove(MapPath);
+  fs::remove(DumpPath);
+  fs::remove_all(Dir);
+}
+#endif
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
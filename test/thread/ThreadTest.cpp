@@ -13,6 +13,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "common/log.h"
+#include "executor/profiler.h"
+#include "vm/scheduler.h"
 #include "vm/vm.h"
 
 #ifdef WASMEDGE_BUILD_AOT_RUNTIME
@@ -22,8 +24,12 @@
 #include "gtest/gtest.h"
 
 #include <fstream>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -164,6 +170,70 @@ std::array<uint64_t, 4> Answers{
 
 using namespace std::literals;
 
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+// Compile the module in memory, and load the code without the linker.
+std::unique_ptr<WasmEdge::AST::Module>
+compileModule(const WasmEdge::Configure &Conf,
+              WasmEdge::Span<const WasmEdge::Byte> Wasm) {
+  WasmEdge::Loader::Loader Loader(Conf,
+                                  &WasmEdge::Executor::Executor::Intrinsics);
+  WasmEdge::Validator::Validator ValidatorEngine(Conf);
+  WasmEdge::AOT::Compiler Compiler(Conf);
+  auto Module = Loader.parseModule(Wasm);
+  if (!Module || !ValidatorEngine.validate(**Module) ||
+      !Compiler.compile(Wasm, **Module) || !Loader.loadAOTSection(**Module)) {
+    return nullptr;
+  }
+  return std::move(*Module);
+}
+#endif
+
+// Run the mt19937 in 4 threads sharing the statistics with a cost limit
+// of 2.5 times the cost of one run. The threads together must not exceed the
+// limit, and the runs over it must fail.
+void checkGasLimit(WasmEdge::Configure Conf,
+                   const std::function<bool(WasmEdge::VM::VM &)> &Setup) {
+  uint64_t RunCost;
+  {
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(Setup(VM));
+    ASSERT_TRUE(VM.execute(
+        "mt19937",
+        std::initializer_list<WasmEdge::ValVariant>{
+            UINT32_C(0), UINT64_C(5489), UINT64_C(100000)},
+        {WasmEdge::ValType::I32, WasmEdge::ValType::I64,
+         WasmEdge::ValType::I64}));
+    RunCost = VM.getStatistics().getTotalCost();
+  }
+  const uint64_t Limit = RunCost * 2 + RunCost / 2;
+  Conf.getStatisticsConfigure().setCostLimit(Limit);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(Setup(VM));
+  std::array<WasmEdge::VM::Async<WasmEdge::Expect<
+                 std::vector<std::pair<WasmEdge::ValVariant, WasmEdge::ValType>>>>,
+             4>
+      AsyncResults;
+  for (uint64_t Index = 0; Index < AsyncResults.size(); ++Index) {
+    AsyncResults[Index] = VM.asyncExecute(
+        "mt19937",
+        std::initializer_list<WasmEdge::ValVariant>{
+            UINT32_C(2504) * Index, UINT64_C(5489), UINT64_C(100000)},
+        {WasmEdge::ValType::I32, WasmEdge::ValType::I64,
+         WasmEdge::ValType::I64});
+  }
+  uint32_t Succeeded = 0;
+  for (auto &AsyncResult : AsyncResults) {
+    if (auto Result = AsyncResult.get()) {
+      EXPECT_EQ((*Result)[0].first.get<uint64_t>(), Answers[0]);
+      ++Succeeded;
+    } else {
+      EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::CostLimitExceeded);
+    }
+  }
+  EXPECT_LE(Succeeded, 2U);
+  EXPECT_LE(VM.getStatistics().getTotalCost(), Limit);
+}
+
 TEST(AsyncExecute, ThreadTest) {
   WasmEdge::Configure Conf;
   WasmEdge::VM::VM VM(Conf);
@@ -223,6 +293,524 @@ TEST(AsyncExecute, GasThreadTest) {
   }
 }
 
+TEST(AsyncExecute, GasLimitThreadTest) {
+  WasmEdge::Configure Conf;
+  Conf.getStatisticsConfigure().setCostMeasuring(true);
+  checkGasLimit(Conf, [](WasmEdge::VM::VM &VM) {
+    return VM.loadWasm(MersenneTwister19937) && VM.validate() &&
+           VM.instantiate();
+  });
+}
+
+TEST(SharedModule, ThreadTest) {
+  WasmEdge::Configure Conf;
+  std::shared_ptr<const WasmEdge::AST::Module> Module;
+  {
+    WasmEdge::VM::VM VM(Conf);
+    EXPECT_EQ(VM.getValidatedModule(), nullptr);
+    ASSERT_TRUE(VM.loadWasm(MersenneTwister19937));
+    EXPECT_EQ(VM.getValidatedModule(), nullptr);
+    ASSERT_TRUE(VM.validate());
+    Module = VM.getValidatedModule();
+    ASSERT_NE(Module, nullptr);
+  }
+  // The module outlives the VM which loaded it.
+  const auto Instrs =
+      Module->getCodeSection().getContent()[0].getExpr().getInstrs();
+
+  std::array<std::unique_ptr<WasmEdge::VM::VM>, 4> VMs;
+  std::array<std::thread, 4> Threads;
+  std::array<std::optional<uint64_t>, 4> Results;
+  for (uint64_t Index = 0; Index < VMs.size(); ++Index) {
+    VMs[Index] = std::make_unique<WasmEdge::VM::VM>(Conf);
+    Threads[Index] = std::thread([&VM = *VMs[Index], &Module,
+                                  &Result = Results[Index], Index]() {
+      VM.newThread();
+      if (!VM.loadWasm(Module) || !VM.instantiate()) {
+        return;
+      }
+      auto Res = VM.execute(
+          "mt19937",
+          std::initializer_list<WasmEdge::ValVariant>{
+              UINT32_C(2504) * Index, UINT64_C(5489), UINT64_C(100000) + Index},
+          {WasmEdge::ValType::I32, WasmEdge::ValType::I64,
+           WasmEdge::ValType::I64});
+      if (Res && (*Res)[0].second == WasmEdge::ValType::I64) {
+        Result = (*Res)[0].first.get<uint64_t>();
+      }
+    });
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  for (uint64_t Index = 0; Index < VMs.size(); ++Index) {
+    ASSERT_TRUE(Results[Index].has_value());
+    EXPECT_EQ(*Results[Index], Answers[Index]);
+    // The instances refer to the instructions of the shared module.
+    const auto *ModInst = VMs[Index]->getActiveModule();
+    ASSERT_NE(ModInst, nullptr);
+    const auto *FuncInst = ModInst->findFuncExports("mt19937");
+    ASSERT_NE(FuncInst, nullptr);
+    EXPECT_EQ(FuncInst->getInstrs().data(), Instrs.data());
+    EXPECT_EQ(VMs[Index]->getValidatedModule(), Module);
+  }
+}
+
+TEST(SharedModule, UnvalidatedThreadTest) {
+  WasmEdge::Configure Conf;
+  WasmEdge::Loader::Loader Loader(Conf);
+  std::shared_ptr<const WasmEdge::AST::Module> Module;
+  if (auto Res = Loader.parseModule(MersenneTwister19937)) {
+    Module = std::move(*Res);
+  }
+  ASSERT_NE(Module, nullptr);
+
+  // The module not validated yet is copied, and the shared one is untouched.
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Module));
+  EXPECT_EQ(VM.getValidatedModule(), nullptr);
+  ASSERT_TRUE(VM.validate());
+  const auto Validated = VM.getValidatedModule();
+  ASSERT_NE(Validated, nullptr);
+  EXPECT_NE(Validated, Module);
+  EXPECT_TRUE(Validated->getIsValidated());
+  EXPECT_FALSE(Module->getIsValidated());
+  ASSERT_TRUE(VM.instantiate());
+  auto Res = VM.execute(
+      "mt19937",
+      std::initializer_list<WasmEdge::ValVariant>{UINT32_C(0), UINT64_C(5489),
+                                                  UINT64_C(100000)},
+      {WasmEdge::ValType::I32, WasmEdge::ValType::I64, WasmEdge::ValType::I64});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint64_t>(), Answers[0]);
+}
+
+TEST(Continuation, ThreadTest) {
+  WasmEdge::Configure Conf;
+  Conf.getStatisticsConfigure().setCostMeasuring(true);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(MersenneTwister19937));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  const auto *FuncInst = VM.getActiveModule()->findFuncExports("mt19937");
+  ASSERT_NE(FuncInst, nullptr);
+
+  auto &Exec = VM.getExecutor();
+  auto Cont = Exec.createContinuation(
+      *FuncInst,
+      std::initializer_list<WasmEdge::ValVariant>{
+          UINT32_C(0), UINT64_C(5489), UINT64_C(100000)},
+      {WasmEdge::ValType::I32, WasmEdge::ValType::I64,
+       WasmEdge::ValType::I64});
+  ASSERT_TRUE(Cont);
+  EXPECT_FALSE(Exec.createContinuation(*FuncInst, {}, {}));
+
+  // Resume with small fuel slices on alternating threads.
+  bool Returned = false;
+  for (uint32_t I = 0; !Returned; ++I) {
+    ASSERT_TRUE((*Cont)->isResumable());
+    std::thread([&]() {
+      auto Res = Exec.resume(**Cont, UINT64_C(100000));
+      ASSERT_TRUE(Res);
+      Returned = *Res;
+    }).join();
+  }
+  EXPECT_EQ((*Cont)->getStatus(),
+            WasmEdge::Executor::Continuation::Status::Returned);
+  EXPECT_GT((*Cont)->getSuspendCount(), 1U);
+  ASSERT_EQ((*Cont)->getReturns().size(), 1U);
+  EXPECT_EQ((*Cont)->getReturns()[0].first.get<uint64_t>(), Answers[0]);
+  EXPECT_FALSE(Exec.resume(**Cont));
+
+  // The invocation is not affected by the continuation.
+  auto Res = VM.execute(
+      "mt19937",
+      std::initializer_list<WasmEdge::ValVariant>{
+          UINT32_C(2504), UINT64_C(5489), UINT64_C(100001)},
+      {WasmEdge::ValType::I32, WasmEdge::ValType::I64,
+       WasmEdge::ValType::I64});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint64_t>(), Answers[1]);
+}
+
+// Host function suspending the caller until polled three times.
+class HostPoll : public WasmEdge::Runtime::HostFunction<HostPoll> {
+public:
+  HostPoll(uint32_t &Polls) : Polls(Polls) {}
+  WasmEdge::Expect<uint32_t> body(const WasmEdge::Runtime::CallingFrame &,
+                                  uint32_t Val) {
+    if (++Polls < 3) {
+      return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::Suspended);
+    }
+    return Val * 2;
+  }
+
+private:
+  uint32_t &Polls;
+};
+
+// (module
+//   (import "env" "poll" (func $poll (param i32) (result i32)))
+//   (func (export "run") (param i32) (result i32)
+//     (i32.add (call $poll (local.get 0)) (i32.const 1))))
+std::array<WasmEdge::Byte, 56> PollWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x02, 0x0c, 0x01, 0x03, 0x65, 0x6e, 0x76, 0x04,
+    0x70, 0x6f, 0x6c, 0x6c, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0x07, 0x07,
+    0x01, 0x03, 0x72, 0x75, 0x6e, 0x00, 0x01, 0x0a, 0x0b, 0x01, 0x09, 0x00,
+    0x20, 0x00, 0x10, 0x00, 0x41, 0x01, 0x6a, 0x0b,
+};
+
+TEST(Continuation, HostSuspendTest) {
+  uint32_t Polls = 0;
+  WasmEdge::Runtime::Instance::ModuleInstance Env("env");
+  Env.addHostFunc("poll", std::make_unique<HostPoll>(Polls));
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.registerModule(Env));
+  ASSERT_TRUE(VM.loadWasm(PollWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  auto Cont = VM.createContinuation(
+      "run", std::initializer_list<WasmEdge::ValVariant>{UINT32_C(20)},
+      {WasmEdge::ValType::I32});
+  ASSERT_TRUE(Cont);
+  for (uint32_t I = 1; I < 3; ++I) {
+    auto Res = VM.resume(**Cont);
+    ASSERT_TRUE(Res);
+    EXPECT_FALSE(*Res);
+    EXPECT_EQ(Polls, I);
+  }
+  auto Res = VM.resume(**Cont);
+  ASSERT_TRUE(Res);
+  EXPECT_TRUE(*Res);
+  EXPECT_EQ(Polls, 3U);
+  EXPECT_EQ((*Cont)->getSuspendCount(), 2U);
+  ASSERT_EQ((*Cont)->getReturns().size(), 1U);
+  EXPECT_EQ((*Cont)->getReturns()[0].first.get<uint32_t>(), 41U);
+
+  // The host function cannot suspend an invocation.
+  Polls = 0;
+  EXPECT_FALSE(VM.execute(
+      "run", std::initializer_list<WasmEdge::ValVariant>{UINT32_C(20)},
+      {WasmEdge::ValType::I32}));
+}
+
+// Host function counting the calls.
+class HostCount : public WasmEdge::Runtime::HostFunction<HostCount> {
+public:
+  HostCount(uint32_t &Calls) : Calls(Calls) {}
+  WasmEdge::Expect<uint32_t> body(const WasmEdge::Runtime::CallingFrame &,
+                                  uint32_t Val) {
+    ++Calls;
+    return Val + 1;
+  }
+
+private:
+  uint32_t &Calls;
+};
+
+// Host function stopping the executor of the caller.
+class HostHalt : public WasmEdge::Runtime::HostFunction<HostHalt> {
+public:
+  WasmEdge::Expect<void> body(const WasmEdge::Runtime::CallingFrame &Frame) {
+    Frame.getExecutor()->stop();
+    return {};
+  }
+};
+
+// (module
+//   (func (export "twice") (param i32) (result i32)
+//     (i32.mul (local.get 0) (i32.const 2))))
+std::array<WasmEdge::Byte, 42> TwiceWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x09, 0x01, 0x05,
+    0x74, 0x77, 0x69, 0x63, 0x65, 0x00, 0x00, 0x0a, 0x09, 0x01, 0x07, 0x00,
+    0x20, 0x00, 0x41, 0x02, 0x6c, 0x0b,
+};
+
+// (module
+//   (import "env" "halt" (func $halt))
+//   (import "env" "count" (func $count (param i32) (result i32)))
+//   (import "lib" "twice" (func $twice (param i32) (result i32)))
+//   (func (export "run") (param i32) (result i32)
+//     (i32.add (call $count (local.get 0)) (call $twice (local.get 0))))
+//   (func (export "stop") (param i32) (result i32)
+//     (call $halt) (call $count (local.get 0))))
+std::array<WasmEdge::Byte, 102> CallWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x09, 0x02, 0x60,
+    0x00, 0x00, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x02, 0x24, 0x03, 0x03, 0x65,
+    0x6e, 0x76, 0x04, 0x68, 0x61, 0x6c, 0x74, 0x00, 0x00, 0x03, 0x65, 0x6e,
+    0x76, 0x05, 0x63, 0x6f, 0x75, 0x6e, 0x74, 0x00, 0x01, 0x03, 0x6c, 0x69,
+    0x62, 0x05, 0x74, 0x77, 0x69, 0x63, 0x65, 0x00, 0x01, 0x03, 0x03, 0x02,
+    0x01, 0x01, 0x07, 0x0e, 0x02, 0x03, 0x72, 0x75, 0x6e, 0x00, 0x03, 0x04,
+    0x73, 0x74, 0x6f, 0x70, 0x00, 0x04, 0x0a, 0x16, 0x02, 0x0b, 0x00, 0x20,
+    0x00, 0x10, 0x01, 0x20, 0x00, 0x10, 0x02, 0x6a, 0x0b, 0x08, 0x00, 0x10,
+    0x00, 0x20, 0x00, 0x10, 0x01, 0x0b,
+};
+
+// Run the calls to the imported functions, and check the interruption at the
+// entry of the callee after the executor is stopped.
+void checkImportCalls(WasmEdge::VM::VM &VM, const uint32_t &Calls) {
+  auto Res = VM.execute(
+      "run", std::initializer_list<WasmEdge::ValVariant>{UINT32_C(5)},
+      {WasmEdge::ValType::I32});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 16U);
+  EXPECT_EQ(Calls, 1U);
+
+  Res = VM.execute("stop",
+                   std::initializer_list<WasmEdge::ValVariant>{UINT32_C(5)},
+                   {WasmEdge::ValType::I32});
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::Interrupted);
+  EXPECT_EQ(Calls, 1U);
+
+  // The interruption is consumed.
+  Res = VM.execute("run",
+                   std::initializer_list<WasmEdge::ValVariant>{UINT32_C(5)},
+                   {WasmEdge::ValType::I32});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 16U);
+  EXPECT_EQ(Calls, 2U);
+}
+
+TEST(ImportCall, InterpreterTest) {
+  uint32_t Calls = 0;
+  WasmEdge::Runtime::Instance::ModuleInstance Env("env");
+  Env.addHostFunc("halt", std::make_unique<HostHalt>());
+  Env.addHostFunc("count", std::make_unique<HostCount>(Calls));
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.registerModule(Env));
+  ASSERT_TRUE(VM.registerModule("lib", TwiceWasm));
+  ASSERT_TRUE(VM.loadWasm(CallWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  checkImportCalls(VM, Calls);
+}
+
+TEST(Continuation, RequestSuspendTest) {
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(MersenneTwister19937));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  auto Cont = VM.createContinuation(
+      "mt19937",
+      std::initializer_list<WasmEdge::ValVariant>{
+          UINT32_C(0), UINT64_C(5489), UINT64_C(100000)},
+      {WasmEdge::ValType::I32, WasmEdge::ValType::I64,
+       WasmEdge::ValType::I64});
+  ASSERT_TRUE(Cont);
+  // A request made before running takes effect at the first safe point.
+  EXPECT_TRUE(VM.requestSuspend(**Cont));
+  auto Res = VM.resume(**Cont);
+  ASSERT_TRUE(Res);
+  EXPECT_FALSE(*Res);
+  EXPECT_EQ((*Cont)->getSuspendCount(), 1U);
+
+  // Request from another thread while running.
+  std::thread Requester([&VM, &Cont]() { VM.requestSuspend(**Cont); });
+  do {
+    Res = VM.resume(**Cont);
+    ASSERT_TRUE(Res);
+  } while (!*Res);
+  Requester.join();
+  EXPECT_FALSE(VM.requestSuspend(**Cont));
+  ASSERT_EQ((*Cont)->getReturns().size(), 1U);
+  EXPECT_EQ((*Cont)->getReturns()[0].first.get<uint64_t>(), Answers[0]);
+}
+
+// (module
+//   (func $f (param i32) (result i32)
+//     (loop $l
+//       (br_if $l (local.tee 0 (i32.sub (local.get 0) (i32.const 1)))))
+//     (local.get 0))
+//   (func (export "run") (param i32) (result i32)
+//     (if (result i32) (local.get 0)
+//       (then (call $f (local.get 0))) (else (i32.const 7)))))
+std::array<WasmEdge::Byte, 65> BranchWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x03, 0x02, 0x00, 0x00, 0x07, 0x07, 0x01,
+    0x03, 0x72, 0x75, 0x6e, 0x00, 0x01, 0x0a, 0x21, 0x02, 0x10, 0x00, 0x03,
+    0x40, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x22, 0x00, 0x0d, 0x00, 0x0b, 0x20,
+    0x00, 0x0b, 0x0e, 0x00, 0x20, 0x00, 0x04, 0x7f, 0x20, 0x00, 0x10, 0x00,
+    0x05, 0x41, 0x07, 0x0b, 0x0b,
+};
+// Offsets of the `br_if` and the `if` instructions in the binary.
+constexpr uint32_t BranchWasmBrIf = 44;
+constexpr uint32_t BranchWasmIf = 54;
+
+TEST(PGOProfile, ThreadTest) {
+  WasmEdge::PGO::Profile Prof;
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  VM.setPGOProfile(&Prof);
+  ASSERT_TRUE(VM.loadWasm(BranchWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  const uint32_t Args[] = {5, 0, 3, 0};
+  std::vector<std::thread> Threads;
+  for (const auto Arg : Args) {
+    Threads.emplace_back([&VM, Arg]() {
+      auto Res = VM.getExecutor().invoke(
+          *VM.getActiveModule()->findFuncExports("run"),
+          std::initializer_list<WasmEdge::ValVariant>{Arg},
+          {WasmEdge::ValType::I32});
+      ASSERT_TRUE(Res);
+      EXPECT_EQ((*Res)[0].first.get<uint32_t>(), Arg ? 0U : 7U);
+    });
+  }
+  for (auto &T : Threads) {
+    T.join();
+  }
+  // The counts are kept after the module instance is destroyed.
+  VM.cleanup();
+  EXPECT_TRUE(Prof.empty());
+  VM.setPGOProfile(nullptr);
+
+  EXPECT_EQ(Prof.getEntryCount(0), 2U);
+  EXPECT_EQ(Prof.getEntryCount(1), 4U);
+  const auto BrIf = Prof.getBranchCounts(BranchWasmBrIf);
+  EXPECT_EQ(std::vector<uint64_t>(BrIf.begin(), BrIf.end()),
+            (std::vector<uint64_t>{6, 2}));
+  const auto If = Prof.getBranchCounts(BranchWasmIf);
+  EXPECT_EQ(std::vector<uint64_t>(If.begin(), If.end()),
+            (std::vector<uint64_t>{2, 2}));
+}
+
+TEST(Scheduler, ThreadTest) {
+  WasmEdge::Configure Conf;
+  Conf.getStatisticsConfigure().setCostMeasuring(true);
+  std::array<std::unique_ptr<WasmEdge::VM::VM>, 4> VMs;
+  for (auto &VM : VMs) {
+    VM = std::make_unique<WasmEdge::VM::VM>(Conf);
+    ASSERT_TRUE(VM->loadWasm(MersenneTwister19937));
+    ASSERT_TRUE(VM->validate());
+    ASSERT_TRUE(VM->instantiate());
+  }
+
+  WasmEdge::VM::Scheduler::Options Opts;
+  Opts.Workers = 2;
+  Opts.Quantum = 1ms;
+  Opts.Fuel = UINT64_C(200000);
+  std::array<std::shared_ptr<WasmEdge::VM::Scheduler::Task>, 4> Tasks;
+  WasmEdge::VM::Scheduler::Statistics Stat;
+  {
+    WasmEdge::VM::Scheduler Sched(Opts);
+    Sched.setTenantWeight(1, 2);
+    EXPECT_FALSE(Sched.submit(*VMs[0], "not_exist", {}, {}));
+    for (uint64_t Index = 0; Index < VMs.size(); ++Index) {
+      auto Res = Sched.submit(
+          *VMs[Index], "mt19937",
+          std::initializer_list<WasmEdge::ValVariant>{
+              UINT32_C(2504) * Index, UINT64_C(5489), UINT64_C(100000) + Index},
+          {WasmEdge::ValType::I32, WasmEdge::ValType::I64,
+           WasmEdge::ValType::I64},
+          static_cast<uint32_t>(Index % 2));
+      ASSERT_TRUE(Res);
+      Tasks[Index] = *Res;
+    }
+    for (uint64_t Index = 0; Index < Tasks.size(); ++Index) {
+      auto Result = Tasks[Index]->wait();
+      ASSERT_TRUE(Result);
+      ASSERT_EQ((*Result)[0].second, WasmEdge::ValType::I64);
+      EXPECT_EQ((*Result)[0].first.get<uint64_t>(), Answers[Index]);
+      EXPECT_TRUE(Tasks[Index]->isFinished());
+      EXPECT_GT(Tasks[Index]->getSliceCount(), 1U);
+    }
+    Stat = Sched.getStatistics();
+  }
+  EXPECT_EQ(Stat.Submitted, 4U);
+  EXPECT_EQ(Stat.Finished, 4U);
+  EXPECT_EQ(Stat.Failed, 0U);
+  EXPECT_EQ(Stat.Slices, Stat.Suspends + 4U);
+}
+
+// The epoch counter advances only while a deadline is armed.
+TEST(Epoch, ThreadTest) {
+  using namespace std::literals;
+  // Let the timer thread park after the previous tests.
+  std::this_thread::sleep_for(5ms);
+  const uint64_t Parked = WasmEdge::Epoch::current();
+  std::this_thread::sleep_for(20ms);
+  EXPECT_EQ(WasmEdge::Epoch::current(), Parked);
+
+  WasmEdge::Epoch::arm();
+  const auto Until = std::chrono::steady_clock::now() + 1s;
+  while (WasmEdge::Epoch::current() == Parked &&
+         std::chrono::steady_clock::now() < Until) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_GT(WasmEdge::Epoch::current(), Parked);
+  WasmEdge::Epoch::disarm();
+
+  std::this_thread::sleep_for(5ms);
+  const uint64_t Stopped = WasmEdge::Epoch::current();
+  std::this_thread::sleep_for(20ms);
+  EXPECT_EQ(WasmEdge::Epoch::current(), Stopped);
+}
+
+// memory.atomic.wait32 on a shared memory without a timeout.
+std::array<WasmEdge::Byte, 51> WaitWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60,
+    0x00, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x01, 0x03, 0x01,
+    0x01, 0x07, 0x08, 0x01, 0x04, 0x77, 0x61, 0x69, 0x74, 0x00, 0x00, 0x0a,
+    0x0e, 0x01, 0x0c, 0x00, 0x41, 0x00, 0x41, 0x00, 0x42, 0x7f, 0xfe, 0x01,
+    0x02, 0x00, 0x0b,
+};
+
+// The timeout wakes up memory.atomic.wait, as `wasmedge --time-limit` does.
+TEST(Timeout, AtomicWaitTest) {
+  using namespace std::literals;
+  WasmEdge::Configure Conf;
+  Conf.addProposal(WasmEdge::Proposal::Threads);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(WaitWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  const auto Start = std::chrono::steady_clock::now();
+  VM.setTimeout(Start + 50ms);
+  auto Res = VM.execute("wait");
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::Interrupted);
+  EXPECT_GE(std::chrono::steady_clock::now() - Start, 50ms);
+
+  // The timeout is consumed, so the epoch timer is parked again.
+  VM.clearTimeout();
+  std::this_thread::sleep_for(5ms);
+  const uint64_t Stopped = WasmEdge::Epoch::current();
+  std::this_thread::sleep_for(20ms);
+  EXPECT_EQ(WasmEdge::Epoch::current(), Stopped);
+}
+
+// The interpreted frames are sampled while running.
+TEST(Profiler, InterpreterTest) {
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  WasmEdge::Executor::Profiler Prof(std::chrono::milliseconds(1));
+  VM.setProfiler(&Prof);
+  ASSERT_TRUE(VM.loadWasm(MersenneTwister19937));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  ASSERT_TRUE(VM.execute(
+      "mt19937",
+      std::initializer_list<WasmEdge::ValVariant>{
+          UINT32_C(0), UINT64_C(5489), UINT64_C(100000)},
+      {WasmEdge::ValType::I32, WasmEdge::ValType::I64,
+       WasmEdge::ValType::I64}));
+  VM.setProfiler(nullptr);
+  EXPECT_GT(Prof.getSampleCount(), 0U);
+  std::ostringstream OS;
+  Prof.dumpFolded(OS);
+  EXPECT_EQ(OS.str().rfind("mt19937 ", 0), 0U);
+}
+
 #ifdef WASMEDGE_BUILD_AOT_RUNTIME
 
 TEST(AOTAsyncExecute, ThreadTest) {
@@ -316,6 +904,117 @@ TEST(AOTAsyncExecute, GasThreadTest) {
   std::filesystem::remove(Path);
 }
 
+TEST(AOTAsyncExecute, GasLimitThreadTest) {
+  WasmEdge::Configure Conf;
+  Conf.getStatisticsConfigure().setCostMeasuring(true);
+  auto Module = compileModule(Conf, MersenneTwister19937);
+  ASSERT_TRUE(Module);
+  checkGasLimit(Conf, [&Module](WasmEdge::VM::VM &VM) {
+    return VM.loadWasm(*Module) && VM.validate() && VM.instantiate();
+  });
+}
+
+TEST(AOTImportCall, ThreadTest) {
+  uint32_t Calls = 0;
+  WasmEdge::Runtime::Instance::ModuleInstance Env("env");
+  Env.addHostFunc("halt", std::make_unique<HostHalt>());
+  Env.addHostFunc("count", std::make_unique<HostCount>(Calls));
+  WasmEdge::Configure Conf;
+  auto Lib = compileModule(Conf, TwiceWasm);
+  ASSERT_NE(Lib, nullptr);
+  auto Main = compileModule(Conf, CallWasm);
+  ASSERT_NE(Main, nullptr);
+
+  // The calls from the compiled code to the host function and to the compiled
+  // function of another module take the direct paths.
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.registerModule(Env));
+  ASSERT_TRUE(VM.registerModule("lib", *Lib));
+  ASSERT_TRUE(VM.loadWasm(
+      std::shared_ptr<const WasmEdge::AST::Module>(std::move(Main))));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  checkImportCalls(VM, Calls);
+}
+
+// The host function called by the compiled code cannot suspend it.
+TEST(AOTContinuation, HostSuspendTest) {
+  uint32_t Polls = 0;
+  WasmEdge::Runtime::Instance::ModuleInstance Env("env");
+  Env.addHostFunc("poll", std::make_unique<HostPoll>(Polls));
+  WasmEdge::Configure Conf;
+  auto Module = compileModule(Conf, PollWasm);
+  ASSERT_NE(Module, nullptr);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.registerModule(Env));
+  ASSERT_TRUE(VM.loadWasm(
+      std::shared_ptr<const WasmEdge::AST::Module>(std::move(Module))));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  auto Cont = VM.createContinuation(
+      "run", std::initializer_list<WasmEdge::ValVariant>{UINT32_C(20)},
+      {WasmEdge::ValType::I32});
+  ASSERT_TRUE(Cont);
+  auto Res = VM.resume(**Cont);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::HostFuncError);
+  EXPECT_EQ(Polls, 1U);
+  EXPECT_EQ((*Cont)->getStatus(),
+            WasmEdge::Executor::Continuation::Status::Failed);
+  EXPECT_EQ((*Cont)->getSuspendCount(), 0U);
+
+  // The instance is still usable after the failure.
+  auto Ret = VM.execute(
+      "run", std::initializer_list<WasmEdge::ValVariant>{UINT32_C(20)},
+      {WasmEdge::ValType::I32});
+  ASSERT_FALSE(Ret);
+  EXPECT_EQ(Polls, 2U);
+  Ret = VM.execute("run",
+                   std::initializer_list<WasmEdge::ValVariant>{UINT32_C(20)},
+                   {WasmEdge::ValType::I32});
+  ASSERT_TRUE(Ret);
+  EXPECT_EQ((*Ret)[0].first.get<uint32_t>(), 41U);
+}
+
+// The compiled frames are walked only through the code ranges of the
+// registered functions, and within the stack with growing frame pointers.
+TEST(AOTProfiler, ThreadTest) {
+  WasmEdge::Configure Conf;
+  auto Lib = compileModule(Conf, TwiceWasm);
+  ASSERT_TRUE(Lib);
+  WasmEdge::VM::VM VM(Conf);
+  WasmEdge::Executor::Profiler Prof;
+  VM.setProfiler(&Prof);
+  ASSERT_TRUE(VM.loadWasm(*Lib));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  VM.setProfiler(nullptr);
+  const auto *Func = VM.getActiveModule()->findFuncExports("twice");
+  ASSERT_NE(Func, nullptr);
+  const auto Entry = reinterpret_cast<uintptr_t>(Func->getSymbol().get());
+  WasmEdge::Runtime::StackManager StackMgr;
+
+  // The return address of the second record is outside the code ranges.
+  std::array<void *, 4> Records = {
+      &Records[2], reinterpret_cast<void *>(Entry + 1), &Records[4],
+      reinterpret_cast<void *>(Entry + (UINT64_C(1) << 32))};
+  Prof.addSample(StackMgr, nullptr, {}, Records.data(),
+                 Records.data() + Records.size());
+  // The frame pointer of the first record does not grow.
+  Records[0] = &Records[0];
+  Records[3] = reinterpret_cast<void *>(Entry + 1);
+  Prof.addSample(StackMgr, nullptr, {}, Records.data(),
+                 Records.data() + Records.size());
+  // The second record is out of the stack.
+  Records[0] = &Records[2];
+  Prof.addSample(StackMgr, nullptr, {}, Records.data(), Records.data() + 2);
+
+  std::ostringstream OS;
+  Prof.dumpFolded(OS);
+  EXPECT_EQ(OS.str(), "twice 3\n");
+}
+
 #endif
 
 } // namespace
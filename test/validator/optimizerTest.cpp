@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/validator/optimizerTest.cpp - Optimizer unit tests --===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the wasm-level optimizer.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/configure.h"
+#include "loader/loader.h"
+#include "validator/validator.h"
+#include "vm/vm.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using namespace WasmEdge;
+
+// (module
+//   (memory 1)
+//   (func $add (param i32 i32) (result i32)
+//     local.get 0 local.get 1 i32.add)
+//   (func (export "calc") (param i32) (result i32) (local i32 i32)
+//     i32.const 7 local.set 1
+//     local.get 0 i32.const 2 i32.const 3 i32.mul call $add
+//     i32.const 0 i32.add local.set 2 local.get 2)
+//   (func (export "mem") (param i32) (result i32)
+//     local.get 0 i32.const 42 i32.store offset=4
+//     local.get 0 i32.load offset=4 local.get 0 i32.load i32.add)
+//   (func (export "dead") (param i32) (result i32)
+//     local.get 0 return i32.const 1 drop)
+//   (func (export "trap") (result i32)
+//     i32.const 1 i32.const 0 i32.div_u))
+const std::vector<Byte> Wasm = {
+    0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00,
+    // Type section.
+    0x01, 0x10, 0x03, 0x60, 0x01, 0x7F, 0x01, 0x7F, 0x60, 0x02, 0x7F, 0x7F,
+    0x01, 0x7F, 0x60, 0x00, 0x01, 0x7F,
+    // Function section.
+    0x03, 0x06, 0x05, 0x01, 0x00, 0x00, 0x00, 0x02,
+    // Memory section.
+    0x05, 0x03, 0x01, 0x00, 0x01,
+    // Export section.
+    0x07, 0x1C, 0x04, 0x04, 0x63, 0x61, 0x6C, 0x63, 0x00, 0x01, 0x03, 0x6D,
+    0x65, 0x6D, 0x00, 0x02, 0x04, 0x64, 0x65, 0x61, 0x64, 0x00, 0x03, 0x04,
+    0x74, 0x72, 0x61, 0x70, 0x00, 0x04,
+    // Code section.
+    0x0A, 0x4A, 0x05,
+    // $add
+    0x07, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6A, 0x0B,
+    // calc
+    0x1A, 0x02, 0x01, 0x7F, 0x01, 0x7F, 0x41, 0x07, 0x21, 0x01, 0x20, 0x00,
+    0x41, 0x02, 0x41, 0x03, 0x6C, 0x10, 0x00, 0x41, 0x00, 0x6A, 0x21, 0x02,
+    0x20, 0x02, 0x0B,
+    // mem
+    0x14, 0x00, 0x20, 0x00, 0x41, 0x2A, 0x36, 0x02, 0x04, 0x20, 0x00, 0x28,
+    0x02, 0x04, 0x20, 0x00, 0x28, 0x02, 0x00, 0x6A, 0x0B,
+    // dead
+    0x08, 0x00, 0x20, 0x00, 0x0F, 0x41, 0x01, 0x1A, 0x0B,
+    // trap
+    0x07, 0x00, 0x41, 0x01, 0x41, 0x00, 0x6E, 0x0B};
+
+Configure createConf(bool IsWasmOptimization) {
+  Configure Conf;
+  Conf.getCompilerConfigure().setWasmOptimization(IsWasmOptimization);
+  return Conf;
+}
+
+std::vector<OpCode> getOpCodes(const AST::CodeSegment &CodeSeg) {
+  std::vector<OpCode> OpCodes;
+  for (const auto &Instr : CodeSeg.getExpr().getInstrs()) {
+    OpCodes.push_back(Instr.getOpCode());
+  }
+  return OpCodes;
+}
+
+TEST(OptimizerTest, Rewrite) {
+  const auto Conf = createConf(true);
+  Loader::Loader Load(Conf);
+  Validator::Validator Valid(Conf);
+  auto Mod = Load.parseModule(Wasm);
+  ASSERT_TRUE(Mod);
+  ASSERT_TRUE(Valid.validate(**Mod));
+  const auto Codes = (*Mod)->getCodeSection().getContent();
+  ASSERT_EQ(Codes.size(), 5U);
+
+  // The call is inlined, the constants are folded, and the unread locals are
+  // removed.
+  EXPECT_EQ(getOpCodes(Codes[1]),
+            (std::vector<OpCode>{OpCode::Local__get, OpCode::I32__const,
+                                 OpCode::I32__add, OpCode::End}));
+  EXPECT_EQ(Codes[1].getExpr().getInstrs()[1].getNum().get<uint32_t>(), 6U);
+  EXPECT_TRUE(Codes[1].getLocals().empty());
+
+  // The accesses covered by the store skip the bounds check.
+  const auto MemInstrs = Codes[2].getExpr().getInstrs();
+  ASSERT_EQ(MemInstrs.size(), 9U);
+  EXPECT_FALSE(MemInstrs[2].isInBounds());
+  EXPECT_TRUE(MemInstrs[4].isInBounds());
+  EXPECT_TRUE(MemInstrs[6].isInBounds());
+
+  // The unreachable code is removed.
+  EXPECT_EQ(getOpCodes(Codes[3]),
+            (std::vector<OpCode>{OpCode::Local__get, OpCode::Return,
+                                 OpCode::End}));
+
+  // The trapping division is kept.
+  EXPECT_EQ(getOpCodes(Codes[4]),
+            (std::vector<OpCode>{OpCode::I32__const, OpCode::I32__const,
+                                 OpCode::I32__div_u, OpCode::End}));
+
+  // The validated module is not optimized again.
+  ASSERT_TRUE(Valid.validate(**Mod));
+  EXPECT_EQ(getOpCodes(Codes[1]).size(), 4U);
+}
+
+TEST(OptimizerTest, Execute) {
+  for (const bool IsWasmOptimization : {false, true}) {
+    VM::VM VM(createConf(IsWasmOptimization));
+    ASSERT_TRUE(VM.loadWasm(Wasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+
+    const std::array<ValType, 1> ParamTypes = {ValType::I32};
+    const std::array<ValVariant, 1> Five = {ValVariant(UINT32_C(5))};
+    auto Res = VM.execute("calc", Five, ParamTypes);
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 11U);
+
+    const std::array<ValVariant, 1> Zero = {ValVariant(UINT32_C(0))};
+    Res = VM.execute("mem", Zero, ParamTypes);
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 42U);
+
+    const std::array<ValVariant, 1> Edge = {ValVariant(UINT32_C(65532))};
+    Res = VM.execute("mem", Edge, ParamTypes);
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), ErrCode::Value::MemoryOutOfBounds);
+
+    Res = VM.execute("dead", Five, ParamTypes);
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 5U);
+
+    Res = VM.execute("trap");
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), ErrCode::Value::DivideByZero);
+  }
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  WasmEdge::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}